@@ -35,6 +35,10 @@ public:
 
     zx_status_t Query(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flags) override;
 
+    zx_status_t HarvestAccessed(vaddr_t vaddr, size_t count,
+                                HarvestCallback accessed, void* context) override;
+    zx_status_t MarkAccessed(vaddr_t vaddr, size_t count) override;
+
     vaddr_t PickSpot(vaddr_t base, uint prev_region_mmu_flags,
                      vaddr_t end, uint next_region_mmu_flags,
                      vaddr_t align, size_t size, uint mmu_flags) override;
@@ -87,6 +91,8 @@ private:
                              vaddr_t vaddr_base, uint top_size_shift,
                              uint top_index_shift, uint page_size_shift) TA_REQ(lock_);
     zx_status_t QueryLocked(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flags) TA_REQ(lock_);
+    zx_status_t LookupLocked(vaddr_t vaddr, volatile pte_t** entry,
+                             vaddr_t* offset) TA_REQ(lock_);
 
     void FlushTLBEntry(vaddr_t vaddr, bool terminal) TA_REQ(lock_);
 
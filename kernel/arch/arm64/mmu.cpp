@@ -298,6 +298,35 @@ zx_status_t ArmArchVmAspace::Query(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flag
 }
 
 zx_status_t ArmArchVmAspace::QueryLocked(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flags) {
+    canary_.Assert();
+    LTRACEF("aspace %p, vaddr 0x%lx\n", this, vaddr);
+
+    volatile pte_t* entry;
+    vaddr_t vaddr_rem;
+    zx_status_t status = LookupLocked(vaddr, &entry, &vaddr_rem);
+    if (status != ZX_OK)
+        return status;
+
+    pte_t pte = *entry;
+    if (paddr)
+        *paddr = (pte & MMU_PTE_OUTPUT_ADDR_MASK) + vaddr_rem;
+    if (mmu_flags) {
+        *mmu_flags = 0;
+        if (flags_ & ARCH_ASPACE_FLAG_GUEST) {
+            s2_pte_attr_to_mmu_flags(pte, mmu_flags);
+        } else {
+            s1_pte_attr_to_mmu_flags(pte, mmu_flags);
+        }
+    }
+    LTRACEF("va 0x%lx, paddr 0x%lx, flags 0x%x\n",
+            vaddr, paddr ? *paddr : ~0UL, mmu_flags ? *mmu_flags : ~0U);
+    return 0;
+}
+
+// Walk the translation tables for |vaddr|, returning the block or page
+// descriptor that maps it and the offset of |vaddr| within that block or page.
+zx_status_t ArmArchVmAspace::LookupLocked(vaddr_t vaddr, volatile pte_t** entry,
+                                          vaddr_t* offset) {
     ulong index;
     uint index_shift;
     uint page_size_shift;
@@ -307,9 +336,6 @@ zx_status_t ArmArchVmAspace::QueryLocked(vaddr_t vaddr, paddr_t* paddr, uint* mm
     volatile pte_t* page_table;
     vaddr_t vaddr_rem;
 
-    canary_.Assert();
-    LTRACEF("aspace %p, vaddr 0x%lx\n", this, vaddr);
-
     DEBUG_ASSERT(tt_virt_);
 
     DEBUG_ASSERT(IsValidVaddr(vaddr));
@@ -371,19 +397,9 @@ zx_status_t ArmArchVmAspace::QueryLocked(vaddr_t vaddr, paddr_t* paddr, uint* mm
         index_shift -= page_size_shift - 3;
     }
 
-    if (paddr)
-        *paddr = pte_addr + vaddr_rem;
-    if (mmu_flags) {
-        *mmu_flags = 0;
-        if (flags_ & ARCH_ASPACE_FLAG_GUEST) {
-            s2_pte_attr_to_mmu_flags(pte, mmu_flags);
-        } else {
-            s1_pte_attr_to_mmu_flags(pte, mmu_flags);
-        }
-    }
-    LTRACEF("va 0x%lx, paddr 0x%lx, flags 0x%x\n",
-            vaddr, paddr ? *paddr : ~0UL, mmu_flags ? *mmu_flags : ~0U);
-    return 0;
+    *entry = &page_table[index];
+    *offset = vaddr_rem;
+    return ZX_OK;
 }
 
 zx_status_t ArmArchVmAspace::AllocPageTable(paddr_t* paddrp, uint page_size_shift) {
@@ -1031,6 +1047,90 @@ zx_status_t ArmArchVmAspace::Protect(vaddr_t vaddr, size_t count, uint mmu_flags
     return ret;
 }
 
+zx_status_t ArmArchVmAspace::HarvestAccessed(vaddr_t vaddr, size_t count,
+                                             HarvestCallback accessed, void* context) {
+    canary_.Assert();
+    LTRACEF("vaddr %#" PRIxPTR " count %zu\n", vaddr, count);
+
+    if (!IsValidVaddr(vaddr))
+        return ZX_ERR_INVALID_ARGS;
+
+    if (!IS_PAGE_ALIGNED(vaddr))
+        return ZX_ERR_INVALID_ARGS;
+
+    // Only user page mappings are aged; the kernel and stage 2 tables must
+    // never take access flag faults.
+    const bool track_accessed = !(flags_ & (ARCH_ASPACE_FLAG_KERNEL | ARCH_ASPACE_FLAG_GUEST));
+
+    fbl::AutoLock a(&lock_);
+
+    bool flushed = false;
+    for (size_t i = 0; i < count; ++i, vaddr += PAGE_SIZE) {
+        volatile pte_t* entry;
+        vaddr_t offset;
+        if (LookupLocked(vaddr, &entry, &offset) != ZX_OK)
+            continue;
+
+        pte_t pte = *entry;
+        if (track_accessed && (pte & MMU_PTE_DESCRIPTOR_MASK) == MMU_PTE_L3_DESCRIPTOR_PAGE) {
+            if (!(pte & MMU_PTE_ATTR_AF))
+                continue;
+
+            // The next access takes an access flag fault, which sets the flag
+            // again through MarkAccessed().
+            *entry = pte & ~MMU_PTE_ATTR_AF;
+
+            // ensure that the update is observable from hardware page table walkers
+            DMB_ISHST;
+
+            // flush the terminal TLB entry
+            FlushTLBEntry(vaddr, true);
+            flushed = true;
+        }
+
+        accessed(vaddr, (pte & MMU_PTE_OUTPUT_ADDR_MASK) + offset, context);
+    }
+
+    if (flushed)
+        DSB;
+
+    return ZX_OK;
+}
+
+zx_status_t ArmArchVmAspace::MarkAccessed(vaddr_t vaddr, size_t count) {
+    canary_.Assert();
+    LTRACEF("vaddr %#" PRIxPTR " count %zu\n", vaddr, count);
+
+    if (!IsValidVaddr(vaddr))
+        return ZX_ERR_INVALID_ARGS;
+
+    if (!IS_PAGE_ALIGNED(vaddr))
+        return ZX_ERR_INVALID_ARGS;
+
+    fbl::AutoLock a(&lock_);
+
+    bool updated = false;
+    for (size_t i = 0; i < count; ++i, vaddr += PAGE_SIZE) {
+        volatile pte_t* entry;
+        vaddr_t offset;
+        if (LookupLocked(vaddr, &entry, &offset) != ZX_OK)
+            continue;
+
+        pte_t pte = *entry;
+        if (!(pte & MMU_PTE_ATTR_AF)) {
+            // Entries that fault on access are never held in the TLB, so
+            // there is nothing to flush.
+            *entry = pte | MMU_PTE_ATTR_AF;
+            updated = true;
+        }
+    }
+
+    if (updated)
+        DSB;
+
+    return ZX_OK;
+}
+
 zx_status_t ArmArchVmAspace::Init(vaddr_t base, size_t size, uint flags) {
     canary_.Assert();
     LTRACEF("aspace %p, base %#" PRIxPTR ", size 0x%zx, flags 0x%x\n",
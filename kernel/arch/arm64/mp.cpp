@@ -12,6 +12,7 @@
 #include <dev/interrupt.h>
 #include <err.h>
 #include <kernel/event.h>
+#include <kernel/mp.h>
 #include <platform.h>
 #include <trace.h>
 #include <zircon/types.h>
@@ -51,6 +52,9 @@ void arch_init_cpu_map(uint cluster_count, const uint* cluster_cpus) {
             // set the per cpu structure's cpu id
             arm64_percpu_array[cpu_id].cpu_num = cpu_id;
 
+            // cpus in a cluster share the last level cache, and each is its own core
+            mp_set_cpu_topology(cpu_id, cluster, cpu);
+
             cpu_id++;
         }
     }
@@ -44,6 +44,7 @@ private:
     void TlbInvalidate(PendingTlbInvalidation* pending) final;
     uint pt_flags_to_mmu_flags(PtFlags flags, PageTableLevel level) final;
     bool needs_cache_flushes() final { return false; }
+    PtFlags accessed_flag() final { return X86_MMU_PG_A; }
 
     // If true, all mappings will have the global bit set.
     bool use_global_mappings_ = false;
@@ -66,6 +67,8 @@ private:
     void TlbInvalidate(PendingTlbInvalidation* pending) final;
     uint pt_flags_to_mmu_flags(PtFlags flags, PageTableLevel level) final;
     bool needs_cache_flushes() final { return false; }
+    // Accessed flags in EPT entries are only written when enabled in the EPTP.
+    PtFlags accessed_flag() final { return 0; }
 };
 
 class X86ArchVmAspace final : public ArchVmAspaceInterface {
@@ -86,6 +89,10 @@ public:
     zx_status_t Protect(vaddr_t vaddr, size_t count, uint mmu_flags) override;
     zx_status_t Query(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flags) override;
 
+    zx_status_t HarvestAccessed(vaddr_t vaddr, size_t count,
+                                HarvestCallback accessed, void* context) override;
+    zx_status_t MarkAccessed(vaddr_t vaddr, size_t count) override { return ZX_OK; }
+
     vaddr_t PickSpot(vaddr_t base, uint prev_region_mmu_flags,
                      vaddr_t end, uint next_region_mmu_flags,
                      vaddr_t align, size_t size, uint mmu_flags) override;
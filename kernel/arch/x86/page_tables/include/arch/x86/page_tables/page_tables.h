@@ -91,6 +91,9 @@ public:
 
     zx_status_t QueryVaddr(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flags);
 
+    zx_status_t HarvestAccessed(vaddr_t vaddr, size_t count,
+                                ArchVmAspaceInterface::HarvestCallback accessed, void* context);
+
 protected:
     // Initialize an empty page table, assigning this given context to it.
     zx_status_t Init(void* ctx);
@@ -124,6 +127,9 @@ protected:
     // Returns true if a cache flush is necessary for pagetable changes to be
     // visible.
     virtual bool needs_cache_flushes() = 0;
+    // Returns the hardware flag set on terminal entries when they are
+    // accessed, or 0 if accessed state is not tracked.
+    virtual PtFlags accessed_flag() = 0;
 
     // Pointer to the translation table.
     paddr_t phys_ = 0;
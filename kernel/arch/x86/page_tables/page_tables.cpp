@@ -1020,6 +1020,45 @@ zx_status_t X86PageTableBase::QueryVaddr(vaddr_t vaddr, paddr_t* paddr, uint* mm
     return ZX_OK;
 }
 
+zx_status_t X86PageTableBase::HarvestAccessed(vaddr_t vaddr, size_t count,
+                                              ArchVmAspaceInterface::HarvestCallback accessed,
+                                              void* context) {
+    canary_.Assert();
+
+    LTRACEF("aspace %p, vaddr %#" PRIxPTR " count %#zx\n", this, vaddr, count);
+
+    if (!check_vaddr(vaddr))
+        return ZX_ERR_INVALID_ARGS;
+
+    const PtFlags accessed_bit = accessed_flag();
+
+    fbl::AutoLock a(&lock_);
+    for (size_t i = 0; i < count; ++i, vaddr += PAGE_SIZE) {
+        PageTableLevel level;
+        volatile pt_entry_t* e;
+        if (GetMapping(virt_, vaddr, top_level(), &level, &e) != ZX_OK) {
+            continue;
+        }
+
+        // Large pages and tables without accessed tracking are always reported.
+        const pt_entry_t pt_val = *e;
+        if (level == PT_L && accessed_bit) {
+            if (!(pt_val & accessed_bit)) {
+                continue;
+            }
+            // The CPU may set the dirty bit concurrently, so clear atomically.
+            // Skip the TLB invalidation: a stale entry only hides accesses
+            // until it is evicted, making the page look colder than it is.
+            __atomic_fetch_and(const_cast<pt_entry_t*>(e), ~accessed_bit, __ATOMIC_RELAXED);
+        }
+
+        const paddr_t pa = paddr_from_pte(level, pt_val) | (vaddr & (page_size(level) - 1));
+        accessed(vaddr, pa, context);
+    }
+
+    return ZX_OK;
+}
+
 void X86PageTableBase::Destroy(vaddr_t base, size_t size) {
     canary_.Assert();
 
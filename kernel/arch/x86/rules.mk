@@ -71,6 +71,7 @@ MODULE_SRCS += \
 	$(LOCAL_DIR)/tsc.cpp \
 	$(LOCAL_DIR)/user_copy.S \
 	$(LOCAL_DIR)/user_copy.cpp \
+	$(LOCAL_DIR)/user_copy_tests.cpp \
 	$(LOCAL_DIR)/uspace_entry.S \
 
 MODULE_DEPS += \
@@ -12,6 +12,7 @@
 #include <arch/x86.h>
 #include <arch/x86/apic.h>
 #include <arch/x86/bootstrap16.h>
+#include <arch/x86/cpu_topology.h>
 #include <arch/x86/descriptor.h>
 #include <arch/x86/mmu_mem_types.h>
 #include <arch/x86/mp.h>
@@ -31,6 +32,17 @@ void x86_init_smp(uint32_t* apic_ids, uint32_t num_cpus) {
         return;
     }
 
+    // let the scheduler know which cpus share a cache or a core.  the package and die
+    // (node) together identify the last level cache.
+    for (uint32_t i = 0; i < num_cpus; ++i) {
+        int cpu = x86_apic_id_to_cpu_num(apic_ids[i]);
+        DEBUG_ASSERT(cpu >= 0);
+
+        x86_cpu_topology_t topo;
+        x86_cpu_topology_decode(apic_ids[i], &topo);
+        mp_set_cpu_topology(cpu, (topo.package_id << 16) | topo.node_id, topo.core_id);
+    }
+
     lk_init_secondary_cpus(num_cpus - 1);
 }
 
@@ -21,6 +21,16 @@
 
 CODE_TEMPLATE(kStacInstruction, "stac");
 CODE_TEMPLATE(kClacInstruction, "clac");
+CODE_TEMPLATE(kErmsCopy,
+              "mov %rdx, %rcx\n"
+              "rep movsb");
+CODE_TEMPLATE(kQuadCopy,
+              "mov %rdx, %rcx\n"
+              "shr $3, %rcx\n"
+              "rep movsq\n"
+              "mov %rdx, %rcx\n"
+              "and $7, %rcx\n"
+              "rep movsb");
 static const uint8_t kNopInstruction = 0x90;
 
 extern "C" {
@@ -46,6 +56,25 @@ void fill_out_clac_instruction(const CodePatchInfo* patch) {
         memset(patch->dest_addr, kNopInstruction, kSize);
     }
 }
+
+// Chooses how _x86_copy_to_or_from_user() does copies too large for its
+// plain move loop.  With ERMS, "rep movsb" is at least as fast as anything
+// else for these sizes; otherwise moving quadwords is much faster.
+void x86_user_copy_select(const CodePatchInfo* patch) {
+    const uint8_t* start;
+    const uint8_t* end;
+    if (x86_feature_test(X86_FEATURE_ERMS)) {
+        start = kErmsCopy;
+        end = kErmsCopyEnd;
+    } else {
+        start = kQuadCopy;
+        end = kQuadCopyEnd;
+    }
+    const size_t size = end - start;
+    DEBUG_ASSERT(size <= patch->dest_size);
+    memcpy(patch->dest_addr, start, size);
+    memset(patch->dest_addr + size, kNopInstruction, patch->dest_size - size);
+}
 }
 
 static inline bool ac_flag(void) {
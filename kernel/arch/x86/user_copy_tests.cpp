@@ -0,0 +1,56 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <arch/x86/user_copy.h>
+#include <err.h>
+#include <lib/unittest/unittest.h>
+#include <string.h>
+#include <zircon/types.h>
+
+// _x86_copy_to_or_from_user() doesn't check which address space its buffers
+// are in, so kernel buffers are enough to check that each of its copy paths
+// moves exactly the bytes asked for.
+static bool user_copy_sizes_test() {
+    BEGIN_TEST;
+
+    constexpr size_t kMaxLen = 300;
+    constexpr size_t kPad = 16;
+    static uint8_t src[kMaxLen + kPad];
+    static uint8_t dst[kMaxLen + 2 * kPad];
+
+    for (size_t i = 0; i < sizeof(src); ++i) {
+        src[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+
+    for (size_t src_offset = 0; src_offset < 8; ++src_offset) {
+        for (size_t dst_offset = 0; dst_offset < 8; ++dst_offset) {
+            for (size_t len = 0; len <= kMaxLen; ++len) {
+                memset(dst, 0, sizeof(dst));
+
+                void* fault_return = nullptr;
+                zx_status_t status = _x86_copy_to_or_from_user(
+                    dst + kPad + dst_offset, src + src_offset, len, &fault_return);
+                ASSERT_EQ(ZX_OK, status, "copy failed");
+                ASSERT_TRUE(fault_return == nullptr, "fault return not reset");
+
+                ASSERT_TRUE(!memcmp(dst + kPad + dst_offset, src + src_offset, len),
+                            "buffer mismatch");
+                for (size_t i = 0; i < kPad + dst_offset; ++i) {
+                    ASSERT_EQ(0, dst[i], "overwrote before buffer");
+                }
+                for (size_t i = kPad + dst_offset + len; i < sizeof(dst); ++i) {
+                    ASSERT_EQ(0, dst[i], "overwrote after buffer");
+                }
+            }
+        }
+    }
+
+    END_TEST;
+}
+
+UNITTEST_START_TESTCASE(x86_user_copy_tests)
+UNITTEST("copy sizes and alignments", user_copy_sizes_test)
+UNITTEST_END_TESTCASE(x86_user_copy_tests, "x86_user_copy", "x86 user copy tests");
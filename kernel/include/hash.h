@@ -0,0 +1,27 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <stdint.h>
+#include <zircon/compiler.h>
+
+__BEGIN_CDECLS
+
+// Mix the bits of |x| so that nearby values, such as the addresses of
+// neighbouring objects, spread over the whole range. This is the 64-bit
+// MurmurHash3 finalizer; it is a bijection, so distinct inputs stay distinct.
+__CONSTEXPR static inline uint64_t hash_mix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+__END_CDECLS
@@ -99,6 +99,11 @@ struct mp_state {
 
     // lock for serializing CPU hotplug/unplug operations
     mutex_t hotplug_lock;
+
+    // cpus sharing a last level cache or a physical core with each cpu, not including
+    // the cpu itself; see mp_set_cpu_topology()
+    cpu_mask_t cache_siblings[SMP_MAX_CPUS];
+    cpu_mask_t smt_siblings[SMP_MAX_CPUS];
 };
 
 extern struct mp_state mp;
@@ -106,6 +111,22 @@ extern struct mp_state mp;
 void mp_set_curr_cpu_online(bool online);
 void mp_set_curr_cpu_active(bool active);
 
+// Called by the architecture for each cpu before the secondary cpus are started.
+// |cache_domain| identifies the cpus sharing a last level cache, and |core| the physical
+// core within that cache domain; cpus with the same core are SMT siblings.
+// Cpus whose topology is never set are treated as sharing nothing.
+void mp_set_cpu_topology(cpu_num_t cpu, uint32_t cache_domain, uint32_t core);
+
+// the cpus sharing a last level cache with |cpu|, including |cpu|
+static inline cpu_mask_t mp_get_cache_siblings(cpu_num_t cpu) {
+    return mp.cache_siblings[cpu] | cpu_num_to_mask(cpu);
+}
+
+// the cpus sharing a physical core with |cpu|, including |cpu|
+static inline cpu_mask_t mp_get_smt_siblings(cpu_num_t cpu) {
+    return mp.smt_siblings[cpu] | cpu_num_to_mask(cpu);
+}
+
 static inline int mp_is_cpu_active(cpu_num_t cpu) {
     return atomic_load((int*)&mp.active_cpus) & cpu_num_to_mask(cpu);
 }
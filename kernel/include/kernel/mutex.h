@@ -24,8 +24,11 @@ __BEGIN_CDECLS
 // The val field holds either 0 or a pointer to the thread_t holding the mutex.
 // If one or more threads are blocking and queued up, MUTEX_FLAG_QUEUED is ORed in as well.
 // NOTE: MUTEX_FLAG_QUEUED is only manipulated under the THREAD_LOCK.
+// holder_cpu is a hint of the cpu the holder was running on when it took the
+// mutex, used by contending threads to decide whether spinning is worthwhile.
 typedef struct TA_CAP("mutex") mutex {
     uint32_t magic;
+    cpu_num_t holder_cpu;
     uintptr_t val;
     wait_queue_t wait;
 } mutex_t;
@@ -46,6 +49,7 @@ static inline thread_t* mutex_holder(const mutex_t* m) {
 #define MUTEX_INITIAL_VALUE(m)                      \
     {                                               \
         .magic = MUTEX_MAGIC,                       \
+        .holder_cpu = INVALID_CPU,                  \
         .val = 0,                                   \
         .wait = WAIT_QUEUE_INITIAL_VALUE((m).wait), \
     }
@@ -18,8 +18,9 @@
 __BEGIN_CDECLS
 
 struct percpu {
-    // per cpu timer queue
+    // per cpu timer queue, and the root of the search tree that indexes it
     struct list_node timer_queue;
+    struct timer* timer_tree;
 
     // per cpu preemption timer; ZX_TIME_INFINITE means not set
     zx_time_t preempt_timer_deadline;
@@ -30,6 +31,8 @@ struct percpu {
     // per cpu run queue and bitmap to indicate which queues are non empty
     struct list_node run_queue[NUM_PRIORITIES];
     uint32_t run_queue_bitmap;
+    // number of threads across all of the run queues
+    uint32_t run_queue_count;
 
 #if WITH_LOCK_DEP
     // state for runtime lock validation when in irq context
@@ -30,10 +30,29 @@ void sched_migrate(thread_t* t) TA_REQ(thread_lock);
 // pri should be <= MAX_PRIORITY, negative values disable priority inheritance.
 void sched_inherit_priority(thread_t* t, int pri, bool* local_resched) TA_REQ(thread_lock);
 
+// same as sched_inherit_priority(), but for priority inherited through user futexes.
+void sched_inherit_futex_priority(thread_t* t, int pri, bool* local_resched) TA_REQ(thread_lock);
+
+// same as sched_inherit_priority(), but for priority inherited through channel calls.
+void sched_inherit_call_priority(thread_t* t, int pri, bool* local_resched) TA_REQ(thread_lock);
+
+// the priority a thread passes on to a thread it waits for: its effective
+// priority without the lift from a cpu reservation, which stays its own.
+int sched_lendable_priority(const thread_t* t) TA_REQ(thread_lock);
+
 // set the priority of a thread and reset the boost value. This function might reschedule.
 // pri should be 0 <= to <= MAX_PRIORITY.
 void sched_change_priority(thread_t* t, int pri) TA_REQ(thread_lock);
 
+// set the weight and cpu reservation of a thread. a |period| of zero removes any
+// reservation. returns ZX_ERR_NO_RESOURCES if the reservation would overcommit the cpus.
+// This function might reschedule.
+zx_status_t sched_set_bandwidth(thread_t* t, uint32_t weight, zx_duration_t capacity,
+                                zx_duration_t period) TA_REQ(thread_lock);
+
+// give back the cpu reservation of a thread that is exiting
+void sched_release_bandwidth(thread_t* t) TA_REQ(thread_lock);
+
 // return true if the thread was placed on the current cpu's run queue
 // this usually means the caller should locally reschedule soon
 bool sched_unblock(thread_t* t) __WARN_UNUSED_RESULT TA_REQ(thread_lock);
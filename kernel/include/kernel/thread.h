@@ -13,6 +13,7 @@
 #include <debug.h>
 #include <kernel/cpu.h>
 #include <kernel/spinlock.h>
+#include <kernel/timer.h>
 #include <kernel/wait.h>
 #include <list.h>
 #include <sys/types.h>
@@ -110,12 +111,39 @@ typedef struct thread {
     // priority_boost is a signed value that is moved around within a range by the scheduler.
     // inherited_priority is temporarily set to >0 when inheriting a priority from another
     // thread blocked on a locking primitive this thread holds. -1 means no inherit.
-    // effective_priority is MAX(base_priority + priority boost, inherited_priority) and is
-    // the working priority for run queue decisions.
+    // futex_inherited_priority is the same, but inherited from user threads blocked on a
+    // futex this thread owns. It is tracked apart from inherited_priority so that releasing
+    // kernel mutexes doesn't drop it.
+    // call_inherited_priority is the same again, but inherited from a user thread blocked in
+    // a channel call this thread is serving.
+    // effective_priority is MAX(base_priority + priority boost, inherited_priority,
+    // futex_inherited_priority, call_inherited_priority) and is the working priority for
+    // run queue decisions.
     int effec_priority;
     int base_priority;
     int priority_boost;
     int inherited_priority;
+    int futex_inherited_priority;
+    int call_inherited_priority;
+
+    // FutexNodes of the user threads whose priority makes up futex_inherited_priority.
+    // Guarded by thread_lock.
+    struct list_node futex_lenders;
+
+    // cpu bandwidth, managed by the scheduler.
+    // sched_weight scales the thread's time slice relative to ZX_SCHED_WEIGHT_DEFAULT.
+    // If reserve_period is nonzero, the thread runs at RESERVED_PRIORITY or above until
+    // it has used reserve_capacity in the period ending at reserve_deadline, and then
+    // reserve_timer starts the next period at reserve_deadline.
+    // reserve_runtime_ns is the total running time charged against the reservation.
+    uint32_t sched_weight;
+    zx_duration_t reserve_capacity;
+    zx_duration_t reserve_period;
+    zx_duration_t reserve_remaining;
+    zx_time_t reserve_deadline;
+    zx_time_t reserve_charged_at;
+    zx_duration_t reserve_runtime_ns;
+    timer_t reserve_timer;
 
     // current cpu the thread is either running on or in the ready queue, undefined otherwise
     cpu_num_t curr_cpu;
@@ -231,6 +259,8 @@ typedef struct thread {
 #define LOW_PRIORITY (NUM_PRIORITIES / 4)
 #define DEFAULT_PRIORITY (NUM_PRIORITIES / 2)
 #define HIGH_PRIORITY ((NUM_PRIORITIES / 4) * 3)
+// threads with cpu bandwidth left in their reservation run at least at this priority
+#define RESERVED_PRIORITY HIGH_PRIORITY
 
 // stack size
 #ifdef CUSTOM_DEFAULT_STACK_SIZE
@@ -248,6 +278,8 @@ void thread_construct_first(thread_t* t, const char* name);
 thread_t* thread_create_idle_thread(uint cpu_num);
 void thread_set_name(const char* name);
 void thread_set_priority(thread_t* t, int priority);
+zx_status_t thread_set_bandwidth(thread_t* t, uint32_t weight, zx_duration_t capacity,
+                                 zx_duration_t period);
 void thread_set_user_callback(thread_t* t, thread_user_callback_t cb);
 thread_t* thread_create(const char* name, thread_start_routine entry, void* arg, int priority, size_t stack_size);
 thread_t* thread_create_etc(thread_t* t, const char* name, thread_start_routine entry, void* arg, int priority, void* stack, void* unsafe_stack, size_t stack_size, thread_trampoline_routine alt_trampoline);
@@ -311,6 +343,10 @@ zx_status_t thread_sleep_relative(zx_duration_t delay);
 // return the number of nanoseconds a thread has been running for
 zx_duration_t thread_runtime(const thread_t* t);
 
+// return the number of nanoseconds of running time charged against the thread's cpu
+// reservation, as of the last time it was rescheduled
+zx_duration_t thread_reserved_runtime(const thread_t* t);
+
 // deliver a kill signal to a thread
 void thread_kill(thread_t* t);
 
@@ -32,6 +32,13 @@ typedef struct timer {
     int magic;
     struct list_node node;
 
+    // Links in the search tree over queue_cpu's timer queue, which holds the
+    // same timers in the same order as the queue.
+    struct timer* tree_parent;
+    struct timer* tree_left;
+    struct timer* tree_right;
+    int queue_cpu;
+
     zx_time_t scheduled_time;
     zx_duration_t slack; // Stores the applied slack adjustment from
                          // the ideal scheduled_time.
@@ -46,6 +53,10 @@ typedef struct timer {
     {                                       \
         .magic = TIMER_MAGIC,               \
         .node = LIST_INITIAL_CLEARED_VALUE, \
+        .tree_parent = NULL,                \
+        .tree_left = NULL,                  \
+        .tree_right = NULL,                 \
+        .queue_cpu = -1,                    \
         .scheduled_time = 0,                \
         .slack = 0,                         \
         .callback = NULL,                   \
@@ -95,5 +95,10 @@ static inline zx_status_t ktrace_control(uint32_t action, uint32_t options, void
 
 void ktrace_report_live_threads(void);
 void ktrace_report_live_processes(void);
+#if WITH_LOCK_DEP
+void ktrace_report_lock_classes(void);
+#else
+static inline void ktrace_report_lock_classes(void) {}
+#endif
 
 __END_CDECLS
@@ -38,6 +38,12 @@ zx_ticks_t ticks_per_second(void);
 /* high-precision timer current_ticks */
 zx_ticks_t current_ticks(void);
 
+/* if current_time() is the tick counter that user mode reads in zx_ticks_get()
+ * scaled by a constant factor, fills in |ns_per_tick| and returns true. The vDSO
+ * then computes the monotonic clock without entering the kernel. */
+struct fp_32_64;
+bool platform_usermode_ticks_to_nanos(struct fp_32_64* ns_per_tick);
+
 /* super early platform initialization, before almost everything */
 void platform_early_init(void);
 
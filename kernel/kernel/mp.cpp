@@ -400,6 +400,35 @@ void mp_set_curr_cpu_online(bool online) {
     }
 }
 
+void mp_set_cpu_topology(cpu_num_t cpu, uint32_t cache_domain, uint32_t core) {
+    DEBUG_ASSERT(cpu < SMP_MAX_CPUS);
+
+    // the topology ids of the cpus reported so far
+    static cpu_mask_t known_cpus;
+    static uint32_t cache_domains[SMP_MAX_CPUS];
+    static uint32_t cores[SMP_MAX_CPUS];
+
+    cache_domains[cpu] = cache_domain;
+    cores[cpu] = core;
+    known_cpus |= cpu_num_to_mask(cpu);
+
+    const cpu_mask_t cpu_mask = cpu_num_to_mask(cpu);
+    for (cpu_num_t i = 0; i < SMP_MAX_CPUS; i++) {
+        if (i == cpu || !(known_cpus & cpu_num_to_mask(i)) || cache_domains[i] != cache_domain)
+            continue;
+
+        mp.cache_siblings[cpu] |= cpu_num_to_mask(i);
+        mp.cache_siblings[i] |= cpu_mask;
+        if (cores[i] == core) {
+            mp.smt_siblings[cpu] |= cpu_num_to_mask(i);
+            mp.smt_siblings[i] |= cpu_mask;
+        }
+    }
+
+    LTRACEF("cpu %u: cache domain %u core %u, cache siblings %#x smt siblings %#x\n",
+            cpu, cache_domain, core, mp.cache_siblings[cpu], mp.smt_siblings[cpu]);
+}
+
 void mp_set_curr_cpu_active(bool active) {
     if (active) {
         atomic_or((volatile int*)&mp.active_cpus, cpu_num_to_mask(arch_curr_cpu_num()));
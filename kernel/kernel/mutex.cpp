@@ -16,6 +16,7 @@
 
 #include <kernel/mutex.h>
 
+#include <arch/ops.h>
 #include <assert.h>
 #include <debug.h>
 #include <err.h>
@@ -23,12 +24,23 @@
 #include <kernel/sched.h>
 #include <kernel/thread.h>
 #include <kernel/thread_lock.h>
+#include <lib/counters.h>
 #include <lib/ktrace.h>
+#include <platform.h>
 #include <trace.h>
+#include <zircon/time.h>
 #include <zircon/types.h>
 
 #define LOCAL_TRACE 0
 
+// Upper bound on how long a contending thread spins waiting for a holder
+// running on another cpu before giving up and blocking.
+#define MUTEX_SPIN_MAX_DURATION ZX_USEC(20)
+
+KCOUNTER(mutex_contended_count, "kernel.mutex.contended");
+KCOUNTER(mutex_spin_acquired_count, "kernel.mutex.spin_acquired");
+KCOUNTER(mutex_blocked_count, "kernel.mutex.blocked");
+
 /**
  * @brief  Initialize a mutex_t
  */
@@ -60,6 +72,62 @@ void mutex_destroy(mutex_t* m) {
     wait_queue_destroy(&m->wait);
 }
 
+// try once to take an unheld mutex, recording the cpu we took it on
+static inline bool mutex_try_acquire(mutex_t* m, thread_t* ct) {
+    uintptr_t oldval = 0;
+    if (likely(atomic_cmpxchg_u64(&m->val, &oldval, (uintptr_t)ct))) {
+        atomic_store_relaxed_u32(&m->holder_cpu, arch_curr_cpu_num());
+        ct->mutexes_held++;
+        return true;
+    }
+    return false;
+}
+
+// Spin while the holder is running on another cpu, on the theory that it
+// will drop the mutex sooner than a block/wake cycle would take. Gives up
+// when the holder changes hands, stops running, a waiter has already queued,
+// or the time budget runs out.
+static bool mutex_spin_acquire(mutex_t* m, thread_t* ct) {
+    const uintptr_t holder = mutex_val(m);
+    if (holder == 0 || (holder & MUTEX_FLAG_QUEUED)) {
+        return false;
+    }
+    const volatile thread_t* holder_thread = reinterpret_cast<const thread_t*>(holder);
+
+    const zx_time_t deadline = zx_time_add_duration(current_time(), MUTEX_SPIN_MAX_DURATION);
+    for (;;) {
+        // holder_cpu is only a hint, and may be stale or belong to a
+        // previous holder; re-read it each time around.
+        const cpu_num_t holder_cpu = atomic_load_u32(&m->holder_cpu);
+        if (holder_cpu == arch_curr_cpu_num() || holder_cpu >= SMP_MAX_CPUS) {
+            return false;
+        }
+
+        // The holder's state is read without the thread lock, so it is only
+        // a hint too. A busy cpu may be running some other thread while the
+        // holder is blocked or preempted, and then spinning only wastes time.
+        // If the holder has since released the mutex and exited, the read
+        // still lands in the heap's physmap pages, and the check of the
+        // mutex below sees the change.
+        if (holder_thread->state != THREAD_RUNNING || holder_thread->curr_cpu != holder_cpu) {
+            return false;
+        }
+
+        arch_spinloop_pause();
+
+        const uintptr_t val = mutex_val(m);
+        if (val == 0) {
+            if (mutex_try_acquire(m, ct)) {
+                return true;
+            }
+            continue;
+        }
+        if (val != holder || current_time() >= deadline) {
+            return false;
+        }
+    }
+}
+
 /**
  * @brief  Acquire the mutex
  */
@@ -70,12 +138,8 @@ void mutex_acquire(mutex_t* m) TA_NO_THREAD_SAFETY_ANALYSIS {
     thread_t* ct = get_current_thread();
     uintptr_t oldval;
 
-retry:
     // fast path: assume its unheld, try to grab it
-    oldval = 0;
-    if (likely(atomic_cmpxchg_u64(&m->val, &oldval, (uintptr_t)ct))) {
-        // acquired it cleanly
-        ct->mutexes_held++;
+    if (likely(mutex_try_acquire(m, ct))) {
         return;
     }
 
@@ -85,6 +149,19 @@ retry:
               ct, ct->name, m);
 #endif
 
+    kcounter_add(mutex_contended_count, 1);
+
+    // the holder may be about to release it from another cpu
+    if (mutex_spin_acquire(m, ct)) {
+        kcounter_add(mutex_spin_acquired_count, 1);
+        return;
+    }
+
+retry:
+    if (mutex_try_acquire(m, ct)) {
+        return;
+    }
+
     {
         // we contended with someone else, will probably need to block
         Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
@@ -101,6 +178,8 @@ retry:
             goto retry;
         }
 
+        kcounter_add(mutex_blocked_count, 1);
+
         // have the holder inherit our priority
         // discard the local reschedule flag because we're just about to block anyway
         bool unused;
@@ -119,6 +198,7 @@ retry:
         DEBUG_ASSERT(ct == mutex_holder(m));
 
         // record that we hold it
+        atomic_store_relaxed_u32(&m->holder_cpu, arch_curr_cpu_num());
         ct->mutexes_held++;
     }
 }
@@ -12,15 +12,20 @@
 #include <inttypes.h>
 #include <kernel/mp.h>
 #include <kernel/percpu.h>
+#include <kernel/cmdline.h>
 #include <kernel/thread.h>
+#include <kernel/timer.h>
+#include <lib/counters.h>
 #include <lib/ktrace.h>
 #include <list.h>
+#include <lk/init.h>
 #include <platform.h>
 #include <printf.h>
 #include <string.h>
 #include <target.h>
 #include <trace.h>
 #include <vm/vm.h>
+#include <zircon/syscalls/profile.h>
 #include <zircon/time.h>
 #include <zircon/types.h>
 
@@ -53,19 +58,53 @@
 // threads get 10ms to run before they use up their time slice and the scheduler is invoked
 #define THREAD_INITIAL_TIME_SLICE ZX_MSEC(10)
 
+// cpu reservations may add up to at most this share of each active cpu, in parts per million
+#define MAX_RESERVED_PPM_PER_CPU 800000
+
+KCOUNTER(sched_steal_count, "kernel.sched.steal");
+KCOUNTER(sched_push_count, "kernel.sched.push");
+KCOUNTER(sched_throttle_count, "kernel.sched.throttle");
+
+// move queued threads between cpus to keep them busy; see sched_steal_init()
+static bool work_stealing = true;
+
+// sum of the cpu reservations of all threads, in parts per million of a cpu
+static uint64_t reserved_ppm;
+
 static bool local_migrate_if_needed(thread_t* curr_thread);
+static void sched_priority_changed(thread_t* t, int old_prio,
+                                   bool* local_resched,
+                                   cpu_mask_t* accum_cpu_mask) TA_REQ(thread_lock);
 
-// compute the effective priority of a thread
-static void compute_effec_priority(thread_t* t) {
+// the effective priority of a thread before any reservation lift
+static int lendable_priority(const thread_t* t) {
     int ep = t->base_priority + t->priority_boost;
     if (t->inherited_priority > ep)
         ep = t->inherited_priority;
+    if (t->futex_inherited_priority > ep)
+        ep = t->futex_inherited_priority;
+    if (t->call_inherited_priority > ep)
+        ep = t->call_inherited_priority;
+    return ep;
+}
+
+// compute the effective priority of a thread
+static void compute_effec_priority(thread_t* t) {
+    int ep = lendable_priority(t);
+
+    // threads with time left in their reservation run ahead of unreserved threads
+    if (t->reserve_remaining > 0 && ep < RESERVED_PRIORITY)
+        ep = RESERVED_PRIORITY;
 
     DEBUG_ASSERT(ep >= LOWEST_PRIORITY && ep <= HIGHEST_PRIORITY);
 
     t->effec_priority = ep;
 }
 
+int sched_lendable_priority(const thread_t* t) {
+    return lendable_priority(t);
+}
+
 // boost the priority of the thread by +1
 static void boost_thread(thread_t* t) {
     if (NO_BOOST)
@@ -114,6 +153,22 @@ static void deboost_thread(thread_t* t, bool quantum_expiration) {
     compute_effec_priority(t);
 }
 
+// the length of a full time slice for the thread, scaled by its weight
+static zx_duration_t time_slice(const thread_t* t) {
+    return THREAD_INITIAL_TIME_SLICE * t->sched_weight / ZX_SCHED_WEIGHT_DEFAULT;
+}
+
+// the time at which the running thread should next be preempted: the end of its time slice,
+// or sooner if it will run out of reserved time first
+static zx_time_t preempt_deadline(const thread_t* t) {
+    zx_time_t deadline = zx_time_add_duration(t->last_started_running, t->remaining_time_slice);
+    if (t->reserve_remaining > 0) {
+        zx_time_t exhausted = zx_time_add_duration(t->reserve_charged_at, t->reserve_remaining);
+        deadline = MIN(deadline, exhausted);
+    }
+    return deadline;
+}
+
 // pick a 'random' cpu out of the passed in mask of cpus
 static cpu_mask_t rand_cpu(cpu_mask_t mask) {
     if (unlikely(mask == 0))
@@ -141,6 +196,42 @@ static cpu_mask_t rand_cpu(cpu_mask_t mask) {
     }
 }
 
+// the cpus in |idle_mask| whose physical core has no busy SMT siblings
+static cpu_mask_t idle_cores(cpu_mask_t idle_mask) {
+    cpu_mask_t cores = 0;
+    for (cpu_mask_t mask = idle_mask; mask != 0; mask &= mask - 1) {
+        cpu_num_t cpu = lowest_cpu_set(mask);
+        if ((mp_get_smt_siblings(cpu) & ~idle_mask) == 0)
+            cores |= cpu_num_to_mask(cpu);
+    }
+    return cores;
+}
+
+// narrow down the idle cpus in |affinity| a thread could be woken up on. in order, prefer a
+// whole idle core sharing a cache with the waker, then with the cpu the thread last ran on, then
+// an idle SMT sibling sharing a cache with the waker, then a whole idle core anywhere.
+// |idle_mask| is every idle cpu, not just those in |affinity|: a core is only idle if all of its
+// SMT siblings are, whether or not the thread may run on them.
+static cpu_mask_t pick_idle_cpus(cpu_mask_t idle_mask, cpu_mask_t affinity, cpu_num_t last_cpu) {
+    const cpu_mask_t cores = idle_cores(idle_mask) & affinity;
+    idle_mask &= affinity;
+    const cpu_mask_t waker_cache = mp_get_cache_siblings(arch_curr_cpu_num());
+    const cpu_mask_t last_cache =
+        is_valid_cpu_num(last_cpu) ? mp_get_cache_siblings(last_cpu) : 0;
+
+    const cpu_mask_t preferences[] = {
+        cores & waker_cache,
+        cores & last_cache,
+        idle_mask & waker_cache,
+        cores,
+    };
+    for (cpu_mask_t mask : preferences) {
+        if (mask != 0)
+            return mask;
+    }
+    return idle_mask;
+}
+
 // find a cpu to wake up
 static cpu_mask_t find_cpu_mask(thread_t* t) {
     // get the last cpu the thread ran on
@@ -156,9 +247,9 @@ static cpu_mask_t find_cpu_mask(thread_t* t) {
                   last_ran_cpu_mask, curr_cpu_mask, cpu_affinity, t->name);
 
     // get a list of idle cpus and mask off the ones that aren't in our affinity mask
-    cpu_mask_t idle_cpu_mask = mp_get_idle_mask();
+    const cpu_mask_t all_idle_cpu_mask = mp_get_idle_mask();
     cpu_mask_t active_cpu_mask = mp_get_active_mask();
-    idle_cpu_mask &= cpu_affinity;
+    cpu_mask_t idle_cpu_mask = all_idle_cpu_mask & cpu_affinity;
     if (idle_cpu_mask != 0) {
         if (idle_cpu_mask & curr_cpu_mask) {
             // the current cpu is idle and within our affinity mask, so run it here
@@ -173,7 +264,7 @@ static cpu_mask_t find_cpu_mask(thread_t* t) {
 
         // pick an idle_cpu
         DEBUG_ASSERT((idle_cpu_mask & mp_get_active_mask()) == idle_cpu_mask);
-        return rand_cpu(idle_cpu_mask);
+        return rand_cpu(pick_idle_cpus(all_idle_cpu_mask, cpu_affinity, t->last_cpu));
     }
 
     // no idle cpus in our affinity mask
@@ -205,6 +296,7 @@ static void insert_in_run_queue_head(cpu_num_t cpu, thread_t* t) {
 
     list_add_head(&percpu[cpu].run_queue[t->effec_priority], &t->queue_node);
     percpu[cpu].run_queue_bitmap |= (1u << t->effec_priority);
+    percpu[cpu].run_queue_count++;
 
     // mark the cpu as busy since the run queue now has at least one item in it
     mp_set_cpu_busy(cpu);
@@ -215,6 +307,7 @@ static void insert_in_run_queue_tail(cpu_num_t cpu, thread_t* t) {
 
     list_add_tail(&percpu[cpu].run_queue[t->effec_priority], &t->queue_node);
     percpu[cpu].run_queue_bitmap |= (1u << t->effec_priority);
+    percpu[cpu].run_queue_count++;
 
     // mark the cpu as busy since the run queue now has at least one item in it
     mp_set_cpu_busy(cpu);
@@ -232,6 +325,7 @@ static void remove_from_run_queue(thread_t* t, int prio_queue) {
     if (list_is_empty(&c->run_queue[prio_queue])) {
         c->run_queue_bitmap &= ~(1u << prio_queue);
     }
+    c->run_queue_count--;
 }
 
 // using the per cpu run queue bitmap, find the highest populated queue
@@ -258,6 +352,7 @@ static thread_t* sched_get_top_thread(cpu_num_t cpu) {
 
         if (list_is_empty(&c->run_queue[highest_queue]))
             c->run_queue_bitmap &= ~(1u << highest_queue);
+        c->run_queue_count--;
 
         LOCAL_KTRACE2("sched_get_top", newthread->priority_boost, newthread->base_priority);
 
@@ -268,10 +363,117 @@ static thread_t* sched_get_top_thread(cpu_num_t cpu) {
     return &c->idle_thread;
 }
 
+// find the highest priority thread queued up on |cpu|, other than the current thread, that
+// is allowed to run on one of the cpus in |mask|
+static thread_t* find_movable_thread(cpu_num_t cpu, cpu_mask_t mask) TA_REQ(thread_lock) {
+    const struct percpu* c = &percpu[cpu];
+    thread_t* current_thread = get_current_thread();
+
+    for (int prio = HIGHEST_PRIORITY; prio >= LOWEST_PRIORITY; prio--) {
+        if ((c->run_queue_bitmap & (1u << prio)) == 0)
+            continue;
+
+        thread_t* t;
+        list_for_every_entry (&c->run_queue[prio], t, thread_t, queue_node) {
+            if (t != current_thread && !thread_is_idle(t) && (t->cpu_affinity & mask))
+                return t;
+        }
+    }
+    return NULL;
+}
+
+// move a thread from the run queue it's in to the run queue of |cpu|
+static void move_queued_thread(thread_t* t, cpu_num_t cpu) TA_REQ(thread_lock) {
+    DEBUG_ASSERT(t->cpu_affinity & cpu_num_to_mask(cpu));
+
+    remove_from_run_queue(t, t->effec_priority);
+    t->curr_cpu = cpu;
+    if (t->remaining_time_slice > 0) {
+        insert_in_run_queue_head(cpu, t);
+    } else {
+        insert_in_run_queue_tail(cpu, t);
+    }
+}
+
+// called when |cpu| has nothing left to run: take the highest priority thread that can run
+// here from whichever other cpu has the most threads waiting, preferring cpus that share
+// a cache with this one.
+static void steal_thread(cpu_num_t cpu) TA_REQ(thread_lock) {
+    if (!work_stealing)
+        return;
+
+    const cpu_mask_t cpu_mask = cpu_num_to_mask(cpu);
+    const cpu_mask_t active_mask = mp_get_active_mask();
+    if ((active_mask & cpu_mask) == 0)
+        return;
+
+    // look for work on the cpus sharing our cache before going further afield
+    const cpu_mask_t cache_mask = mp_get_cache_siblings(cpu);
+    const cpu_mask_t victims[] = {
+        active_mask & cache_mask & ~cpu_mask,
+        active_mask & ~cache_mask,
+    };
+
+    thread_t* t = NULL;
+    for (cpu_mask_t victim_mask : victims) {
+        uint32_t busiest_count = 0;
+        for (cpu_mask_t mask = victim_mask; mask != 0; mask &= mask - 1) {
+            cpu_num_t i = lowest_cpu_set(mask);
+            if (percpu[i].run_queue_count <= busiest_count)
+                continue;
+
+            thread_t* candidate = find_movable_thread(i, cpu_mask);
+            if (candidate) {
+                t = candidate;
+                busiest_count = percpu[i].run_queue_count;
+            }
+        }
+        if (t)
+            break;
+    }
+
+    if (t) {
+        LOCAL_KTRACE2("sched_steal", (uint32_t)t->user_tid, t->curr_cpu);
+        move_queued_thread(t, cpu);
+        kcounter_add(sched_steal_count, 1);
+    }
+}
+
+// called periodically on a busy |cpu|: if there are threads waiting here that an idle cpu
+// could be running, hand the highest priority one over and wake that cpu up.
+static void push_thread(cpu_num_t cpu) TA_REQ(thread_lock) {
+    if (!work_stealing || percpu[cpu].run_queue_count < 2)
+        return;
+
+    cpu_mask_t idle_mask = mp_get_idle_mask() & mp_get_active_mask() & ~cpu_num_to_mask(cpu);
+    if (idle_mask == 0)
+        return;
+
+    thread_t* t = find_movable_thread(cpu, idle_mask);
+    if (!t)
+        return;
+
+    cpu_mask_t target_mask = t->cpu_affinity & idle_mask;
+    if (target_mask & cpu_num_to_mask(t->last_cpu)) {
+        target_mask = cpu_num_to_mask(t->last_cpu);
+    } else {
+        target_mask = pick_idle_cpus(idle_mask, t->cpu_affinity, t->last_cpu);
+    }
+    cpu_num_t target = lowest_cpu_set(target_mask);
+
+    LOCAL_KTRACE2("sched_push", (uint32_t)t->user_tid, target);
+    move_queued_thread(t, target);
+    kcounter_add(sched_push_count, 1);
+    mp_reschedule(cpu_num_to_mask(target), 0);
+}
+
 void sched_init_thread(thread_t* t, int priority) {
     t->base_priority = priority;
     t->priority_boost = 0;
     t->inherited_priority = -1;
+    t->futex_inherited_priority = -1;
+    t->call_inherited_priority = -1;
+    t->sched_weight = ZX_SCHED_WEIGHT_DEFAULT;
     compute_effec_priority(t);
 }
 
@@ -427,6 +629,10 @@ void sched_preempt(void) {
             insert_in_run_queue_head(curr_cpu, current_thread);
         } else {
             insert_in_run_queue_tail(curr_cpu, current_thread);
+
+            // a full quantum went by on this cpu, so see whether another cpu has
+            // gone idle while threads are waiting here
+            push_thread(curr_cpu);
         }
     }
 
@@ -640,18 +846,17 @@ static void sched_priority_changed(thread_t* t, int old_prio,
 
 // set the priority to the higher value of what it was before and the newly inherited value
 // pri < 0 disables priority inheritance and goes back to the naturally computed values
-void sched_inherit_priority(thread_t* t, int pri, bool* local_resched) {
-    DEBUG_ASSERT(spin_lock_held(&thread_lock));
-
+static void inherit_priority(thread_t* t, int* inherited, int pri, bool* local_resched)
+    TA_REQ(thread_lock) {
     if (pri > HIGHEST_PRIORITY)
         pri = HIGHEST_PRIORITY;
 
     // if we're setting it to something real and it's less than the current, skip
-    if (pri >= 0 && pri <= t->inherited_priority)
+    if (pri >= 0 && pri <= *inherited)
         return;
 
     // adjust the priority and remember the old value
-    t->inherited_priority = pri;
+    *inherited = pri;
     int old_ep = t->effec_priority;
     compute_effec_priority(t);
     if (old_ep == t->effec_priority) {
@@ -669,6 +874,24 @@ void sched_inherit_priority(thread_t* t, int pri, bool* local_resched) {
     }
 }
 
+void sched_inherit_priority(thread_t* t, int pri, bool* local_resched) {
+    DEBUG_ASSERT(spin_lock_held(&thread_lock));
+
+    inherit_priority(t, &t->inherited_priority, pri, local_resched);
+}
+
+void sched_inherit_futex_priority(thread_t* t, int pri, bool* local_resched) {
+    DEBUG_ASSERT(spin_lock_held(&thread_lock));
+
+    inherit_priority(t, &t->futex_inherited_priority, pri, local_resched);
+}
+
+void sched_inherit_call_priority(thread_t* t, int pri, bool* local_resched) {
+    DEBUG_ASSERT(spin_lock_held(&thread_lock));
+
+    inherit_priority(t, &t->call_inherited_priority, pri, local_resched);
+}
+
 // changes the thread's base priority and if the re-computed effective priority changed
 //  then the thread is moved to the proper queue on the same processor and a re-schedule
 //  might be issued.
@@ -706,6 +929,143 @@ void sched_change_priority(thread_t* t, int pri) {
     }
 }
 
+// share of a cpu a reservation takes up, in parts per million, rounded up
+static uint64_t reservation_ppm(zx_duration_t capacity, zx_duration_t period) {
+    if (period == 0)
+        return 0;
+    return (static_cast<uint64_t>(capacity) * 1000000 + period - 1) / period;
+}
+
+// the effective priority of a thread may have changed along with its reservation, move it
+// between queues as needed
+static void reservation_changed(thread_t* t, bool* local_resched,
+                                cpu_mask_t* accum_cpu_mask) TA_REQ(thread_lock) {
+    int old_ep = t->effec_priority;
+    compute_effec_priority(t);
+    if (old_ep != t->effec_priority)
+        sched_priority_changed(t, old_ep, local_resched, accum_cpu_mask);
+}
+
+// start a new period for a reserved thread if its current one is over. periods that went
+// by entirely while the thread wasn't running are skipped.
+static void replenish_reservation(thread_t* t, zx_time_t now) TA_REQ(thread_lock) {
+    if (t->reserve_period == 0 || now < t->reserve_deadline)
+        return;
+
+    // a throttled thread's reserve_timer is still set for this deadline
+    if (t->reserve_remaining == 0)
+        timer_cancel(&t->reserve_timer);
+
+    zx_duration_t late = zx_time_sub_time(now, t->reserve_deadline);
+    t->reserve_deadline = zx_time_add_duration(now, t->reserve_period - late % t->reserve_period);
+    t->reserve_remaining = t->reserve_capacity;
+}
+
+// start the next period of a throttled thread when it begins, whether or not any cpu
+// happens to reschedule then, so a thread blocked or queued at its normal priority gets
+// its reserved priority back on time.
+static void reserve_timer_handler(timer_t* timer, zx_time_t now, void* arg) {
+    thread_t* t = static_cast<thread_t*>(arg);
+
+    DEBUG_ASSERT(t->magic == THREAD_MAGIC);
+
+    // the thread lock holder may be canceling this timer, see thread_sleep_handler()
+    if (timer_trylock_or_cancel(timer, &thread_lock))
+        return;
+
+    bool local_resched = false;
+    cpu_mask_t accum_cpu_mask = 0;
+    replenish_reservation(t, now);
+    reservation_changed(t, &local_resched, &accum_cpu_mask);
+
+    accum_cpu_mask &= ~cpu_num_to_mask(arch_curr_cpu_num());
+    if (accum_cpu_mask) {
+        mp_reschedule(accum_cpu_mask, 0);
+    }
+    if (local_resched) {
+        sched_reschedule();
+    }
+
+    spin_unlock(&thread_lock);
+}
+
+// charge the time the current thread ran since it was last charged to its reservation
+static void update_reservations(thread_t* current_thread, zx_time_t now) TA_REQ(thread_lock) {
+    if (current_thread->reserve_period == 0)
+        return;
+
+    zx_duration_t delta = zx_time_sub_time(now, current_thread->reserve_charged_at);
+    current_thread->reserve_charged_at = now;
+    if (current_thread->reserve_remaining > 0) {
+        delta = MIN(delta, current_thread->reserve_remaining);
+        current_thread->reserve_remaining -= delta;
+        current_thread->reserve_runtime_ns =
+            zx_duration_add_duration(current_thread->reserve_runtime_ns, delta);
+        if (current_thread->reserve_remaining == 0) {
+            timer_set(&current_thread->reserve_timer, current_thread->reserve_deadline,
+                      TIMER_SLACK_CENTER, 0, reserve_timer_handler, current_thread);
+            kcounter_add(sched_throttle_count, 1);
+        }
+    }
+    replenish_reservation(current_thread, now);
+
+    // we're about to pick the next thread anyway, so local_resched doesn't matter, and
+    // the current thread isn't in any other cpu's run queue
+    bool local_resched = false;
+    cpu_mask_t accum_cpu_mask = 0;
+    reservation_changed(current_thread, &local_resched, &accum_cpu_mask);
+}
+
+zx_status_t sched_set_bandwidth(thread_t* t, uint32_t weight, zx_duration_t capacity,
+                                zx_duration_t period) {
+    DEBUG_ASSERT(spin_lock_held(&thread_lock));
+    DEBUG_ASSERT(weight >= ZX_SCHED_WEIGHT_MIN && weight <= ZX_SCHED_WEIGHT_MAX);
+    DEBUG_ASSERT(period == 0 ? capacity == 0 : (capacity > 0 && capacity <= period));
+
+    // admission control: don't promise more cpu time than there is to go around
+    uint64_t old_ppm = reservation_ppm(t->reserve_capacity, t->reserve_period);
+    uint64_t new_ppm = reservation_ppm(capacity, period);
+    uint64_t limit = MAX_RESERVED_PPM_PER_CPU *
+                     static_cast<uint64_t>(__builtin_popcount(mp_get_active_mask()));
+    if (new_ppm > old_ppm && reserved_ppm - old_ppm + new_ppm > limit)
+        return ZX_ERR_NO_RESOURCES;
+    reserved_ppm = reserved_ppm - old_ppm + new_ppm;
+
+    LOCAL_KTRACE2("sched_set_bandwidth", weight, (uint32_t)new_ppm);
+
+    timer_cancel(&t->reserve_timer);
+
+    zx_time_t now = current_time();
+    t->sched_weight = weight;
+    t->reserve_capacity = capacity;
+    t->reserve_period = period;
+    t->reserve_remaining = capacity;
+    t->reserve_deadline = zx_time_add_duration(now, period);
+    t->reserve_charged_at = now;
+
+    bool local_resched = false;
+    cpu_mask_t accum_cpu_mask = 0;
+    reservation_changed(t, &local_resched, &accum_cpu_mask);
+
+    if (accum_cpu_mask) {
+        mp_reschedule(accum_cpu_mask, 0);
+    }
+    if (local_resched) {
+        sched_reschedule();
+    }
+    return ZX_OK;
+}
+
+void sched_release_bandwidth(thread_t* t) {
+    DEBUG_ASSERT(spin_lock_held(&thread_lock));
+
+    reserved_ppm -= reservation_ppm(t->reserve_capacity, t->reserve_period);
+    timer_cancel(&t->reserve_timer);
+    t->reserve_capacity = 0;
+    t->reserve_period = 0;
+    t->reserve_remaining = 0;
+}
+
 // preemption timer that is set whenever a thread is scheduled
 void sched_preempt_timer_tick(zx_time_t now) {
     // if the preemption timer went off on the idle or a real time thread, ignore it
@@ -724,12 +1084,19 @@ void sched_preempt_timer_tick(zx_time_t now) {
         current_thread->remaining_time_slice = 0;
 
         // set a timer to go off on the time slice interval from now
-        timer_preempt_reset(zx_time_add_duration(now, THREAD_INITIAL_TIME_SLICE));
+        timer_preempt_reset(zx_time_add_duration(now, time_slice(current_thread)));
 
         // Mark a reschedule as pending.  The irq handler will call back
         // into us with sched_preempt().
         thread_preempt_set_pending();
     } else {
+        // if the thread ran out of reserved time, let the scheduler lower its priority
+        if (current_thread->reserve_remaining > 0 &&
+            zx_time_sub_time(now, current_thread->reserve_charged_at) >=
+                current_thread->reserve_remaining) {
+            thread_preempt_set_pending();
+        }
+
         // the timer tick must have fired early, reschedule and continue
         zx_time_t deadline = zx_time_add_duration(current_thread->last_started_running,
                                                   current_thread->remaining_time_slice);
@@ -761,6 +1128,15 @@ void sched_resched_internal(void) {
 
     CPU_STATS_INC(reschedules);
 
+    zx_time_t now = current_time();
+
+    // reservations running out or being refilled can change which thread runs next
+    update_reservations(current_thread, now);
+
+    // if there's nothing left to run here, look for work waiting on another cpu
+    if (percpu[cpu].run_queue_bitmap == 0)
+        steal_thread(cpu);
+
     // pick a new thread to run
     thread_t* newthread = sched_get_top_thread(cpu);
 
@@ -779,10 +1155,12 @@ void sched_resched_internal(void) {
     mp_prepare_current_cpu_idle_state(thread_is_idle(newthread));
 
     // if it's the same thread as we're already running, exit
-    if (newthread == oldthread)
+    if (newthread == oldthread) {
+        // its reservation may have been refilled, so make sure it's enforced
+        if (newthread->reserve_remaining > 0 && !thread_is_real_time_or_idle(newthread))
+            timer_preempt_reset(preempt_deadline(newthread));
         return;
-
-    zx_time_t now = current_time();
+    }
 
     // account for time used on the old thread
     DEBUG_ASSERT(now >= oldthread->last_started_running);
@@ -793,10 +1171,11 @@ void sched_resched_internal(void) {
 
     // set up quantum for the new thread if it was consumed
     if (newthread->remaining_time_slice == 0) {
-        newthread->remaining_time_slice = THREAD_INITIAL_TIME_SLICE;
+        newthread->remaining_time_slice = time_slice(newthread);
     }
 
     newthread->last_started_running = now;
+    newthread->reserve_charged_at = now;
 
     // mark the cpu ownership of the threads
     if (oldthread->state != THREAD_READY)
@@ -847,7 +1226,7 @@ void sched_resched_internal(void) {
         // make sure the time slice is reasonable
         DEBUG_ASSERT(newthread->remaining_time_slice > 0 && newthread->remaining_time_slice < ZX_SEC(1));
 
-        timer_preempt_reset(zx_time_add_duration(now, newthread->remaining_time_slice));
+        timer_preempt_reset(preempt_deadline(newthread));
     }
 
     // set some optional target debug leds
@@ -900,3 +1279,10 @@ void sched_init_early(void) {
         for (unsigned int i = 0; i < NUM_PRIORITIES; i++)
             list_initialize(&percpu[cpu].run_queue[i]);
 }
+
+static void sched_steal_init(uint level) {
+    // Be sure to update kernel_cmdline.md if this default changes.
+    work_stealing = cmdline_get_bool("kernel.sched.work-stealing", true);
+}
+
+LK_INIT_HOOK(sched_steal, sched_steal_init, LK_INIT_LEVEL_THREADING);
@@ -84,6 +84,8 @@ static void init_thread_struct(thread_t* t, const char* name) {
     t->magic = THREAD_MAGIC;
     strlcpy(t->name, name, sizeof(t->name));
     wait_queue_init(&t->retcode_wait_queue);
+    list_initialize(&t->futex_lenders);
+    timer_init(&t->reserve_timer);
     init_thread_lock_state(t);
 }
 
@@ -510,6 +512,9 @@ __NO_RETURN static void thread_exit_locked(thread_t* current_thread,
     current_thread->state = THREAD_DEATH;
     current_thread->retcode = retcode;
 
+    // give back any cpu time reserved for us
+    sched_release_bandwidth(current_thread);
+
     // if we're detached, then do our teardown here
     if (current_thread->flags & THREAD_FLAG_DETACHED) {
         // remove it from the master thread list
@@ -552,6 +557,7 @@ void thread_forget(thread_t* t) {
         DEBUG_ASSERT(current_thread != t);
 
         list_delete(&t->thread_list_node);
+        sched_release_bandwidth(t);
     }
 
     DEBUG_ASSERT(!list_in_list(&t->queue_node));
@@ -961,6 +967,12 @@ zx_duration_t thread_runtime(const thread_t* t) {
     return runtime;
 }
 
+zx_duration_t thread_reserved_runtime(const thread_t* t) {
+    Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+
+    return t->reserve_runtime_ns;
+}
+
 /**
  * @brief Construct a thread t around the current running state
  *
@@ -1047,6 +1059,23 @@ void thread_set_priority(thread_t* t, int priority) {
     sched_change_priority(t, priority);
 }
 
+/**
+ * @brief Change the cpu bandwidth of a thread
+ *
+ * Sets the weight that scales the thread's time slice and, if |period| is
+ * nonzero, reserves |capacity| of running time for it in every |period|.
+ *
+ * @return ZX_ERR_NO_RESOURCES if the cpus can't accommodate the reservation.
+ */
+zx_status_t thread_set_bandwidth(thread_t* t, uint32_t weight, zx_duration_t capacity,
+                                 zx_duration_t period) {
+    DEBUG_ASSERT(t->magic == THREAD_MAGIC);
+
+    Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+
+    return sched_set_bandwidth(t, weight, capacity, period);
+}
+
 /**
  * @brief  Become an idle thread
  *
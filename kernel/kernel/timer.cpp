@@ -21,6 +21,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <err.h>
+#include <hash.h>
 #include <inttypes.h>
 #include <kernel/align.h>
 #include <kernel/lockdep.h>
@@ -67,6 +68,114 @@ static void update_platform_timer(uint cpu, zx_time_t new_deadline) {
     }
 }
 
+// Each cpu's timer queue is a list sorted by scheduled_time, indexed by a
+// treap so that timers can be placed in O(log n) rather than by walking the
+// list. The treap is ordered like the list, timers with equal scheduled_time
+// in the order they were queued, and is heap ordered on a priority derived
+// from each timer's address.
+
+static uint64_t tree_priority(const timer_t* timer) {
+    // Mix the address so that timers allocated next to each other don't
+    // form long chains.
+    return hash_mix64(reinterpret_cast<uintptr_t>(timer));
+}
+
+// Points |parent|'s link to |old_child|, or the root of |cpu|'s tree if
+// |parent| is null, at |new_child| instead.
+static void tree_replace_child(uint cpu, timer_t* parent, timer_t* old_child,
+                               timer_t* new_child) {
+    if (new_child) {
+        new_child->tree_parent = parent;
+    }
+    if (!parent) {
+        percpu[cpu].timer_tree = new_child;
+    } else if (parent->tree_left == old_child) {
+        parent->tree_left = new_child;
+    } else {
+        parent->tree_right = new_child;
+    }
+}
+
+// Rotates |child| into its parent's place, keeping the in-order sequence.
+static void tree_rotate_up(uint cpu, timer_t* child) {
+    timer_t* parent = child->tree_parent;
+    timer_t* grandparent = parent->tree_parent;
+
+    if (parent->tree_left == child) {
+        parent->tree_left = child->tree_right;
+        if (child->tree_right) {
+            child->tree_right->tree_parent = parent;
+        }
+        child->tree_right = parent;
+    } else {
+        parent->tree_right = child->tree_left;
+        if (child->tree_left) {
+            child->tree_left->tree_parent = parent;
+        }
+        child->tree_left = parent;
+    }
+    parent->tree_parent = child;
+    tree_replace_child(cpu, grandparent, parent, child);
+}
+
+// Returns the last timer in |cpu|'s queue scheduled before |deadline|, or at
+// or before it if |inclusive|, or null if there is none.
+static timer_t* tree_find_before(uint cpu, zx_time_t deadline, bool inclusive) {
+    timer_t* found = NULL;
+    timer_t* t = percpu[cpu].timer_tree;
+    while (t) {
+        if (t->scheduled_time < deadline || (inclusive && t->scheduled_time == deadline)) {
+            found = t;
+            t = t->tree_right;
+        } else {
+            t = t->tree_left;
+        }
+    }
+    return found;
+}
+
+// Adds |timer| to |cpu|'s tree after any timers with the same scheduled_time.
+static void tree_insert(uint cpu, timer_t* timer) {
+    timer_t* parent = NULL;
+    timer_t** link = &percpu[cpu].timer_tree;
+    while (*link) {
+        parent = *link;
+        link = (timer->scheduled_time < parent->scheduled_time) ? &parent->tree_left
+                                                                : &parent->tree_right;
+    }
+    timer->tree_parent = parent;
+    timer->tree_left = NULL;
+    timer->tree_right = NULL;
+    *link = timer;
+
+    while (timer->tree_parent && tree_priority(timer) > tree_priority(timer->tree_parent)) {
+        tree_rotate_up(cpu, timer);
+    }
+}
+
+static void tree_remove(uint cpu, timer_t* timer) {
+    // Rotate the timer down until it has at most one child, then splice it out.
+    while (timer->tree_left && timer->tree_right) {
+        tree_rotate_up(cpu, tree_priority(timer->tree_left) > tree_priority(timer->tree_right)
+                                ? timer->tree_left
+                                : timer->tree_right);
+    }
+    tree_replace_child(cpu, timer->tree_parent, timer,
+                       timer->tree_left ? timer->tree_left : timer->tree_right);
+    timer->tree_parent = NULL;
+    timer->tree_left = NULL;
+    timer->tree_right = NULL;
+}
+
+// Removes |timer| from the queue it is in.
+static void remove_timer_from_queue(timer_t* timer) {
+    DEBUG_ASSERT(timer->queue_cpu >= 0);
+
+    list_delete(&timer->node);
+    tree_remove(timer->queue_cpu, timer);
+    timer->queue_cpu = -1;
+}
+
 static void insert_timer_in_queue(uint cpu, timer_t* timer,
                                   zx_time_t earliest_deadline, zx_time_t latest_deadline) {
 
@@ -74,110 +183,81 @@ static void insert_timer_in_queue(uint cpu, timer_t* timer,
     LTRACEF("timer %p, cpu %u, scheduled %" PRIi64 "\n", timer, cpu, timer->scheduled_time);
 
     // For inserting the timer we consider several cases. In general we
-    // want to coalesce with the current timer unless we can prove that
+    // want to coalesce with a neighboring timer unless we can prove that
     // either that:
-    //  1- there is no slack overlap with current timer OR
-    //  2- the next timer is a better fit.
+    //  1- there is no slack overlap with the neighbor OR
+    //  2- the other neighbor is a better fit.
     //
     // In diagrams that follow
-    // - Let |e| be the current (existing) timer deadline
+    // - Let |p| be the deadline of the last timer before the new timer, if any
+    // - Let |n| be the deadline of the next timer at or after it, if any
     // - Let |t| be the deadline of the timer we are inserting
-    // - Let |n| be the next timer deadline if any
-    // - Let |x| be the end of the list (not a timer)
     // - Let |(| and |)| the earliest_deadline and latest_deadline.
     //
-    timer_t* entry;
-
-    list_for_every_entry (&percpu[cpu].timer_queue, entry, timer_t, node) {
-        if (entry->scheduled_time > latest_deadline) {
-            // New timer latest is earlier than the current timer.
-            // Just add upfront as is, without slack.
-            //
-            //   ---------t---)--e-------------------------------> time
-            //
-            timer->slack = 0ll;
-            list_add_before(&entry->node, &timer->node);
-            return;
-        }
-
-        if (entry->scheduled_time >= timer->scheduled_time) {
-            //  New timer slack overlaps and is to the left (or equal). We
-            //  coalesce with current by scheduling late.
-            //
-            //  --------(----t---e-)----------------------------> time
-            //
-            timer->slack = zx_time_sub_time(entry->scheduled_time, timer->scheduled_time);
-            timer->scheduled_time = entry->scheduled_time;
-            list_add_after(&entry->node, &timer->node);
-            return;
-        }
-
-        if (entry->scheduled_time < earliest_deadline) {
-            // new timer earliest is later than the current timer. This case
-            // is handled in a future iteration.
-            //
-            //   ----------------e--(---t-----------------------> time
-            //
-            continue;
-        }
-
-        // New timer is to the right of current timer and there is overlap
-        // with the current timer, but could the next timer (if any) be
-        // a better fit?
+    timer_t* prev = tree_find_before(cpu, timer->scheduled_time, false);
+    timer_t* next = prev ? list_next_type(&percpu[cpu].timer_queue, &prev->node, timer_t, node)
+                         : list_peek_head_type(&percpu[cpu].timer_queue, timer_t, node);
+
+    timer_t* target = NULL;
+    if (prev != NULL && prev->scheduled_time >= earliest_deadline) {
+        // There is slack overlap with the previous timer, but could the next
+        // timer (if any) be a better fit?
         //
-        //  -------------(--e---t-----?-------------------> time
+        //  -------------(--p---t-----?-------------------> time
         //
-
-        const timer_t* next =
-            list_next_type(&percpu[cpu].timer_queue, &entry->node, timer_t, node);
-
+        target = prev;
         if (next != NULL) {
-            if (next->scheduled_time <= timer->scheduled_time) {
-                // The new timer is to the right of the next timer. There is no
-                // chance the current timer is a better fit.
+            if (next->scheduled_time == timer->scheduled_time) {
+                // The next timer is already at our deadline.
                 //
-                //  -------------(--e---n---t----------------------> time
+                //  -------------(--p---tn---------------------> time
                 //
-                continue;
-            }
-
-            if (next->scheduled_time < latest_deadline) {
-                // There is slack overlap with the next timer, and also with the
-                // current timer. Which coalescing is a better match?
+                target = next;
+            } else if (next->scheduled_time < latest_deadline) {
+                // There is slack overlap with both timers. Which coalescing
+                // is a better match?
                 //
-                //  --------------(-e---t---n-)-----------------------> time
+                //  --------------(-p---t---n-)-----------------------> time
                 //
-                zx_duration_t delta_entry =
-                    zx_time_sub_time(timer->scheduled_time, entry->scheduled_time);
+                zx_duration_t delta_prev =
+                    zx_time_sub_time(timer->scheduled_time, prev->scheduled_time);
                 zx_duration_t delta_next =
                     zx_time_sub_time(next->scheduled_time, timer->scheduled_time);
-                if (delta_next < delta_entry) {
-                    // New timer is closer to the next timer, handle it in the
-                    // next iteration.
-                    continue;
+                if (delta_next < delta_prev) {
+                    target = next;
                 }
             }
         }
-
-        // Handles the remaining cases, note that there is overlap with
-        // the current timer.
+    } else if (next != NULL && next->scheduled_time <= latest_deadline) {
+        //  New timer slack overlaps the next timer only. We coalesce with it
+        //  by scheduling late.
         //
-        //  1- this is the last timer (next == NULL) or
-        //  2- there is no overlap with the next timer, or
-        //  3- there is overlap with both current and next but
-        //     current is closer.
+        //  --------(----t---n-)----------------------------> time
         //
-        //  So we coalesce by scheduling early.
+        target = next;
+    }
+
+    if (target != NULL) {
+        // Coalesce by moving the timer to its neighbor's deadline, early or
+        // late.
+        timer->slack = zx_time_sub_time(target->scheduled_time, timer->scheduled_time);
+        timer->scheduled_time = target->scheduled_time;
+    } else {
+        // No overlap, so the timer goes in as is, without slack.
         //
-        timer->slack = zx_time_sub_time(entry->scheduled_time, timer->scheduled_time);
-        timer->scheduled_time = entry->scheduled_time;
-        list_add_after(&entry->node, &timer->node);
-        return;
+        //   ---p--(---t---)--n-------------------------------> time
+        //
+        timer->slack = 0;
     }
 
-    // Walked off the end of the list and there was no overlap.
-    timer->slack = 0;
-    list_add_tail(&percpu[cpu].timer_queue, &timer->node);
+    timer_t* after = tree_find_before(cpu, timer->scheduled_time, true);
+    if (after != NULL) {
+        list_add_after(&after->node, &timer->node);
+    } else {
+        list_add_head(&percpu[cpu].timer_queue, &timer->node);
+    }
+    tree_insert(cpu, timer);
+    timer->queue_cpu = cpu;
 }
 
 void timer_set(timer_t* timer, zx_time_t deadline,
@@ -308,7 +388,7 @@ bool timer_cancel(timer_t* timer) {
         timer_t* oldhead = list_peek_head_type(&percpu[cpu].timer_queue, timer_t, node);
 
         // remove our timer from the queue
-        list_delete(&timer->node);
+        remove_timer_from_queue(timer);
 
         // TODO(cpu): if  after removing |timer| there is one other single timer with
         // the same scheduled_time and slack non-zero then it is possible to return
@@ -382,7 +462,7 @@ void timer_tick(zx_time_t now) {
         DEBUG_ASSERT_MSG(timer && timer->magic == TIMER_MAGIC,
                          "ASSERT: timer failed magic check: timer %p, magic 0x%x\n",
                          timer, (uint)timer->magic);
-        list_delete(&timer->node);
+        remove_timer_from_queue(timer);
 
         // mark the timer busy
         timer->active_cpu = cpu;
@@ -456,7 +536,7 @@ void timer_transition_off_cpu(uint old_cpu) {
     timer_t *entry = NULL, *tmp_entry = NULL;
     // Move all timers from old_cpu to this cpu
     list_for_every_entry_safe (&percpu[old_cpu].timer_queue, entry, tmp_entry, timer_t, node) {
-        list_delete(&entry->node);
+        remove_timer_from_queue(entry);
         // We lost the original asymmetric slack information so when we combine them
         // with the other timer queue they are not coalesced again.
         // TODO(cpu): figure how important this case is.
@@ -493,6 +573,7 @@ void timer_thaw_percpu(void) {
 void timer_queue_init(void) {
     for (uint i = 0; i < SMP_MAX_CPUS; i++) {
         list_initialize(&percpu[i].timer_queue);
+        percpu[i].timer_tree = NULL;
         percpu[i].preempt_timer_deadline = ZX_TIME_INFINITE;
         percpu[i].next_timer_deadline = ZX_TIME_INFINITE;
     }
@@ -139,6 +139,7 @@ zx_status_t ktrace_control(uint32_t action, uint32_t options, void* ptr) {
         atomic_store(&ks->grpmask, options ? options : KTRACE_GRP_TO_MASK(KTRACE_GRP_ALL));
         ktrace_report_live_processes();
         ktrace_report_live_threads();
+        ktrace_report_lock_classes();
         break;
     case KTRACE_ACTION_STOP: {
         atomic_store(&ks->grpmask, 0);
@@ -235,6 +236,9 @@ void ktrace_init(unsigned level) {
     // report names of existing threads
     ktrace_report_live_threads();
 
+    // report names of profiled lock classes
+    ktrace_report_lock_classes();
+
     // report metadata for VCPUs
     ktrace_report_vcpu_meta();
 
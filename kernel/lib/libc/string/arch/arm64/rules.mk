@@ -7,10 +7,14 @@
 
 LOCAL_DIR := $(GET_LOCAL_DIR)
 
-ASM_STRING_OPS := memcpy memset
+ASM_STRING_OPS := memcmp memcpy memmove memset
 
+# These only use general-purpose registers, so they are safe to use in the
+# kernel.  memmove relies on memcpy handling the overlapping cases it hands off.
 MODULE_SRCS += \
+    third_party/lib/cortex-strings/src/aarch64/memcmp.S \
     third_party/lib/cortex-strings/src/aarch64/memcpy.S \
+    third_party/lib/cortex-strings/src/aarch64/memmove.S \
     third_party/lib/cortex-strings/no-neon/src/aarch64/memset.S \
 
 # filter out the C implementation
@@ -13,11 +13,14 @@
 #include <vm/vm.h>
 
 #include <lib/console.h>
+#include <lib/ktrace.h>
 #include <lib/version.h>
 
 #include <inttypes.h>
+#include <platform.h>
 #include <string.h>
 
+#include <fbl/algorithm.h>
 #include <fbl/atomic.h>
 #include <fbl/new.h>
 #include <lockdep/lockdep.h>
@@ -82,6 +85,33 @@ void DumpLockClassState() {
     }
 }
 
+// Dumps the contention statistics of every lock class that has been acquired
+// since boot or the last reset.
+void DumpLockClassProfile() {
+    if (!lockdep::kLockProfilingEnabled) {
+        printf("Lock profiling is not enabled in this build\n");
+        return;
+    }
+
+    printf("%12s %12s %16s %14s  %s\n",
+           "acquired", "contended", "total wait ns", "max hold ns", "name");
+    for (auto& state : lockdep::LockClassState::Iter()) {
+        const lockdep::LockClassState::Profile profile = state.profile();
+        if (profile.acquisitions == 0)
+            continue;
+        printf("%12" PRIu64 " %12" PRIu64 " %16" PRIu64 " %14" PRIu64 "  %s\n",
+               profile.acquisitions, profile.contended, profile.total_wait_time,
+               profile.max_hold_time, state.name());
+    }
+}
+
+// Clears the contention statistics of every lock class.
+void ResetLockClassProfile() {
+    for (auto& state : lockdep::LockClassState::Iter()) {
+        state.ResetProfile();
+    }
+}
+
 // Top-level lockdep command.
 int CommandLockDep(int argc, const cmd_args* argv, uint32_t flags) {
     if (argc < 2) {
@@ -89,6 +119,8 @@ int CommandLockDep(int argc, const cmd_args* argv, uint32_t flags) {
     usage:
         printf("%s dump              : dump lock classes\n", argv[0].str);
         printf("%s loop              : trigger loop detection pass\n", argv[0].str);
+        printf("%s profile           : dump lock contention statistics\n", argv[0].str);
+        printf("%s profile reset     : clear lock contention statistics\n", argv[0].str);
         return -1;
     }
 
@@ -97,6 +129,15 @@ int CommandLockDep(int argc, const cmd_args* argv, uint32_t flags) {
     } else if (strcmp(argv[1].str, "loop") == 0) {
         printf("Triggering loop detection pass:\n");
         lockdep::SystemTriggerLoopDetection();
+    } else if (strcmp(argv[1].str, "profile") == 0) {
+        if (argc < 3) {
+            DumpLockClassProfile();
+        } else if (strcmp(argv[2].str, "reset") == 0) {
+            ResetLockClassProfile();
+        } else {
+            printf("Unrecognized subcommand: '%s'\n", argv[2].str);
+            goto usage;
+        }
     } else {
         printf("Unrecognized subcommand: '%s'\n", argv[1].str);
         goto usage;
@@ -205,6 +246,27 @@ void SystemTriggerLoopDetection() {
     event_signal(&graph_edge_event, /*reschedule=*/false);
 }
 
+// Returns the current time in nanoseconds for lock profiling.
+uint64_t SystemGetLockProfilingTime() {
+    return current_time();
+}
+
+// Emits a ktrace record for a contended lock acquisition. The lock class is
+// identified by its profile id, which is mapped to a name by the records
+// emitted by ktrace_report_lock_classes().
+void SystemLockContended(LockClassState* lock_class, uint64_t wait_time) {
+    const uint32_t wait_ns = static_cast<uint32_t>(fbl::min<uint64_t>(wait_time, UINT32_MAX));
+    ktrace(TAG_LOCK_CONTENDED, lock_class->profile_id(), wait_ns, arch_curr_cpu_num(), 0);
+}
+
 } // namespace lockdep
 
+void ktrace_report_lock_classes() {
+    if (!lockdep::kLockProfilingEnabled)
+        return;
+
+    for (auto& state : lockdep::LockClassState::Iter())
+        ktrace_name_etc(TAG_LOCK_CLASS_NAME, state.profile_id(), 0, state.name(), true);
+}
+
 #endif
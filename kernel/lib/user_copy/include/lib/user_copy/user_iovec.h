@@ -0,0 +1,121 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <debug.h>
+#include <fbl/algorithm.h>
+#include <lib/user_copy/user_ptr.h>
+#include <zircon/compiler.h>
+#include <zircon/types.h>
+
+// user_iovec holds a kernel copy of a zx_iovec_t array supplied by user space
+// and copies bytes between kernel memory and the user buffers it describes as
+// if they were a single buffer of total() bytes.
+//
+// Accesses are expected to walk the buffers front to back; a cursor remembers
+// where the last access ended so that sequential copies don't rescan the
+// vector.
+class user_iovec {
+public:
+    user_iovec() = default;
+
+    // Describes the single user buffer |buffer| of |len| bytes.
+    user_iovec(user_in_ptr<const void> buffer, size_t len)
+        : user_iovec(const_cast<void*>(buffer.get()), len) {}
+    user_iovec(user_out_ptr<void> buffer, size_t len)
+        : user_iovec(buffer.get(), len) {}
+
+    // Copies in |count| entries from |vector|.
+    //
+    // Returns ZX_ERR_OUT_OF_RANGE if |count| is larger than ZX_IOVEC_MAX and
+    // ZX_ERR_INVALID_ARGS if |vector| can't be read or the total capacity
+    // overflows.
+    zx_status_t copy_vector_from_user(user_in_ptr<const zx_iovec_t> vector, size_t count) {
+        if (count > ZX_IOVEC_MAX)
+            return ZX_ERR_OUT_OF_RANGE;
+        if (count > 0 && vector.copy_array_from_user(entries_, count) != ZX_OK)
+            return ZX_ERR_INVALID_ARGS;
+
+        size_t total = 0u;
+        for (size_t i = 0; i < count; ++i) {
+            if (add_overflow(total, entries_[i].capacity, &total))
+                return ZX_ERR_INVALID_ARGS;
+        }
+
+        count_ = count;
+        total_ = total;
+        cursor_index_ = 0u;
+        cursor_base_ = 0u;
+        return ZX_OK;
+    }
+
+    // Returns the combined capacity of all the buffers.
+    size_t total() const { return total_; }
+
+    // Copies |len| bytes starting at byte |offset| of the user buffers into
+    // |dst|.
+    zx_status_t copy_from_user(void* dst, size_t len, size_t offset) {
+        return Copy(dst, len, offset, /*to_user=*/false);
+    }
+
+    // Copies |len| bytes from |src| to the user buffers starting at byte
+    // |offset|.
+    zx_status_t copy_to_user(const void* src, size_t len, size_t offset) {
+        return Copy(const_cast<void*>(src), len, offset, /*to_user=*/true);
+    }
+
+private:
+    user_iovec(void* buffer, size_t len) : count_(1u), total_(len) {
+        entries_[0] = {buffer, len};
+    }
+
+    zx_status_t Copy(void* kernel, size_t len, size_t offset, bool to_user) {
+        if (offset > total_ || len > total_ - offset)
+            return ZX_ERR_OUT_OF_RANGE;
+
+        if (offset < cursor_base_) {
+            cursor_index_ = 0u;
+            cursor_base_ = 0u;
+        }
+
+        char* k = static_cast<char*>(kernel);
+        while (len > 0) {
+            DEBUG_ASSERT(cursor_index_ < count_);
+            const zx_iovec_t& entry = entries_[cursor_index_];
+            const size_t skip = offset - cursor_base_;
+            if (skip >= entry.capacity) {
+                cursor_base_ += entry.capacity;
+                cursor_index_++;
+                continue;
+            }
+
+            const size_t chunk = fbl::min(entry.capacity - skip, len);
+            const uintptr_t user = reinterpret_cast<uintptr_t>(entry.buffer) + skip;
+            zx_status_t status =
+                to_user ? make_user_out_ptr(reinterpret_cast<void*>(user))
+                              .copy_array_to_user(k, chunk)
+                        : make_user_in_ptr(reinterpret_cast<const void*>(user))
+                              .copy_array_from_user(k, chunk);
+            if (status != ZX_OK)
+                return status;
+
+            k += chunk;
+            offset += chunk;
+            len -= chunk;
+        }
+        return ZX_OK;
+    }
+
+    zx_iovec_t entries_[ZX_IOVEC_MAX];
+    size_t count_ = 0u;
+    size_t total_ = 0u;
+
+    // The entry holding the most recently accessed byte and the offset of its
+    // first byte.
+    size_t cursor_index_ = 0u;
+    size_t cursor_base_ = 0u;
+};
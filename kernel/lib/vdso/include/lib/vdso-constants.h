@@ -18,6 +18,11 @@
 #define MAX_BUILDID_SIZE 64
 #define VDSO_CONSTANTS_SIZE (4 * 4 + 2 * 8 + MAX_BUILDID_SIZE)
 
+// The clock data sits alone on a page so that the kernel can keep
+// updating it after the vDSO variants are cloned from the main image.
+#define VDSO_CLOCK_ALIGN 4096
+#define VDSO_CLOCK_SIZE (8 + 4 * 4 + 8)
+
 #ifndef __ASSEMBLER__
 
 #include <stdint.h>
@@ -58,9 +63,35 @@ struct vdso_constants {
     char buildid[MAX_BUILDID_SIZE];
 };
 
+// This struct contains the parameters of ZX_CLOCK_MONOTONIC and
+// ZX_CLOCK_UTC.  Unlike vdso_constants, the kernel may change it at any
+// time, so readers must use the seqlock protocol: read |seq|, read the
+// fields, then read |seq| again, and retry if it was odd or changed.
+struct vdso_clock {
+    // Incremented before and after each update, so it is odd while an
+    // update is in progress.
+    uint64_t seq;
+
+    // The fixed-point factor that converts zx_ticks_get() values to
+    // ZX_CLOCK_MONOTONIC, as the bits before and after the binary point.
+    // See struct fp_32_64 in kernel/lib/fixed_point.
+    uint32_t ns_per_tick_l0;
+    uint32_t ns_per_tick_l32;
+    uint32_t ns_per_tick_l64;
+
+    // Nonzero if ns_per_tick is valid.  Otherwise, the vDSO must ask the
+    // kernel for the time.
+    uint32_t ticks_valid;
+
+    // The offset of ZX_CLOCK_UTC from ZX_CLOCK_MONOTONIC.
+    int64_t utc_offset;
+};
+
 static_assert(VDSO_CONSTANTS_SIZE == sizeof(vdso_constants),
               "Need to adjust VDSO_CONSTANTS_SIZE");
 static_assert(VDSO_CONSTANTS_ALIGN == alignof(vdso_constants),
               "Need to adjust VDSO_CONSTANTS_ALIGN");
+static_assert(VDSO_CLOCK_SIZE == sizeof(vdso_clock),
+              "Need to adjust VDSO_CLOCK_SIZE");
 
 #endif // __ASSEMBLER__
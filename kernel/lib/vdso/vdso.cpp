@@ -10,6 +10,7 @@
 #include <fbl/alloc_checker.h>
 #include <fbl/type_support.h>
 #include <kernel/cmdline.h>
+#include <lib/fixed_point.h>
 #include <object/handle.h>
 #include <platform.h>
 #include <vm/pmm.h>
@@ -200,6 +201,23 @@ void blacklist_##category##_syscalls(VDsoDynSymWindow& dynsym_window, \
 #undef SYSCALL_IN_CATEGORY_END
 #undef SYSCALL_CATEGORY_END
 
+// The clock data stays mapped into the kernel for the life of the system,
+// so that it can be updated.  All variants see the updates because they are
+// clones that never write to the clock's page, so they share the original.
+KernelVmoWindow<vdso_clock>* clock_window;
+
+// Runs |update| on the clock data following the seqlock protocol described
+// in vdso-constants.h.
+template <typename T>
+void update_clock(T update) {
+    vdso_clock* clock = clock_window->data();
+    uint64_t seq = __atomic_load_n(&clock->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&clock->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    update(clock);
+    __atomic_store_n(&clock->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
 } // anonymous namespace
 
 const VDso* VDso::instance_ = NULL;
@@ -248,6 +266,30 @@ const VDso* VDso::Create() {
         REDIRECT_SYSCALL(dynsym_window, zx_ticks_get, soft_ticks_get);
     }
 
+    // Map a window into the VMO to publish the clock parameters.  If user
+    // mode can't read the ticks the kernel uses, the vDSO will ask the
+    // kernel for the time instead.
+    static_assert(sizeof(vdso_clock) == VDSO_DATA_CLOCK_SIZE,
+                  "gen-rodso-code.sh is suspect");
+    static_assert(VDSO_DATA_CLOCK % PAGE_SIZE == 0,
+                  "the vDSO clock data must start a page");
+    clock_window = new (&ac) KernelVmoWindow<vdso_clock>(
+        "vDSO clock", vdso->vmo()->vmo(), VDSO_DATA_CLOCK);
+    ASSERT(ac.check());
+
+    fp_32_64 ns_per_tick = {};
+    bool ticks_valid = per_second != 0 &&
+                       !cmdline_get_bool("vdso.soft_ticks", false) &&
+                       platform_usermode_ticks_to_nanos(&ns_per_tick) &&
+                       (ns_per_tick.l0 | ns_per_tick.l32 | ns_per_tick.l64) != 0;
+    update_clock([&](vdso_clock* clock) {
+        clock->ns_per_tick_l0 = ns_per_tick.l0;
+        clock->ns_per_tick_l32 = ns_per_tick.l32;
+        clock->ns_per_tick_l64 = ns_per_tick.l64;
+        clock->ticks_valid = ticks_valid;
+        clock->utc_offset = 0;
+    });
+
     for (size_t v = static_cast<size_t>(Variant::FULL) + 1;
          v < static_cast<size_t>(Variant::COUNT);
          ++v)
@@ -257,6 +299,13 @@ const VDso* VDso::Create() {
     return instance_;
 }
 
+void VDso::SetUtcOffset(int64_t utc_offset) {
+    DEBUG_ASSERT(instance_);
+    update_clock([utc_offset](vdso_clock* clock) {
+        clock->utc_offset = utc_offset;
+    });
+}
+
 uintptr_t VDso::base_address(const fbl::RefPtr<VmMapping>& code_mapping) {
     return code_mapping ? code_mapping->base() - VDSO_CODE_START : 0;
 }
@@ -313,6 +362,11 @@ void VDso::CreateVariant(Variant variant) {
         PANIC("VDso::CreateVariant called with bad variant");
     }
 
+    // zx_syscall_batch() doesn't go through the syscall entry check for
+    // each call it makes, so a variant that takes any syscalls away has
+    // to take it away too.
+    BLACKLIST_SYSCALL(dynsym_window, code_window, zx_syscall_batch);
+
     fbl::RefPtr<Dispatcher> dispatcher;
     zx_rights_t rights;
     status = VmObjectDispatcher::Create(fbl::move(new_vmo),
@@ -0,0 +1,139 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <kernel/sched.h>
+#include <kernel/thread.h>
+#include <kernel/thread_lock.h>
+#include <lib/unittest/unittest.h>
+#include <zircon/syscalls/profile.h>
+
+namespace {
+
+int idle_thread(void*) {
+    return 0;
+}
+
+// The thread is never resumed while the test looks at it, so changing its
+// priority doesn't move it between any queues.
+thread_t* create_thread(int priority) {
+    return thread_create("call priority test", idle_thread, nullptr, priority,
+                         DEFAULT_STACK_SIZE);
+}
+
+void join_thread(thread_t* t) {
+    thread_resume(t);
+    thread_join(t, nullptr, ZX_TIME_INFINITE);
+}
+
+// A thread serving a channel call runs at the caller's priority until the
+// loan ends, independently of anything it inherits through a futex.
+bool call_priority_test() {
+    BEGIN_TEST;
+
+    thread_t* server = create_thread(LOW_PRIORITY);
+    ASSERT_NONNULL(server, "");
+
+    {
+        Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+        bool local_resched = false;
+
+        sched_inherit_call_priority(server, HIGH_PRIORITY, &local_resched);
+        EXPECT_EQ(HIGH_PRIORITY, server->effec_priority, "");
+
+        // A futex boost on top of the loan wins while it is higher, and
+        // giving it back leaves the loan in place.
+        sched_inherit_futex_priority(server, HIGHEST_PRIORITY, &local_resched);
+        EXPECT_EQ(HIGHEST_PRIORITY, server->effec_priority, "");
+        sched_inherit_futex_priority(server, -1, &local_resched);
+        EXPECT_EQ(HIGH_PRIORITY, server->effec_priority, "");
+
+        // Ending the loan when the caller's wait ends drops the boost.
+        sched_inherit_call_priority(server, -1, &local_resched);
+        EXPECT_EQ(LOW_PRIORITY, server->effec_priority, "");
+    }
+
+    join_thread(server);
+
+    END_TEST;
+}
+
+// Reading a new call replaces the loan of the previous one, even when the new
+// caller runs at a lower priority, the way ThreadDispatcher hands it over.
+bool call_priority_replaced_test() {
+    BEGIN_TEST;
+
+    thread_t* server = create_thread(LOW_PRIORITY);
+    ASSERT_NONNULL(server, "");
+
+    {
+        Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+        bool local_resched = false;
+
+        sched_inherit_call_priority(server, HIGHEST_PRIORITY, &local_resched);
+        EXPECT_EQ(HIGHEST_PRIORITY, server->effec_priority, "");
+
+        sched_inherit_call_priority(server, -1, &local_resched);
+        sched_inherit_call_priority(server, HIGH_PRIORITY, &local_resched);
+        EXPECT_EQ(HIGH_PRIORITY, server->effec_priority, "");
+
+        sched_inherit_call_priority(server, -1, &local_resched);
+        EXPECT_EQ(LOW_PRIORITY, server->effec_priority, "");
+    }
+
+    join_thread(server);
+
+    END_TEST;
+}
+
+// A caller lends the priority it inherited, so it reaches the end of a chain
+// of calls, but not the lift its own cpu reservation gives it.
+bool call_priority_lendable_test() {
+    BEGIN_TEST;
+
+    thread_t* client = create_thread(LOW_PRIORITY);
+    ASSERT_NONNULL(client, "");
+    thread_t* server = create_thread(LOWEST_PRIORITY);
+    ASSERT_NONNULL(server, "");
+    thread_t* next_server = create_thread(LOWEST_PRIORITY);
+    ASSERT_NONNULL(next_server, "");
+
+    {
+        Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+        bool local_resched = false;
+
+        ASSERT_EQ(ZX_OK, sched_set_bandwidth(client, ZX_SCHED_WEIGHT_DEFAULT, ZX_MSEC(1),
+                                             ZX_SEC(1)), "");
+        EXPECT_EQ(RESERVED_PRIORITY, client->effec_priority, "");
+        EXPECT_EQ(LOW_PRIORITY, sched_lendable_priority(client), "");
+
+        // The way sys_channel_call() lends it, and a server passes it on.
+        sched_inherit_call_priority(server, sched_lendable_priority(client), &local_resched);
+        EXPECT_EQ(LOW_PRIORITY, server->effec_priority, "");
+        sched_inherit_call_priority(next_server, sched_lendable_priority(server),
+                                    &local_resched);
+        EXPECT_EQ(LOW_PRIORITY, next_server->effec_priority, "");
+
+        sched_inherit_call_priority(next_server, -1, &local_resched);
+        sched_inherit_call_priority(server, -1, &local_resched);
+        EXPECT_EQ(LOWEST_PRIORITY, server->effec_priority, "");
+    }
+
+    // The client gives its reservation back when it exits.
+
+    join_thread(client);
+    join_thread(server);
+    join_thread(next_server);
+
+    END_TEST;
+}
+
+} // namespace
+
+UNITTEST_START_TESTCASE(call_priority_tests)
+UNITTEST("call priority", call_priority_test)
+UNITTEST("call priority replaced", call_priority_replaced_test)
+UNITTEST("call priority lendable", call_priority_lendable_test)
+UNITTEST_END_TESTCASE(call_priority_tests, "call_priority", "Channel call priority inheritance tests");
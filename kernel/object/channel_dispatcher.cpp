@@ -20,6 +20,8 @@
 #include <object/process_dispatcher.h>
 #include <object/thread_dispatcher.h>
 
+#include <kernel/thread_lock.h>
+
 #include <fbl/alloc_checker.h>
 #include <fbl/auto_lock.h>
 #include <fbl/type_support.h>
@@ -121,6 +123,7 @@ void ChannelDispatcher::RemoveWaiter(MessageWaiter* waiter) {
         return;
     }
     waiters_.erase(*waiter);
+    waiter->EndLoan();
 }
 
 void ChannelDispatcher::on_zero_handles_locked() {
@@ -186,6 +189,20 @@ zx_status_t ChannelDispatcher::Read(uint32_t* msg_size,
     return rv;
 }
 
+void ChannelDispatcher::Unread(fbl::unique_ptr<MessagePacket> msg) {
+    canary_.Assert();
+
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    messages_.push_front(fbl::move(msg));
+    message_count_++;
+    if (message_count_ > max_message_count_) {
+        max_message_count_ = message_count_;
+    }
+
+    UpdateStateLocked(0u, ZX_CHANNEL_READABLE);
+}
+
 zx_status_t ChannelDispatcher::Write(fbl::unique_ptr<MessagePacket> msg) {
     canary_.Assert();
 
@@ -240,6 +257,7 @@ alloc_txid:
 
         // Install our txid in the waiter and the outbound message
         waiter->set_txid(txid);
+        waiter->set_lends_priority(msg->priority() >= 0);
         msg->set_txid(txid);
 
         // (0) Before writing the outbound message and waiting, add our
@@ -294,6 +312,30 @@ zx_status_t ChannelDispatcher::ResumeInterruptedCall(MessageWaiter* waiter,
     }
 }
 
+void ChannelDispatcher::InheritCallPriority(const MessagePacket& msg) {
+    canary_.Assert();
+
+    ThreadDispatcher* reader = ThreadDispatcher::GetCurrent();
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    // The caller waits on the other endpoint, and only until its wait ends.
+    // Holding the channel lock keeps the waiter from ending its wait while
+    // the loan is set up.
+    MessageWaiter* lender = nullptr;
+    if (peer_) {
+        for (auto& waiter : peer_->waiters_) {
+            if (waiter.get_txid() == msg.get_txid()) {
+                if (waiter.lends_priority())
+                    lender = &waiter;
+                break;
+            }
+        }
+    }
+
+    Guard<spin_lock_t, IrqSave> thread_lock_guard{ThreadLock::Get()};
+    reader->InheritCallPriorityLocked(lender, msg.priority());
+}
+
 size_t ChannelDispatcher::TxMessageMax() const {
     return SIZE_MAX;
 }
@@ -336,6 +378,7 @@ ChannelDispatcher::MessageWaiter::~MessageWaiter() {
         channel_->RemoveWaiter(this);
     }
     DEBUG_ASSERT(!InContainer());
+    DEBUG_ASSERT(!lends_priority_);
 }
 
 zx_status_t ChannelDispatcher::MessageWaiter::BeginWait(fbl::RefPtr<ChannelDispatcher> channel) {
@@ -353,6 +396,7 @@ zx_status_t ChannelDispatcher::MessageWaiter::BeginWait(fbl::RefPtr<ChannelDispa
 void ChannelDispatcher::MessageWaiter::Deliver(fbl::unique_ptr<MessagePacket> msg) {
     DEBUG_ASSERT(channel_);
 
+    EndLoan();
     msg_ = fbl::move(msg);
     status_ = ZX_OK;
     event_.Signal(ZX_OK);
@@ -361,6 +405,7 @@ void ChannelDispatcher::MessageWaiter::Deliver(fbl::unique_ptr<MessagePacket> ms
 void ChannelDispatcher::MessageWaiter::Cancel(zx_status_t status) {
     DEBUG_ASSERT(!InContainer());
     DEBUG_ASSERT(channel_);
+    EndLoan();
     status_ = status;
     event_.Signal(status);
 }
@@ -377,7 +422,19 @@ zx_status_t ChannelDispatcher::MessageWaiter::EndWait(fbl::unique_ptr<MessagePac
     if (unlikely(!channel_)) {
         return ZX_ERR_BAD_STATE;
     }
+    EndLoan();
     *out = fbl::move(msg_);
     channel_ = nullptr;
     return status_;
 }
+
+void ChannelDispatcher::MessageWaiter::EndLoan() {
+    if (!lends_priority_)
+        return;
+    lends_priority_ = false;
+
+    Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+    if (borrower_)
+        borrower_->EndCallPriorityLocked();
+    DEBUG_ASSERT(!borrower_);
+}
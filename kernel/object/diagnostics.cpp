@@ -18,6 +18,7 @@
 #include <object/process_dispatcher.h>
 #include <object/vm_object_dispatcher.h>
 #include <pretty/sizes.h>
+#include <vm/harvester.h>
 #include <zircon/types.h>
 
 // Machinery to walk over a job tree and run a callback on each process.
@@ -60,7 +61,7 @@ static void DumpProcessListKeyMap() {
 }
 
 static const char* ObjectTypeToString(zx_obj_type_t type) {
-    static_assert(ZX_OBJ_TYPE_LAST == 28, "need to update switch below");
+    static_assert(ZX_OBJ_TYPE_LAST == 29, "need to update switch below");
 
     switch (type) {
         case ZX_OBJ_TYPE_PROCESS: return "process";
@@ -86,6 +87,7 @@ static const char* ObjectTypeToString(zx_obj_type_t type) {
         case ZX_OBJ_TYPE_PROFILE: return "profile";
         case ZX_OBJ_TYPE_PMT: return "pmt";
         case ZX_OBJ_TYPE_SUSPEND_TOKEN: return "suspend-token";
+        case ZX_OBJ_TYPE_WAITSET: return "waitset";
         default: return "???";
     }
 }
@@ -114,7 +116,7 @@ static uint32_t BuildHandleStats(const ProcessDispatcher& pd,
 // buffer as strings.
 static void FormatHandleTypeCount(const ProcessDispatcher& pd,
                                   char *buf, size_t buf_len) {
-    static_assert(ZX_OBJ_TYPE_LAST == 28, "need to update table below");
+    static_assert(ZX_OBJ_TYPE_LAST == 29, "need to update table below");
 
     uint32_t types[ZX_OBJ_TYPE_LAST] = {0};
     uint32_t handle_count = BuildHandleStats(pd, types, sizeof(types));
@@ -137,7 +139,7 @@ static void FormatHandleTypeCount(const ProcessDispatcher& pd,
              types[ZX_OBJ_TYPE_GUEST] + types[ZX_OBJ_TYPE_VCPU] +
              types[ZX_OBJ_TYPE_IOMMU] + types[ZX_OBJ_TYPE_BTI] +
              types[ZX_OBJ_TYPE_PROFILE] + types[ZX_OBJ_TYPE_PMT] +
-             types[ZX_OBJ_TYPE_SUSPEND_TOKEN]
+             types[ZX_OBJ_TYPE_SUSPEND_TOKEN] + types[ZX_OBJ_TYPE_WAITSET]
              );
 }
 
@@ -438,6 +440,54 @@ zx_status_t VmAspace::GetMemoryUsage(vm_usage_t* usage) {
     return ZX_OK;
 }
 
+namespace {
+// Counts committed pages under a VmAspace by how recently they were accessed.
+class WorkingSetCounter final : public VmEnumerator {
+public:
+    bool OnVmMapping(const VmMapping* map, const VmAddressRegion* vmar,
+                     uint depth) override {
+        committed_pages += map->vmo()->CountPagesByAgeInRange(
+            map->object_offset(), map->size(), accessed_pages,
+            ZX_INFO_WORKING_SET_WINDOWS);
+        return true;
+    }
+
+    size_t committed_pages = 0;
+    uint64_t accessed_pages[ZX_INFO_WORKING_SET_WINDOWS] = {};
+};
+
+void FillWorkingSet(size_t committed_pages, const uint64_t* accessed_pages,
+                    zx_info_working_set_t* info) {
+    *info = {};
+    info->harvest_period = harvester_period();
+    info->committed_bytes = committed_pages * PAGE_SIZE;
+    for (size_t i = 0; i < ZX_INFO_WORKING_SET_WINDOWS; i++) {
+        info->accessed_bytes[i] = accessed_pages[i] * PAGE_SIZE;
+    }
+}
+} // namespace
+
+void GetVmoWorkingSet(const VmObject* vmo, zx_info_working_set_t* info) {
+    uint64_t accessed_pages[ZX_INFO_WORKING_SET_WINDOWS] = {};
+    size_t committed_pages = vmo->CountPagesByAgeInRange(
+        0, vmo->size(), accessed_pages, ZX_INFO_WORKING_SET_WINDOWS);
+    FillWorkingSet(committed_pages, accessed_pages, info);
+}
+
+zx_status_t GetVmAspaceWorkingSet(fbl::RefPtr<VmAspace> aspace,
+                                  zx_info_working_set_t* info) {
+    DEBUG_ASSERT(aspace != nullptr);
+    if (aspace->is_destroyed()) {
+        return ZX_ERR_BAD_STATE;
+    }
+    WorkingSetCounter wsc;
+    if (!aspace->EnumerateChildren(&wsc)) {
+        return ZX_ERR_INTERNAL;
+    }
+    FillWorkingSet(wsc.committed_pages, wsc.accessed_pages, info);
+    return ZX_OK;
+}
+
 namespace {
 unsigned int arch_mmu_flags_to_vm_flags(unsigned int arch_mmu_flags) {
     if (arch_mmu_flags & ARCH_MMU_FLAG_INVALID) {
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <zircon/rights.h>
+#include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
 #include <fbl/auto_lock.h>
 #include <object/handle.h>
@@ -95,23 +96,38 @@ void FifoDispatcher::OnPeerZeroHandlesLocked() {
 }
 
 zx_status_t FifoDispatcher::WriteFromUser(size_t elem_size, user_in_ptr<const uint8_t> ptr,
-                                          size_t count, size_t* actual)
+                                          size_t count, size_t* actual) {
+    canary_.Assert();
+
+    if (elem_size != elem_size_)
+        return ZX_ERR_OUT_OF_RANGE;
+
+    // No more than elem_count_ entries can ever be copied, so clamping keeps
+    // the byte length from overflowing.
+    user_iovec src(ptr.reinterpret<const void>(), fbl::min<size_t>(count, elem_count_) * elem_size);
+    return WriteFromUser(elem_size, &src, actual);
+}
+
+zx_status_t FifoDispatcher::WriteFromUser(size_t elem_size, user_iovec* src, size_t* actual)
     TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
     Guard<fbl::Mutex> guard{get_lock()};
     if (!peer_)
         return ZX_ERR_PEER_CLOSED;
-    return peer_->WriteSelfLocked(elem_size, ptr, count, actual);
+    return peer_->WriteSelfLocked(elem_size, src, actual);
 }
 
-zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const uint8_t> ptr,
-                                            size_t count, size_t* actual)
+zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_iovec* src, size_t* actual)
     TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
     if (elem_size != elem_size_)
         return ZX_ERR_OUT_OF_RANGE;
+    if (src->total() % elem_size_ != 0)
+        return ZX_ERR_INVALID_ARGS;
+
+    size_t count = src->total() / elem_size_;
     if (count == 0)
         return ZX_ERR_OUT_OF_RANGE;
 
@@ -128,6 +144,7 @@ zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const
     if (count > avail)
         count = avail;
 
+    size_t pos = 0;
     while (count > 0) {
         uint32_t offset = (head_ & mask_);
 
@@ -137,8 +154,8 @@ zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const
         // number of slots we can actually copy
         size_t to_copy = (count > n) ? n : count;
 
-        zx_status_t status = ptr.copy_array_from_user(&data_[offset * elem_size_],
-                                                      to_copy * elem_size_);
+        zx_status_t status = src->copy_from_user(&data_[offset * elem_size_],
+                                                 to_copy * elem_size_, pos);
         if (status != ZX_OK) {
             // roll back, in case this is the second copy
             head_ = old_head;
@@ -149,7 +166,7 @@ zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const
         // due to size limitations on fifo, to_copy will always fit in a u32
         head_ += static_cast<uint32_t>(to_copy);
         count -= to_copy;
-        ptr = ptr.byte_offset(to_copy * elem_size_);
+        pos += to_copy * elem_size_;
     }
 
     // if was empty, we've become readable
@@ -165,12 +182,26 @@ zx_status_t FifoDispatcher::WriteSelfLocked(size_t elem_size, user_in_ptr<const
 }
 
 zx_status_t FifoDispatcher::ReadToUser(size_t elem_size, user_out_ptr<uint8_t> ptr, size_t count,
-                                       size_t* actual)
+                                       size_t* actual) {
+    canary_.Assert();
+
+    if (elem_size != elem_size_)
+        return ZX_ERR_OUT_OF_RANGE;
+
+    user_iovec dst(ptr.reinterpret<void>(), fbl::min<size_t>(count, elem_count_) * elem_size);
+    return ReadToUser(elem_size, &dst, actual);
+}
+
+zx_status_t FifoDispatcher::ReadToUser(size_t elem_size, user_iovec* dst, size_t* actual)
     TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
     if (elem_size != elem_size_)
         return ZX_ERR_OUT_OF_RANGE;
+    if (dst->total() % elem_size_ != 0)
+        return ZX_ERR_INVALID_ARGS;
+
+    size_t count = dst->total() / elem_size_;
     if (count == 0)
         return ZX_ERR_OUT_OF_RANGE;
 
@@ -189,6 +220,7 @@ zx_status_t FifoDispatcher::ReadToUser(size_t elem_size, user_out_ptr<uint8_t> p
     if (count > avail)
         count = avail;
 
+    size_t pos = 0;
     while (count > 0) {
         uint32_t offset = (tail_ & mask_);
 
@@ -198,8 +230,8 @@ zx_status_t FifoDispatcher::ReadToUser(size_t elem_size, user_out_ptr<uint8_t> p
         // number of slots we can actually copy
         size_t to_copy = (count > n) ? n : count;
 
-        zx_status_t status = ptr.copy_array_to_user(&data_[offset * elem_size_],
-                                                    to_copy * elem_size_);
+        zx_status_t status = dst->copy_to_user(&data_[offset * elem_size_],
+                                               to_copy * elem_size_, pos);
         if (status != ZX_OK) {
             // roll back, in case this is the second copy
             tail_ = old_tail;
@@ -210,7 +242,7 @@ zx_status_t FifoDispatcher::ReadToUser(size_t elem_size, user_out_ptr<uint8_t> p
         // due to size limitations on fifo, to_copy will always fit in a u32
         tail_ += static_cast<uint32_t>(to_copy);
         count -= to_copy;
-        ptr = ptr.byte_offset(to_copy * elem_size_);
+        pos += to_copy * elem_size_;
     }
 
     // if we were full, we have become writable
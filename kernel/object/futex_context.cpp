@@ -7,6 +7,8 @@
 #include <object/futex_context.h>
 
 #include <assert.h>
+#include <kernel/sched.h>
+#include <kernel/thread_lock.h>
 #include <lib/user_copy/user_ptr.h>
 #include <object/thread_dispatcher.h>
 #include <trace.h>
@@ -14,6 +16,36 @@
 
 #define LOCAL_TRACE 0
 
+namespace {
+
+// Returns ZX_ERR_BAD_STATE if the futex at |value_ptr| no longer holds
+// |current_value|.  The caller must hold the futex's bucket lock.
+zx_status_t CheckFutexValue(user_in_ptr<const int> value_ptr, int current_value) {
+    int value;
+    zx_status_t result = value_ptr.copy_from_user(&value);
+    if (result != ZX_OK) return result;
+    if (value != current_value) return ZX_ERR_BAD_STATE;
+    return ZX_OK;
+}
+
+// A thread that wakes a futex is taken to be releasing whatever it owned, so
+// it gives up any priority it inherited from futex waiters.  The priority is
+// checked without the thread lock; a waiter that starts lending just after
+// the check keeps lending only until it stops waiting.
+void DropFutexPriority() {
+    thread_t* current_thread = get_current_thread();
+    if (current_thread->futex_inherited_priority < 0)
+        return;
+
+    Guard<spin_lock_t, IrqSave> thread_lock_guard{ThreadLock::Get()};
+    bool local_resched = false;
+    FutexNode::ReleaseLendersLocked(current_thread, &local_resched);
+    if (local_resched)
+        sched_reschedule();
+}
+
+} // namespace
+
 FutexContext::FutexContext() {
     LTRACE_ENTRY;
 }
@@ -23,44 +55,48 @@ FutexContext::~FutexContext() {
 
     // All of the threads should have removed themselves from wait queues
     // by the time the process has exited.
-    DEBUG_ASSERT(futex_table_.is_empty());
+    for (const Bucket& bucket : buckets_) {
+        DEBUG_ASSERT(bucket.futex_table.is_empty());
+    }
 }
 
-zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int current_value, zx_time_t deadline) {
+zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int current_value,
+                                    zx_time_t deadline, ThreadDispatcher* owner) {
     LTRACE_ENTRY;
 
     uintptr_t futex_key = reinterpret_cast<uintptr_t>(value_ptr.get());
     if (futex_key % sizeof(int))
         return ZX_ERR_INVALID_ARGS;
 
+    Bucket* bucket = GetBucket(futex_key);
+
     // FutexWait() checks that the address value_ptr still contains
     // current_value, and if so it sleeps awaiting a FutexWake() on value_ptr.
     // Those two steps must together be atomic with respect to FutexWake().
     // If a FutexWake() operation could occur between them, a userland mutex
     // operation built on top of futexes would have a race condition that
     // could miss wakeups.
-    Guard<fbl::Mutex> guard{&lock_};
+    Guard<fbl::Mutex> guard{&bucket->lock};
 
-    int value;
-    zx_status_t result = value_ptr.copy_from_user(&value);
+    zx_status_t result = CheckFutexValue(value_ptr, current_value);
     if (result != ZX_OK) {
         return result;
     }
-    if (value != current_value) {
-        return ZX_ERR_BAD_STATE;
-    }
 
     FutexNode node;
     node.set_hash_key(futex_key);
+    node.set_waiter(get_current_thread(), owner != nullptr);
     node.SetAsSingletonList();
 
-    QueueNodesLocked(&node);
+    QueueNodesLocked(bucket, &node);
 
-    // Block current thread.  This releases lock_ and does not reacquire it.
-    result = node.BlockThread(guard.take(), deadline);
+    // Block current thread.  This releases the bucket lock and does not
+    // reacquire it.
+    result = node.BlockThread(guard.take(), deadline, owner);
     if (result == ZX_OK) {
         DEBUG_ASSERT(!node.IsInQueue());
         // All the work necessary for removing us from the hash table was done by FutexWake()
+        node.StopLending();
         return ZX_OK;
     }
 
@@ -69,9 +105,12 @@ zx_status_t FutexContext::FutexWait(user_in_ptr<const int> value_ptr, int curren
     // (ZX_ERR_INTERNAL_INTR_RETRY).
     //
     // We need to ensure that the thread's node is removed from the wait
-    // queue, because FutexWake() probably didn't do that.
-    Guard<fbl::Mutex> guard2{&lock_};
-    if (UnqueueNodeLocked(&node)) {
+    // queue, because FutexWake() probably didn't do that.  Only then can it
+    // stop lending its priority, since PassOwnership() may lend it to a new
+    // owner for as long as it is queued.
+    const bool unqueued = UnqueueNode(&node);
+    node.StopLending();
+    if (unqueued) {
         return result;
     }
     // The current thread was not found on the wait queue.  This means
@@ -106,23 +145,31 @@ zx_status_t FutexContext::FutexWake(user_in_ptr<const int> value_ptr,
     if (futex_key % sizeof(int))
         return ZX_ERR_INVALID_ARGS;
 
+    Bucket* bucket = GetBucket(futex_key);
+
     AutoReschedDisable resched_disable; // Must come before the Guard.
     resched_disable.Disable();
-    Guard<fbl::Mutex> guard{&lock_};
+    Guard<fbl::Mutex> guard{&bucket->lock};
+
+    DropFutexPriority();
 
-    FutexNode* node = futex_table_.erase(futex_key);
+    FutexNode* node = bucket->futex_table.erase(futex_key);
     if (!node) {
         // nothing blocked on this futex if we can't find it
         return ZX_OK;
     }
     DEBUG_ASSERT(node->GetKey() == futex_key);
 
+    if (count == 1 && node->inherit_priority()) {
+        FutexNode::PassOwnership(node);
+    }
+
     FutexNode* remaining_waiters =
         FutexNode::WakeThreads(node, count, futex_key);
 
     if (remaining_waiters) {
         DEBUG_ASSERT(remaining_waiters->GetKey() == futex_key);
-        futex_table_.insert(remaining_waiters);
+        bucket->futex_table.insert(remaining_waiters);
     }
 
     return ZX_OK;
@@ -135,33 +182,60 @@ zx_status_t FutexContext::FutexRequeue(user_in_ptr<const int> wake_ptr, uint32_t
     if ((requeue_ptr.get() == nullptr) && requeue_count)
         return ZX_ERR_INVALID_ARGS;
 
-    AutoReschedDisable resched_disable; // Must come before the Guard.
-    Guard<fbl::Mutex> guard{&lock_};
-
-    int value;
-    zx_status_t result = wake_ptr.copy_from_user(&value);
-    if (result != ZX_OK) return result;
-    if (value != current_value) return ZX_ERR_BAD_STATE;
-
     uintptr_t wake_key = reinterpret_cast<uintptr_t>(wake_ptr.get());
     uintptr_t requeue_key = reinterpret_cast<uintptr_t>(requeue_ptr.get());
     if (wake_key == requeue_key) return ZX_ERR_INVALID_ARGS;
     if (wake_key % sizeof(int) || requeue_key % sizeof(int))
         return ZX_ERR_INVALID_ARGS;
 
+    Bucket* wake_bucket = GetBucket(wake_key);
+    Bucket* requeue_bucket = GetBucket(requeue_key);
+
+    AutoReschedDisable resched_disable; // Must come before the Guard.
+
+    // Both futexes' buckets must be held at once so that a requeued thread
+    // can't be found in neither.  GuardMultiple orders the locks by address,
+    // but can't take the same lock twice.
+    if (wake_bucket == requeue_bucket) {
+        Guard<fbl::Mutex> guard{&wake_bucket->lock};
+
+        zx_status_t result = CheckFutexValue(wake_ptr, current_value);
+        if (result != ZX_OK) return result;
+
+        // This must come before WakeThreads() to be useful, but we want to
+        // avoid doing it before copy_from_user() in case that faults.
+        resched_disable.Disable();
+        RequeueLocked(wake_bucket, wake_key, wake_count,
+                      requeue_bucket, requeue_key, requeue_count);
+    } else {
+        GuardMultiple<2, fbl::Mutex> guard{&wake_bucket->lock, &requeue_bucket->lock};
+
+        zx_status_t result = CheckFutexValue(wake_ptr, current_value);
+        if (result != ZX_OK) return result;
+
+        resched_disable.Disable();
+        RequeueLocked(wake_bucket, wake_key, wake_count,
+                      requeue_bucket, requeue_key, requeue_count);
+    }
+
+    return ZX_OK;
+}
+
+void FutexContext::RequeueLocked(Bucket* wake_bucket, uintptr_t wake_key, uint32_t wake_count,
+                                 Bucket* requeue_bucket, uintptr_t requeue_key,
+                                 uint32_t requeue_count) {
+    DEBUG_ASSERT(wake_bucket->lock.lock().IsHeld());
+    DEBUG_ASSERT(requeue_bucket->lock.lock().IsHeld());
+
     // This must happen before RemoveFromHead() calls set_hash_key() on
-    // nodes below, because operations on futex_table_ look at the GetKey
+    // nodes below, because operations on futex_table look at the GetKey
     // field of the list head nodes for wake_key and requeue_key.
-    FutexNode* node = futex_table_.erase(wake_key);
+    FutexNode* node = wake_bucket->futex_table.erase(wake_key);
     if (!node) {
         // nothing blocked on this futex if we can't find it
-        return ZX_OK;
+        return;
     }
 
-    // This must come before WakeThreads() to be useful, but we want to
-    // avoid doing it before copy_from_user() in case that faults.
-    resched_disable.Disable();
-
     if (wake_count > 0) {
         node = FutexNode::WakeThreads(node, wake_count, wake_key);
     }
@@ -176,51 +250,56 @@ zx_status_t FutexContext::FutexRequeue(user_in_ptr<const int> wake_ptr, uint32_t
 
             // now requeue our nodes to requeue_ptr mutex
             DEBUG_ASSERT(requeue_head->GetKey() == requeue_key);
-            QueueNodesLocked(requeue_head);
+            QueueNodesLocked(requeue_bucket, requeue_head);
         }
     }
 
     // add any remaining nodes back to wake_key futex
     if (node != nullptr) {
         DEBUG_ASSERT(node->GetKey() == wake_key);
-        futex_table_.insert(node);
+        wake_bucket->futex_table.insert(node);
     }
-
-    return ZX_OK;
 }
 
-void FutexContext::QueueNodesLocked(FutexNode* head) {
-    DEBUG_ASSERT(lock_.lock().IsHeld());
+void FutexContext::QueueNodesLocked(Bucket* bucket, FutexNode* head) {
+    DEBUG_ASSERT(bucket->lock.lock().IsHeld());
 
-    FutexNode::HashTable::iterator iter;
+    FutexTable::iterator iter;
 
     // Attempt to insert this FutexNode into the hash table.  If the insert
     // succeeds, then the current thread is first to block on this futex and we
     // are finished.  If the insert fails, then there is already a thread
     // waiting on this futex.  Add ourselves to that thread's list.
-    if (!futex_table_.insert_or_find(head, &iter))
+    if (!bucket->futex_table.insert_or_find(head, &iter))
         iter->AppendList(head);
 }
 
 // This attempts to unqueue a thread (which may or may not be waiting on a
 // futex), given its FutexNode.  This returns whether the FutexNode was
 // found and removed from a futex wait queue.
-bool FutexContext::UnqueueNodeLocked(FutexNode* node) {
-    DEBUG_ASSERT(lock_.lock().IsHeld());
-
-    if (!node->IsInQueue())
-        return false;
-
-    // Note: When UnqueueNode() is called from FutexWait(), it might be
-    // tempting to reuse the futex key that was passed to FutexWait().
-    // However, that could be out of date if the thread was requeued by
-    // FutexRequeue(), so we need to re-get the hash table key here.
-    uintptr_t futex_key = node->GetKey();
-
-    FutexNode* old_head = futex_table_.erase(futex_key);
-    DEBUG_ASSERT(old_head);
-    FutexNode* new_head = FutexNode::RemoveNodeFromList(old_head, node);
-    if (new_head)
-        futex_table_.insert(new_head);
-    return true;
+bool FutexContext::UnqueueNode(FutexNode* node) {
+    for (;;) {
+        // Note: When UnqueueNode() is called from FutexWait(), it might be
+        // tempting to reuse the futex key that was passed to FutexWait().
+        // However, that could be out of date if the thread was requeued by
+        // FutexRequeue(), so we need to re-get the hash table key here.
+        // FutexRequeue() and FutexWake() change the key while holding the
+        // bucket lock for it, so check it again once that lock is held.
+        Bucket* bucket = GetBucket(node->GetKey());
+        Guard<fbl::Mutex> guard{&bucket->lock};
+        if (GetBucket(node->GetKey()) != bucket)
+            continue;
+
+        if (!node->IsInQueue())
+            return false;
+
+        uintptr_t futex_key = node->GetKey();
+
+        FutexNode* old_head = bucket->futex_table.erase(futex_key);
+        DEBUG_ASSERT(old_head);
+        FutexNode* new_head = FutexNode::RemoveNodeFromList(old_head, node);
+        if (new_head)
+            bucket->futex_table.insert(new_head);
+        return true;
+    }
 }
@@ -12,6 +12,7 @@
 #include <fbl/mutex.h>
 #include <platform.h>
 #include <trace.h>
+#include <kernel/sched.h>
 #include <kernel/thread_lock.h>
 #include <zircon/types.h>
 
@@ -25,6 +26,7 @@ FutexNode::~FutexNode() {
     LTRACE_ENTRY;
 
     DEBUG_ASSERT(!IsInQueue());
+    DEBUG_ASSERT(!lender_.owner);
 }
 
 bool FutexNode::IsInQueue() const {
@@ -146,7 +148,8 @@ FutexNode* FutexNode::RemoveFromHead(FutexNode* list_head, uint32_t count,
 // This blocks the current thread.  This releases the given mutex (which
 // must be held when BlockThread() is called).  To reduce contention, it
 // does not reclaim the mutex on return.
-zx_status_t FutexNode::BlockThread(Guard<fbl::Mutex>&& adopt_guard, zx_time_t deadline) {
+zx_status_t FutexNode::BlockThread(Guard<fbl::Mutex>&& adopt_guard, zx_time_t deadline,
+                                   ThreadDispatcher* owner) {
     // Adopt the guarded lock from the caller. This could happen before or after
     // the following locks because the underlying lock is held from the caller's
     // frame. The runtime validator state is not affected by the adoption.
@@ -155,12 +158,16 @@ zx_status_t FutexNode::BlockThread(Guard<fbl::Mutex>&& adopt_guard, zx_time_t de
     Guard<spin_lock_t, IrqSave> thread_lock_guard{ThreadLock::Get()};
     ThreadDispatcher::AutoBlocked by(ThreadDispatcher::Blocked::FUTEX);
 
+    thread_t* current_thread = get_current_thread();
+    if (owner) {
+        owner->AddFutexLenderLocked(this, sched_lendable_priority(current_thread));
+    }
+
     // We specifically want reschedule=MutexPolicy::NoReschedule here, otherwise
     // the combination of releasing the mutex and enqueuing the current thread
     // would not be atomic, which would mean that we could miss wakeups.
     guard.Release(MutexPolicy::ThreadLockHeld, MutexPolicy::NoReschedule);
 
-    thread_t* current_thread = get_current_thread();
     zx_status_t result;
     current_thread->interruptable = true;
     result = wait_queue_.Block(deadline);
@@ -169,16 +176,91 @@ zx_status_t FutexNode::BlockThread(Guard<fbl::Mutex>&& adopt_guard, zx_time_t de
     return result;
 }
 
+void FutexNode::PassOwnership(FutexNode* list_head) {
+    Guard<spin_lock_t, IrqSave> thread_lock_guard{ThreadLock::Get()};
+
+    bool local_resched = false;
+    for (FutexNode* node = list_head->queue_next_; node != list_head; node = node->queue_next_) {
+        if (node->inherit_priority_) {
+            node->StopLendingLocked(&local_resched);
+            node->LendPriorityLocked(list_head->waiter_,
+                                     sched_lendable_priority(node->waiter_));
+        }
+    }
+    // The new owner is still blocked, but an earlier owner of one of the
+    // waiters may be running here.
+    if (local_resched)
+        sched_reschedule();
+}
+
+void FutexNode::LendPriorityLocked(thread_t* owner, int priority) {
+    DEBUG_ASSERT(!lender_.owner);
+
+    lender_.owner = owner;
+    lender_.priority = priority;
+    list_add_tail(&owner->futex_lenders, &lender_.node);
+
+    // The lender is about to block, or the owner is, so there is no need to
+    // reschedule locally.
+    bool local_resched = false;
+    sched_inherit_futex_priority(owner, priority, &local_resched);
+}
+
+void FutexNode::StopLendingLocked(bool* local_resched) {
+    thread_t* owner = lender_.owner;
+    if (!owner)
+        return;
+
+    list_delete(&lender_.node);
+    lender_.owner = nullptr;
+    lender_.priority = -1;
+    RecomputeOwnerPriorityLocked(owner, local_resched);
+}
+
+void FutexNode::StopLending() {
+    Guard<spin_lock_t, IrqSave> thread_lock_guard{ThreadLock::Get()};
+
+    bool local_resched = false;
+    StopLendingLocked(&local_resched);
+    if (local_resched)
+        sched_reschedule();
+}
+
+void FutexNode::ReleaseLendersLocked(thread_t* owner, bool* local_resched) {
+    Lender* lender;
+    Lender* temp;
+    list_for_every_entry_safe (&owner->futex_lenders, lender, temp, Lender, node) {
+        list_delete(&lender->node);
+        lender->owner = nullptr;
+        lender->priority = -1;
+    }
+    sched_inherit_futex_priority(owner, -1, local_resched);
+}
+
+void FutexNode::RecomputeOwnerPriorityLocked(thread_t* owner, bool* local_resched) {
+    int priority = -1;
+    Lender* lender;
+    list_for_every_entry (&owner->futex_lenders, lender, Lender, node) {
+        if (lender->priority > priority)
+            priority = lender->priority;
+    }
+
+    // Passing -1 first lets the remaining lenders lower the priority.
+    sched_inherit_futex_priority(owner, -1, local_resched);
+    if (priority >= 0)
+        sched_inherit_futex_priority(owner, priority, local_resched);
+}
+
 void FutexNode::WakeThread() {
     // We must be careful to correctly handle the case where the thread
     // for |this| wakes and exits, deleting |this|.  There are two
     // cases to consider:
     //  1) The thread's wait times out, or the thread is killed or
     //     suspended.  In those cases, FutexWait() will reacquire the
-    //     FutexContext lock.  We are currently holding that lock, so
-    //     FutexWait() will not race with us.
+    //     lock of the futex's FutexContext bucket.  We are currently
+    //     holding that lock, so FutexWait() will not race with us.
     //  2) The thread is woken by our wait_queue_wake_one() call.  In
-    //     this case, FutexWait() will *not* reacquire the FutexContext
+    //     this case, FutexWait() will *not* reacquire the bucket
     //     lock.  To handle this correctly, we must not access |this|
     //     after wait_queue_wake_one().
 
@@ -0,0 +1,143 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <object/futex_node.h>
+
+#include <kernel/sched.h>
+#include <kernel/thread.h>
+#include <kernel/thread_lock.h>
+#include <lib/unittest/unittest.h>
+
+namespace {
+
+int idle_thread(void*) {
+    return 0;
+}
+
+// The threads are never resumed while the test looks at them, so changing
+// their priority doesn't move them between any queues.
+thread_t* create_thread(int priority) {
+    return thread_create("futex node test", idle_thread, nullptr, priority,
+                         DEFAULT_STACK_SIZE);
+}
+
+void join_thread(thread_t* t) {
+    thread_resume(t);
+    thread_join(t, nullptr, ZX_TIME_INFINITE);
+}
+
+int effective_priority(thread_t* t) {
+    Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+    return t->effec_priority;
+}
+
+// A thread woken alone from the head of a futex queue runs at the highest
+// priority among the waiters left behind that asked for inheritance. A waiter
+// that leaves takes its priority back, and the owner keeps what the rest lend
+// until it releases them.
+bool pass_ownership_test() {
+    BEGIN_TEST;
+
+    thread_t* owner = create_thread(LOW_PRIORITY);
+    thread_t* inheriting = create_thread(HIGH_PRIORITY);
+    thread_t* not_inheriting = create_thread(HIGHEST_PRIORITY);
+    thread_t* inheriting_default = create_thread(DEFAULT_PRIORITY);
+    ASSERT_NONNULL(owner, "");
+    ASSERT_NONNULL(inheriting, "");
+    ASSERT_NONNULL(not_inheriting, "");
+    ASSERT_NONNULL(inheriting_default, "");
+
+    FutexNode head;
+    FutexNode second;
+    FutexNode third;
+    FutexNode fourth;
+    head.set_waiter(owner, true);
+    second.set_waiter(not_inheriting, false);
+    third.set_waiter(inheriting, true);
+    fourth.set_waiter(inheriting_default, true);
+    head.SetAsSingletonList();
+    second.SetAsSingletonList();
+    third.SetAsSingletonList();
+    fourth.SetAsSingletonList();
+    head.AppendList(&second);
+    head.AppendList(&third);
+    head.AppendList(&fourth);
+
+    EXPECT_EQ(LOW_PRIORITY, effective_priority(owner), "");
+    FutexNode::PassOwnership(&head);
+    EXPECT_EQ(HIGH_PRIORITY, effective_priority(owner), "");
+
+    {
+        Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+        bool local_resched = false;
+
+        // Releasing a kernel mutex doesn't touch the futex boost.
+        sched_inherit_priority(owner, -1, &local_resched);
+        EXPECT_EQ(HIGH_PRIORITY, owner->effec_priority, "");
+
+        // The highest waiter timing out leaves the next highest's priority.
+        third.StopLendingLocked(&local_resched);
+        EXPECT_EQ(DEFAULT_PRIORITY, owner->effec_priority, "");
+
+        FutexNode::ReleaseLendersLocked(owner, &local_resched);
+        EXPECT_EQ(LOW_PRIORITY, owner->effec_priority, "");
+        EXPECT_TRUE(list_is_empty(&owner->futex_lenders), "");
+
+        // A released waiter has nothing left to take back.
+        fourth.StopLendingLocked(&local_resched);
+        EXPECT_EQ(LOW_PRIORITY, owner->effec_priority, "");
+    }
+
+    FutexNode* list = &head;
+    while (list != nullptr) {
+        list = FutexNode::RemoveNodeFromList(list, list);
+    }
+
+    join_thread(owner);
+    join_thread(inheriting);
+    join_thread(not_inheriting);
+    join_thread(inheriting_default);
+
+    END_TEST;
+}
+
+// Nothing is inherited when none of the remaining waiters asked for it.
+bool pass_ownership_without_inheritance_test() {
+    BEGIN_TEST;
+
+    thread_t* owner = create_thread(LOW_PRIORITY);
+    thread_t* waiter = create_thread(HIGH_PRIORITY);
+    ASSERT_NONNULL(owner, "");
+    ASSERT_NONNULL(waiter, "");
+
+    FutexNode head;
+    FutexNode second;
+    head.set_waiter(owner, true);
+    second.set_waiter(waiter, false);
+    head.SetAsSingletonList();
+    second.SetAsSingletonList();
+    head.AppendList(&second);
+
+    FutexNode::PassOwnership(&head);
+    EXPECT_EQ(LOW_PRIORITY, effective_priority(owner), "");
+
+    FutexNode* list = &head;
+    while (list != nullptr) {
+        list = FutexNode::RemoveNodeFromList(list, list);
+    }
+
+    join_thread(owner);
+    join_thread(waiter);
+
+    END_TEST;
+}
+
+} // namespace
+
+UNITTEST_START_TESTCASE(futex_node_tests)
+UNITTEST("pass ownership", pass_ownership_test)
+UNITTEST("pass ownership without inheritance", pass_ownership_without_inheritance_test)
+UNITTEST_END_TESTCASE(futex_node_tests, "futex_node", "FutexNode priority inheritance tests");
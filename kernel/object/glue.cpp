@@ -30,6 +30,9 @@
 
 #include <fbl/function.h>
 
+#include <vm/compression.h>
+#include <vm/scanner.h>
+
 #include <zircon/types.h>
 
 #define LOCAL_TRACE 0
@@ -115,6 +118,24 @@ private:
 // Called from a dedicated kernel thread when the system is low on memory.
 static void oom_lowmem(size_t shortfall_bytes) {
     printf("OOM: oom_lowmem(shortfall_bytes=%zu) called\n", shortfall_bytes);
+
+    // Decommitting pages that only hold zeroes is invisible to userspace, so
+    // try that before killing anything.
+    const size_t reclaimed_bytes = scanner_reclaim_zero_pages() * PAGE_SIZE;
+    printf("OOM: reclaimed %zu bytes of zero pages\n", reclaimed_bytes);
+    if (reclaimed_bytes >= shortfall_bytes) {
+        return;
+    }
+
+    // Next, compress cold pages if that is enabled.
+    const size_t remaining_pages =
+        ROUNDUP_PAGE_SIZE(shortfall_bytes - reclaimed_bytes) / PAGE_SIZE;
+    const size_t compressed_bytes = compression_reclaim_pages(remaining_pages) * PAGE_SIZE;
+    printf("OOM: reclaimed %zu bytes by compressing pages\n", compressed_bytes);
+    if (reclaimed_bytes + compressed_bytes >= shortfall_bytes) {
+        return;
+    }
+
     printf("OOM: Process mapped committed bytes:\n");
     DumpProcessMemoryUsage("OOM:   ", /*min_pages=*/8 * MB / PAGE_SIZE);
     printf("OOM: Finding a job to kill...\n");
@@ -7,7 +7,9 @@
 #include <object/handle.h>
 
 #include <object/dispatcher.h>
+#include <arch/ops.h>
 #include <fbl/arena.h>
+#include <fbl/atomic.h>
 #include <fbl/mutex.h>
 #include <lib/counters.h>
 #include <pow2.h>
@@ -32,7 +34,8 @@ KCOUNTER(handle_count_freed, "kernel.handles.freed");
 //   [31..30]: Must be zero
 //   [29..kHandleGenerationShift]: Generation number
 //                                 Masked by kHandleGenerationMask
-//   [kHandleGenerationShift-1..0]: Index into handle_arena
+//   [kHandleGenerationShift-1..0]: Index into the handle arena, whose
+//                                  top bits select the arena shard
 //                                  Masked by kHandleIndexMask
 constexpr uint32_t kHandleIndexMask = kMaxHandleCount - 1;
 static_assert((kHandleIndexMask & kMaxHandleCount) == 0,
@@ -48,20 +51,40 @@ static_assert(((3 << 30) ^ kHandleGenerationMask ^ kHandleIndexMask) ==
                   0xffffffffu,
               "Masks do not agree");
 
+// The handle arena is split into Handle::kArenaShards equal shards, each
+// owning a contiguous range of indices.
+constexpr uint32_t kShardCount = 8;
+constexpr uint32_t kShardHandleCount = kMaxHandleCount / kShardCount;
+constexpr uint32_t kShardShift = log2_uint_floor(kShardHandleCount);
+constexpr uint32_t kShardSlotMask = kShardHandleCount - 1;
+
+// The number of outstanding handles across all shards, for diagnostics.
+fbl::atomic<size_t> outstanding_handles;
+
 }  // namespace
 
-fbl::Arena Handle::arena_;
+Handle::ArenaShard Handle::arena_shards_[Handle::kArenaShards];
 
 void Handle::Init() TA_NO_THREAD_SAFETY_ANALYSIS {
-    arena_.Init("handles", sizeof(Handle), kMaxHandleCount);
+    static_assert(kArenaShards == kShardCount, "Shard counts do not agree");
+    for (auto& shard : arena_shards_) {
+        shard.arena.Init("handles", sizeof(Handle), kShardHandleCount);
+    }
 }
 
-// Returns a new |base_value| based on the value stored in the free
-// arena slot pointed to by |addr|. The new value will be different
-// from the last |base_value| used by this slot.
-uint32_t Handle::GetNewBaseValue(void* addr) TA_REQ(ArenaLock::Get()) {
-    // Get the index of this slot within the arena.
-    uint32_t handle_index = HandleToIndex(reinterpret_cast<Handle*>(addr));
+// Allocates a free slot from this shard and computes a new |base_value| based
+// on the value stashed in it. The new value will be different from the last
+// |base_value| used by this slot.
+void* Handle::ArenaShard::Alloc(uint32_t shard_index, uint32_t* base_value) {
+    Guard<fbl::Mutex> guard{&lock};
+    void* addr = arena.Alloc();
+    if (unlikely(!addr))
+        return nullptr;
+
+    // Get the index of this slot within the whole arena.
+    const uint32_t slot = static_cast<uint32_t>(
+        reinterpret_cast<Handle*>(addr) - reinterpret_cast<Handle*>(arena.start()));
+    const uint32_t handle_index = (shard_index << kShardShift) | slot;
     DEBUG_ASSERT((handle_index & ~kHandleIndexMask) == 0);
 
     // Check the free memory for a stashed base_value.
@@ -74,7 +97,20 @@ uint32_t Handle::GetNewBaseValue(void* addr) TA_REQ(ArenaLock::Get()) {
     }
     uint32_t new_gen =
         (((old_gen + 1) << kHandleGenerationShift) & kHandleGenerationMask);
-    return (handle_index | new_gen);
+    *base_value = handle_index | new_gen;
+    return addr;
+}
+
+// The lock can't be skipped here even though arena.start() never changes:
+// freeing the top slot can decommit the pages above it, so in_range() has to
+// be checked against the arena's current top.
+Handle* Handle::ArenaShard::SlotToHandle(uint32_t slot) {
+    Guard<fbl::Mutex> guard{&lock};
+    uintptr_t handle_addr =
+        reinterpret_cast<uintptr_t>(arena.start()) + slot * sizeof(Handle);
+    if (unlikely(!arena.in_range(handle_addr)))
+        return nullptr;
+    return reinterpret_cast<Handle*>(handle_addr);
 }
 
 // Allocate space for a Handle from the arena, but don't instantiate the
@@ -82,27 +118,26 @@ uint32_t Handle::GetNewBaseValue(void* addr) TA_REQ(ArenaLock::Get()) {
 // says whether this is allocation or duplication, for the error message.
 void* Handle::Alloc(const fbl::RefPtr<Dispatcher>& dispatcher,
                     const char* what, uint32_t* base_value) {
-    size_t outstanding_handles;
-    {
-        Guard<fbl::Mutex> guard{ArenaLock::Get()};
-        void* addr = arena_.Alloc();
-        outstanding_handles = arena_.DiagnosticCount();
+    // Start with the current CPU's shard and fall back on the others when
+    // it's full, so the whole arena stays usable.
+    const uint32_t first = arch_curr_cpu_num() % kArenaShards;
+    for (uint32_t i = 0; i < kArenaShards; i++) {
+        const uint32_t shard_index = (first + i) % kArenaShards;
+        void* addr = arena_shards_[shard_index].Alloc(shard_index, base_value);
         if (likely(addr)) {
-            if (outstanding_handles > kHighHandleCount) {
+            size_t count = outstanding_handles.fetch_add(1) + 1;
+            if (unlikely(count > kHighHandleCount)) {
                 // TODO: Avoid calling this for every handle after
-                // kHighHandleCount; printfs are slow and we're
-                // holding the mutex.
-                printf("WARNING: High handle count: %zu handles\n",
-                       outstanding_handles);
+                // kHighHandleCount; printfs are slow.
+                printf("WARNING: High handle count: %zu handles\n", count);
             }
             dispatcher->increment_handle_count();
-            *base_value = GetNewBaseValue(addr);
             return addr;
         }
     }
 
     printf("WARNING: Could not allocate %s handle (%zu outstanding)\n",
-           what, outstanding_handles);
+           what, outstanding_handles.load());
     return nullptr;
 }
 
@@ -146,7 +181,7 @@ Handle::Handle(Handle* rhs, zx_rights_t rights, uint32_t base_value)
 // Destroys, but does not free, the Handle, and fixes up its memory to protect
 // against stale pointers to it. Also stashes the Handle's base_value for reuse
 // the next time this slot is allocated.
-void Handle::TearDown() TA_EXCL(ArenaLock::Get()) {
+void Handle::TearDown() {
     uint32_t old_base_value = base_value();
 
     // Calling the handle dtor can cause many things to happen, so it is
@@ -171,18 +206,19 @@ void Handle::TearDown() TA_EXCL(ArenaLock::Get()) {
 
 void Handle::Delete() {
     fbl::RefPtr<Dispatcher> disp = dispatcher();
+    ArenaShard& shard = arena_shards_[(base_value() & kHandleIndexMask) >> kShardShift];
 
     if (disp->has_state_tracker())
         disp->Cancel(this);
 
     TearDown();
 
-    bool zero_handles = false;
+    bool zero_handles = disp->decrement_handle_count();
     {
-        Guard<fbl::Mutex> guard{ArenaLock::Get()};
-        zero_handles = disp->decrement_handle_count();
-        arena_.Free(this);
+        Guard<fbl::Mutex> guard{&shard.lock};
+        shard.arena.Free(this);
     }
+    outstanding_handles.fetch_sub(1);
 
     if (zero_handles)
         disp->on_zero_handles();
@@ -192,29 +228,25 @@ void Handle::Delete() {
     kcounter_add(handle_count_freed, 1);
 }
 
-Handle* Handle::FromU32(uint32_t value) TA_NO_THREAD_SAFETY_ANALYSIS {
-    uintptr_t handle_addr = IndexToHandle(value & kHandleIndexMask);
-    {
-        Guard<fbl::Mutex> guard{ArenaLock::Get()};
-        if (unlikely(!arena_.in_range(handle_addr)))
-            return nullptr;
-    }
-    auto handle = reinterpret_cast<Handle*>(handle_addr);
+Handle* Handle::FromU32(uint32_t value) {
+    const uint32_t index = value & kHandleIndexMask;
+    Handle* handle = arena_shards_[index >> kShardShift].SlotToHandle(index & kShardSlotMask);
+    if (unlikely(!handle))
+        return nullptr;
     return likely(handle->base_value() == value) ? handle : nullptr;
 }
 
 uint32_t Handle::Count(const fbl::RefPtr<const Dispatcher>& dispatcher) {
-    // Handle::ArenaLock also guards Dispatcher::handle_count_.
-    Guard<fbl::Mutex> guard{ArenaLock::Get()};
     return dispatcher->current_handle_count();
 }
 
 size_t Handle::diagnostics::OutstandingHandles() {
-    Guard<fbl::Mutex> guard{ArenaLock::Get()};
-    return arena_.DiagnosticCount();
+    return outstanding_handles.load();
 }
 
 void Handle::diagnostics::DumpTableInfo() {
-    Guard<fbl::Mutex> guard{ArenaLock::Get()};
-    arena_.Dump();
+    for (auto& shard : arena_shards_) {
+        Guard<fbl::Mutex> guard{&shard.lock};
+        shard.arena.Dump();
+    }
 }
@@ -19,6 +19,8 @@
 #include <fbl/ref_counted.h>
 #include <fbl/unique_ptr.h>
 
+class ThreadDispatcher;
+
 class ChannelDispatcher final : public PeeredDispatcher<ChannelDispatcher> {
 public:
     class MessageWaiter;
@@ -41,6 +43,10 @@ public:
                      fbl::unique_ptr<MessagePacket>* msg,
                      bool may_disard);
 
+    // Puts |msg|, just taken by Read(), back at the head of this endpoint's
+    // message queue, for when it could not be copied out to the reader.
+    void Unread(fbl::unique_ptr<MessagePacket> msg);
+
     // Write to the opposing endpoint's message queue.
     zx_status_t Write(fbl::unique_ptr<MessagePacket> msg) TA_NO_THREAD_SAFETY_ANALYSIS;
     zx_status_t Call(fbl::unique_ptr<MessagePacket> msg, zx_time_t deadline,
@@ -51,6 +57,13 @@ public:
     zx_status_t ResumeInterruptedCall(MessageWaiter* waiter, zx_time_t deadline,
                                       fbl::unique_ptr<MessagePacket>* reply);
 
+    // Called by the thread that has just read |msg| from this endpoint. If
+    // |msg| is a call made with ZX_CHANNEL_CALL_INHERIT_PRIORITY whose caller
+    // is still waiting, the thread runs at the caller's priority until that
+    // wait ends. Any priority the thread was lent by an earlier call is given
+    // back either way.
+    void InheritCallPriority(const MessagePacket& msg) TA_NO_THREAD_SAFETY_ANALYSIS;
+
     // Returns the maximum depth this channel endpoint will queue
     // messages to. This value is accessible to userspace via the
     // ZX_PROP_CHANNEL_TX_MSG_MAX object property.
@@ -79,11 +92,20 @@ public:
         fbl::RefPtr<ChannelDispatcher> get_channel() { return channel_; }
         zx_txid_t get_txid() const { return txid_; }
         void set_txid(zx_txid_t txid) { txid_ = txid; };
+        bool lends_priority() const { return lends_priority_; }
+        void set_lends_priority(bool lends) { lends_priority_ = lends; }
         zx_status_t Wait(zx_time_t deadline);
         // Returns any delivered message via out and the status.
         zx_status_t EndWait(fbl::unique_ptr<MessagePacket>* out);
 
     private:
+        friend class ChannelDispatcher;
+        friend class ThreadDispatcher;
+
+        // Gives back the priority this call lent, if it is still lent. Called
+        // whenever the wait ends, however it ends.
+        void EndLoan();
+
         fbl::RefPtr<ChannelDispatcher> channel_;
         fbl::unique_ptr<MessagePacket> msg_;
         // TODO(teisenbe/swetland): Investigate hoisting this outside to reduce
@@ -91,6 +113,11 @@ public:
         Event event_;
         zx_txid_t txid_;
         zx_status_t status_;
+
+        // Whether the call was made with ZX_CHANNEL_CALL_INHERIT_PRIORITY, and
+        // the thread serving it at the caller's priority, if any.
+        bool lends_priority_ = false;
+        ThreadDispatcher* borrower_ TA_GUARDED(thread_lock) = nullptr;
     };
 
     // PeeredDispatcher implementation.
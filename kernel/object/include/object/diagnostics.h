@@ -13,6 +13,7 @@
 
 class ProcessDispatcher;
 class VmAspace;
+class VmObject;
 
 // Walks the VmAspace and writes entries that describe it into |maps|, which
 // must point to enough memory for |max| entries. The number of entries
@@ -44,6 +45,16 @@ zx_status_t GetProcessVmosViaHandles(ProcessDispatcher* process,
                                      user_out_ptr<zx_info_vmo_t> vmos, size_t max,
                                      size_t* actual, size_t* available);
 
+// Fills |info| with an estimate of how much of the committed memory of |vmo|
+// has been recently accessed.
+void GetVmoWorkingSet(const VmObject* vmo, zx_info_working_set_t* info);
+
+// Fills |info| with an estimate of how much of the committed memory mapped
+// into the VmAspace has been recently accessed. Does not take sharing into
+// account.
+zx_status_t GetVmAspaceWorkingSet(fbl::RefPtr<VmAspace> aspace,
+                                  zx_info_working_set_t* info);
+
 // Prints (with the supplied prefix) the number of mapped, committed bytes for
 // each process in the system whose page count > |min_pages|. Does not take
 // sharing into account, and does not count unmapped VMOs.
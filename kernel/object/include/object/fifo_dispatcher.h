@@ -14,6 +14,7 @@
 #include <fbl/canary.h>
 #include <fbl/mutex.h>
 #include <fbl/ref_counted.h>
+#include <lib/user_copy/user_iovec.h>
 #include <lib/user_copy/user_ptr.h>
 
 class FifoDispatcher final : public PeeredDispatcher<FifoDispatcher> {
@@ -33,6 +34,12 @@ public:
     zx_status_t ReadToUser(size_t elem_size, user_out_ptr<uint8_t> dst, size_t count,
                            size_t* actual);
 
+    // Vectored variants of the above. The buffers are treated as one array of
+    // entries, so an entry may span two buffers, but their combined size must
+    // be a multiple of |elem_size|.
+    zx_status_t WriteFromUser(size_t elem_size, user_iovec* src, size_t* actual);
+    zx_status_t ReadToUser(size_t elem_size, user_iovec* dst, size_t* actual);
+
     // PeeredDispatcher implementation.
     void on_zero_handles_locked() TA_REQ(get_lock());
     void OnPeerZeroHandlesLocked() TA_REQ(get_lock());
@@ -42,8 +49,8 @@ private:
                    uint32_t options, uint32_t elem_count, uint32_t elem_size,
                    fbl::unique_ptr<uint8_t[]> data);
     void Init(fbl::RefPtr<FifoDispatcher> other);
-    zx_status_t WriteSelfLocked(size_t elem_size, user_in_ptr<const uint8_t> ptr, size_t count,
-                                size_t* actual) TA_REQ(get_lock());
+    zx_status_t WriteSelfLocked(size_t elem_size, user_iovec* src, size_t* actual)
+        TA_REQ(get_lock());
     zx_status_t UserSignalSelfLocked(uint32_t clear_mask, uint32_t set_mask) TA_REQ(get_lock());
 
     fbl::Canary<fbl::magic("FIFO")> canary_;
@@ -8,13 +8,17 @@
 
 #include <lib/user_copy/user_ptr.h>
 #include <zircon/types.h>
+#include <fbl/intrusive_hash_table.h>
 #include <fbl/mutex.h>
 #include <kernel/lockdep.h>
 #include <object/futex_node.h>
 
+class ThreadDispatcher;
+
 // FutexContext is a class that encapsulates support for futex operations.
 // FutexContext uses a hash table keyed on the futex address (a pointer to integer in userspace)
-// to contain all active futexes.
+// to contain all active futexes. The table is split into buckets by futex address, each with
+// its own lock, so that threads using unrelated futexes don't contend with each other.
 // A futex is considered active if there is one or more threads blocked on the futex.
 // After no threads are left blocked on a futex it is removed from the hash table.
 // The value in the futex hash table is the FutexNode object associated with the head
@@ -34,9 +38,14 @@ public:
     // Otherwise it will block the current thread until the |deadline| passes,
     // or until the thread is woken by a FutexWake or FutexRequeue operation
     // on the same |value_ptr| futex.
-    zx_status_t FutexWait(user_in_ptr<const int> value_ptr, int current_value, zx_time_t deadline);
+    // If |owner| is non-null, it is the thread that owns the futex and it inherits the
+    // priority of the current thread until it next wakes a futex. A FutexWake that wakes
+    // a single such waiter passes the priority of the remaining waiters on to it.
+    zx_status_t FutexWait(user_in_ptr<const int> value_ptr, int current_value, zx_time_t deadline,
+                          ThreadDispatcher* owner);
 
     // FutexWake will wake up to |count| number of threads blocked on the |value_ptr| futex.
+    // The current thread gives up any priority it inherited through futexes.
     zx_status_t FutexWake(user_in_ptr<const int> value_ptr, uint32_t count);
 
     // FutexWait first verifies that the integer pointed to by |wake_ptr|
@@ -52,14 +61,39 @@ private:
     FutexContext(const FutexContext&) = delete;
     FutexContext& operator=(const FutexContext&) = delete;
 
-    void QueueNodesLocked(FutexNode* head) TA_REQ(lock_);
+    // Each bucket keeps a small table of its own. The bucket is picked from
+    // the high bits of the hash and the chain within it from the low bits, so
+    // futexes that share a lock still spread over the chains.
+    static constexpr size_t kNumTableBuckets = 8;
+    using FutexTable = fbl::HashTable<uintptr_t, FutexNode*,
+                                      fbl::SinglyLinkedList<FutexNode*>, size_t,
+                                      kNumTableBuckets>;
+
+    struct Bucket {
+        DECLARE_MUTEX(Bucket) lock;
+
+        // Key is futex address, value is the FutexNode for the head of futex's blocked
+        // thread list.
+        FutexTable futex_table TA_GUARDED(lock);
+    };
+
+    static constexpr size_t kNumBuckets = 32;
+
+    Bucket* GetBucket(uintptr_t futex_key) {
+        return &buckets_[(FutexNode::GetHash(futex_key) >> 32) % kNumBuckets];
+    }
+
+    // Wakes waiters on |wake_key| and moves others to |requeue_key|. Both buckets must be
+    // locked, and may be the same bucket. The locks may be held by a GuardMultiple, which
+    // the thread safety analysis can't see through.
+    static void RequeueLocked(Bucket* wake_bucket, uintptr_t wake_key, uint32_t wake_count,
+                              Bucket* requeue_bucket, uintptr_t requeue_key,
+                              uint32_t requeue_count) TA_NO_THREAD_SAFETY_ANALYSIS;
 
-    bool UnqueueNodeLocked(FutexNode* node) TA_REQ(lock_);
+    static void QueueNodesLocked(Bucket* bucket, FutexNode* head) TA_REQ(bucket->lock);
 
-    // protects futex_table_
-    DECLARE_MUTEX(FutexContext) lock_;
+    // Locks the bucket |node| is queued in and removes it, if it is still queued.
+    bool UnqueueNode(FutexNode* node);
 
-    // Hash table for futexes in this context.
-    // Key is futex address, value is the FutexNode for the head of futex's blocked thread list.
-    FutexNode::HashTable futex_table_ TA_GUARDED(lock_);
+    Bucket buckets_[kNumBuckets];
 };
@@ -6,14 +6,18 @@
 
 #pragma once
 
+#include <hash.h>
 #include <kernel/lockdep.h>
 #include <kernel/thread.h>
+#include <kernel/thread_lock.h>
 #include <kernel/wait.h>
 #include <list.h>
 #include <zircon/types.h>
 #include <fbl/intrusive_hash_table.h>
 #include <fbl/mutex.h>
 
+class ThreadDispatcher;
+
 // Node for linked list of threads blocked on a futex
 // Intended to be embedded within a ThreadDispatcher Instance
 class FutexNode : public fbl::SinglyLinkedListable<FutexNode*> {
@@ -42,19 +46,56 @@ public:
                                      uintptr_t old_hash_key,
                                      uintptr_t new_hash_key);
 
+    // Called before the head of |list_head| is woken alone: the waiters left
+    // behind it that asked for priority inheritance lend their priority to
+    // the woken thread instead, since it is about to own the futex.
+    static void PassOwnership(FutexNode* list_head);
+
     // This must be called with a guard held in the calling scope. Releases the
-    // guard and does not reacquire it.
-    zx_status_t BlockThread(Guard<fbl::Mutex>&& adopt_guard, zx_time_t deadline);
+    // guard and does not reacquire it. If |owner| is non-null it inherits the
+    // priority of the current thread while the current thread is blocked.
+    zx_status_t BlockThread(Guard<fbl::Mutex>&& adopt_guard, zx_time_t deadline,
+                            ThreadDispatcher* owner);
+
+    // Lends |priority| to |owner|, which runs at no less than the highest
+    // priority lent to it until its lenders stop lending or are released.
+    void LendPriorityLocked(thread_t* owner, int priority) TA_REQ(thread_lock);
+
+    // Takes back the priority this node lent, if any, and recomputes its
+    // owner's priority from the lenders that remain. The waiter calls
+    // StopLending() once its node has left the futex queue, however it left.
+    void StopLendingLocked(bool* local_resched) TA_REQ(thread_lock);
+    void StopLending();
+
+    // Detaches every node lending to |owner| and drops its futex priority,
+    // when |owner| wakes a futex or exits.
+    static void ReleaseLendersLocked(thread_t* owner, bool* local_resched) TA_REQ(thread_lock);
 
     void set_hash_key(uintptr_t key) {
         hash_key_ = key;
     }
 
+    // Records the thread that is about to block on this node, and whether it
+    // asked for priority inheritance.
+    void set_waiter(thread_t* thread, bool inherit_priority) {
+        waiter_ = thread;
+        inherit_priority_ = inherit_priority;
+    }
+
+    bool inherit_priority() const { return inherit_priority_; }
+
     // Trait implementation for fbl::HashTable
     uintptr_t GetKey() const { return hash_key_; }
-    static size_t GetHash(uintptr_t key) { return (key >> 3); }
+    // Futex addresses are aligned and tend to cluster within a few pages, so
+    // their bits are mixed before being reduced to a bucket index.
+    static size_t GetHash(uintptr_t key) {
+        return static_cast<size_t>(hash_mix64(key));
+    }
 
 private:
+    static void RecomputeOwnerPriorityLocked(thread_t* owner, bool* local_resched)
+        TA_REQ(thread_lock);
+
     static void RelinkAsAdjacent(FutexNode* node1, FutexNode* node2);
     static void SpliceNodes(FutexNode* node1, FutexNode* node2);
 
@@ -80,4 +121,19 @@ private:
     //  * When the thread is not waiting on a futex, queue_next_ is null.
     FutexNode* queue_prev_ = nullptr;
     FutexNode* queue_next_ = nullptr;
+
+    // The thread blocked on this node. It stays valid for as long as the node
+    // is in a queue, since the thread must take the futex bucket lock to
+    // leave the queue on its own.
+    thread_t* waiter_ = nullptr;
+    bool inherit_priority_ = false;
+
+    // The thread this node lends its waiter's priority to, if any, and the
+    // priority lent. |node| is the entry in that thread's futex_lenders list.
+    struct Lender {
+        struct list_node node = LIST_INITIAL_CLEARED_VALUE;
+        thread_t* owner = nullptr;
+        int priority = -1;
+    };
+    Lender lender_ TA_GUARDED(thread_lock);
 };
@@ -146,12 +146,11 @@ private:
     // Private subroutines of Make and Dup.
     static void* Alloc(const fbl::RefPtr<Dispatcher>&, const char* what,
                        uint32_t* base_value);
-    static uint32_t GetNewBaseValue(void* addr);
 
     // Handle should never be destroyed by anything other than Delete,
     // which uses TearDown to do the actual destruction.
     ~Handle() = default;
-    void TearDown() TA_EXCL(ArenaLock::Get());
+    void TearDown();
     void Delete();
 
     // Only HandleOwner is allowed to call Delete.
@@ -165,20 +164,24 @@ private:
     const zx_rights_t rights_;
     const uint32_t base_value_;
 
-    // The handle arena and its mutex; also guards Dispatcher::handle_count_.
-    DECLARE_SINGLETON_MUTEX(ArenaLock);
-    static fbl::Arena TA_GUARDED(ArenaLock::Get()) arena_;
+    // The handle arena is split into shards, each covering a contiguous
+    // range of handle indices and guarded by its own mutex, so that handle
+    // creation and lookup on different CPUs don't serialize on one lock.
+    struct ArenaShard {
+        DECLARE_MUTEX(ArenaShard) lock;
+        fbl::Arena arena TA_GUARDED(lock);
 
-    // NOTE! This can return an invalid address.  It must be checked
-    // against the arena bounds before being cast to a Handle*.
-    static uintptr_t IndexToHandle(uint32_t index) TA_NO_THREAD_SAFETY_ANALYSIS {
-        return reinterpret_cast<uintptr_t>(arena_.start()) + index * sizeof(Handle);
-    }
+        // Allocates a slot and returns a new base_value for it, or nullptr
+        // if this shard is full. |shard_index| is the index of this shard.
+        void* Alloc(uint32_t shard_index, uint32_t* base_value);
 
-    static uint32_t HandleToIndex(Handle* handle) TA_NO_THREAD_SAFETY_ANALYSIS {
-        return static_cast<uint32_t>(
-            handle - reinterpret_cast<Handle*>(arena_.start()));
-    }
+        // Returns the Handle at |slot| within this shard, or nullptr if that
+        // slot has never been allocated.
+        Handle* SlotToHandle(uint32_t slot);
+    };
+
+    static constexpr uint32_t kArenaShards = 8;
+    static ArenaShard arena_shards_[kArenaShards];
 };
 
 // This can't be defined direclty in the HandleOwner class definition
@@ -8,7 +8,7 @@
 
 #include <stdint.h>
 
-#include <lib/user_copy/user_ptr.h>
+#include <lib/user_copy/user_iovec.h>
 #include <zircon/types.h>
 #include <fbl/intrusive_single_list.h>
 
@@ -21,12 +21,14 @@ public:
     MBufChain() = default;
     ~MBufChain();
 
-    // Writes |len| bytes of stream data from |src| and sets |written| to number of bytes written.
+    // Writes the bytes of stream data described by |src| and sets |written| to number of bytes
+    // written.
     //
     // Returns an error on failure.
-    zx_status_t WriteStream(user_in_ptr<const void> src, size_t len, size_t* written);
+    zx_status_t WriteStream(user_iovec* src, size_t* written);
 
-    // Writes a datagram of |len| bytes from |src| and sets |written| to number of bytes written.
+    // Writes a datagram made of all the bytes described by |src| and sets |written| to number of
+    // bytes written.
     //
     // This operation is atomic in that either the entire datagram is written successfully or the
     // chain is unmodified.
@@ -34,18 +36,18 @@ public:
     // Writing a zero-length datagram is an error.
     //
     // Returns an error on failure.
-    zx_status_t WriteDatagram(user_in_ptr<const void> src, size_t len, size_t* written);
+    zx_status_t WriteDatagram(user_iovec* src, size_t* written);
 
-    // Reads upto |len| bytes from chain into |dst|.
+    // Reads upto dst->total() bytes from chain into the buffers described by |dst|.
     //
     // When |datagram| is false, the data in the chain is treated as a stream (no boundaries).
     //
     // When |datagram| is true, the data in the chain is treated as a sequence of datagrams and the
-    // call will read at most one datagram.  If |len| is too small to read a complete datagram, a
+    // call will read at most one datagram.  If |dst| is too small to read a complete datagram, a
     // partial datagram is returned and its remaining bytes are discarded.
     //
     // Returns number of bytes read.
-    size_t Read(user_out_ptr<void> dst, size_t len, bool datagram);
+    size_t Read(user_iovec* dst, bool datagram);
 
     bool is_full() const;
     bool is_empty() const;
@@ -54,7 +56,14 @@ public:
     size_t size() const { return size_; }
 
     // Returns the maximum number of bytes that can be stored in the chain.
-    size_t max_size() const { return kSizeMax; }
+    size_t max_size() const { return max_size_; }
+
+    // Sets the maximum number of bytes that can be stored in the chain. Data already in the chain
+    // is kept if it's over the new maximum; the chain stays full until enough of it is read.
+    //
+    // Returns ZX_ERR_OUT_OF_RANGE unless |max_size| is between one MBuf's payload and
+    // kSizeLimit.
+    zx_status_t set_max_size(size_t max_size);
 
 private:
     // An MBuf is a small fixed-size chainable memory buffer.
@@ -82,7 +91,9 @@ private:
     };
     static_assert(sizeof(MBuf) == MBuf::kMallocSize, "");
 
+    // The default and largest values of max_size_.
     static constexpr size_t kSizeMax = 128 * MBuf::kPayloadSize;
+    static constexpr size_t kSizeLimit = 2048 * MBuf::kPayloadSize;
 
     MBuf* AllocMBuf();
     void FreeMBuf(MBuf* buf);
@@ -91,4 +102,5 @@ private:
     fbl::SinglyLinkedList<MBuf*> tail_;
     MBuf* head_ = nullptr;;
     size_t size_ = 0u;
+    size_t max_size_ = kSizeMax;
 };
@@ -38,11 +38,21 @@ public:
                               uint32_t num_handles,
                               fbl::unique_ptr<MessagePacket>* msg);
 
+    // Creates a message packet whose |data_size| bytes of payload are the
+    // leading bytes of |pages|, as returned by VmObject::TakePages(), rather
+    // than a copy. Always takes ownership of the pages.
+    static zx_status_t CreateFromPages(list_node* pages, uint32_t data_size,
+                                       uint32_t num_handles,
+                                       fbl::unique_ptr<MessagePacket>* msg);
+
     uint32_t data_size() const { return data_size_; }
 
     // Copies the packet's |data_size()| bytes to |buf|.
     // Returns an error if |buf| points to a bad user address.
     zx_status_t CopyDataTo(user_out_ptr<void> buf) const {
+        if (unlikely(!list_is_empty(&pages_))) {
+            return CopyPagesTo(buf);
+        }
         return buffer_chain_->CopyOut(buf, payload_offset_, data_size_);
     }
 
@@ -59,22 +69,27 @@ public:
             return 0;
         }
         // The first few bytes of the payload are a zx_txid_t.
-        void* payload_start = buffer_chain_->buffers()->front().data() + payload_offset_;
-        return *reinterpret_cast<zx_txid_t*>(payload_start);
+        return *reinterpret_cast<zx_txid_t*>(payload_start());
     }
 
     void set_txid(zx_txid_t txid) {
         if (data_size_ >= sizeof(zx_txid_t)) {
-            void* payload_start = buffer_chain_->buffers()->front().data() + payload_offset_;
-            *(reinterpret_cast<zx_txid_t*>(payload_start)) = txid;
+            *(reinterpret_cast<zx_txid_t*>(payload_start())) = txid;
         }
     }
 
+    // The priority the thread reading a call lends from the caller, set by
+    // zx_channel_call() with ZX_CHANNEL_CALL_INHERIT_PRIORITY. -1 if none.
+    int priority() const { return priority_; }
+    void set_priority(int priority) { priority_ = priority; }
+
 private:
     MessagePacket(BufferChain* chain, uint32_t data_size, uint32_t payload_offset,
                   uint16_t num_handles, Handle** handles)
         : buffer_chain_(chain), handles_(handles), data_size_(data_size),
-          payload_offset_(payload_offset), num_handles_(num_handles), owns_handles_(false) {}
+          payload_offset_(payload_offset), num_handles_(num_handles), owns_handles_(false) {
+        list_initialize(&pages_);
+    }
 
     friend class fbl::unique_ptr<MessagePacket>;
     ~MessagePacket() {
@@ -90,13 +105,27 @@ private:
     friend class fbl::Recyclable<MessagePacket>;
     void fbl_recycle();
 
-    static zx_status_t CreateCommon(uint32_t data_size, uint32_t num_handles,
+    static zx_status_t CreateCommon(uint32_t data_size, uint32_t num_handles, bool inline_data,
                                     fbl::unique_ptr<MessagePacket>* msg);
 
+    zx_status_t CopyPagesTo(user_out_ptr<void> buf) const;
+
+    char* payload_start() const {
+        if (!list_is_empty(&pages_)) {
+            const vm_page* page = containerof(pages_.next, vm_page, queue_node);
+            return static_cast<char*>(paddr_to_physmap(page->paddr()));
+        }
+        return buffer_chain_->buffers()->front().data() + payload_offset_;
+    }
+
     BufferChain* buffer_chain_;
+    // Holds the payload instead of |buffer_chain_| if the packet was created
+    // with CreateFromPages().
+    list_node pages_;
     Handle** const handles_;
     const uint32_t data_size_;
     const uint32_t payload_offset_;
     const uint16_t num_handles_;
     bool owns_handles_;
+    int priority_ = -1;
 };
@@ -15,6 +15,7 @@
 #include <fbl/canary.h>
 #include <fbl/intrusive_double_list.h>
 #include <fbl/mutex.h>
+#include <fbl/slab_allocator.h>
 #include <fbl/unique_ptr.h>
 #include <kernel/spinlock.h>
 
@@ -87,7 +88,13 @@ struct PortAllocator {
     virtual void Free(PortPacket* port_packet) = 0;
 };
 
-struct PortPacket final : public fbl::DoublyLinkedListable<PortPacket*> {
+// Non-ephemeral packets, such as those from zx_port_queue(), come from slabs
+// on the kernel heap. See PortDispatcher::DefaultPortAllocator().
+using PortPacketAllocatorTraits =
+    fbl::ManualDeleteSlabAllocatorTraits<PortPacket*, fbl::DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE>;
+
+struct PortPacket final : public fbl::DoublyLinkedListable<PortPacket*>,
+                          public fbl::SlabAllocated<PortPacketAllocatorTraits> {
     zx_port_packet_t packet;
     const void* const handle;
     PortObserver* observer;
@@ -176,6 +183,10 @@ public:
     zx_status_t QueueUser(const zx_port_packet_t& packet);
     bool QueueInterruptPacket(PortInterruptPacket* port_packet, zx_time_t timestamp);
     zx_status_t Dequeue(zx_time_t deadline, zx_port_packet_t* packet);
+    // Dequeues up to |count| packets into |packets|, blocking until |deadline|
+    // only if none are queued. Returns the number dequeued in |actual|.
+    zx_status_t DequeueMany(zx_time_t deadline, zx_port_packet_t* packets, size_t count,
+                            size_t* actual);
     bool RemoveInterruptPacket(PortInterruptPacket* port_packet);
 
     // Decides who is going to destroy the observer. If it returns |true| it
@@ -196,7 +207,7 @@ public:
 private:
     friend class ExceptionPort;
 
-    explicit PortDispatcher(uint32_t options);
+    PortDispatcher(uint32_t options, size_t max_packets);
 
     void FreePacket(PortPacket* port_packet) TA_REQ(get_lock());
 
@@ -211,6 +222,8 @@ private:
 
     fbl::Canary<fbl::magic("PORT")> canary_;
     const uint32_t options_;
+    // The most packets that can be pending in |packets_|.
+    const size_t max_packets_;
     Semaphore sema_;
     bool zero_handles_ TA_GUARDED(get_lock());
 
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 
+#include <lib/user_copy/user_iovec.h>
 #include <lib/user_copy/user_ptr.h>
 #include <object/dispatcher.h>
 #include <object/handle.h>
@@ -32,6 +33,9 @@ public:
 
     // Socket methods.
     zx_status_t Write(user_in_ptr<const void> src, size_t len, size_t* written);
+    // Writes the bytes of every buffer in |src|, in order. Datagram sockets
+    // write them as a single datagram.
+    zx_status_t Write(user_iovec* src, size_t* written);
 
     zx_status_t WriteControl(user_in_ptr<const void> src, size_t len);
 
@@ -41,6 +45,9 @@ public:
     zx_status_t HalfClose();
 
     zx_status_t Read(user_out_ptr<void> dst, size_t len, size_t* nread);
+    // Fills the buffers in |dst| in order. Datagram sockets read at most one
+    // datagram.
+    zx_status_t Read(user_iovec* dst, size_t* nread);
 
     zx_status_t ReadControl(user_out_ptr<void> dst, size_t len, size_t* nread);
 
@@ -57,6 +64,10 @@ public:
     size_t TransmitBufferMax() const;
     size_t TransmitBufferSize() const;
 
+    // Sets how many bytes this endpoint buffers for reading. There is no
+    // transmit counterpart: only the reading end sizes its buffer.
+    zx_status_t SetReceiveBufferMax(size_t max);
+
     zx_status_t CheckShareable(SocketDispatcher* to_send);
 
     struct ControlMsg {
@@ -74,11 +85,12 @@ private:
                      zx_signals_t starting_signals, uint32_t flags,
                      fbl::unique_ptr<ControlMsg> control_msg);
     void Init(fbl::RefPtr<SocketDispatcher> other);
-    zx_status_t WriteSelfLocked(user_in_ptr<const void> src, size_t len, size_t* nwritten) TA_REQ(get_lock());
+    zx_status_t WriteSelfLocked(user_iovec* src, size_t* nwritten) TA_REQ(get_lock());
     zx_status_t WriteControlSelfLocked(user_in_ptr<const void> src, size_t len) TA_REQ(get_lock());
     zx_status_t UserSignalSelfLocked(uint32_t clear_mask, uint32_t set_mask) TA_REQ(get_lock());
     zx_status_t ShutdownOtherLocked(uint32_t how) TA_REQ(get_lock());
     zx_status_t ShareSelfLocked(HandleOwner h) TA_REQ(get_lock());
+    zx_status_t SetReceiveBufferMaxSelfLocked(size_t max) TA_REQ(get_lock());
 
     bool is_full() const TA_REQ(get_lock()) { return data_.is_full(); }
     bool is_empty() const TA_REQ(get_lock()) { return data_.is_empty(); }
@@ -190,6 +190,20 @@ public:
                            size_t buffer_len);
     // Profile support
     zx_status_t SetPriority(int32_t priority);
+    zx_status_t SetBandwidth(uint32_t weight, zx_duration_t capacity, zx_duration_t period);
+
+    // Futex priority inheritance support. Raises the thread's priority to at least
+    // |priority| while |lender| lends it; see FutexNode::LendPriorityLocked().
+    void AddFutexLenderLocked(FutexNode* lender, int priority) TA_REQ(thread_lock);
+
+    // Channel call priority inheritance support. InheritCallPriorityLocked() is only
+    // called by the thread itself, with the lock of the channel |lender| waits on held.
+    // It gives back any priority lent by an earlier call and, if |lender| is non-null,
+    // runs the thread at no less than |priority| until EndCallPriorityLocked() is
+    // called: when |lender|'s wait ends, however it ends, or when the thread exits.
+    void InheritCallPriorityLocked(ChannelDispatcher::MessageWaiter* lender, int priority)
+        TA_REQ(thread_lock);
+    void EndCallPriorityLocked() TA_REQ(thread_lock);
 
     // For ChannelDispatcher use.
     ChannelDispatcher::MessageWaiter* GetMessageWaiter() { return &channel_waiter_; }
@@ -295,6 +309,10 @@ private:
     // in order to suspend a thread.
     ChannelDispatcher::MessageWaiter channel_waiter_;
 
+    // The waiter of the call whose priority the thread is running at, if any.
+    // It points back at this thread through its borrower_.
+    ChannelDispatcher::MessageWaiter* call_lender_ TA_GUARDED(thread_lock) = nullptr;
+
     // LK thread structure
     // put last to ease debugging since this is a pretty large structure
     // (~1.5K on x86_64).
@@ -0,0 +1,164 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <stdint.h>
+
+#include <kernel/event.h>
+#include <kernel/lockdep.h>
+#include <object/dispatcher.h>
+#include <object/state_observer.h>
+
+#include <fbl/canary.h>
+#include <fbl/intrusive_double_list.h>
+#include <fbl/intrusive_wavl_tree.h>
+#include <fbl/mutex.h>
+#include <fbl/ref_counted.h>
+#include <fbl/ref_ptr.h>
+#include <zircon/types.h>
+
+class Handle;
+class WaitSetDispatcher;
+
+// One member of a wait set. It is owned by the wait set's member tree and,
+// while it observes its object, by a reference held for the object's
+// observer list, which is dropped in OnRemoved().
+class WaitSetMember final : public StateObserver,
+                            public fbl::RefCounted<WaitSetMember>,
+                            public fbl::WAVLTreeContainable<fbl::RefPtr<WaitSetMember>> {
+public:
+    WaitSetMember(fbl::RefPtr<WaitSetDispatcher> wait_set, const Handle* handle,
+                  fbl::RefPtr<Dispatcher> dispatcher, uint64_t cookie, zx_signals_t signals);
+    ~WaitSetMember() = default;
+
+    uint64_t GetKey() const { return cookie_; }
+
+private:
+    friend class WaitSetDispatcher;
+    friend struct WaitSetReadyListTraits;
+
+    WaitSetMember(const WaitSetMember&) = delete;
+    WaitSetMember& operator=(const WaitSetMember&) = delete;
+
+    // StateObserver overrides.
+    Flags OnInitialize(zx_signals_t initial_state, const StateObserver::CountInfo* cinfo) final;
+    Flags OnStateChange(zx_signals_t new_state) final;
+    Flags OnCancel(const Handle* handle) final;
+    Flags OnCancelByKey(const Handle* handle, const void* port, uint64_t key) final;
+    void OnRemoved() final;
+
+    fbl::Canary<fbl::magic("WSMB")> canary_;
+
+    const fbl::RefPtr<WaitSetDispatcher> wait_set_;
+    const Handle* const handle_;
+    const uint64_t cookie_;
+    const zx_signals_t trigger_;
+
+    // Set by OnCancel() with the object's lock held, and read by the
+    // OnRemoved() that follows it.
+    bool handle_closed_ = false;
+
+    // The rest is guarded by the wait set's lock.
+
+    // The observed object, until the member is removed from the wait set
+    // or its handle is closed.
+    fbl::RefPtr<Dispatcher> dispatcher_;
+    zx_status_t status_ = ZX_OK;
+    zx_signals_t observed_ = 0u;
+    fbl::DoublyLinkedListNodeState<WaitSetMember*> ready_node_state_;
+};
+
+struct WaitSetReadyListTraits {
+    static fbl::DoublyLinkedListNodeState<WaitSetMember*>& node_state(WaitSetMember& member) {
+        return member.ready_node_state_;
+    }
+};
+
+// The WaitSetDispatcher implements the wait set kernel object, a set of
+// (handle, signals) pairs that threads can wait on together.
+//
+// Unlike zx_object_wait_many(), which registers an observer on every object
+// each time it is called, a member's observer is registered once by
+// zx_waitset_add() and stays on the object's state tracker until the member
+// is removed, its handle is closed or the wait set goes away. The wait set
+// keeps a list of the members whose signals are currently satisfied, so a
+// wait only has to copy out the front of that list.
+//
+// Members are level triggered: a member stays on the ready list for as long
+// as its object asserts one of the watched signals. A member whose handle is
+// closed is reported as ZX_ERR_CANCELED until it is removed.
+class WaitSetDispatcher final : public SoloDispatcher<WaitSetDispatcher> {
+public:
+    // The most members a wait set can hold.
+    static constexpr size_t kMaxMembers = 4096u;
+
+    static zx_status_t Create(uint32_t options, fbl::RefPtr<Dispatcher>* dispatcher,
+                              zx_rights_t* rights);
+
+    ~WaitSetDispatcher() final;
+    zx_obj_type_t get_type() const final { return ZX_OBJ_TYPE_WAITSET; }
+    void on_zero_handles() final;
+
+    // Adds |handle| as the member named |cookie|, to be reported when its
+    // object asserts any of |signals|.
+    // Called under the handle table lock.
+    zx_status_t AddMember(Handle* handle, uint64_t cookie, zx_signals_t signals);
+
+    // Removes the member named |cookie|.
+    zx_status_t RemoveMember(uint64_t cookie);
+
+    // Copies up to |count| ready members into |results|, blocking until
+    // |deadline| only if none are ready. Returns the number copied in
+    // |actual| and the number of ready members left out in |remaining|.
+    // The members reported are moved behind the others, so a following call
+    // for at most |remaining| members reports only ones left out by this one.
+    zx_status_t Wait(zx_time_t deadline, zx_waitset_result_t* results, size_t count,
+                     size_t* actual, size_t* remaining);
+
+private:
+    friend class WaitSetMember;
+
+    using MemberTree = fbl::WAVLTree<uint64_t, fbl::RefPtr<WaitSetMember>>;
+    using ReadyList = fbl::DoublyLinkedList<WaitSetMember*, WaitSetReadyListTraits>;
+
+    WaitSetDispatcher() = default;
+
+    // Called by a WaitSetMember, with its object's lock held, when the object's
+    // signals change.
+    void UpdateMember(WaitSetMember* member, zx_signals_t signals);
+
+    // Called by a WaitSetMember after its handle was closed.
+    void CancelMember(WaitSetMember* member);
+
+    // Add |member| to or remove it from |ready_|, keeping |num_ready_| and
+    // |ready_event_| up to date. The caller signals |ready_event_| after
+    // adding.
+    void PushReadyLocked(WaitSetMember* member) TA_REQ(get_lock());
+    void EraseReadyLocked(WaitSetMember* member) TA_REQ(get_lock());
+
+    // Removes |member| from the set and returns the set's reference to it.
+    // If the member still observes its object, |*dispatcher| is set to the
+    // object so the caller can cancel the observer once |lock_| is released.
+    fbl::RefPtr<WaitSetMember> DetachMemberLocked(WaitSetMember* member,
+                                                  fbl::RefPtr<Dispatcher>* dispatcher)
+        TA_REQ(get_lock());
+
+    fbl::Canary<fbl::magic("WSET")> canary_;
+
+    // Serializes adding and removing members, which can't hold |lock_| while
+    // they register or cancel observers because the observers take |lock_|
+    // with the observed object's lock held.
+    DECLARE_MUTEX(WaitSetDispatcher) membership_lock_;
+
+    bool zero_handles_ TA_GUARDED(get_lock()) = false;
+    MemberTree members_ TA_GUARDED(get_lock());
+    ReadyList ready_ TA_GUARDED(get_lock());
+    size_t num_ready_ TA_GUARDED(get_lock()) = 0u;
+
+    // Signaled whenever |ready_| is not empty.
+    Event ready_event_;
+};
@@ -6,7 +6,7 @@
 
 #include <object/mbuf.h>
 
-#include <lib/user_copy/user_ptr.h>
+#include <lib/user_copy/user_iovec.h>
 
 #include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
@@ -17,6 +17,7 @@ constexpr size_t MBufChain::MBuf::kHeaderSize;
 constexpr size_t MBufChain::MBuf::kMallocSize;
 constexpr size_t MBufChain::MBuf::kPayloadSize;
 constexpr size_t MBufChain::kSizeMax;
+constexpr size_t MBufChain::kSizeLimit;
 
 size_t MBufChain::MBuf::rem() const {
     return kPayloadSize - (off_ + len_);
@@ -30,18 +31,19 @@ MBufChain::~MBufChain() {
 }
 
 bool MBufChain::is_full() const {
-    return size_ >= kSizeMax;
+    return size_ >= max_size_;
 }
 
 bool MBufChain::is_empty() const {
     return size_ == 0;
 }
 
-size_t MBufChain::Read(user_out_ptr<void> dst, size_t len, bool datagram) {
+size_t MBufChain::Read(user_iovec* dst, bool datagram) {
     if (size_ == 0) {
         return 0;
     }
 
+    size_t len = dst->total();
     if (datagram && len > tail_.front().pkt_len_)
         len = tail_.front().pkt_len_;
 
@@ -50,7 +52,7 @@ size_t MBufChain::Read(user_out_ptr<void> dst, size_t len, bool datagram) {
         MBuf& cur = tail_.front();
         char* src = cur.data_ + cur.off_;
         size_t copy_len = MIN(cur.len_, len - pos);
-        if (dst.byte_offset(pos).copy_array_to_user(src, copy_len) != ZX_OK)
+        if (dst->copy_to_user(src, copy_len, pos) != ZX_OK)
             return pos;
         pos += copy_len;
         cur.off_ += static_cast<uint32_t>(copy_len);
@@ -76,12 +78,12 @@ size_t MBufChain::Read(user_out_ptr<void> dst, size_t len, bool datagram) {
     return pos;
 }
 
-zx_status_t MBufChain::WriteDatagram(user_in_ptr<const void> src, size_t len,
-                                     size_t* written) {
+zx_status_t MBufChain::WriteDatagram(user_iovec* src, size_t* written) {
+    const size_t len = src->total();
     if (len == 0) {
         return ZX_ERR_INVALID_ARGS;
     }
-    if (len + size_ > kSizeMax)
+    if (len + size_ > max_size_)
         return ZX_ERR_SHOULD_WAIT;
 
     fbl::SinglyLinkedList<MBuf*> bufs;
@@ -98,7 +100,7 @@ zx_status_t MBufChain::WriteDatagram(user_in_ptr<const void> src, size_t len,
     size_t pos = 0;
     for (auto& buf : bufs) {
         size_t copy_len = fbl::min(MBuf::kPayloadSize, len - pos);
-        if (src.byte_offset(pos).copy_array_from_user(buf.data_, copy_len) != ZX_OK) {
+        if (src->copy_from_user(buf.data_, copy_len, pos) != ZX_OK) {
             while (!bufs.is_empty())
                 FreeMBuf(bufs.pop_front());
             return ZX_ERR_INVALID_ARGS; // Bad user buffer.
@@ -125,7 +127,8 @@ zx_status_t MBufChain::WriteDatagram(user_in_ptr<const void> src, size_t len,
     return ZX_OK;
 }
 
-zx_status_t MBufChain::WriteStream(user_in_ptr<const void> src, size_t len, size_t* written) {
+zx_status_t MBufChain::WriteStream(user_iovec* src, size_t* written) {
+    const size_t len = src->total();
     if (head_ == nullptr) {
         head_ = AllocMBuf();
         if (head_ == nullptr)
@@ -144,13 +147,17 @@ zx_status_t MBufChain::WriteStream(user_in_ptr<const void> src, size_t len, size
         }
         void* dst = head_->data_ + head_->off_ + head_->len_;
         size_t copy_len = fbl::min(head_->rem(), len - pos);
-        if (size_ + copy_len > kSizeMax) {
-            copy_len = kSizeMax - size_;
+        if (size_ + copy_len > max_size_) {
+            copy_len = size_ < max_size_ ? max_size_ - size_ : 0;
             if (copy_len == 0)
                 break;
         }
-        if (src.byte_offset(pos).copy_array_from_user(dst, copy_len) != ZX_OK)
+        if (src->copy_from_user(dst, copy_len, pos) != ZX_OK) {
+            // Only report the bad user buffer if nothing was written.
+            if (pos == 0)
+                return ZX_ERR_INVALID_ARGS;
             break;
+        }
         pos += copy_len;
         head_->len_ += static_cast<uint32_t>(copy_len);
         size_ += copy_len;
@@ -163,6 +170,13 @@ zx_status_t MBufChain::WriteStream(user_in_ptr<const void> src, size_t len, size
     return ZX_OK;
 }
 
+zx_status_t MBufChain::set_max_size(size_t max_size) {
+    if (max_size < MBuf::kPayloadSize || max_size > kSizeLimit)
+        return ZX_ERR_OUT_OF_RANGE;
+    max_size_ = max_size;
+    return ZX_OK;
+}
+
 MBufChain::MBuf* MBufChain::AllocMBuf() {
     if (freelist_.is_empty()) {
         fbl::AllocChecker ac;
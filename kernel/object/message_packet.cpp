@@ -10,6 +10,7 @@
 #include <fbl/algorithm.h>
 #include <stdint.h>
 #include <string.h>
+#include <vm/pmm.h>
 #include <zxcpp/new.h>
 
 // MessagePackets have special allocation requirements because they can contain a variable number of
@@ -21,6 +22,10 @@
 //
 // The first buffer in a MessagePacket's BufferChain contains the MessagePacket object, followed by
 // its handles (if any), and finally its payload data (if any).
+//
+// Large page aligned payloads can instead be moved out of the writer's VMO a page at a time (see
+// CreateFromPages()), in which case the BufferChain holds only the MessagePacket and its handles
+// and the payload is copied straight from those pages on read.
 
 // The MessagePacket object, its handles and zx_txid_t must all fit in the first buffer.
 static constexpr size_t kContiguousBytes =
@@ -36,7 +41,8 @@ static inline uint32_t PayloadOffset(uint32_t num_handles) {
     return kHandlesOffset + num_handles * static_cast<uint32_t>(sizeof(Handle*));
 }
 
-// Creates a MessagePacket in |msg| sufficient to hold |data_size| bytes and |num_handles|.
+// Creates a MessagePacket in |msg| sufficient to hold |data_size| bytes and |num_handles|. If
+// |inline_data| is false, no room is made for the payload in the BufferChain.
 //
 // Note: This method does not write the payload into the MessagePacket.
 //
@@ -44,6 +50,7 @@ static inline uint32_t PayloadOffset(uint32_t num_handles) {
 //
 // static
 inline zx_status_t MessagePacket::CreateCommon(uint32_t data_size, uint32_t num_handles,
+                                               bool inline_data,
                                                fbl::unique_ptr<MessagePacket>* msg) {
     if (unlikely(data_size > kMaxMessageSize || num_handles > kMaxMessageHandles)) {
         return ZX_ERR_OUT_OF_RANGE;
@@ -53,7 +60,7 @@ inline zx_status_t MessagePacket::CreateCommon(uint32_t data_size, uint32_t num_
 
     // MessagePackets lives *inside* a list of buffers.  The first buffer holds the MessagePacket
     // object, followed by its handles (if any), and finally the payload data.
-    BufferChain* chain = BufferChain::Alloc(payload_offset + data_size);
+    BufferChain* chain = BufferChain::Alloc(payload_offset + (inline_data ? data_size : 0));
     if (unlikely(!chain)) {
         return ZX_ERR_NO_MEMORY;
     }
@@ -76,7 +83,7 @@ inline zx_status_t MessagePacket::CreateCommon(uint32_t data_size, uint32_t num_
 zx_status_t MessagePacket::Create(user_in_ptr<const void> data, uint32_t data_size,
                                   uint32_t num_handles, fbl::unique_ptr<MessagePacket>* msg) {
     fbl::unique_ptr<MessagePacket> new_msg;
-    zx_status_t status = CreateCommon(data_size, num_handles, &new_msg);
+    zx_status_t status = CreateCommon(data_size, num_handles, true, &new_msg);
     if (unlikely(status != ZX_OK)) {
         return status;
     }
@@ -92,7 +99,7 @@ zx_status_t MessagePacket::Create(user_in_ptr<const void> data, uint32_t data_si
 zx_status_t MessagePacket::Create(const void* data, uint32_t data_size, uint32_t num_handles,
                                   fbl::unique_ptr<MessagePacket>* msg) {
     fbl::unique_ptr<MessagePacket> new_msg;
-    zx_status_t status = CreateCommon(data_size, num_handles, &new_msg);
+    zx_status_t status = CreateCommon(data_size, num_handles, true, &new_msg);
     if (unlikely(status != ZX_OK)) {
         return status;
     }
@@ -104,10 +111,58 @@ zx_status_t MessagePacket::Create(const void* data, uint32_t data_size, uint32_t
     return ZX_OK;
 }
 
+// static
+zx_status_t MessagePacket::CreateFromPages(list_node* pages, uint32_t data_size,
+                                           uint32_t num_handles,
+                                           fbl::unique_ptr<MessagePacket>* msg) {
+    DEBUG_ASSERT(data_size > 0);
+    DEBUG_ASSERT(list_length(pages) == ROUNDUP_PAGE_SIZE(data_size) / PAGE_SIZE);
+
+    fbl::unique_ptr<MessagePacket> new_msg;
+    zx_status_t status = CreateCommon(data_size, num_handles, false, &new_msg);
+    if (unlikely(status != ZX_OK)) {
+        pmm_free(pages);
+        return status;
+    }
+
+    vm_page* page;
+    list_for_every_entry (pages, page, vm_page, queue_node) {
+        page->state = VM_PAGE_STATE_IPC;
+    }
+    list_move(pages, &new_msg->pages_);
+
+    *msg = fbl::move(new_msg);
+    return ZX_OK;
+}
+
+zx_status_t MessagePacket::CopyPagesTo(user_out_ptr<void> buf) const {
+    size_t rem = data_size_;
+    const vm_page* page;
+    list_for_every_entry (&pages_, page, vm_page, queue_node) {
+        if (rem == 0) {
+            break;
+        }
+        const size_t copy_len = fbl::min<size_t>(rem, PAGE_SIZE);
+        const char* src = static_cast<const char*>(paddr_to_physmap(page->paddr()));
+        const zx_status_t status = buf.copy_array_to_user(src, copy_len);
+        if (unlikely(status != ZX_OK)) {
+            return status;
+        }
+        buf = buf.byte_offset(copy_len);
+        rem -= copy_len;
+    }
+    return ZX_OK;
+}
+
 void MessagePacket::fbl_recycle() {
     // This function invokes the destructor so be careful about taking any references to |this|.
     BufferChain* chain = buffer_chain_;
+    list_node pages;
+    list_move(&pages_, &pages);
     this->~MessagePacket();
     // |this| has been destroyed.
+    if (!list_is_empty(&pages)) {
+        pmm_free(&pages);
+    }
     BufferChain::Free(chain);
 }
@@ -10,10 +10,14 @@
 #include <err.h>
 #include <platform.h>
 #include <pow2.h>
+#include <string.h>
 
+#include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
-#include <fbl/arena.h>
+#include <fbl/atomic.h>
 #include <fbl/auto_lock.h>
+#include <kernel/cmdline.h>
+#include <lib/console.h>
 #include <lib/counters.h>
 #include <object/excp_port.h>
 #include <object/handle.h>
@@ -34,46 +38,85 @@ static_assert(sizeof(zx_packet_guest_io_t) == sizeof(zx_packet_user_t),
 static_assert(sizeof(zx_packet_guest_vcpu_t) == sizeof(zx_packet_user_t),
               "size of zx_packet_guest_vcpu_t must match zx_packet_user_t");
 
-KCOUNTER(port_arena_count, "kernel.port.arena.count");
+KCOUNTER(port_packet_count, "kernel.port.packet.count");
+KCOUNTER(port_packet_fail_count, "kernel.port.packet.fail.count");
 KCOUNTER(port_full_count, "kernel.port.full.count");
 
-class ArenaPortAllocator final : public PortAllocator {
+// Hands out PortPackets from slabs on the kernel heap, adding slabs as they
+// are needed until the system-wide packet limit is reached.  Slabs are never
+// returned to the heap, so the memory used is that of the peak packet count,
+// and at most max_packets() packets' worth of slabs.
+class SlabPortAllocator final : public PortAllocator {
 public:
-    zx_status_t Init();
-    virtual ~ArenaPortAllocator() = default;
+    zx_status_t Init(size_t max_packets);
+    virtual ~SlabPortAllocator() = default;
 
     virtual PortPacket* Alloc();
     virtual void Free(PortPacket* port_packet);
 
+    size_t max_packets() const { return max_packets_; }
+    size_t packet_count() const { return packet_count_.load(); }
+    size_t peak_packet_count() const { return peak_packet_count_.load(); }
+    size_t slab_bytes() const {
+        return slabs_->slab_count() * fbl::DEFAULT_SLAB_ALLOCATOR_SLAB_SIZE;
+    }
+
 private:
-    fbl::TypedArena<PortPacket, fbl::Mutex> arena_;
+    using SlabAllocator = fbl::SlabAllocator<PortPacketAllocatorTraits>;
+
+    size_t max_packets_ = 0u;
+    fbl::atomic<size_t> packet_count_;
+    fbl::atomic<size_t> peak_packet_count_;
+    fbl::unique_ptr<SlabAllocator> slabs_;
 };
 
 namespace {
-constexpr size_t kMaxPendingPacketCount = 16 * 1024u;
+// Be sure to update kernel_cmdline.md if any of these defaults change.
+constexpr uint64_t kDefaultMaxPacketCount = 256 * 1024u;
+constexpr uint64_t kDefaultMaxPacketCountPerPort = 16 * 1024u;
 
-// TODO(maniscalco): Enforce this limit per process via the job policy.
-constexpr size_t kMaxPendingPacketCountPerPort = kMaxPendingPacketCount / 8;
-ArenaPortAllocator port_allocator;
+// TODO(maniscalco): Enforce a limit per process via the job policy.
+size_t max_packets_per_port;
+SlabPortAllocator port_allocator;
 } // namespace.
 
-zx_status_t ArenaPortAllocator::Init() {
-    return arena_.Init("packets", kMaxPendingPacketCount);
+zx_status_t SlabPortAllocator::Init(size_t max_packets) {
+    const size_t max_slabs = fbl::round_up(max_packets, SlabAllocator::AllocsPerSlab) /
+                             SlabAllocator::AllocsPerSlab;
+
+    fbl::AllocChecker ac;
+    slabs_.reset(new (&ac) SlabAllocator(max_slabs));
+    if (!ac.check())
+        return ZX_ERR_NO_MEMORY;
+
+    max_packets_ = max_packets;
+    return ZX_OK;
 }
 
-PortPacket* ArenaPortAllocator::Alloc() {
-    PortPacket* packet = arena_.New(nullptr, this);
+PortPacket* SlabPortAllocator::Alloc() {
+    // Reserve a packet first so that the limit holds without taking a lock.
+    size_t count = packet_count_.fetch_add(1u) + 1u;
+    PortPacket* packet = (count <= max_packets_) ? slabs_->New(nullptr, this) : nullptr;
     if (packet == nullptr) {
+        packet_count_.fetch_sub(1u);
+        kcounter_add(port_packet_fail_count, 1);
         printf("WARNING: Could not allocate new port packet\n");
         return nullptr;
     }
-    kcounter_add(port_arena_count, 1);
+
+    size_t peak = peak_packet_count_.load(fbl::memory_order_relaxed);
+    while (count > peak &&
+           !peak_packet_count_.compare_exchange_strong(&peak, count, fbl::memory_order_relaxed,
+                                                       fbl::memory_order_relaxed)) {
+    }
+    kcounter_add(port_packet_count, 1);
     return packet;
 }
 
-void ArenaPortAllocator::Free(PortPacket* port_packet) {
-    arena_.Delete(port_packet);
-    kcounter_add(port_arena_count, -1);
+void SlabPortAllocator::Free(PortPacket* port_packet) {
+    slabs_->Delete(port_packet);
+    packet_count_.fetch_sub(1u);
+    kcounter_add(port_packet_count, -1);
 }
 
 PortPacket::PortPacket(const void* handle, PortAllocator* allocator)
@@ -147,7 +190,7 @@ StateObserver::Flags PortObserver::MaybeQueue(zx_signals_t new_state, uint64_t c
 
     // TODO(cpu): Queue() can fail and we don't propagate this information
     // here properly. Now, this failure is self inflicted because we constrain
-    // the packet arena size artificially.  See ZX-2166 for details.
+    // the number of pending packets per port.  See ZX-2166 for details.
     auto status = port_->Queue(&packet_, new_state, count);
 
     if ((type_ == ZX_PKT_TYPE_SIGNAL_ONE) || (status < 0))
@@ -159,7 +202,14 @@ StateObserver::Flags PortObserver::MaybeQueue(zx_signals_t new_state, uint64_t c
 /////////////////////////////////////////////////////////////////////////////////////////
 
 void PortDispatcher::Init() {
-    port_allocator.Init();
+    const size_t max_packets = cmdline_get_uint64("kernel.port.max-packets",
+                                                  kDefaultMaxPacketCount);
+    max_packets_per_port = fbl::min<size_t>(
+        cmdline_get_uint64("kernel.port.max-packets-per-port", kDefaultMaxPacketCountPerPort),
+        max_packets);
+
+    zx_status_t status = port_allocator.Init(max_packets);
+    ASSERT_MSG(status == ZX_OK, "failed to init port packet allocator: %d\n", status);
 }
 
 PortAllocator* PortDispatcher::DefaultPortAllocator() {
@@ -168,11 +218,24 @@ PortAllocator* PortDispatcher::DefaultPortAllocator() {
 
 zx_status_t PortDispatcher::Create(uint32_t options, fbl::RefPtr<Dispatcher>* dispatcher,
                                    zx_rights_t* rights) {
+    const uint32_t quota = (options & ZX_PORT_QUOTA_MASK) >> ZX_PORT_QUOTA_SHIFT;
+    options &= ~ZX_PORT_QUOTA_MASK;
     if (options && options != PORT_BIND_TO_INTERRUPT) {
         return ZX_ERR_INVALID_ARGS;
     }
+    if (quota > ZX_PORT_QUOTA_MAX) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+
+    // A quota can only lower the per-port limit, so that no port can take
+    // more than its share of the system-wide packets.
+    size_t max_packets = max_packets_per_port;
+    if (quota != 0u) {
+        max_packets = fbl::min(size_t(1) << quota, max_packets_per_port);
+    }
+
     fbl::AllocChecker ac;
-    auto disp = new (&ac) PortDispatcher(options);
+    auto disp = new (&ac) PortDispatcher(options, max_packets);
     if (!ac.check())
         return ZX_ERR_NO_MEMORY;
 
@@ -181,8 +244,8 @@ zx_status_t PortDispatcher::Create(uint32_t options, fbl::RefPtr<Dispatcher>* di
     return ZX_OK;
 }
 
-PortDispatcher::PortDispatcher(uint32_t options)
-    : options_(options), zero_handles_(false), num_packets_(0u) {
+PortDispatcher::PortDispatcher(uint32_t options, size_t max_packets)
+    : options_(options), max_packets_(max_packets), zero_handles_(false), num_packets_(0u) {
 }
 
 PortDispatcher::~PortDispatcher() {
@@ -257,7 +320,7 @@ zx_status_t PortDispatcher::Queue(PortPacket* port_packet, zx_signals_t observed
     if (zero_handles_)
         return ZX_ERR_BAD_STATE;
 
-    if (num_packets_ > kMaxPendingPacketCountPerPort) {
+    if (num_packets_ >= max_packets_) {
         kcounter_add(port_full_count, 1);
         return ZX_ERR_SHOULD_WAIT;
     }
@@ -282,31 +345,46 @@ zx_status_t PortDispatcher::Queue(PortPacket* port_packet, zx_signals_t observed
 }
 
 zx_status_t PortDispatcher::Dequeue(zx_time_t deadline, zx_port_packet_t* out_packet) {
+    size_t actual;
+    return DequeueMany(deadline, out_packet, 1, &actual);
+}
+
+zx_status_t PortDispatcher::DequeueMany(zx_time_t deadline, zx_port_packet_t* out_packets,
+                                        size_t count, size_t* actual) {
     canary_.Assert();
+    DEBUG_ASSERT(count > 0);
 
     while (true) {
+        size_t dequeued = 0;
         if (options_ == PORT_BIND_TO_INTERRUPT) {
             Guard<SpinLock, IrqSave> guard{&spinlock_};
-            PortInterruptPacket* port_interrupt_packet = interrupt_packets_.pop_front();
-            if (port_interrupt_packet != nullptr) {
+            while (dequeued < count) {
+                PortInterruptPacket* port_interrupt_packet = interrupt_packets_.pop_front();
+                if (port_interrupt_packet == nullptr)
+                    break;
+                zx_port_packet_t* out_packet = &out_packets[dequeued++];
                 *out_packet = {};
                 out_packet->key = port_interrupt_packet->key;
                 out_packet->type = ZX_PKT_TYPE_INTERRUPT;
                 out_packet->status = ZX_OK;
                 out_packet->interrupt.timestamp = port_interrupt_packet->timestamp;
-                return ZX_OK;
             }
         }
-        {
+        if (dequeued < count) {
             Guard<fbl::Mutex> guard{get_lock()};
-            PortPacket* port_packet = packets_.pop_front();
-            if (port_packet != nullptr) {
+            while (dequeued < count) {
+                PortPacket* port_packet = packets_.pop_front();
+                if (port_packet == nullptr)
+                    break;
                 --num_packets_;
-                *out_packet = port_packet->packet;
+                out_packets[dequeued++] = port_packet->packet;
                 FreePacket(port_packet);
-                return ZX_OK;
             }
         }
+        if (dequeued > 0) {
+            *actual = dequeued;
+            return ZX_OK;
+        }
 
         {
             ThreadDispatcher::AutoBlocked by(ThreadDispatcher::Blocked::PORT);
@@ -434,3 +512,29 @@ void PortDispatcher::UnlinkExceptionPort(ExceptionPort* eport) {
         eports_.erase(*eport);
     }
 }
+
+static int cmd_port(int argc, const cmd_args* argv, uint32_t flags) {
+    if (argc < 2) {
+        printf("not enough arguments\n");
+    usage:
+        printf("usage:\n");
+        printf("%s info : print port packet usage\n", argv[0].str);
+        return ZX_ERR_INTERNAL;
+    }
+
+    if (!strcmp(argv[1].str, "info")) {
+        printf("%zu packets allocated, peak %zu, limit %zu, %zu per port, %zu bytes of slabs\n",
+               port_allocator.packet_count(), port_allocator.peak_packet_count(),
+               port_allocator.max_packets(), max_packets_per_port,
+               port_allocator.slab_bytes());
+    } else {
+        printf("unknown command\n");
+        goto usage;
+    }
+
+    return ZX_OK;
+}
+
+STATIC_COMMAND_START
+STATIC_COMMAND("port", "port packet allocator", &cmd_port)
+STATIC_COMMAND_END(port);
@@ -557,6 +557,15 @@ zx_status_t ProcessDispatcher::GetStats(zx_info_task_stats_t* stats) {
     return ZX_OK;
 }
 
+zx_status_t ProcessDispatcher::GetWorkingSet(zx_info_working_set_t* info) {
+    DEBUG_ASSERT(info != nullptr);
+    Guard<fbl::Mutex> guard{get_lock()};
+    if (state_ != State::RUNNING) {
+        return ZX_ERR_BAD_STATE;
+    }
+    return GetVmAspaceWorkingSet(aspace_, info);
+}
+
 zx_status_t ProcessDispatcher::GetAspaceMaps(
     user_out_ptr<zx_info_maps_t> maps, size_t max,
     size_t* actual, size_t* available) {
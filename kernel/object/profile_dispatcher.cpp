@@ -7,6 +7,7 @@
 #include <object/profile_dispatcher.h>
 
 #include <err.h>
+#include <stddef.h>
 
 #include <fbl/alloc_checker.h>
 #include <fbl/ref_ptr.h>
@@ -15,15 +16,46 @@
 
 #include <zircon/rights.h>
 
-zx_status_t validate_profile(const zx_profile_info_t& info) {
-    if (info.type != ZX_PROFILE_INFO_SCHEDULER)
-        return ZX_ERR_NOT_SUPPORTED;
-    if ((info.scheduler.priority < LOWEST_PRIORITY) ||
-        (info.scheduler.priority  > HIGHEST_PRIORITY))
+// The bandwidth profile shares the union with the scheduler profile, and must
+// not change the layout existing binaries were built against.
+static_assert(sizeof(zx_profile_info_t) == 20u, "zx_profile_info_t layout changed");
+static_assert(offsetof(zx_profile_info_t, scheduler) == 4u, "zx_profile_info_t layout changed");
+static_assert(sizeof(zx_profile_bandwidth_t) <= sizeof(zx_profile_scheduler_t),
+              "zx_profile_bandwidth_t grows zx_profile_info_t");
+
+// Bounds on the period of a cpu reservation, in microseconds.
+static constexpr uint32_t kMinReservationPeriodUs = 100u;
+static constexpr uint32_t kMaxReservationPeriodUs = 10u * 1000u * 1000u;
+
+static zx_status_t validate_bandwidth(const zx_profile_bandwidth_t& bandwidth) {
+    if ((bandwidth.weight < ZX_SCHED_WEIGHT_MIN) ||
+        (bandwidth.weight > ZX_SCHED_WEIGHT_MAX) ||
+        (bandwidth.reserved != 0))
+        return ZX_ERR_INVALID_ARGS;
+    if ((bandwidth.capacity_us == 0) && (bandwidth.period_us == 0))
+        return ZX_OK;
+    if ((bandwidth.period_us < kMinReservationPeriodUs) ||
+        (bandwidth.period_us > kMaxReservationPeriodUs) ||
+        (bandwidth.capacity_us == 0) ||
+        (bandwidth.capacity_us > bandwidth.period_us))
         return ZX_ERR_INVALID_ARGS;
     return ZX_OK;
 }
 
+zx_status_t validate_profile(const zx_profile_info_t& info) {
+    switch (info.type) {
+    case ZX_PROFILE_INFO_SCHEDULER:
+        if ((info.scheduler.priority < LOWEST_PRIORITY) ||
+            (info.scheduler.priority  > HIGHEST_PRIORITY))
+            return ZX_ERR_INVALID_ARGS;
+        return ZX_OK;
+    case ZX_PROFILE_INFO_BANDWIDTH:
+        return validate_bandwidth(info.bandwidth);
+    default:
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+}
+
 zx_status_t ProfileDispatcher::Create(const zx_profile_info_t& info,
                                       fbl::RefPtr<Dispatcher>* dispatcher,
                                       zx_rights_t* rights) {
@@ -48,6 +80,10 @@ ProfileDispatcher::~ProfileDispatcher() {
 }
 
 zx_status_t ProfileDispatcher::ApplyProfile(fbl::RefPtr<ThreadDispatcher> thread) {
-    // At the moment, the only thing we support is the priority.
+    if (info_.type == ZX_PROFILE_INFO_BANDWIDTH) {
+        return thread->SetBandwidth(info_.bandwidth.weight,
+                                    ZX_USEC(info_.bandwidth.capacity_us),
+                                    ZX_USEC(info_.bandwidth.period_us));
+    }
     return thread->SetPriority(info_.scheduler.priority);
 }
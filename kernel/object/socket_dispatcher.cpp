@@ -13,6 +13,7 @@
 #include <pow2.h>
 #include <trace.h>
 
+#include <lib/user_copy/user_iovec.h>
 #include <lib/user_copy/user_ptr.h>
 
 #include <vm/vm_aspace.h>
@@ -187,6 +188,12 @@ zx_status_t SocketDispatcher::ShutdownOtherLocked(uint32_t how) {
 }
 
 zx_status_t SocketDispatcher::Write(user_in_ptr<const void> src, size_t len,
+                                    size_t* nwritten) {
+    user_iovec iovec(src, len);
+    return Write(&iovec, nwritten);
+}
+
+zx_status_t SocketDispatcher::Write(user_iovec* src,
                                     size_t* nwritten) TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
@@ -200,6 +207,7 @@ zx_status_t SocketDispatcher::Write(user_in_ptr<const void> src, size_t len,
     if (signals & ZX_SOCKET_WRITE_DISABLED)
         return ZX_ERR_BAD_STATE;
 
+    const size_t len = src->total();
     if (len == 0) {
         *nwritten = 0;
         return ZX_OK;
@@ -207,7 +215,7 @@ zx_status_t SocketDispatcher::Write(user_in_ptr<const void> src, size_t len,
     if (len != static_cast<size_t>(static_cast<uint32_t>(len)))
         return ZX_ERR_INVALID_ARGS;
 
-    return peer_->WriteSelfLocked(src, len, nwritten);
+    return peer_->WriteSelfLocked(src, nwritten);
 }
 
 zx_status_t SocketDispatcher::WriteControl(user_in_ptr<const void> src, size_t len)
@@ -249,7 +257,7 @@ zx_status_t SocketDispatcher::WriteControlSelfLocked(user_in_ptr<const void> src
     return ZX_OK;
 }
 
-zx_status_t SocketDispatcher::WriteSelfLocked(user_in_ptr<const void> src, size_t len,
+zx_status_t SocketDispatcher::WriteSelfLocked(user_iovec* src,
                                               size_t* written) TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
@@ -261,9 +269,9 @@ zx_status_t SocketDispatcher::WriteSelfLocked(user_in_ptr<const void> src, size_
     size_t st = 0u;
     zx_status_t status;
     if (flags_ & ZX_SOCKET_DATAGRAM) {
-        status = data_.WriteDatagram(src, len, &st);
+        status = data_.WriteDatagram(src, &st);
     } else {
-        status = data_.WriteStream(src, len, &st);
+        status = data_.WriteStream(src, &st);
     }
     if (status)
         return status;
@@ -284,16 +292,26 @@ zx_status_t SocketDispatcher::Read(user_out_ptr<void> dst, size_t len,
                                    size_t* nread) TA_NO_THREAD_SAFETY_ANALYSIS {
     canary_.Assert();
 
-    LTRACE_ENTRY;
-
-    Guard<fbl::Mutex> guard{get_lock()};
-
     // Just query for bytes outstanding.
     if (!dst && len == 0) {
+        Guard<fbl::Mutex> guard{get_lock()};
         *nread = data_.size();
         return ZX_OK;
     }
 
+    user_iovec iovec(dst, len);
+    return Read(&iovec, nread);
+}
+
+zx_status_t SocketDispatcher::Read(user_iovec* dst,
+                                   size_t* nread) TA_NO_THREAD_SAFETY_ANALYSIS {
+    canary_.Assert();
+
+    LTRACE_ENTRY;
+
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    const size_t len = dst->total();
     if (len != (size_t)((uint32_t)len))
         return ZX_ERR_INVALID_ARGS;
 
@@ -309,7 +327,7 @@ zx_status_t SocketDispatcher::Read(user_out_ptr<void> dst, size_t len,
 
     bool was_full = is_full();
 
-    auto st = data_.Read(dst, len, flags_ & ZX_SOCKET_DATAGRAM);
+    auto st = data_.Read(dst, flags_ & ZX_SOCKET_DATAGRAM);
 
     if (is_empty()) {
         uint32_t set_mask = 0u;
@@ -440,3 +458,31 @@ size_t SocketDispatcher::TransmitBufferSize() const TA_NO_THREAD_SAFETY_ANALYSIS
     Guard<fbl::Mutex> guard{get_lock()};
     return peer_ ? peer_->data_.size() : 0;
 }
+
+zx_status_t SocketDispatcher::SetReceiveBufferMax(size_t max) {
+    canary_.Assert();
+    Guard<fbl::Mutex> guard{get_lock()};
+    return SetReceiveBufferMaxSelfLocked(max);
+}
+
+zx_status_t SocketDispatcher::SetReceiveBufferMaxSelfLocked(size_t max)
+    TA_NO_THREAD_SAFETY_ANALYSIS {
+    canary_.Assert();
+
+    bool was_full = is_full();
+
+    zx_status_t status = data_.set_max_size(max);
+    if (status != ZX_OK)
+        return status;
+
+    // Growing a full buffer makes room for the writer, and shrinking one to
+    // below what it holds stops the writer until it drains.
+    if (peer_ && was_full != is_full()) {
+        if (was_full) {
+            peer_->UpdateStateLocked(0u, ZX_SOCKET_WRITABLE);
+        } else {
+            peer_->UpdateStateLocked(ZX_SOCKET_WRITABLE, 0u);
+        }
+    }
+    return ZX_OK;
+}
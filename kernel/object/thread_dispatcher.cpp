@@ -16,7 +16,9 @@
 #include <arch/debugger.h>
 #include <arch/exception.h>
 
+#include <kernel/sched.h>
 #include <kernel/thread.h>
+#include <kernel/thread_lock.h>
 #include <vm/kstack.h>
 #include <vm/vm.h>
 #include <vm/vm_address_region.h>
@@ -345,6 +347,15 @@ void ThreadDispatcher::Exiting() {
         }
     }
 
+    // Give back any priority lent by a channel call this thread was serving
+    // or by futex waiters, since their waiters still point at this thread.
+    {
+        Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+        EndCallPriorityLocked();
+        bool local_resched = false;
+        FutexNode::ReleaseLendersLocked(&thread_, &local_resched);
+    }
+
     // Mark the thread as dead. Do this before removing the thread from the
     // process because if this is the last thread then the process will be
     // marked dead, and we don't want to have a state where the process is
@@ -859,6 +870,7 @@ zx_status_t ThreadDispatcher::GetStatsForUserspace(zx_info_thread_stats_t* info)
     *info = {};
 
     info->total_runtime = runtime_ns();
+    info->reserved_runtime = thread_reserved_runtime(&thread_);
     return ZX_OK;
 }
 
@@ -984,6 +996,60 @@ zx_status_t ThreadDispatcher::SetPriority(int32_t priority) {
     return ZX_OK;
 }
 
+zx_status_t ThreadDispatcher::SetBandwidth(uint32_t weight, zx_duration_t capacity,
+                                           zx_duration_t period) {
+    Guard<fbl::Mutex> guard{get_lock()};
+    if ((state_ == State::INITIAL) ||
+        (state_ == State::DYING) ||
+        (state_ == State::DEAD)) {
+        return ZX_ERR_BAD_STATE;
+    }
+    // The bandwidth was already validated by the Profile dispatcher.
+    return thread_set_bandwidth(&thread_, weight, capacity, period);
+}
+
+void ThreadDispatcher::AddFutexLenderLocked(FutexNode* lender, int priority) {
+    lender->LendPriorityLocked(&thread_, priority);
+}
+
+void ThreadDispatcher::InheritCallPriorityLocked(ChannelDispatcher::MessageWaiter* lender,
+                                                 int priority) {
+    DEBUG_ASSERT(get_current_thread() == &thread_);
+
+    if (call_lender_) {
+        call_lender_->borrower_ = nullptr;
+        call_lender_ = nullptr;
+    }
+
+    // Dropping the old priority first lets the new one replace it even if it
+    // is lower.
+    bool local_resched = false;
+    sched_inherit_call_priority(&thread_, -1, &local_resched);
+    if (lender) {
+        // Each call is read once, so no other thread can hold its loan.
+        DEBUG_ASSERT(!lender->borrower_);
+        lender->borrower_ = this;
+        call_lender_ = lender;
+        sched_inherit_call_priority(&thread_, priority, &local_resched);
+    }
+    if (local_resched)
+        sched_reschedule();
+}
+
+void ThreadDispatcher::EndCallPriorityLocked() {
+    if (!call_lender_)
+        return;
+    call_lender_->borrower_ = nullptr;
+    call_lender_ = nullptr;
+
+    // This thread may be running elsewhere, in which case the scheduler sends
+    // that CPU an IPI itself, and |local_resched| stays false.
+    bool local_resched = false;
+    sched_inherit_call_priority(&thread_, -1, &local_resched);
+    if (local_resched)
+        sched_reschedule();
+}
+
 void get_user_thread_process_name(const void* user_thread,
                                   char out_name[ZX_MAX_NAME_LEN]) {
     const ThreadDispatcher* ut =
@@ -121,6 +121,12 @@ zx_status_t VmObjectDispatcher::RangeOp(uint32_t op, uint64_t offset, uint64_t s
             auto status = vmo_->DecommitRange(offset, size, nullptr);
             return status;
         }
+        case ZX_VMO_OP_ZERO: {
+            if ((rights & ZX_RIGHT_WRITE) == 0) {
+                return ZX_ERR_ACCESS_DENIED;
+            }
+            return vmo_->ZeroRange(offset, size);
+        }
         case ZX_VMO_OP_LOCK:
         case ZX_VMO_OP_UNLOCK:
             // TODO: handle or remove
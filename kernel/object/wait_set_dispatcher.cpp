@@ -0,0 +1,286 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <object/wait_set_dispatcher.h>
+
+#include <assert.h>
+#include <err.h>
+
+#include <fbl/algorithm.h>
+#include <fbl/alloc_checker.h>
+#include <kernel/thread.h>
+#include <lib/counters.h>
+#include <object/handle.h>
+#include <object/thread_dispatcher.h>
+#include <zircon/rights.h>
+
+KCOUNTER(wait_set_add_count, "kernel.waitset.add");
+KCOUNTER(wait_set_remove_count, "kernel.waitset.remove");
+
+WaitSetMember::WaitSetMember(fbl::RefPtr<WaitSetDispatcher> wait_set, const Handle* handle,
+                             fbl::RefPtr<Dispatcher> dispatcher, uint64_t cookie,
+                             zx_signals_t signals)
+    : wait_set_(fbl::move(wait_set)),
+      handle_(handle),
+      cookie_(cookie),
+      trigger_(signals),
+      dispatcher_(fbl::move(dispatcher)) {
+}
+
+StateObserver::Flags WaitSetMember::OnInitialize(zx_signals_t initial_state,
+                                                 const StateObserver::CountInfo* cinfo) {
+    canary_.Assert();
+
+    wait_set_->UpdateMember(this, initial_state);
+    return 0;
+}
+
+StateObserver::Flags WaitSetMember::OnStateChange(zx_signals_t new_state) {
+    canary_.Assert();
+
+    wait_set_->UpdateMember(this, new_state);
+    return 0;
+}
+
+StateObserver::Flags WaitSetMember::OnCancel(const Handle* handle) {
+    canary_.Assert();
+
+    if (handle != handle_)
+        return 0;
+    handle_closed_ = true;
+    return kHandled | kNeedRemoval;
+}
+
+StateObserver::Flags WaitSetMember::OnCancelByKey(const Handle* handle, const void* port,
+                                                  uint64_t key) {
+    canary_.Assert();
+
+    // Members are canceled by key only by their own wait set, which doesn't
+    // know which handle they were added with.
+    if (port != wait_set_.get() || key != cookie_)
+        return 0;
+    return kHandled | kNeedRemoval;
+}
+
+void WaitSetMember::OnRemoved() {
+    canary_.Assert();
+
+    if (handle_closed_)
+        wait_set_->CancelMember(this);
+
+    // Drop the reference taken for the object's observer list.
+    if (Release())
+        delete this;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+zx_status_t WaitSetDispatcher::Create(uint32_t options, fbl::RefPtr<Dispatcher>* dispatcher,
+                                      zx_rights_t* rights) {
+    if (options != 0u)
+        return ZX_ERR_INVALID_ARGS;
+
+    fbl::AllocChecker ac;
+    auto disp = new (&ac) WaitSetDispatcher();
+    if (!ac.check())
+        return ZX_ERR_NO_MEMORY;
+
+    *rights = ZX_DEFAULT_WAITSET_RIGHTS;
+    *dispatcher = fbl::AdoptRef<Dispatcher>(disp);
+    return ZX_OK;
+}
+
+WaitSetDispatcher::~WaitSetDispatcher() {
+    DEBUG_ASSERT(members_.is_empty());
+    DEBUG_ASSERT(ready_.is_empty());
+}
+
+void WaitSetDispatcher::on_zero_handles() {
+    canary_.Assert();
+
+    // Members hold references to the wait set, so the wait set can't be
+    // destroyed until they are all gone.
+    Guard<fbl::Mutex> membership_guard{&membership_lock_};
+    for (;;) {
+        fbl::RefPtr<WaitSetMember> member;
+        fbl::RefPtr<Dispatcher> dispatcher;
+        {
+            Guard<fbl::Mutex> guard{get_lock()};
+            zero_handles_ = true;
+            if (members_.is_empty())
+                break;
+            member = DetachMemberLocked(&members_.front(), &dispatcher);
+        }
+        if (dispatcher)
+            dispatcher->CancelByKey(nullptr, this, member->cookie_);
+    }
+}
+
+zx_status_t WaitSetDispatcher::AddMember(Handle* handle, uint64_t cookie,
+                                         zx_signals_t signals) {
+    canary_.Assert();
+
+    // Called under the handle table lock, so |handle| can't be closed until
+    // its observer is in place.
+
+    auto dispatcher = handle->dispatcher();
+    if (!dispatcher->has_state_tracker())
+        return ZX_ERR_NOT_SUPPORTED;
+
+    Guard<fbl::Mutex> membership_guard{&membership_lock_};
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        if (zero_handles_)
+            return ZX_ERR_BAD_STATE;
+        if (members_.find(cookie).IsValid())
+            return ZX_ERR_ALREADY_EXISTS;
+        if (members_.size() >= kMaxMembers)
+            return ZX_ERR_NO_RESOURCES;
+    }
+
+    fbl::AllocChecker ac;
+    fbl::RefPtr<WaitSetMember> member = fbl::AdoptRef(
+        new (&ac) WaitSetMember(fbl::RefPtr<WaitSetDispatcher>(this), handle, dispatcher,
+                                cookie, signals));
+    if (!ac.check())
+        return ZX_ERR_NO_MEMORY;
+
+    // The member has to be in the set before it is observing so that the
+    // object's initial state is recorded.
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        members_.insert(member);
+    }
+
+    // The object's observer list holds a reference until OnRemoved().
+    member->AddRef();
+    dispatcher->AddObserver(member.get(), nullptr);
+
+    kcounter_add(wait_set_add_count, 1);
+    return ZX_OK;
+}
+
+zx_status_t WaitSetDispatcher::RemoveMember(uint64_t cookie) {
+    canary_.Assert();
+
+    Guard<fbl::Mutex> membership_guard{&membership_lock_};
+    fbl::RefPtr<WaitSetMember> member;
+    fbl::RefPtr<Dispatcher> dispatcher;
+    {
+        Guard<fbl::Mutex> guard{get_lock()};
+        auto it = members_.find(cookie);
+        if (!it.IsValid())
+            return ZX_ERR_NOT_FOUND;
+        member = DetachMemberLocked(&*it, &dispatcher);
+    }
+
+    // Once this returns the object won't call the member again, unless its
+    // handle is being closed at the same time, in which case the callback
+    // finds the member detached.
+    if (dispatcher)
+        dispatcher->CancelByKey(nullptr, this, cookie);
+
+    kcounter_add(wait_set_remove_count, 1);
+    return ZX_OK;
+}
+
+zx_status_t WaitSetDispatcher::Wait(zx_time_t deadline, zx_waitset_result_t* results,
+                                    size_t count, size_t* actual, size_t* remaining) {
+    canary_.Assert();
+    DEBUG_ASSERT(count > 0);
+
+    while (true) {
+        {
+            Guard<fbl::Mutex> guard{get_lock()};
+            const size_t reported = fbl::min(count, num_ready_);
+            if (reported > 0) {
+                // Move the reported members to the back so that a caller
+                // with a small buffer sees every ready member in turn.
+                for (size_t i = 0; i < reported; ++i) {
+                    WaitSetMember* member = ready_.pop_front();
+                    results[i] = {member->cookie_, member->status_, member->observed_};
+                    ready_.push_back(member);
+                }
+                *actual = reported;
+                *remaining = num_ready_ - reported;
+                return ZX_OK;
+            }
+        }
+
+        {
+            ThreadDispatcher::AutoBlocked by(ThreadDispatcher::Blocked::WAIT_MANY);
+            zx_status_t st = ready_event_.Wait(deadline);
+            if (st != ZX_OK)
+                return st;
+        }
+    }
+}
+
+void WaitSetDispatcher::UpdateMember(WaitSetMember* member, zx_signals_t signals) {
+    canary_.Assert();
+
+    AutoReschedDisable resched_disable; // Must come before the lock guard.
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    // The member may have just been removed; see RemoveMember().
+    if (!member->InContainer())
+        return;
+
+    member->observed_ = signals;
+    const bool ready = (signals & member->trigger_) != 0u;
+    if (ready == member->ready_node_state_.InContainer())
+        return;
+
+    if (ready) {
+        PushReadyLocked(member);
+        // This Disable() call must come before Signal() to be useful.
+        resched_disable.Disable();
+        ready_event_.Signal();
+    } else {
+        EraseReadyLocked(member);
+    }
+}
+
+void WaitSetDispatcher::CancelMember(WaitSetMember* member) {
+    canary_.Assert();
+
+    // Declared before the guard so the object is released after the lock.
+    fbl::RefPtr<Dispatcher> dispatcher;
+
+    AutoReschedDisable resched_disable; // Must come before the lock guard.
+    Guard<fbl::Mutex> guard{get_lock()};
+
+    dispatcher = fbl::move(member->dispatcher_);
+    if (!member->InContainer())
+        return;
+
+    member->status_ = ZX_ERR_CANCELED;
+    member->observed_ = ZX_SIGNAL_HANDLE_CLOSED;
+    if (!member->ready_node_state_.InContainer()) {
+        PushReadyLocked(member);
+        resched_disable.Disable();
+        ready_event_.Signal();
+    }
+}
+
+fbl::RefPtr<WaitSetMember> WaitSetDispatcher::DetachMemberLocked(
+    WaitSetMember* member, fbl::RefPtr<Dispatcher>* dispatcher) {
+    if (member->ready_node_state_.InContainer())
+        EraseReadyLocked(member);
+    *dispatcher = fbl::move(member->dispatcher_);
+    return members_.erase(*member);
+}
+
+void WaitSetDispatcher::PushReadyLocked(WaitSetMember* member) {
+    ready_.push_back(member);
+    ++num_ready_;
+}
+
+void WaitSetDispatcher::EraseReadyLocked(WaitSetMember* member) {
+    ready_.erase(*member);
+    if (--num_ready_ == 0u)
+        ready_event_.Unsignal();
+}
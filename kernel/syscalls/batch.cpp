@@ -0,0 +1,82 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <err.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <trace.h>
+
+#include <kernel/thread.h>
+#include <lib/counters.h>
+#include <object/process_dispatcher.h>
+
+#include "priv.h"
+
+#define LOCAL_TRACE 0
+
+KCOUNTER(batch_calls, "kernel.syscall.batch.calls");
+
+namespace {
+
+// Makes the call described by one batch entry.  The cases are generated by
+// abigen, one for each syscall that can be batched; see
+// Syscall::is_batchable().  They match the public ZX_BATCH_* numbers, which
+// are derived from the syscall names rather than the kernel's syscall
+// indices; see Syscall::batch_id().
+zx_status_t batch_one(ProcessDispatcher* current_process, uint32_t num, const uint64_t* args) {
+    switch (num) {
+#include <zircon/syscall-kernel-batch.inc>
+    default:
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+}
+
+} // namespace
+
+// zx_status_t zx_syscall_batch
+zx_status_t sys_syscall_batch(uint32_t options, user_inout_ptr<zx_syscall_call_t> calls,
+                              size_t num_calls, user_out_ptr<size_t> num_completed) {
+    LTRACEF("options %#x, %zu calls\n", options, num_calls);
+
+    if (options & ~ZX_SYSCALL_BATCH_STOP_ON_ERROR)
+        return ZX_ERR_INVALID_ARGS;
+    if (num_calls > ZX_SYSCALL_BATCH_MAX)
+        return ZX_ERR_OUT_OF_RANGE;
+
+    auto up = ProcessDispatcher::GetCurrent();
+    thread_t* thread = get_current_thread();
+
+    size_t completed = 0;
+    while (completed < num_calls) {
+        // A call may have killed or suspended this thread.  Let that take
+        // effect now rather than after the rest of the batch; the caller
+        // can resubmit whatever is left.
+        if (completed > 0 && thread_is_signaled(thread))
+            break;
+
+        auto entry = calls.element_offset(completed);
+        zx_syscall_call_t call;
+        if (entry.copy_from_user(&call) != ZX_OK)
+            return ZX_ERR_INVALID_ARGS;
+
+        zx_status_t status = batch_one(up, call.num, call.args);
+        if (entry.byte_offset(offsetof(zx_syscall_call_t, status))
+                .reinterpret<zx_status_t>()
+                .copy_to_user(status) != ZX_OK)
+            return ZX_ERR_INVALID_ARGS;
+
+        ++completed;
+        if (status != ZX_OK && (options & ZX_SYSCALL_BATCH_STOP_ON_ERROR))
+            break;
+    }
+    kcounter_add(batch_calls, completed);
+
+    if (num_completed) {
+        if (num_completed.copy_to_user(completed) != ZX_OK)
+            return ZX_ERR_INVALID_ARGS;
+    }
+    return ZX_OK;
+}
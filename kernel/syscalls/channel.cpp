@@ -8,6 +8,8 @@
 #include <inttypes.h>
 #include <trace.h>
 
+#include <kernel/sched.h>
+#include <kernel/thread_lock.h>
 #include <lib/counters.h>
 #include <lib/ktrace.h>
 
@@ -15,6 +17,9 @@
 #include <object/handle.h>
 #include <object/message_packet.h>
 #include <object/process_dispatcher.h>
+#include <vm/vm_address_region.h>
+#include <vm/vm_aspace.h>
+#include <vm/vm_object.h>
 #include <zircon/syscalls/policy.h>
 #include <zircon/types.h>
 
@@ -25,6 +30,10 @@
 
 #define LOCAL_TRACE 0
 
+// Payloads smaller than this are always copied, as taking the pages away
+// from the writer's mappings costs more than copying them.
+static constexpr uint32_t kMinTransferBytes = 16384u;
+
 KCOUNTER(channel_msg_0_bytes,   "kernel.channel.bytes.0");
 KCOUNTER(channel_msg_64_bytes,  "kernel.channel.bytes.64");
 KCOUNTER(channel_msg_256_bytes, "kernel.channel.bytes.256");
@@ -33,6 +42,15 @@ KCOUNTER(channel_msg_4k_bytes,  "kernel.channel.bytes.4k");
 KCOUNTER(channel_msg_16k_bytes, "kernel.channel.bytes.16k");
 KCOUNTER(channel_msg_64k_bytes, "kernel.channel.bytes.64k");
 KCOUNTER(channel_msg_received,  "kernel.channel.messages");
+KCOUNTER(channel_msg_transferred, "kernel.channel.messages.transferred");
+
+// A thread reading a call made with ZX_CHANNEL_CALL_INHERIT_PRIORITY runs at
+// the caller's priority for as long as the caller waits for the reply.
+static void inherit_call_priority(ChannelDispatcher* channel, const MessagePacket* msg) {
+    if (msg->priority() < 0)
+        return;
+    channel->InheritCallPriority(*msg);
+}
 
 static void record_recv_msg_sz(uint32_t size) {
     kcounter_add(channel_msg_received, 1);
@@ -163,6 +181,7 @@ static zx_status_t channel_read(zx_handle_t handle_value, uint32_t options,
         msg_get_handles(up, msg.get(), handles, num_handles);
     }
 
+    inherit_call_priority(channel.get(), msg.get());
     record_recv_msg_sz(num_bytes);
     ktrace(TAG_CHANNEL_READ, (uint32_t)channel->get_koid(), num_bytes, num_handles, 0);
     return result;
@@ -188,6 +207,81 @@ zx_status_t sys_channel_read_etc(zx_handle_t handle_value, uint32_t options,
         bytes, handle_info, num_bytes, num_handles, actual_bytes, actual_handles);
 }
 
+zx_status_t sys_channel_read_many(zx_handle_t handle_value, uint32_t options,
+                                  user_inout_ptr<zx_channel_read_slot_t> slots,
+                                  size_t num_slots, user_out_ptr<size_t> actual_slots) {
+    LTRACEF("handle %x slots %p num_slots %zu\n", handle_value, slots.get(), num_slots);
+
+    if (options != 0u || num_slots == 0u)
+        return ZX_ERR_INVALID_ARGS;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<ChannelDispatcher> channel;
+    zx_status_t result = up->GetDispatcherWithRights(handle_value, ZX_RIGHT_READ, &channel);
+    if (result != ZX_OK)
+        return result;
+
+    // Read messages into successive slots until the channel is empty or the
+    // next message doesn't fit its slot, in which case it stays queued.  Only
+    // the first message's status is reported: once a message has been read, a
+    // later failure ends the call early rather than failing it.  A message
+    // whose slot faults before anything of it reaches the caller is put back,
+    // since the caller can't tell it was ever taken.
+    size_t count = 0;
+    for (; count < num_slots; ++count) {
+        zx_channel_read_slot_t slot;
+        result = slots.element_offset(count).copy_from_user(&slot);
+        if (result != ZX_OK)
+            break;
+
+        uint32_t num_bytes = slot.num_bytes;
+        uint32_t num_handles = slot.num_handles;
+        fbl::unique_ptr<MessagePacket> msg;
+        result = channel->Read(&num_bytes, &num_handles, &msg, false);
+        if (result != ZX_OK && (count > 0 || result != ZX_ERR_BUFFER_TOO_SMALL))
+            break;
+
+        slot.actual_bytes = num_bytes;
+        slot.actual_handles = num_handles;
+        zx_status_t status = slots.element_offset(count).copy_to_user(slot);
+        if (status != ZX_OK) {
+            if (msg)
+                channel->Unread(fbl::move(msg));
+            result = status;
+            break;
+        }
+        // Only the first slot can get here with ZX_ERR_BUFFER_TOO_SMALL.
+        if (result != ZX_OK)
+            break;
+
+        if (num_bytes > 0u) {
+            if (msg->CopyDataTo(make_user_out_ptr(slot.bytes)) != ZX_OK) {
+                channel->Unread(fbl::move(msg));
+                result = ZX_ERR_INVALID_ARGS;
+                break;
+            }
+        }
+        if (num_handles > 0u) {
+            msg_get_handles(up, msg.get(), make_user_out_ptr(slot.handles), num_handles);
+        }
+
+        inherit_call_priority(channel.get(), msg.get());
+        record_recv_msg_sz(num_bytes);
+        ktrace(TAG_CHANNEL_READ, (uint32_t)channel->get_koid(), num_bytes, num_handles, 0);
+    }
+
+    if (count == 0)
+        return result;
+
+    if (actual_slots) {
+        zx_status_t status = actual_slots.copy_to_user(count);
+        if (status != ZX_OK)
+            return status;
+    }
+    return ZX_OK;
+}
+
 static zx_status_t channel_read_out(ProcessDispatcher* up,
                                     fbl::unique_ptr<MessagePacket> reply,
                                     zx_channel_call_args_t* args,
@@ -271,6 +365,38 @@ static zx_status_t msg_put_handles(ProcessDispatcher* up, MessagePacket* msg,
     return status;
 }
 
+// Takes the pages backing the payload at |user_bytes| out of the VMO mapped
+// there, for ZX_CHANNEL_WRITE_TRANSFER_PAGES. Fails without touching the
+// payload if it isn't large enough, page aligned and within a single
+// writable mapping, in which case the caller should copy it instead.
+static zx_status_t take_user_pages(ProcessDispatcher* up, user_in_ptr<const void> user_bytes,
+                                   uint32_t num_bytes, list_node* pages) {
+    const vaddr_t va = reinterpret_cast<vaddr_t>(user_bytes.get());
+    if (num_bytes < kMinTransferBytes || num_bytes > kMaxMessageSize || !IS_PAGE_ALIGNED(va))
+        return ZX_ERR_NOT_SUPPORTED;
+
+    auto aspace = up->aspace();
+    if (!aspace)
+        return ZX_ERR_BAD_STATE;
+
+    auto region = aspace->FindRegion(va);
+    if (!region)
+        return ZX_ERR_NOT_FOUND;
+    auto vm_mapping = region->as_vm_mapping();
+    if (!vm_mapping)
+        return ZX_ERR_NOT_FOUND;
+
+    // Taking the pages zeroes the range for every mapping of the VMO, so the
+    // writer must be able to write it.
+    const size_t len = ROUNDUP_PAGE_SIZE(num_bytes);
+    if (!(vm_mapping->arch_mmu_flags() & ARCH_MMU_FLAG_PERM_WRITE) ||
+        va - vm_mapping->base() + len > vm_mapping->size())
+        return ZX_ERR_NOT_SUPPORTED;
+
+    const uint64_t offset = va - vm_mapping->base() + vm_mapping->object_offset();
+    return vm_mapping->vmo()->TakePages(offset, len, pages);
+}
+
 zx_status_t sys_channel_write(zx_handle_t handle_value, uint32_t options,
                               user_in_ptr<const void> user_bytes, uint32_t num_bytes,
                               user_in_ptr<const zx_handle_t> user_handles, uint32_t num_handles) {
@@ -279,7 +405,7 @@ zx_status_t sys_channel_write(zx_handle_t handle_value, uint32_t options,
 
     auto up = ProcessDispatcher::GetCurrent();
 
-    if (options != 0u) {
+    if (options & ~ZX_CHANNEL_WRITE_TRANSFER_PAGES) {
         up->RemoveHandles(user_handles, num_handles);
         return ZX_ERR_INVALID_ARGS;
     }
@@ -291,8 +417,17 @@ zx_status_t sys_channel_write(zx_handle_t handle_value, uint32_t options,
         return status;
     }
 
+    // A payload that can't be transferred is copied like any other.
     fbl::unique_ptr<MessagePacket> msg;
-    status = MessagePacket::Create(user_bytes, num_bytes, num_handles, &msg);
+    list_node pages;
+    list_initialize(&pages);
+    if ((options & ZX_CHANNEL_WRITE_TRANSFER_PAGES) &&
+        take_user_pages(up, user_bytes, num_bytes, &pages) == ZX_OK) {
+        kcounter_add(channel_msg_transferred, 1);
+        status = MessagePacket::CreateFromPages(&pages, num_bytes, num_handles, &msg);
+    } else {
+        status = MessagePacket::Create(user_bytes, num_bytes, num_handles, &msg);
+    }
     if (status != ZX_OK) {
         up->RemoveHandles(user_handles, num_handles);
         return status;
@@ -332,7 +467,7 @@ zx_status_t sys_channel_call_noretry(zx_handle_t handle_value, uint32_t options,
 
     auto up = ProcessDispatcher::GetCurrent();
 
-    if (options || num_bytes < sizeof(zx_txid_t)) {
+    if ((options & ~ZX_CHANNEL_CALL_INHERIT_PRIORITY) || num_bytes < sizeof(zx_txid_t)) {
         up->RemoveHandles(user_handles, num_handles);
         return ZX_ERR_INVALID_ARGS;
     }
@@ -359,6 +494,13 @@ zx_status_t sys_channel_call_noretry(zx_handle_t handle_value, uint32_t options,
             return status;
     }
 
+    // The lendable priority already includes anything this thread inherited
+    // itself, so a server making calls to serve a call passes it along.
+    if (options & ZX_CHANNEL_CALL_INHERIT_PRIORITY) {
+        Guard<spin_lock_t, IrqSave> guard{ThreadLock::Get()};
+        msg->set_priority(sched_lendable_priority(get_current_thread()));
+    }
+
     // TODO(ZX-970): ktrace channel calls; maybe two traces, maybe with txid.
 
     // Write message and wait for reply, deadline, or cancelation
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <trace.h>
 
+#include <lib/user_copy/user_iovec.h>
 #include <lib/user_copy/user_ptr.h>
 #include <object/fifo_dispatcher.h>
 #include <object/handle.h>
@@ -86,3 +87,59 @@ zx_status_t sys_fifo_read(zx_handle_t handle, size_t elem_size, user_out_ptr<voi
     }
     return ZX_OK;
 }
+
+zx_status_t sys_fifo_writev(zx_handle_t handle, size_t elem_size,
+                            user_in_ptr<const zx_iovec_t> vector, size_t num_vector,
+                            user_out_ptr<size_t> actual_out) {
+    user_iovec iovec;
+    zx_status_t status = iovec.copy_vector_from_user(vector, num_vector);
+    if (status != ZX_OK)
+        return status;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<FifoDispatcher> fifo;
+    status = up->GetDispatcherWithRights(handle, ZX_RIGHT_WRITE, &fifo);
+    if (status != ZX_OK)
+        return status;
+
+    size_t actual;
+    status = fifo->WriteFromUser(elem_size, &iovec, &actual);
+    if (status != ZX_OK)
+        return status;
+
+    if (actual_out) {
+        status = actual_out.copy_to_user(actual);
+        if (status != ZX_OK)
+            return status;
+    }
+    return ZX_OK;
+}
+
+zx_status_t sys_fifo_readv(zx_handle_t handle, size_t elem_size,
+                           user_in_ptr<const zx_iovec_t> vector, size_t num_vector,
+                           user_out_ptr<size_t> actual_out) {
+    user_iovec iovec;
+    zx_status_t status = iovec.copy_vector_from_user(vector, num_vector);
+    if (status != ZX_OK)
+        return status;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<FifoDispatcher> fifo;
+    status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &fifo);
+    if (status != ZX_OK)
+        return status;
+
+    size_t actual;
+    status = fifo->ReadToUser(elem_size, &iovec, &actual);
+    if (status != ZX_OK)
+        return status;
+
+    if (actual_out) {
+        status = actual_out.copy_to_user(actual);
+        if (status != ZX_OK)
+            return status;
+    }
+    return ZX_OK;
+}
@@ -9,6 +9,7 @@
 #include <trace.h>
 
 #include <object/process_dispatcher.h>
+#include <object/thread_dispatcher.h>
 #include <zircon/types.h>
 
 #include "priv.h"
@@ -19,7 +20,26 @@ zx_status_t sys_futex_wait(user_in_ptr<const zx_futex_t> value_ptr, int32_t curr
     LTRACEF("futex %p current %d\n", value_ptr.get(), current_value);
 
     return ProcessDispatcher::GetCurrent()->futex_context()->FutexWait(
-        value_ptr, current_value, deadline);
+        value_ptr, current_value, deadline, nullptr);
+}
+
+zx_status_t sys_futex_wait_owned(user_in_ptr<const zx_futex_t> value_ptr, int32_t current_value,
+                                 zx_handle_t owner_handle, zx_time_t deadline) {
+    LTRACEF("futex %p current %d owner %x\n", value_ptr.get(), current_value, owner_handle);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<ThreadDispatcher> owner;
+    zx_status_t status = up->GetDispatcherWithRights(owner_handle, ZX_RIGHT_MANAGE_THREAD,
+                                                     &owner);
+    if (status != ZX_OK)
+        return status;
+
+    // Futexes are private to a process, and a thread can't wait on itself.
+    if (owner->process() != up || owner.get() == ThreadDispatcher::GetCurrent())
+        return ZX_ERR_INVALID_ARGS;
+
+    return up->futex_context()->FutexWait(value_ptr, current_value, deadline, owner.get());
 }
 
 zx_status_t sys_futex_wake(user_in_ptr<const zx_futex_t> value_ptr, uint32_t count) {
@@ -13,7 +13,9 @@
 #include <kernel/thread_lock.h>
 #include <lib/heap.h>
 #include <platform.h>
+#include <vm/compression.h>
 #include <vm/pmm.h>
+#include <vm/scanner.h>
 #include <vm/vm.h>
 #include <zircon/time.h>
 #include <zircon/types.h>
@@ -28,8 +30,10 @@
 #include <object/socket_dispatcher.h>
 #include <object/thread_dispatcher.h>
 #include <object/vm_address_region_dispatcher.h>
+#include <object/vm_object_dispatcher.h>
 
 #include <fbl/ref_ptr.h>
+#include <lockdep/lockdep.h>
 
 #include "priv.h"
 
@@ -472,6 +476,54 @@ zx_status_t sys_object_get_info(zx_handle_t handle, uint32_t topic,
         }
         return ZX_OK;
     }
+    case ZX_INFO_LOCK_CLASS_STATS: {
+        auto status = validate_resource(handle, ZX_RSRC_KIND_ROOT);
+        if (status != ZX_OK)
+            return status;
+
+        if (!lockdep::kLockProfilingEnabled)
+            return ZX_ERR_NOT_SUPPORTED;
+
+        size_t num_space_for = buffer_size / sizeof(zx_info_lock_class_stats_t);
+        user_out_ptr<zx_info_lock_class_stats_t> stats_buf =
+            _buffer.reinterpret<zx_info_lock_class_stats_t>();
+
+        // The set of lock classes is fixed at init time, so it's safe to walk
+        // without a lock. The counters are read individually and may be
+        // slightly out of step with each other.
+        size_t num_classes = 0;
+        size_t num_copied = 0;
+        for (auto& state : lockdep::LockClassState::Iter()) {
+            if (num_copied < num_space_for) {
+                const lockdep::LockClassState::Profile profile = state.profile();
+
+                zx_info_lock_class_stats_t stats = {};
+                stats.id = state.profile_id();
+                stats.acquisitions = profile.acquisitions;
+                stats.contended = profile.contended;
+                stats.total_wait_time = profile.total_wait_time;
+                stats.max_hold_time = profile.max_hold_time;
+                strlcpy(stats.name, state.name(), sizeof(stats.name));
+
+                if (stats_buf.copy_array_to_user(&stats, 1, num_copied) != ZX_OK)
+                    return ZX_ERR_INVALID_ARGS;
+                num_copied++;
+            }
+            num_classes++;
+        }
+
+        if (_actual) {
+            zx_status_t status = _actual.copy_to_user(num_copied);
+            if (status != ZX_OK)
+                return status;
+        }
+        if (_avail) {
+            zx_status_t status = _avail.copy_to_user(num_classes);
+            if (status != ZX_OK)
+                return status;
+        }
+        return ZX_OK;
+    }
     case ZX_INFO_KMEM_STATS: {
         auto status = validate_resource(handle, ZX_RSRC_KIND_ROOT);
         if (status != ZX_OK)
@@ -521,6 +573,10 @@ zx_status_t sys_object_get_info(zx_handle_t handle, uint32_t topic,
         // All other VM_PAGE_STATE_* counts get lumped into other_bytes.
         stats.other_bytes = other_bytes;
 
+        stats.zero_reclaimed_bytes = scanner_zero_pages_reclaimed() * PAGE_SIZE;
+        stats.compressed_bytes = compression_stored_pages() * PAGE_SIZE;
+        stats.compressed_storage_bytes = compression_pool_bytes();
+
         return single_record_result(
             _buffer, buffer_size, _actual, _avail, &stats, sizeof(stats));
     }
@@ -588,6 +644,32 @@ zx_status_t sys_object_get_info(zx_handle_t handle, uint32_t topic,
         return single_record_result(
             _buffer, buffer_size, _actual, _avail, &info, sizeof(info));
     }
+    case ZX_INFO_VMO_WORKING_SET: {
+        fbl::RefPtr<VmObjectDispatcher> vmo;
+        auto status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &vmo);
+        if (status != ZX_OK)
+            return status;
+
+        zx_info_working_set_t info;
+        GetVmoWorkingSet(vmo->vmo().get(), &info);
+
+        return single_record_result(
+            _buffer, buffer_size, _actual, _avail, &info, sizeof(info));
+    }
+    case ZX_INFO_PROCESS_WORKING_SET: {
+        fbl::RefPtr<ProcessDispatcher> process;
+        auto status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &process);
+        if (status != ZX_OK)
+            return status;
+
+        zx_info_working_set_t info;
+        status = process->GetWorkingSet(&info);
+        if (status != ZX_OK)
+            return status;
+
+        return single_record_result(
+            _buffer, buffer_size, _actual, _avail, &info, sizeof(info));
+    }
 
     default:
         return ZX_ERR_NOT_SUPPORTED;
@@ -704,7 +786,14 @@ zx_status_t sys_object_set_property(zx_handle_t handle_value, uint32_t property,
     auto up = ProcessDispatcher::GetCurrent();
     fbl::RefPtr<Dispatcher> dispatcher;
 
-    auto status = up->GetDispatcherWithRights(handle_value, ZX_RIGHT_SET_PROPERTY, &dispatcher);
+    // A socket's receive buffer belongs to whoever reads from it, so sizing it
+    // takes the right to read rather than ZX_RIGHT_SET_PROPERTY, which socket
+    // handles don't carry. The writer has no say in it.
+    zx_rights_t rights = ZX_RIGHT_SET_PROPERTY;
+    if (property == ZX_PROP_SOCKET_RX_BUF_MAX)
+        rights = ZX_RIGHT_READ;
+
+    auto status = up->GetDispatcherWithRights(handle_value, rights, &dispatcher);
     if (status != ZX_OK)
         return status;
 
@@ -765,6 +854,18 @@ zx_status_t sys_object_set_property(zx_handle_t handle_value, uint32_t property,
             return status;
         return process->set_debug_addr(value);
     }
+    case ZX_PROP_SOCKET_RX_BUF_MAX: {
+        if (size < sizeof(size_t))
+            return ZX_ERR_BUFFER_TOO_SMALL;
+        auto socket = DownCastDispatcher<SocketDispatcher>(&dispatcher);
+        if (!socket)
+            return ZX_ERR_WRONG_TYPE;
+        size_t value = 0;
+        zx_status_t status = _value.reinterpret<const size_t>().copy_from_user(&value);
+        if (status != ZX_OK)
+            return status;
+        return socket->SetReceiveBufferMax(value);
+    }
     }
 
     return ZX_ERR_INVALID_ARGS;
@@ -20,6 +20,7 @@ MODULE_DEPS := \
 
 MODULE_SRCS := \
     $(LOCAL_DIR)/syscalls.cpp \
+    $(LOCAL_DIR)/batch.cpp \
     $(LOCAL_DIR)/channel.cpp \
     $(LOCAL_DIR)/ddk.cpp \
     $(LOCAL_DIR)/ddk_pci.cpp \
@@ -42,6 +43,7 @@ MODULE_SRCS := \
     $(LOCAL_DIR)/timer.cpp \
     $(LOCAL_DIR)/vmar.cpp \
     $(LOCAL_DIR)/vmo.cpp \
+    $(LOCAL_DIR)/waitset.cpp \
 
 ifeq ($(ARCH),x86)
 MODULE_SRCS += $(LOCAL_DIR)/system_x86.cpp \
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <trace.h>
 
+#include <lib/user_copy/user_iovec.h>
 #include <lib/user_copy/user_ptr.h>
 #include <object/handle.h>
 #include <object/process_dispatcher.h>
@@ -121,6 +122,66 @@ zx_status_t sys_socket_read(zx_handle_t handle, uint32_t options,
     return status;
 }
 
+zx_status_t sys_socket_writev(zx_handle_t handle, uint32_t options,
+                              user_in_ptr<const zx_iovec_t> vector, size_t num_vector,
+                              user_out_ptr<size_t> actual) {
+    LTRACEF("handle %x num_vector %zu\n", handle, num_vector);
+
+    if (options != 0)
+        return ZX_ERR_INVALID_ARGS;
+
+    user_iovec iovec;
+    zx_status_t status = iovec.copy_vector_from_user(vector, num_vector);
+    if (status != ZX_OK)
+        return status;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<SocketDispatcher> socket;
+    status = up->GetDispatcherWithRights(handle, ZX_RIGHT_WRITE, &socket);
+    if (status != ZX_OK)
+        return status;
+
+    size_t nwritten;
+    status = socket->Write(&iovec, &nwritten);
+
+    // Caller may ignore results if desired.
+    if (status == ZX_OK && actual)
+        status = actual.copy_to_user(nwritten);
+
+    return status;
+}
+
+zx_status_t sys_socket_readv(zx_handle_t handle, uint32_t options,
+                             user_in_ptr<const zx_iovec_t> vector, size_t num_vector,
+                             user_out_ptr<size_t> actual) {
+    LTRACEF("handle %x num_vector %zu\n", handle, num_vector);
+
+    if (options != 0)
+        return ZX_ERR_INVALID_ARGS;
+
+    user_iovec iovec;
+    zx_status_t status = iovec.copy_vector_from_user(vector, num_vector);
+    if (status != ZX_OK)
+        return status;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<SocketDispatcher> socket;
+    status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &socket);
+    if (status != ZX_OK)
+        return status;
+
+    size_t nread;
+    status = socket->Read(&iovec, &nread);
+
+    // Caller may ignore results if desired.
+    if (status == ZX_OK && actual)
+        status = actual.copy_to_user(nread);
+
+    return status;
+}
+
 zx_status_t sys_socket_share(zx_handle_t handle, zx_handle_t other) {
     auto up = ProcessDispatcher::GetCurrent();
 
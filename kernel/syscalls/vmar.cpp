@@ -170,7 +170,7 @@ zx_status_t sys_vmar_map(zx_handle_t vmar_handle, uint64_t vmar_offset,
     });
 
     if (do_map_range) {
-        status = vm_mapping->MapRange(vmo_offset, len, false);
+        status = vm_mapping->MapRange(0, len, false);
         if (status != ZX_OK) {
             return status;
         }
@@ -8,6 +8,7 @@
 #include <inttypes.h>
 #include <trace.h>
 
+#include <vm/pmm.h>
 #include <vm/vm_object.h>
 #include <vm/vm_object_paged.h>
 
@@ -201,6 +202,60 @@ zx_status_t sys_vmo_op_range(zx_handle_t handle, uint32_t op, uint64_t offset, u
     return vmo->RangeOp(op, offset, size, _buffer, buffer_size, rights);
 }
 
+zx_status_t sys_vmo_transfer_pages(zx_handle_t dst_handle, uint64_t dst_offset,
+                                   zx_handle_t src_handle, uint64_t src_offset,
+                                   uint64_t size) {
+    LTRACEF("dst %x offset %#" PRIx64 " src %x offset %#" PRIx64 " size %#" PRIx64 "\n",
+            dst_handle, dst_offset, src_handle, src_offset, size);
+
+    if (!IS_PAGE_ALIGNED(dst_offset) || !IS_PAGE_ALIGNED(src_offset) ||
+        !IS_PAGE_ALIGNED(size)) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<VmObjectDispatcher> dst;
+    zx_status_t status = up->GetDispatcherWithRights(dst_handle, ZX_RIGHT_WRITE, &dst);
+    if (status != ZX_OK)
+        return status;
+
+    // taking the pages out of the source both reads and writes it
+    fbl::RefPtr<VmObjectDispatcher> src;
+    status = up->GetDispatcherWithRights(src_handle, ZX_RIGHT_READ | ZX_RIGHT_WRITE, &src);
+    if (status != ZX_OK)
+        return status;
+
+    if (size == 0)
+        return ZX_OK;
+
+    // check the destination up front so that a transfer it can't take doesn't
+    // cost the source its contents; SupplyPages() checks again under the lock
+    uint64_t src_end, dst_end;
+    if (add_overflow(src_offset, size, &src_end) || add_overflow(dst_offset, size, &dst_end) ||
+        dst_end > dst->vmo()->size())
+        return ZX_ERR_OUT_OF_RANGE;
+    if (!dst->vmo()->is_paged() || dst->vmo()->is_contiguous())
+        return ZX_ERR_NOT_SUPPORTED;
+    if (dst->vmo() == src->vmo() && src_offset < dst_end && dst_offset < src_end)
+        return ZX_ERR_INVALID_ARGS;
+
+    list_node pages;
+    list_initialize(&pages);
+    status = src->vmo()->TakePages(src_offset, size, &pages);
+    if (status != ZX_OK)
+        return status;
+
+    // if the destination changed under us, say by being resized or pinned,
+    // hand the pages back to the source
+    status = dst->vmo()->SupplyPages(dst_offset, size, &pages);
+    if (status != ZX_OK && !list_is_empty(&pages)) {
+        if (src->vmo()->SupplyPages(src_offset, size, &pages) != ZX_OK)
+            pmm_free(&pages);
+    }
+    return status;
+}
+
 zx_status_t sys_vmo_set_cache_policy(zx_handle_t handle, uint32_t cache_policy) {
     fbl::RefPtr<VmObjectDispatcher> vmo;
     zx_status_t status = ZX_OK;
@@ -0,0 +1,115 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <err.h>
+#include <inttypes.h>
+#include <trace.h>
+
+#include <object/handle.h>
+#include <object/process_dispatcher.h>
+#include <object/wait_set_dispatcher.h>
+
+#include <fbl/algorithm.h>
+#include <fbl/ref_ptr.h>
+
+#include <zircon/types.h>
+
+#include "priv.h"
+
+#define LOCAL_TRACE 0
+
+zx_status_t sys_waitset_create(uint32_t options, user_out_handle* out) {
+    LTRACEF("options %u\n", options);
+
+    fbl::RefPtr<Dispatcher> dispatcher;
+    zx_rights_t rights;
+
+    zx_status_t result = WaitSetDispatcher::Create(options, &dispatcher, &rights);
+    if (result != ZX_OK)
+        return result;
+
+    return out->make(fbl::move(dispatcher), rights);
+}
+
+zx_status_t sys_waitset_add(zx_handle_t handle, uint64_t cookie, zx_handle_t member,
+                            zx_signals_t signals) {
+    LTRACEF("handle %x cookie %#" PRIx64 " member %x\n", handle, cookie, member);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<WaitSetDispatcher> wait_set;
+    zx_status_t status = up->GetDispatcherWithRights(handle, ZX_RIGHT_WRITE, &wait_set);
+    if (status != ZX_OK)
+        return status;
+
+    Guard<fbl::Mutex> guard{up->handle_table_lock()};
+    Handle* watched = up->GetHandleLocked(member);
+    if (!watched)
+        return ZX_ERR_BAD_HANDLE;
+    if (!watched->HasRights(ZX_RIGHT_WAIT))
+        return ZX_ERR_ACCESS_DENIED;
+
+    return wait_set->AddMember(watched, cookie, signals);
+}
+
+zx_status_t sys_waitset_remove(zx_handle_t handle, uint64_t cookie) {
+    LTRACEF("handle %x cookie %#" PRIx64 "\n", handle, cookie);
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<WaitSetDispatcher> wait_set;
+    zx_status_t status = up->GetDispatcherWithRights(handle, ZX_RIGHT_WRITE, &wait_set);
+    if (status != ZX_OK)
+        return status;
+
+    return wait_set->RemoveMember(cookie);
+}
+
+zx_status_t sys_waitset_wait(zx_handle_t handle, zx_time_t deadline,
+                             user_out_ptr<zx_waitset_result_t> results_out, size_t count,
+                             user_out_ptr<size_t> actual_out) {
+    LTRACEF("handle %x count %zu\n", handle, count);
+
+    if (count == 0)
+        return ZX_ERR_INVALID_ARGS;
+
+    auto up = ProcessDispatcher::GetCurrent();
+
+    fbl::RefPtr<WaitSetDispatcher> wait_set;
+    zx_status_t status = up->GetDispatcherWithRights(handle, ZX_RIGHT_READ, &wait_set);
+    if (status != ZX_OK)
+        return status;
+
+    // Results are staged on the stack a chunk at a time. Only the first
+    // chunk waits; the rest take the ready members the first one couldn't.
+    constexpr size_t kMaxChunk = 16;
+    zx_waitset_result_t results[kMaxChunk];
+    size_t total = 0;
+    size_t remaining = 0;
+    zx_status_t st = ZX_OK;
+    do {
+        size_t chunk = fbl::min(count - total, kMaxChunk);
+        if (total > 0)
+            chunk = fbl::min(chunk, remaining);
+
+        size_t actual;
+        st = wait_set->Wait(total == 0 ? deadline : 0, results, chunk, &actual, &remaining);
+        if (st != ZX_OK)
+            break;
+
+        status = results_out.copy_array_to_user(results, actual, total);
+        if (status != ZX_OK)
+            return status;
+        total += actual;
+    } while (total < count && remaining > 0);
+
+    if (total == 0)
+        return st;
+
+    if (actual_out)
+        return actual_out.copy_to_user(total);
+    return ZX_OK;
+}
@@ -15,9 +15,11 @@
 
 #include <explicit-memory/bytes.h>
 #include <kernel/auto_lock.h>
+#include <kernel/mutex.h>
 #include <kernel/thread.h>
 #include <lib/crypto/global_prng.h>
 #include <lib/user_copy/user_ptr.h>
+#include <lib/vdso.h>
 #include <object/event_dispatcher.h>
 #include <object/event_pair_dispatcher.h>
 #include <object/handle.h>
@@ -62,7 +64,12 @@ zx_status_t sys_nanosleep(zx_time_t deadline) {
 // update pvclock too.
 fbl::atomic<int64_t> utc_offset;
 
-zx_time_t sys_clock_get(zx_clock_t clock_id) {
+// Serializes updates to |utc_offset| and its copy in the vDSO.
+DECLARE_SINGLETON_MUTEX(ClockAdjustLock);
+
+// zx_clock_get() and friends are implemented in the vDSO, which only
+// calls this when it can't compute the time itself.
+zx_time_t sys_clock_get_via_kernel(zx_clock_t clock_id) {
     switch (clock_id) {
     case ZX_CLOCK_MONOTONIC:
         return current_time();
@@ -76,29 +83,6 @@ zx_time_t sys_clock_get(zx_clock_t clock_id) {
     }
 }
 
-zx_status_t sys_clock_get_new(zx_clock_t clock_id, user_out_ptr<zx_time_t> out_time) {
-    zx_time_t time;
-    switch (clock_id) {
-    case ZX_CLOCK_MONOTONIC:
-        time = current_time();
-        break;
-    case ZX_CLOCK_UTC:
-        time = current_time() + utc_offset.load();
-        break;
-    case ZX_CLOCK_THREAD:
-        time = ThreadDispatcher::GetCurrent()->runtime_ns();
-        break;
-    default:
-        return ZX_ERR_INVALID_ARGS;
-    }
-
-    return out_time.copy_to_user(time);
-}
-
-zx_time_t sys_clock_get_monotonic() {
-    return current_time();
-}
-
 zx_status_t sys_clock_adjust(zx_handle_t hrsrc, zx_clock_t clock_id, int64_t offset) {
     // TODO(ZX-971): finer grained validation
     zx_status_t status;
@@ -109,9 +93,12 @@ zx_status_t sys_clock_adjust(zx_handle_t hrsrc, zx_clock_t clock_id, int64_t off
     switch (clock_id) {
     case ZX_CLOCK_MONOTONIC:
         return ZX_ERR_ACCESS_DENIED;
-    case ZX_CLOCK_UTC:
+    case ZX_CLOCK_UTC: {
+        Guard<fbl::Mutex> guard{ClockAdjustLock::Get()};
         utc_offset.store(offset);
+        VDso::SetUtcOffset(offset);
         return ZX_OK;
+    }
     default:
         return ZX_ERR_INVALID_ARGS;
     }
@@ -270,6 +270,66 @@ __NO_INLINE static void bench_mutex() {
     printf("%" PRIu64 " cycles to acquire/release uncontended mutex %u times (%" PRIu64 " cycles per)\n", c, count, c / count);
 }
 
+struct mutex_contention_args {
+    mutex_t* m;
+    uint count;
+    volatile uint64_t* shared;
+};
+
+static int mutex_contention_thread(void* arg) {
+    auto args = static_cast<mutex_contention_args*>(arg);
+    for (uint i = 0; i < args->count; i++) {
+        mutex_acquire(args->m);
+        // a short critical section, roughly the size of a handle table update
+        for (int j = 0; j < 16; j++) {
+            (*args->shared)++;
+        }
+        mutex_release(args->m);
+    }
+    return 0;
+}
+
+// Two threads on different cpus hammer the same mutex with short critical
+// sections, the case adaptive spinning is meant to help.
+__NO_INLINE static void bench_mutex_contended() {
+    const cpu_mask_t online = mp_get_online_mask();
+    if ((online & (online - 1)) == 0) {
+        printf("skipping contended mutex benchmark, need more than one cpu\n");
+        return;
+    }
+    const cpu_num_t cpu0 = __builtin_ctz(online);
+    const cpu_num_t cpu1 = __builtin_ctz(online & ~cpu_num_to_mask(cpu0));
+
+    mutex_t m;
+    mutex_init(&m);
+    volatile uint64_t shared = 0;
+    mutex_contention_args args = {&m, 1024 * 1024, &shared};
+
+    thread_t* threads[2];
+    threads[0] = thread_create("mutex bench 0", mutex_contention_thread, &args,
+                               DEFAULT_PRIORITY, DEFAULT_STACK_SIZE);
+    threads[1] = thread_create("mutex bench 1", mutex_contention_thread, &args,
+                               DEFAULT_PRIORITY, DEFAULT_STACK_SIZE);
+    if (threads[0] == nullptr || threads[1] == nullptr) {
+        TRACEF("error: thread_create failed\n");
+        return;
+    }
+    thread_set_cpu_affinity(threads[0], cpu_num_to_mask(cpu0));
+    thread_set_cpu_affinity(threads[1], cpu_num_to_mask(cpu1));
+
+    uint64_t c = arch_cycle_count();
+    thread_resume(threads[0]);
+    thread_resume(threads[1]);
+    thread_join(threads[0], nullptr, ZX_TIME_INFINITE);
+    thread_join(threads[1], nullptr, ZX_TIME_INFINITE);
+    c = arch_cycle_count() - c;
+
+    const uint total = args.count * 2;
+    printf("%" PRIu64 " cycles to acquire/release contended mutex %u times across 2 cpus (%" PRIu64 " cycles per)\n",
+           c, total, c / total);
+    mutex_destroy(&m);
+}
+
 int benchmarks(int, const cmd_args*, uint32_t) {
     bench_set_overhead();
     bench_memcpy();
@@ -286,6 +346,7 @@ int benchmarks(int, const cmd_args*, uint32_t) {
 
     bench_spinlock();
     bench_mutex();
+    bench_mutex_contended();
 
     return 0;
 }
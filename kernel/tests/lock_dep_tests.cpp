@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <fbl/mutex.h>
+#include <kernel/thread.h>
 #include <lib/unittest/unittest.h>
 #include <lockdep/guard_multiple.h>
 #include <lockdep/lockdep.h>
@@ -228,6 +229,10 @@ struct Number {
     void TestExclude() __TA_EXCLUDES(lock) {}
 };
 
+struct Profiled {
+    LOCK_DEP_INSTRUMENT(Profiled, Mutex) lock;
+};
+
 lockdep::LockResult GetLastResult() {
 #if WITH_LOCK_DEP
     lockdep::ThreadLockState* state = lockdep::ThreadLockState::Get();
@@ -657,6 +662,55 @@ static bool lock_dep_dynamic_analysis_tests() {
     END_TEST;
 }
 
+// Tests that the contention profiler counts acquisitions and hold times.
+static bool lock_dep_profiling_tests() {
+    BEGIN_TEST;
+
+#if WITH_LOCK_DEP
+    using lockdep::Guard;
+    using lockdep::LockClassState;
+    using test::Mutex;
+    using test::Profiled;
+
+    if (lockdep::kLockProfilingEnabled) {
+        LockClassState* state =
+            decltype(Profiled::lock)::LockClass<>::GetLockClassState();
+        state->ResetProfile();
+
+        Profiled a{};
+        for (int i = 0; i < 3; i++) {
+            Guard<Mutex> guard{&a.lock};
+            EXPECT_TRUE(guard, "");
+        }
+
+        {
+            Guard<Mutex> guard{&a.lock};
+            thread_sleep_relative(ZX_MSEC(1));
+        }
+
+        const LockClassState::Profile profile = state->profile();
+        EXPECT_EQ(4u, profile.acquisitions, "");
+        EXPECT_LE(profile.contended, profile.acquisitions, "");
+        EXPECT_GE(profile.max_hold_time, static_cast<uint64_t>(ZX_MSEC(1)), "");
+
+        state->ResetProfile();
+        EXPECT_EQ(0u, state->profile().acquisitions, "");
+    }
+
+    // Profile ids number the lock classes from zero, without gaps, so no two
+    // classes share an id.
+    size_t num_classes = 0;
+    uint64_t id_sum = 0;
+    for (auto& state : LockClassState::Iter()) {
+        num_classes++;
+        id_sum += state.profile_id();
+    }
+    EXPECT_EQ(num_classes * (num_classes - 1) / 2, id_sum, "");
+#endif
+
+    END_TEST;
+}
+
 // Basic compile-time tests of lockdep clang lock annotations.
 static bool lock_dep_static_analysis_tests() {
     BEGIN_TEST;
@@ -717,6 +771,7 @@ static bool lock_dep_static_analysis_tests() {
 UNITTEST_START_TESTCASE(lock_dep_tests)
 UNITTEST("lock_dep_dynamic_analysis_tests", lock_dep_dynamic_analysis_tests)
 UNITTEST("lock_dep_static_analysis_tests", lock_dep_static_analysis_tests)
+UNITTEST("lock_dep_profiling_tests", lock_dep_profiling_tests)
 UNITTEST_END_TESTCASE(lock_dep_tests, "lock_dep_tests", "lock_dep_tests");
 
 #endif
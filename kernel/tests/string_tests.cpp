@@ -5,9 +5,12 @@
 // license that can be found in the LICENSE file or at
 // https://opensource.org/licenses/MIT
 
+#include <arch/ops.h>
 #include <inttypes.h>
+#include <fbl/algorithm.h>
 #include <fbl/auto_call.h>
 #include <kernel/thread.h>
+#include <lib/unittest/unittest.h>
 #include <malloc.h>
 #include <platform.h>
 #include <stdio.h>
@@ -289,6 +292,60 @@ static void validate_memset(void) {
     }
 }
 
+// Times memcpy, memmove, memset and memcmp at a range of sizes, since the
+// optimized routines switch strategy by size and the large-buffer benchmarks
+// above only see their bulk loops.
+static void bench_sizes(void) {
+    static const size_t kSizes[] = {8, 16, 32, 64, 128, 256, 1024, 4096, 65536, 1024 * 1024};
+
+    printf("per-size speed test (nsecs per call)\n");
+    thread_sleep_relative(ZX_MSEC(200)); // let the debug string clear the serial port
+
+    fillbuf(src, BUFFER_SIZE, 567);
+    memcpy(dst, src, BUFFER_SIZE);
+
+    for (size_t size : kSizes) {
+        // Do roughly the same number of bytes at each size, within reason.
+        const size_t iterations = fbl::clamp<size_t>(BUFFER_SIZE * 8 / size, 1000, 1000000);
+
+        spin_lock_saved_state_t state;
+        arch_interrupt_save(&state, ARCH_DEFAULT_SPIN_LOCK_FLAG_INTERRUPTS);
+
+        zx_time_t t0 = current_time();
+        for (size_t i = 0; i < iterations; i++) {
+            memcpy(dst, src, size);
+        }
+        zx_duration_t cpy = current_time() - t0;
+
+        t0 = current_time();
+        for (size_t i = 0; i < iterations; i++) {
+            memmove(src + 1, src, size);
+        }
+        zx_duration_t move = current_time() - t0;
+
+        t0 = current_time();
+        for (size_t i = 0; i < iterations; i++) {
+            memset(dst2, 0, size);
+        }
+        zx_duration_t set = current_time() - t0;
+
+        memcpy(src2, dst2, size);
+        volatile int result = 0;
+        t0 = current_time();
+        for (size_t i = 0; i < iterations; i++) {
+            result = memcmp(dst2, src2, size);
+        }
+        zx_duration_t cmp = current_time() - t0;
+        (void)result;
+
+        arch_interrupt_restore(state, ARCH_DEFAULT_SPIN_LOCK_FLAG_INTERRUPTS);
+
+        printf("size %8zu: memcpy %" PRIi64 ", memmove %" PRIi64 ", memset %" PRIi64
+               ", memcmp %" PRIi64 "\n",
+               size, cpy / iterations, move / iterations, set / iterations, cmp / iterations);
+    }
+}
+
 #if defined(WITH_LIB_CONSOLE)
 #include <lib/console.h>
 
@@ -326,6 +383,7 @@ static int string_tests(int argc, const cmd_args* argv, uint32_t flags) {
     usage:
         printf("%s validate <routine>\n", argv[0].str);
         printf("%s bench <routine>\n", argv[0].str);
+        printf("%s bench sizes\n", argv[0].str);
         return -1;
     }
 
@@ -340,6 +398,8 @@ static int string_tests(int argc, const cmd_args* argv, uint32_t flags) {
             bench_memcpy();
         } else if (!strcmp(argv[2].str, "memset")) {
             bench_memset();
+        } else if (!strcmp(argv[2].str, "sizes")) {
+            bench_sizes();
         }
     } else {
         goto usage;
@@ -353,3 +413,109 @@ STATIC_COMMAND("string", "memcpy tests", &string_tests)
 STATIC_COMMAND_END(stringtests);
 
 #endif
+
+// Check memmove against the reference implementation for overlapping copies
+// in both directions, at sizes that cover each of the small, medium and
+// bulk paths of the optimized routines.
+static bool memmove_overlap_test() {
+    BEGIN_TEST;
+
+    constexpr size_t kBufLen = 1024;
+    static uint8_t expected[kBufLen];
+    static uint8_t actual[kBufLen];
+
+    static const size_t kSizes[] = {0, 1, 7, 8, 15, 16, 31, 63, 64, 95, 96, 97, 128, 255, 256, 700};
+    for (size_t size : kSizes) {
+        for (int shift = -17; shift <= 17; ++shift) {
+            const size_t from = 160;
+            const size_t to = from + shift;
+
+            fillbuf(expected, kBufLen, 1234);
+            fillbuf(actual, kBufLen, 1234);
+            c_memmove(expected + to, expected + from, size);
+            memmove(actual + to, actual + from, size);
+            ASSERT_TRUE(!memcmp(expected, actual, kBufLen), "memmove mismatch");
+        }
+    }
+
+    END_TEST;
+}
+
+static int sign(int x) {
+    return (x > 0) - (x < 0);
+}
+
+static bool memcmp_test() {
+    BEGIN_TEST;
+
+    constexpr size_t kBufLen = 160;
+    static uint8_t a[kBufLen + 8];
+    static uint8_t b[kBufLen + 8];
+
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t len = 0; len <= kBufLen; ++len) {
+            fillbuf(a + offset, len, 42);
+            fillbuf(b, len, 42);
+            ASSERT_EQ(0, memcmp(a + offset, b, len), "equal buffers");
+
+            // Differ at each position in turn, with bytes that only compare
+            // correctly as unsigned.
+            for (size_t i = 0; i < len; ++i) {
+                const uint8_t saved = b[i];
+                a[offset + i] = 0x01;
+                b[i] = 0xf0;
+                ASSERT_EQ(-1, sign(memcmp(a + offset, b, len)), "less");
+                ASSERT_EQ(1, sign(memcmp(b, a + offset, len)), "greater");
+                a[offset + i] = saved;
+                b[i] = saved;
+            }
+        }
+    }
+
+    END_TEST;
+}
+
+// Zeroing large enough runs makes the optimized memset use DC ZVA on arm64,
+// so check it around cache line and page boundaries.
+static bool memset_zero_test() {
+    BEGIN_TEST;
+
+    constexpr size_t kBufLen = 3 * PAGE_SIZE;
+    uint8_t* buf = static_cast<uint8_t*>(memalign(PAGE_SIZE, kBufLen));
+    ASSERT_NONNULL(buf, "memalign failed");
+
+    auto free_buf = fbl::MakeAutoCall([buf]() { free(buf); });
+
+    auto zeroed_exactly = [buf](size_t offset, size_t size) {
+        for (size_t i = 0; i < kBufLen; ++i) {
+            const bool zeroed = i >= offset && i < offset + size;
+            if (buf[i] != (zeroed ? 0 : 0xa5)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    static const size_t kOffsets[] = {0, 1, 63, 64, 65, PAGE_SIZE - 1};
+    static const size_t kSizes[] = {0, 63, 64, 127, 256, 1000, PAGE_SIZE, PAGE_SIZE + 65};
+    for (size_t offset : kOffsets) {
+        for (size_t size : kSizes) {
+            memset(buf, 0xa5, kBufLen);
+            memset(buf + offset, 0, size);
+            ASSERT_TRUE(zeroed_exactly(offset, size), "memset wrote the wrong bytes");
+        }
+    }
+
+    // arch_zero_page() should clear exactly one page.
+    memset(buf, 0xa5, kBufLen);
+    arch_zero_page(buf + PAGE_SIZE);
+    EXPECT_TRUE(zeroed_exactly(PAGE_SIZE, PAGE_SIZE), "arch_zero_page wrote the wrong bytes");
+
+    END_TEST;
+}
+
+UNITTEST_START_TESTCASE(string_tests)
+UNITTEST("memmove overlap", memmove_overlap_test)
+UNITTEST("memcmp", memcmp_test)
+UNITTEST("memset zero", memset_zero_test)
+UNITTEST_END_TESTCASE(string_tests, "string", "memory and string routine tests");
@@ -11,6 +11,7 @@
 #include <malloc.h>
 #include <platform.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <kernel/event.h>
 #include <kernel/thread.h>
@@ -190,11 +191,140 @@ static void timer_far_deadline(void) {
     event_destroy(&event);
 }
 
+struct many_timers {
+    timer_t* timers;
+    size_t* fired;         // indices into |timers|, in the order they fired
+    zx_time_t* fired_at;   // indexed like |timers|
+    cpu_num_t* fired_cpu;  // indexed like |timers|
+    uint32_t* fire_count;  // indexed like |timers|
+    fbl::atomic<size_t> fired_count;
+};
+
+static void timer_cb_many(timer_t* timer, zx_time_t now, void* arg) {
+    auto state = static_cast<many_timers*>(arg);
+    size_t ix = static_cast<size_t>(timer - state->timers);
+    state->fired_at[ix] = now;
+    state->fired_cpu[ix] = arch_curr_cpu_num();
+    state->fire_count[ix]++;
+    state->fired[state->fired_count.fetch_add(1)] = ix;
+    thread_preempt_set_pending();
+}
+
+// Sets a large number of timers with random deadlines and slack, cancels
+// every other one, and checks that exactly the rest fire, each no earlier
+// than its deadline and, on each cpu, in deadline order. Also reports the
+// average cost of the timer_set() and timer_cancel() calls.
+static bool timer_test_many(void) {
+    constexpr size_t kTimerCount = 100000;
+    // Long enough that every timer is set before the first one fires, which
+    // the order check relies on.
+    constexpr zx_duration_t kLead = ZX_SEC(1);
+    printf("testing %zu concurrent timers\n", kTimerCount);
+
+    many_timers state;
+    state.timers = static_cast<timer_t*>(malloc(sizeof(timer_t) * kTimerCount));
+    state.fired = static_cast<size_t*>(malloc(sizeof(size_t) * kTimerCount));
+    state.fired_at = static_cast<zx_time_t*>(malloc(sizeof(zx_time_t) * kTimerCount));
+    state.fired_cpu = static_cast<cpu_num_t*>(malloc(sizeof(cpu_num_t) * kTimerCount));
+    state.fire_count = static_cast<uint32_t*>(calloc(kTimerCount, sizeof(uint32_t)));
+    state.fired_count.store(0);
+    bool success = false;
+    if (!state.timers || !state.fired || !state.fired_at || !state.fired_cpu ||
+        !state.fire_count) {
+        printf("failed to allocate timers\n");
+        goto out;
+    }
+
+    {
+        const zx_time_t when = current_time() + kLead;
+        zx_time_t start = current_time();
+        for (size_t ix = 0; ix != kTimerCount; ++ix) {
+            timer_init(&state.timers[ix]);
+            zx_time_t deadline = when + (rand() % ZX_MSEC(100));
+            enum slack_mode mode = static_cast<enum slack_mode>(rand() % 3);
+            zx_duration_t slack = rand() % ZX_USEC(50);
+            timer_set(&state.timers[ix], deadline, mode, slack, timer_cb_many, &state);
+        }
+        zx_duration_t set_time = current_time() - start;
+        if (current_time() >= when - ZX_USEC(50)) {
+            printf("!! setting the timers took %" PRIi64 " ns, too long to check them\n",
+                   set_time);
+            goto out;
+        }
+
+        start = current_time();
+        size_t canceled_count = 0;
+        for (size_t ix = 0; ix < kTimerCount; ix += 2) {
+            if (timer_cancel(&state.timers[ix])) {
+                canceled_count++;
+            }
+        }
+        zx_duration_t cancel_time = current_time() - start;
+
+        printf("timer_set %" PRIi64 " ns, timer_cancel %" PRIi64 " ns on average\n",
+               set_time / static_cast<zx_duration_t>(kTimerCount),
+               cancel_time / static_cast<zx_duration_t>(kTimerCount / 2));
+        if (canceled_count != kTimerCount / 2) {
+            printf("!! canceled %zu timers, expected %zu\n", canceled_count, kTimerCount / 2);
+            goto out;
+        }
+
+        // Wait for the timers to fire.
+        while (state.fired_count.load() < kTimerCount / 2) {
+            thread_sleep(current_time() + ZX_MSEC(5));
+        }
+        // Give any timer that would fire in error a chance to.
+        thread_sleep(current_time() + ZX_MSEC(10));
+    }
+
+    success = true;
+    if (state.fired_count.load() != kTimerCount / 2) {
+        printf("!! %zu timers fired, expected %zu\n", state.fired_count.load(), kTimerCount / 2);
+        success = false;
+    }
+    for (size_t ix = 0; ix != kTimerCount; ++ix) {
+        uint32_t expected = (ix % 2) ? 1u : 0u;
+        if (state.fire_count[ix] != expected) {
+            printf("!! timer %zu fired %u times, expected %u\n", ix, state.fire_count[ix],
+                   expected);
+            success = false;
+        } else if (expected && state.fired_at[ix] < state.timers[ix].scheduled_time) {
+            printf("!! timer %zu fired at %" PRIi64 ", before %" PRIi64 "\n", ix,
+                   state.fired_at[ix], state.timers[ix].scheduled_time);
+            success = false;
+        }
+    }
+    if (success) {
+        zx_time_t last[SMP_MAX_CPUS] = {};
+        for (size_t n = 0; n != kTimerCount / 2; ++n) {
+            size_t ix = state.fired[n];
+            cpu_num_t cpu = state.fired_cpu[ix];
+            if (state.timers[ix].scheduled_time < last[cpu]) {
+                printf("!! timer %zu due at %" PRIi64 " fired after one due at %" PRIi64
+                       " on cpu %u\n",
+                       ix, state.timers[ix].scheduled_time, last[cpu], cpu);
+                success = false;
+                break;
+            }
+            last[cpu] = state.timers[ix].scheduled_time;
+        }
+    }
+
+out:
+    free(state.fire_count);
+    free(state.fired_cpu);
+    free(state.fired_at);
+    free(state.fired);
+    free(state.timers);
+    return success;
+}
+
 int timer_tests(int, const cmd_args*, uint32_t) {
     timer_test_coalescing_center();
     timer_test_coalescing_late();
     timer_test_coalescing_early();
+    bool many_ok = timer_test_many();
     timer_test_all_cpus();
     timer_far_deadline();
-    return 0;
+    return many_ok ? 0 : ZX_ERR_INTERNAL;
 }
@@ -0,0 +1,229 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <vm/compression.h>
+
+#include <assert.h>
+#include <fbl/algorithm.h>
+#include <fbl/alloc_checker.h>
+#include <fbl/atomic.h>
+#include <fbl/auto_lock.h>
+#include <fbl/mutex.h>
+#include <inttypes.h>
+#include <kernel/cmdline.h>
+#include <kernel/thread.h>
+#include <lib/console.h>
+#include <lib/counters.h>
+#include <lk/init.h>
+#include <lz4/lz4.h>
+#include <stdlib.h>
+#include <string.h>
+#include <trace.h>
+#include <vm/physmap.h>
+#include <vm/pmm.h>
+#include <vm/vm.h>
+#include <vm/vm_object.h>
+#include <zircon/time.h>
+#include <zircon/types.h>
+
+#include "vm_priv.h"
+
+#define LOCAL_TRACE MAX(VM_GLOBAL_TRACE, 0)
+
+KCOUNTER(compression_compressed, "kernel.vm.compression.compressed");
+KCOUNTER(compression_decompressed, "kernel.vm.compression.decompressed");
+KCOUNTER(compression_incompressible, "kernel.vm.compression.incompressible");
+
+namespace {
+
+// Pages that don't compress to at most this size stay resident.
+constexpr size_t kMaxCompressedSize = PAGE_SIZE * 3 / 4;
+
+// Set from the kernel command line by compression_init().
+bool compression_enabled = false;
+uint64_t pool_limit_bytes = 0;
+uint8_t compression_min_age = 3;
+
+// Bytes of compressed data held and the number of pages they hold.
+fbl::atomic<uint64_t> pool_bytes;
+fbl::atomic<uint64_t> stored_pages;
+
+// Guards the scratch state used while compressing, which is too large to
+// live on a kernel stack.
+fbl::Mutex compress_lock;
+alignas(8) char compress_state[LZ4_STREAMSIZE] TA_GUARDED(compress_lock);
+char compress_buffer[kMaxCompressedSize] TA_GUARDED(compress_lock);
+
+} // namespace
+
+VmCompressedPage::VmCompressedPage(uint64_t offset, fbl::unique_ptr<uint8_t[]> data, size_t size)
+    : offset_(offset), data_(fbl::move(data)), size_(size) {
+    pool_bytes.fetch_add(size_);
+    stored_pages.fetch_add(1);
+}
+
+VmCompressedPage::~VmCompressedPage() {
+    pool_bytes.fetch_sub(size_);
+    stored_pages.fetch_sub(1);
+}
+
+bool VmCompressedPage::PoolFull() {
+    return pool_bytes.load() + kMaxCompressedSize > pool_limit_bytes;
+}
+
+fbl::unique_ptr<VmCompressedPage> VmCompressedPage::Compress(uint64_t offset, paddr_t pa) {
+    if (PoolFull()) {
+        return nullptr;
+    }
+
+    const char* src = static_cast<const char*>(paddr_to_physmap(pa));
+    DEBUG_ASSERT(src);
+
+    fbl::AutoLock lock(&compress_lock);
+
+    const int size = LZ4_compress_fast_extState(compress_state, src, compress_buffer,
+                                                PAGE_SIZE, sizeof(compress_buffer), 1);
+    if (size <= 0) {
+        kcounter_add(compression_incompressible, 1);
+        return nullptr;
+    }
+
+    fbl::AllocChecker ac;
+    fbl::unique_ptr<uint8_t[]> data(new (&ac) uint8_t[size]);
+    if (!ac.check()) {
+        return nullptr;
+    }
+    memcpy(data.get(), compress_buffer, size);
+
+    fbl::unique_ptr<VmCompressedPage> page(
+        new (&ac) VmCompressedPage(offset, fbl::move(data), size));
+    if (!ac.check()) {
+        return nullptr;
+    }
+
+    kcounter_add(compression_compressed, 1);
+    return page;
+}
+
+void VmCompressedPage::Decompress(paddr_t pa) const {
+    char* dst = static_cast<char*>(paddr_to_physmap(pa));
+    DEBUG_ASSERT(dst);
+
+    const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(data_.get()), dst,
+                                         static_cast<int>(size_), PAGE_SIZE);
+    ASSERT_MSG(size == PAGE_SIZE, "failed to decompress page: %d\n", size);
+
+    kcounter_add(compression_decompressed, 1);
+}
+
+uint64_t compression_reclaim_pages(uint64_t target_pages) {
+    if (!compression_enabled) {
+        return 0;
+    }
+
+    // Prefer pages that have been idle for a while, then fall back on any
+    // page that wasn't accessed since the last harvest.
+    uint64_t count = VmObject::CompressAllColdPages(compression_min_age, target_pages);
+    if (count < target_pages && compression_min_age > 1) {
+        count += VmObject::CompressAllColdPages(1, target_pages - count);
+    }
+
+    LTRACEF("compressed %" PRIu64 " of %" PRIu64 " pages\n", count, target_pages);
+    return count;
+}
+
+uint64_t compression_stored_pages() {
+    return stored_pages.load();
+}
+
+uint64_t compression_pool_bytes() {
+    return pool_bytes.load();
+}
+
+namespace {
+
+struct CompressorConfig {
+    zx_duration_t period;
+    uint64_t watermark_bytes;
+};
+
+int compressor_loop(void* arg) {
+    const CompressorConfig config = *static_cast<CompressorConfig*>(arg);
+
+    for (;;) {
+        thread_sleep_relative(config.period);
+
+        const uint64_t free_bytes = pmm_count_free_pages() * PAGE_SIZE;
+        if (free_bytes < config.watermark_bytes) {
+            compression_reclaim_pages((config.watermark_bytes - free_bytes) / PAGE_SIZE);
+        }
+    }
+
+    return 0;
+}
+
+void compression_init(uint level) {
+    // Be sure to update kernel_cmdline.md if any of these defaults change.
+    pool_limit_bytes = cmdline_get_uint64("kernel.vm.compression.pool-mb", 64) * MB;
+    compression_min_age = static_cast<uint8_t>(
+        fbl::clamp<uint64_t>(cmdline_get_uint64("kernel.vm.compression.min-age", 3),
+                             1, UINT8_MAX));
+
+    if (!cmdline_get_bool("kernel.vm.compression.enable", false)) {
+        return;
+    }
+    compression_enabled = true;
+
+    static CompressorConfig config;
+    config.period = ZX_SEC(cmdline_get_uint64("kernel.vm.compression.period-sec", 10));
+    config.watermark_bytes = cmdline_get_uint64("kernel.vm.compression.watermark-mb", 100) * MB;
+
+    thread_t* t = thread_create("vm-compressor", compressor_loop, &config,
+                                LOW_PRIORITY, DEFAULT_STACK_SIZE);
+    if (t == nullptr) {
+        printf("vm compressor: failed to create thread\n");
+        return;
+    }
+    thread_detach_and_resume(t);
+}
+
+} // namespace
+
+LK_INIT_HOOK(vm_compression, compression_init, LK_INIT_LEVEL_THREADING);
+
+static int cmd_compression(int argc, const cmd_args* argv, uint32_t flags) {
+    if (argc < 2) {
+        printf("not enough arguments\n");
+    usage:
+        printf("usage:\n");
+        printf("%s compress <age> <n>  : compress up to n pages of at least age\n", argv[0].str);
+        printf("%s info                : print compressed pool usage\n", argv[0].str);
+        return ZX_ERR_INTERNAL;
+    }
+
+    if (!strcmp(argv[1].str, "compress")) {
+        if (argc < 4) {
+            goto usage;
+        }
+        uint64_t age = fbl::min<uint64_t>(argv[2].u, UINT8_MAX);
+        uint64_t count = VmObject::CompressAllColdPages(static_cast<uint8_t>(age), argv[3].u);
+        printf("compressed %" PRIu64 " pages (%" PRIu64 " bytes)\n",
+               count, count * PAGE_SIZE);
+    } else if (!strcmp(argv[1].str, "info")) {
+        printf("enabled %d, %" PRIu64 " pages stored in %" PRIu64 " of %" PRIu64 " bytes\n",
+               compression_enabled, compression_stored_pages(), compression_pool_bytes(),
+               pool_limit_bytes);
+    } else {
+        printf("unknown command\n");
+        goto usage;
+    }
+
+    return ZX_OK;
+}
+
+STATIC_COMMAND_START
+STATIC_COMMAND("compression", "compressed page pool", &cmd_compression)
+STATIC_COMMAND_END(compression);
@@ -0,0 +1,116 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <vm/harvester.h>
+
+#include <fbl/atomic.h>
+#include <inttypes.h>
+#include <kernel/cmdline.h>
+#include <kernel/thread.h>
+#include <lib/console.h>
+#include <lib/counters.h>
+#include <lk/init.h>
+#include <platform.h>
+#include <string.h>
+#include <trace.h>
+#include <vm/vm.h>
+#include <vm/vm_object.h>
+#include <zircon/time.h>
+#include <zircon/types.h>
+
+#include "vm_priv.h"
+
+#define LOCAL_TRACE MAX(VM_GLOBAL_TRACE, 0)
+
+KCOUNTER(harvester_passes_counter, "kernel.vm.harvester.passes");
+
+// Set by harvester_init() if the harvester thread is running.
+static zx_duration_t harvest_period;
+
+static fbl::atomic<uint64_t> passes;
+
+void harvester_harvest_all() {
+    const zx_time_t start = current_time();
+
+    VmObject::HarvestAllAccessed();
+
+    kcounter_add(harvester_passes_counter, 1);
+    passes.fetch_add(1);
+
+    LTRACEF("harvest took %" PRIi64 " ns\n", zx_time_sub_time(current_time(), start));
+}
+
+zx_duration_t harvester_period() {
+    return harvest_period;
+}
+
+uint64_t harvester_passes() {
+    return passes.load();
+}
+
+static int harvester_loop(void* arg) {
+    const zx_duration_t period = *static_cast<zx_duration_t*>(arg);
+
+    for (;;) {
+        thread_sleep_relative(period);
+        harvester_harvest_all();
+    }
+
+    return 0;
+}
+
+static void harvester_init(uint level) {
+    // Be sure to update kernel_cmdline.md if any of these defaults change.
+    // Compression relies on page ages, so it turns on harvesting too.
+    if (!cmdline_get_bool("kernel.vm.harvester.enable", false) &&
+        !cmdline_get_bool("kernel.vm.compression.enable", false)) {
+        return;
+    }
+
+    static zx_duration_t period;
+    period = ZX_SEC(cmdline_get_uint64("kernel.vm.harvester.period-sec", 10));
+    if (period <= 0) {
+        return;
+    }
+
+    thread_t* t = thread_create("vm-harvester", harvester_loop, &period,
+                                LOW_PRIORITY, DEFAULT_STACK_SIZE);
+    if (t == nullptr) {
+        printf("vm harvester: failed to create thread\n");
+        return;
+    }
+    harvest_period = period;
+    thread_detach_and_resume(t);
+}
+
+LK_INIT_HOOK(vm_harvester, harvester_init, LK_INIT_LEVEL_THREADING);
+
+static int cmd_harvester(int argc, const cmd_args* argv, uint32_t flags) {
+    if (argc < 2) {
+        printf("not enough arguments\n");
+    usage:
+        printf("usage:\n");
+        printf("%s harvest : age pages by harvesting accessed bits\n", argv[0].str);
+        printf("%s info    : print the harvest period and passes\n", argv[0].str);
+        return ZX_ERR_INTERNAL;
+    }
+
+    if (!strcmp(argv[1].str, "harvest")) {
+        harvester_harvest_all();
+    } else if (!strcmp(argv[1].str, "info")) {
+        printf("period %" PRIi64 " ns, %" PRIu64 " harvests since boot\n",
+               harvester_period(), harvester_passes());
+    } else {
+        printf("unknown command\n");
+        goto usage;
+    }
+
+    return ZX_OK;
+}
+
+STATIC_COMMAND_START
+STATIC_COMMAND("harvester", "page accessed bit harvester", &cmd_harvester)
+STATIC_COMMAND_END(harvester);
@@ -58,6 +58,21 @@ public:
 
     virtual zx_status_t Query(vaddr_t vaddr, paddr_t* paddr, uint* mmu_flags) = 0;
 
+    // Called with the virtual and physical address of each page found to be
+    // accessed by HarvestAccessed().  Runs with the page table lock held.
+    using HarvestCallback = void (*)(vaddr_t vaddr, paddr_t paddr, void* context);
+
+    // Calls |accessed| for every page in the given virtual address range that
+    // has been accessed since the last harvest, and clears its accessed state.
+    // Pages whose accessed state can't be tracked are always reported.
+    virtual zx_status_t HarvestAccessed(vaddr_t vaddr, size_t count,
+                                        HarvestCallback accessed, void* context) = 0;
+
+    // Marks the pages in the given virtual address range as accessed.  Called
+    // when a fault is taken on a page that is already mapped, which happens
+    // on architectures that track accessed state by faulting.
+    virtual zx_status_t MarkAccessed(vaddr_t vaddr, size_t count) = 0;
+
     virtual vaddr_t PickSpot(vaddr_t base, uint prev_region_mmu_flags,
                              vaddr_t end, uint next_region_mmu_flags,
                              vaddr_t align, size_t size, uint mmu_flags) = 0;
@@ -0,0 +1,61 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <fbl/intrusive_wavl_tree.h>
+#include <fbl/macros.h>
+#include <fbl/unique_ptr.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <zircon/compiler.h>
+#include <zircon/types.h>
+
+// Cold pages of anonymous VMOs may be compressed into a bounded in-kernel
+// pool when free memory runs low, and are decompressed when next looked up.
+// Pages are aged by the harvester; see vm/harvester.h.
+
+// A page worth of data held in compressed form by a VmObjectPaged, keyed by
+// its offset into the object.
+class VmCompressedPage final
+    : public fbl::WAVLTreeContainable<fbl::unique_ptr<VmCompressedPage>> {
+public:
+    // Compresses the page at |pa|.  Returns nullptr if the page doesn't
+    // compress well enough to be worth keeping or the pool is full.
+    static fbl::unique_ptr<VmCompressedPage> Compress(uint64_t offset, paddr_t pa);
+
+    // Returns true if the pool can't take another page.
+    static bool PoolFull();
+
+    ~VmCompressedPage();
+
+    // Decompresses the contents into the page at |pa|.
+    void Decompress(paddr_t pa) const;
+
+    uint64_t GetKey() const { return offset_; }
+
+private:
+    VmCompressedPage(uint64_t offset, fbl::unique_ptr<uint8_t[]> data, size_t size);
+
+    DISALLOW_COPY_ASSIGN_AND_MOVE(VmCompressedPage);
+
+    const uint64_t offset_;
+    const fbl::unique_ptr<uint8_t[]> data_;
+    const size_t size_;
+};
+
+using VmCompressedPageTree = fbl::WAVLTree<uint64_t, fbl::unique_ptr<VmCompressedPage>>;
+
+// Compresses up to |target_pages| of the coldest pages in the system, if
+// enabled on the kernel command line. Returns the number of pages returned to
+// the PMM.
+uint64_t compression_reclaim_pages(uint64_t target_pages);
+
+// Returns the number of pages currently held compressed.
+uint64_t compression_stored_pages();
+
+// Returns the number of bytes of compressed data currently held.
+uint64_t compression_pool_bytes();
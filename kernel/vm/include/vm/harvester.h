@@ -0,0 +1,26 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <stdint.h>
+#include <zircon/compiler.h>
+#include <zircon/types.h>
+
+// The harvester is a low priority kernel thread that periodically collects
+// and clears the accessed bits of the page tables mapping user VMOs, counting
+// in each committed page how many harvests it has gone without being
+// accessed. These ages feed page compression and working set estimates.
+
+// Ages every harvestable page in the system by one harvest.
+void harvester_harvest_all();
+
+// Returns the interval between periodic harvests, or 0 if periodic harvesting
+// is disabled.
+zx_duration_t harvester_period();
+
+// Returns the number of harvests performed since boot.
+uint64_t harvester_passes();
@@ -47,6 +47,10 @@ typedef struct vm_page {
 #define VM_PAGE_OBJECT_MAX_PIN_COUNT ((1ul << VM_PAGE_OBJECT_PIN_COUNT_BITS) - 1)
 
             uint8_t pin_count : VM_PAGE_OBJECT_PIN_COUNT_BITS;
+
+            // Number of accessed-bit harvests since the page was last seen
+            // accessed, saturating at UINT8_MAX.
+            uint8_t age;
         } object; // attached to a vm object
     };
 
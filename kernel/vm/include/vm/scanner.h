@@ -0,0 +1,21 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include <stdint.h>
+#include <zircon/compiler.h>
+
+// The scanner is a low priority kernel thread that periodically walks every
+// VMO in the system looking for committed pages that contain only zeroes, and
+// decommits them so that they are backed by the shared zero page again.
+
+// Scans every VMO in the system once and decommits the zero pages it finds.
+// Returns the number of pages returned to the PMM.
+uint64_t scanner_reclaim_zero_pages();
+
+// Returns the number of pages the scanner has returned to the PMM since boot.
+uint64_t scanner_zero_pages_reclaimed();
@@ -13,6 +13,7 @@
 #include <fbl/ref_counted.h>
 #include <fbl/ref_ptr.h>
 #include <stdint.h>
+#include <vm/arch_vm_aspace.h>
 #include <vm/vm_object.h>
 #include <vm/vm_page_list.h>
 #include <zircon/thread_annotations.h>
@@ -430,7 +431,9 @@ public:
     // offset modification and locking.
     zx_status_t DecommitRange(size_t offset, size_t len, size_t* decommitted);
 
-    // Map in pages from the underlying vm object, optionally committing pages as it goes
+    // Map in pages from the underlying vm object, optionally committing pages as it goes.
+    // Without |commit|, a mapping that isn't writable maps the pages a clone shares with
+    // its parent directly instead of copying them.
     zx_status_t MapRange(size_t offset, size_t len, bool commit);
 
     // Unmap a subset of the region of memory in the containing address space,
@@ -460,6 +463,11 @@ protected:
     // unmap any pages that map the passed in vmo range. May not intersect with this range
     zx_status_t UnmapVmoRangeLocked(uint64_t start, uint64_t size) const;
 
+    // report the pages mapping the passed in vmo range that were accessed since the last harvest
+    zx_status_t HarvestAccessedVmoRangeLocked(uint64_t start, uint64_t size,
+                                              ArchVmAspaceInterface::HarvestCallback accessed,
+                                              void* context) const;
+
 private:
     DISALLOW_COPY_ASSIGN_AND_MOVE(VmMapping);
 
@@ -19,6 +19,7 @@
 #include <lib/user_copy/user_ptr.h>
 #include <list.h>
 #include <stdint.h>
+#include <vm/arch_vm_aspace.h>
 #include <vm/page.h>
 #include <vm/vm.h>
 #include <vm/vm_page_list.h>
@@ -77,6 +78,28 @@ public:
         return ZX_ERR_NOT_SUPPORTED;
     }
 
+    // Zeroes the given range of the vmo, decommitting whole pages where doing
+    // so leaves them reading as zero.
+    virtual zx_status_t ZeroRange(uint64_t offset, uint64_t len) {
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+
+    // Removes the pages backing the given page aligned range of the vmo and
+    // appends them to |pages| in offset order, committing any that are
+    // missing first. The range is left decommitted.
+    virtual zx_status_t TakePages(uint64_t offset, uint64_t len, list_node* pages) {
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+
+    // Replaces the pages backing the given page aligned range of the vmo with
+    // the pages in |pages|, as returned by TakePages(). If the range can't
+    // take the pages, fails leaving the vmo and |pages| untouched. Otherwise
+    // takes ownership of the pages, freeing any it can't use if it runs out
+    // of memory part way.
+    virtual zx_status_t SupplyPages(uint64_t offset, uint64_t len, list_node* pages) {
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+
     // Pin the given range of the vmo.  If any pages are not committed, this
     // returns a ZX_ERR_NO_MEMORY.
     virtual zx_status_t Pin(uint64_t offset, uint64_t len) {
@@ -118,6 +141,47 @@ public:
         return ZX_ERR_NOT_SUPPORTED;
     }
 
+    // Scans the committed pages of the object for ones that contain only
+    // zeroes. If |reclaim| is true those pages are decommitted, so that later
+    // reads see the shared zero page and later writes fault in a fresh page.
+    // Returns the number of zero pages found.
+    virtual uint32_t ScanForZeroPages(bool reclaim) {
+        return 0;
+    }
+
+    // Calls ScanForZeroPages() on every VMO in the system, returning the
+    // total number of zero pages found.
+    static uint64_t ScanAllForZeroPages(bool reclaim);
+
+    // Ages the committed pages of the object by one harvest, resetting the
+    // age of those accessed through a mapping since the previous harvest.
+    virtual void HarvestAccessed() {}
+
+    // Compresses and decommits up to |max_pages| committed pages that have
+    // gone at least |min_age| harvests without being accessed. Their contents
+    // are restored the next time they are looked up. Returns the number of
+    // pages decommitted.
+    virtual uint32_t CompressColdPages(uint8_t min_age, uint32_t max_pages) {
+        return 0;
+    }
+
+    // Counts the committed pages in the range [offset, offset + len) by how
+    // recently they were accessed: |counts[i]| is incremented for each page
+    // accessed within the last 2^i harvests, for i < |num_counts|. Pages of
+    // objects that aren't harvested are always counted as accessed. Returns
+    // the number of committed pages in the range.
+    virtual size_t CountPagesByAgeInRange(uint64_t offset, uint64_t len,
+                                          uint64_t* counts, size_t num_counts) const {
+        return 0;
+    }
+
+    // Calls HarvestAccessed() on every VMO in the system.
+    static void HarvestAllAccessed();
+
+    // Calls CompressColdPages() on VMOs until |max_pages| pages have been
+    // decommitted, returning the total.
+    static uint64_t CompressAllColdPages(uint8_t min_age, uint64_t max_pages);
+
     // The assocaited VmObjectDispatcher will set an observer to notify user mode.
     void SetChildObserver(VmObjectChildObserver* child_observer);
 
@@ -238,6 +302,10 @@ protected:
         // Called under the parent's lock, which confuses analysis.
         TA_NO_THREAD_SAFETY_ANALYSIS { RangeChangeUpdateLocked(offset, len); }
 
+    // report the pages of all mappings that were accessed since the last harvest
+    void HarvestMappingsAccessedLocked(ArchVmAspaceInterface::HarvestCallback accessed,
+                                       void* context) TA_REQ(lock_);
+
     // magic value
     fbl::Canary<fbl::magic("VMO_")> canary_;
 
@@ -287,4 +355,8 @@ private:
     using GlobalList = fbl::DoublyLinkedList<VmObject*, GlobalListTraits>;
     DECLARE_SINGLETON_MUTEX(AllVmosLock);
     static GlobalList all_vmos_ TA_GUARDED(AllVmosLock::Get());
+
+    // Fills |refs| with references to every live VMO in the system, returning
+    // the number of references taken.
+    static size_t GetAllRefs(fbl::Array<fbl::RefPtr<VmObject>>* refs);
 };
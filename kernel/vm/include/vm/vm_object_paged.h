@@ -17,6 +17,7 @@
 #include <lib/user_copy/user_ptr.h>
 #include <list.h>
 #include <stdint.h>
+#include <vm/compression.h>
 #include <vm/pmm.h>
 #include <vm/vm.h>
 #include <vm/vm_aspace.h>
@@ -58,6 +59,9 @@ public:
 
     zx_status_t CommitRange(uint64_t offset, uint64_t len, uint64_t* committed) override;
     zx_status_t DecommitRange(uint64_t offset, uint64_t len, uint64_t* decommitted) override;
+    zx_status_t ZeroRange(uint64_t offset, uint64_t len) override;
+    zx_status_t TakePages(uint64_t offset, uint64_t len, list_node* pages) override;
+    zx_status_t SupplyPages(uint64_t offset, uint64_t len, list_node* pages) override;
 
     zx_status_t Pin(uint64_t offset, uint64_t len) override;
     void Unpin(uint64_t offset, uint64_t len) override;
@@ -73,6 +77,13 @@ public:
     zx_status_t LookupUser(uint64_t offset, uint64_t len, user_inout_ptr<paddr_t> buffer,
                            size_t buffer_size) override;
 
+    uint32_t ScanForZeroPages(bool reclaim) override;
+
+    void HarvestAccessed() override;
+    size_t CountPagesByAgeInRange(uint64_t offset, uint64_t len,
+                                  uint64_t* counts, size_t num_counts) const override;
+    uint32_t CompressColdPages(uint8_t min_age, uint32_t max_pages) override;
+
     void Dump(uint depth, bool verbose) override;
 
     zx_status_t InvalidateCache(const uint64_t offset, const uint64_t len) override;
@@ -138,6 +149,23 @@ private:
     // set our offset within our parent
     zx_status_t SetParentOffsetLocked(uint64_t o) TA_REQ(lock_);
 
+    // whether the accessed state of our pages can be harvested
+    bool CanHarvestLocked() const TA_REQ(lock_);
+
+    // whether our pages may be compressed
+    bool CanCompressLocked() const TA_REQ(lock_);
+
+    // restore the compressed page at |offset| into a newly committed page, which may be taken
+    // from |free_list|
+    zx_status_t DecompressPageLocked(uint64_t offset, list_node* free_list,
+                                     vm_page_t** page_out, paddr_t* pa_out) TA_REQ(lock_);
+
+    // restore all compressed pages in the range [start, end)
+    zx_status_t DecompressRangeLocked(uint64_t start, uint64_t end) TA_REQ(lock_);
+
+    // drop all compressed pages in the range [start, end)
+    void FreeCompressedRangeLocked(uint64_t start, uint64_t end) TA_REQ(lock_);
+
     // members
     const uint32_t options_;
     uint64_t size_ TA_GUARDED(lock_) = 0;
@@ -147,4 +175,7 @@ private:
 
     // a tree of pages
     VmPageList page_list_ TA_GUARDED(lock_);
+
+    // pages that have been decommitted with their contents kept in compressed form
+    VmCompressedPageTree compressed_pages_ TA_GUARDED(lock_);
 };
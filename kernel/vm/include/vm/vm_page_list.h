@@ -189,10 +189,15 @@ public:
 
     zx_status_t AddPage(vm_page*, uint64_t offset);
     vm_page* GetPage(uint64_t offset);
+    vm_page* RemovePage(uint64_t offset);
     zx_status_t FreePage(uint64_t offset);
     size_t FreeAllPages();
     bool IsEmpty();
 
+    // Removes tree nodes that no longer hold any pages, for use after
+    // pages have been taken out of nodes in place by ForEveryPage().
+    void RemoveEmptyNodes();
+
 private:
     fbl::WAVLTree<uint64_t, fbl::unique_ptr<VmPageListNode>> list_;
 };
@@ -0,0 +1,112 @@
+// Copyright 2018 The Fuchsia Authors
+//
+// Use of this source code is governed by a MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT
+
+#include <vm/scanner.h>
+
+#include <fbl/atomic.h>
+#include <inttypes.h>
+#include <kernel/cmdline.h>
+#include <kernel/thread.h>
+#include <lib/console.h>
+#include <lib/counters.h>
+#include <lk/init.h>
+#include <string.h>
+#include <trace.h>
+#include <vm/vm.h>
+#include <vm/vm_object.h>
+#include <zircon/time.h>
+#include <zircon/types.h>
+
+#include "vm_priv.h"
+
+#define LOCAL_TRACE MAX(VM_GLOBAL_TRACE, 0)
+
+KCOUNTER(scanner_passes, "kernel.vm.scanner.passes");
+KCOUNTER(scanner_zero_pages, "kernel.vm.scanner.zero_pages_reclaimed");
+
+// Number of pages returned to the PMM by the scanner since boot.
+static fbl::atomic<uint64_t> zero_pages_reclaimed;
+
+uint64_t scanner_reclaim_zero_pages() {
+    const uint64_t count = VmObject::ScanAllForZeroPages(/* reclaim */ true);
+
+    kcounter_add(scanner_passes, 1);
+    kcounter_add(scanner_zero_pages, static_cast<int64_t>(count));
+    zero_pages_reclaimed.fetch_add(count);
+
+    LTRACEF("reclaimed %" PRIu64 " zero pages\n", count);
+    return count;
+}
+
+uint64_t scanner_zero_pages_reclaimed() {
+    return zero_pages_reclaimed.load();
+}
+
+static int scanner_loop(void* arg) {
+    const zx_duration_t period = *static_cast<zx_duration_t*>(arg);
+
+    for (;;) {
+        thread_sleep_relative(period);
+        scanner_reclaim_zero_pages();
+    }
+
+    return 0;
+}
+
+static void scanner_init(uint level) {
+    // Be sure to update kernel_cmdline.md if any of these defaults change.
+    if (!cmdline_get_bool("kernel.vm.scanner.enable", false)) {
+        return;
+    }
+
+    static zx_duration_t period;
+    period = ZX_SEC(cmdline_get_uint64("kernel.vm.scanner.period-sec", 30));
+
+    thread_t* t = thread_create("vm-scanner", scanner_loop, &period,
+                                LOW_PRIORITY, DEFAULT_STACK_SIZE);
+    if (t == nullptr) {
+        printf("vm scanner: failed to create thread\n");
+        return;
+    }
+    thread_detach_and_resume(t);
+}
+
+LK_INIT_HOOK(vm_scanner, scanner_init, LK_INIT_LEVEL_THREADING);
+
+static int cmd_scanner(int argc, const cmd_args* argv, uint32_t flags) {
+    if (argc < 2) {
+        printf("not enough arguments\n");
+    usage:
+        printf("usage:\n");
+        printf("%s count   : count zero pages in all VMOs\n", argv[0].str);
+        printf("%s reclaim : decommit zero pages in all VMOs\n", argv[0].str);
+        printf("%s info    : print pages reclaimed since boot\n", argv[0].str);
+        return ZX_ERR_INTERNAL;
+    }
+
+    if (!strcmp(argv[1].str, "count")) {
+        uint64_t count = VmObject::ScanAllForZeroPages(/* reclaim */ false);
+        printf("found %" PRIu64 " zero pages (%" PRIu64 " bytes)\n",
+               count, count * PAGE_SIZE);
+    } else if (!strcmp(argv[1].str, "reclaim")) {
+        uint64_t count = scanner_reclaim_zero_pages();
+        printf("reclaimed %" PRIu64 " zero pages (%" PRIu64 " bytes)\n",
+               count, count * PAGE_SIZE);
+    } else if (!strcmp(argv[1].str, "info")) {
+        uint64_t count = scanner_zero_pages_reclaimed();
+        printf("reclaimed %" PRIu64 " zero pages (%" PRIu64 " bytes) since boot\n",
+               count, count * PAGE_SIZE);
+    } else {
+        printf("unknown command\n");
+        goto usage;
+    }
+
+    return ZX_OK;
+}
+
+STATIC_COMMAND_START
+STATIC_COMMAND("scanner", "zero page scanner", &cmd_scanner)
+STATIC_COMMAND_END(scanner);
@@ -383,6 +383,33 @@ zx_status_t VmMapping::UnmapVmoRangeLocked(uint64_t offset, uint64_t len) const
     return ZX_OK;
 }
 
+zx_status_t VmMapping::HarvestAccessedVmoRangeLocked(uint64_t offset, uint64_t len,
+                                                     ArchVmAspaceInterface::HarvestCallback accessed,
+                                                     void* context) const {
+    canary_.Assert();
+
+    // NOTE: like UnmapVmoRangeLocked(), this relies on the vmo lock rather than
+    // the address space lock to keep the mapping alive.
+    DEBUG_ASSERT(state_ == LifeCycleState::ALIVE);
+
+    DEBUG_ASSERT(object_);
+    DEBUG_ASSERT(object_->lock()->lock().IsHeld());
+
+    DEBUG_ASSERT(IS_PAGE_ALIGNED(offset));
+    DEBUG_ASSERT(IS_PAGE_ALIGNED(len));
+
+    // compute the intersection of the passed in vmo range and our mapping
+    uint64_t offset_new;
+    uint64_t len_new;
+    if (!GetIntersect(object_offset_, static_cast<uint64_t>(size_), offset, len,
+                      &offset_new, &len_new))
+        return ZX_OK;
+
+    const vaddr_t base = base_ + (offset_new - object_offset_);
+    return aspace_->arch_aspace().HarvestAccessed(base, static_cast<size_t>(len_new) / PAGE_SIZE,
+                                                  accessed, context);
+}
+
 namespace {
 
 class VmMappingCoalescer {
@@ -481,7 +508,11 @@ zx_status_t VmMapping::MapRange(size_t offset, size_t len, bool commit) {
 
     // precompute the flags we'll pass GetPageLocked
     // if committing, then tell it to soft fault in a page
-    uint pf_flags = VMM_PF_FLAG_WRITE;
+    // if the mapping can't be written, look pages up as a read fault would so
+    // that a clone maps its parent's pages rather than taking private copies
+    uint pf_flags = 0;
+    if (commit || (arch_mmu_flags_ & ARCH_MMU_FLAG_PERM_WRITE))
+        pf_flags |= VMM_PF_FLAG_WRITE;
     if (commit)
         pf_flags |= VMM_PF_FLAG_SW_FAULT;
 
@@ -673,8 +704,11 @@ zx_status_t VmMapping::PageFault(vaddr_t va, const uint pf_flags) {
             // page was already mapped, are the permissions compatible?
             // test that the page is already mapped with either the region's mmu flags
             // or the flags that we're about to try to switch it to, which may be read-only
-            if (page_flags == arch_mmu_flags_ || page_flags == mmu_flags)
+            // if they are, this was an access flag fault, so note the access
+            if (page_flags == arch_mmu_flags_ || page_flags == mmu_flags) {
+                aspace_->arch_aspace().MarkAccessed(va, 1);
                 return ZX_OK;
+            }
 
             // assert that we're not accidentally marking the zero page writable
             DEBUG_ASSERT((pa != vm_get_zero_page_paddr()) || !(mmu_flags & ARCH_MMU_FLAG_PERM_WRITE));
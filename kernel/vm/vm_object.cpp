@@ -10,6 +10,9 @@
 
 #include <assert.h>
 #include <err.h>
+#include <fbl/algorithm.h>
+#include <fbl/alloc_checker.h>
+#include <fbl/array.h>
 #include <fbl/auto_lock.h>
 #include <fbl/mutex.h>
 #include <fbl/ref_ptr.h>
@@ -19,6 +22,7 @@
 #include <string.h>
 #include <trace.h>
 
+#include <vm/pmm.h>
 #include <vm/vm.h>
 #include <vm/vm_address_region.h>
 
@@ -71,6 +75,64 @@ VmObject::~VmObject() {
     }
 }
 
+size_t VmObject::GetAllRefs(fbl::Array<fbl::RefPtr<VmObject>>* refs) {
+    // Take references to all live objects under the global lock so that
+    // callers can work on them after dropping it, without holding up object
+    // creation or dropping the last reference with the lock held.
+    Guard<fbl::Mutex> guard{AllVmosLock::Get()};
+
+    const size_t count = all_vmos_.size_slow();
+    fbl::AllocChecker ac;
+    refs->reset(new (&ac) fbl::RefPtr<VmObject>[count], count);
+    if (!ac.check()) {
+        return 0;
+    }
+
+    size_t num_refs = 0;
+    for (auto& vmo : all_vmos_) {
+        // objects that are being destroyed are still on the list, but
+        // have no references left
+        auto ref = fbl::internal::MakeRefPtrUpgradeFromRaw(&vmo, AllVmosLock::Get()->lock());
+        if (ref) {
+            (*refs)[num_refs++] = fbl::move(ref);
+        }
+    }
+    return num_refs;
+}
+
+uint64_t VmObject::ScanAllForZeroPages(bool reclaim) {
+    fbl::Array<fbl::RefPtr<VmObject>> refs;
+    const size_t num_refs = GetAllRefs(&refs);
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < num_refs; i++) {
+        count += refs[i]->ScanForZeroPages(reclaim);
+    }
+    return count;
+}
+
+void VmObject::HarvestAllAccessed() {
+    fbl::Array<fbl::RefPtr<VmObject>> refs;
+    const size_t num_refs = GetAllRefs(&refs);
+
+    for (size_t i = 0; i < num_refs; i++) {
+        refs[i]->HarvestAccessed();
+    }
+}
+
+uint64_t VmObject::CompressAllColdPages(uint8_t min_age, uint64_t max_pages) {
+    fbl::Array<fbl::RefPtr<VmObject>> refs;
+    const size_t num_refs = GetAllRefs(&refs);
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < num_refs && count < max_pages; i++) {
+        const uint64_t remaining = max_pages - count;
+        count += refs[i]->CompressColdPages(
+            min_age, static_cast<uint32_t>(fbl::min<uint64_t>(remaining, UINT32_MAX)));
+    }
+    return count;
+}
+
 void VmObject::get_name(char* out_name, size_t len) const {
     canary_.Assert();
     name_.get(len, out_name);
@@ -248,6 +310,16 @@ void VmObject::RangeChangeUpdateLocked(uint64_t offset, uint64_t len) {
     }
 }
 
+void VmObject::HarvestMappingsAccessedLocked(ArchVmAspaceInterface::HarvestCallback accessed,
+                                             void* context) {
+    canary_.Assert();
+    DEBUG_ASSERT(lock_.lock().IsHeld());
+
+    for (auto& m : mapping_list_) {
+        m.HarvestAccessedVmoRangeLocked(0, ROUNDUP_PAGE_SIZE(size()), accessed, context);
+    }
+}
+
 static int cmd_vm_object(int argc, const cmd_args* argv, uint32_t flags) {
     if (argc < 2) {
     notenoughargs:
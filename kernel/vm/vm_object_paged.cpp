@@ -11,6 +11,7 @@
 #include <arch/ops.h>
 #include <assert.h>
 #include <err.h>
+#include <fbl/algorithm.h>
 #include <fbl/alloc_checker.h>
 #include <fbl/auto_call.h>
 #include <inttypes.h>
@@ -40,10 +41,24 @@ void ZeroPage(vm_page_t* p) {
     ZeroPage(pa);
 }
 
+// Returns true if the page contains only zeroes.
+bool IsZeroPage(vm_page_t* p) {
+    const uint64_t* word = static_cast<const uint64_t*>(paddr_to_physmap(p->paddr()));
+    DEBUG_ASSERT(word);
+
+    for (size_t i = 0; i < PAGE_SIZE / sizeof(uint64_t); i++) {
+        if (word[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void InitializeVmPage(vm_page_t* p) {
     DEBUG_ASSERT(p->state == VM_PAGE_STATE_ALLOC);
     p->state = VM_PAGE_STATE_OBJECT;
     p->object.pin_count = 0;
+    p->object.age = 0;
 }
 
 // round up the size to the next page size boundary and make sure we dont wrap
@@ -377,6 +392,9 @@ zx_status_t VmObjectPaged::GetPageLocked(uint64_t offset, uint pf_flags, list_no
     // see if we already have a page at that offset
     p = page_list_.GetPage(offset);
     if (p) {
+        // looking the page up counts as accessing it
+        p->object.age = 0;
+
         if (page_out)
             *page_out = p;
         if (pa_out)
@@ -388,6 +406,12 @@ zx_status_t VmObjectPaged::GetPageLocked(uint64_t offset, uint pf_flags, list_no
     LTRACEF("vmo %p, offset %#" PRIx64 ", pf_flags %#x (%s)\n", this, offset, pf_flags,
             vmm_pf_flags_to_string(pf_flags, pf_string));
 
+    // if the page was compressed, bring it back regardless of pf_flags, since
+    // our children rely on finding it without faulting
+    if (!compressed_pages_.is_empty() && compressed_pages_.find(offset).IsValid()) {
+        return DecompressPageLocked(offset, free_list, page_out, pa_out);
+    }
+
     // if we have a parent see if they have a page for us
     if (parent_) {
         uint64_t parent_offset;
@@ -638,6 +662,9 @@ zx_status_t VmObjectPaged::DecommitRange(uint64_t offset, uint64_t len, uint64_t
     // unmap all of the pages in this range on all the mapping regions
     RangeChangeUpdateLocked(start, page_aligned_len);
 
+    // compressed pages are already decommitted, but their contents have to go
+    FreeCompressedRangeLocked(start, end);
+
     // iterate through the pages, freeing them
     // TODO: use page_list iterator, move pages to list, free at once
     while (start < end) {
@@ -651,6 +678,196 @@ zx_status_t VmObjectPaged::DecommitRange(uint64_t offset, uint64_t len, uint64_t
     return ZX_OK;
 }
 
+zx_status_t VmObjectPaged::ZeroRange(uint64_t offset, uint64_t len) {
+    canary_.Assert();
+    LTRACEF("offset %#" PRIx64 ", len %#" PRIx64 "\n", offset, len);
+
+    list_node free_list;
+    list_initialize(&free_list);
+
+    {
+        Guard<fbl::Mutex> guard{&lock_};
+
+        // trim the size
+        uint64_t new_len;
+        if (!TrimRange(offset, len, size_, &new_len))
+            return ZX_ERR_OUT_OF_RANGE;
+
+        // was in range, just zero length
+        if (new_len == 0)
+            return ZX_OK;
+
+        const uint64_t end = offset + new_len;
+        for (uint64_t page_off = ROUNDDOWN(offset, PAGE_SIZE); page_off < end;
+             page_off += PAGE_SIZE) {
+            const uint64_t zero_start = fbl::max(page_off, offset);
+            const uint64_t zero_end = fbl::min(page_off + PAGE_SIZE, end);
+            const bool whole_page = zero_end - zero_start == PAGE_SIZE;
+
+            vm_page_t* p = page_list_.GetPage(page_off);
+            if (whole_page && !p) {
+                // an absent page reads as zero unless it is compressed or
+                // comes from our parent
+                FreeCompressedRangeLocked(page_off, page_off + PAGE_SIZE);
+                if (!parent_ || GetPageLocked(page_off, 0, nullptr, nullptr, nullptr) != ZX_OK) {
+                    continue;
+                }
+            } else if (whole_page && !parent_ && !is_contiguous() && p->object.pin_count == 0) {
+                // decommitting is cheaper than zeroing, and leaves the page
+                // reading as zero since there is no parent to show through
+                RangeChangeUpdateLocked(page_off, PAGE_SIZE);
+                page_list_.RemovePage(page_off);
+                list_add_tail(&free_list, &p->queue_node);
+                continue;
+            } else if (!p && GetPageLocked(page_off, 0, nullptr, nullptr, nullptr) != ZX_OK) {
+                // part of a page that already reads as zero
+                continue;
+            }
+
+            // zero the rest in place, first taking our own copy of the page
+            paddr_t pa;
+            zx_status_t status = GetPageLocked(page_off, VMM_PF_FLAG_SW_FAULT | VMM_PF_FLAG_WRITE,
+                                               nullptr, &p, &pa);
+            if (status != ZX_OK) {
+                return status;
+            }
+
+            uint8_t* ptr = static_cast<uint8_t*>(paddr_to_physmap(pa));
+            DEBUG_ASSERT(ptr);
+            ptr += zero_start - page_off;
+            memset(ptr, 0, zero_end - zero_start);
+
+// if ARM and not fully cached, clean/invalidate the range after zeroing it
+#if ARCH_ARM64
+            if (cache_policy_ != ARCH_MMU_FLAG_CACHED) {
+                arch_clean_invalidate_cache_range((addr_t)ptr, zero_end - zero_start);
+            }
+#endif
+        }
+    }
+
+    // return the pages to the pmm outside of our lock
+    pmm_free(&free_list);
+
+    return ZX_OK;
+}
+
+zx_status_t VmObjectPaged::TakePages(uint64_t offset, uint64_t len, list_node* pages) {
+    canary_.Assert();
+    LTRACEF("offset %#" PRIx64 ", len %#" PRIx64 "\n", offset, len);
+
+    DEBUG_ASSERT(IS_PAGE_ALIGNED(offset) && IS_PAGE_ALIGNED(len));
+
+    if (options_ & kContiguous) {
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+
+    Guard<fbl::Mutex> guard{&lock_};
+
+    if (!InRange(offset, len, size_))
+        return ZX_ERR_OUT_OF_RANGE;
+
+    // our children may be reading these pages through us
+    if (children_list_len_ > 0 || AnyPagesPinnedLocked(offset, len)) {
+        return ZX_ERR_BAD_STATE;
+    }
+
+    // make every page in the range our own, copying it from our parent or
+    // filling it with zeroes if necessary
+    const uint64_t end = offset + len;
+    zx_status_t status = DecompressRangeLocked(offset, end);
+    if (status != ZX_OK) {
+        return status;
+    }
+    for (uint64_t o = offset; o < end; o += PAGE_SIZE) {
+        if (!page_list_.GetPage(o)) {
+            status = GetPageLocked(o, VMM_PF_FLAG_SW_FAULT | VMM_PF_FLAG_WRITE,
+                                   nullptr, nullptr, nullptr);
+            if (status != ZX_OK) {
+                return status;
+            }
+        }
+    }
+
+    // unmap all of the pages in this range on all the mapping regions
+    RangeChangeUpdateLocked(offset, len);
+
+    page_list_.ForEveryPageInRange(
+        [pages](vm_page*& p, uint64_t off) {
+            list_add_tail(pages, &p->queue_node);
+            p = nullptr;
+            return ZX_ERR_NEXT;
+        },
+        offset, end);
+    page_list_.RemoveEmptyNodes();
+
+    return ZX_OK;
+}
+
+zx_status_t VmObjectPaged::SupplyPages(uint64_t offset, uint64_t len, list_node* pages) {
+    canary_.Assert();
+    LTRACEF("offset %#" PRIx64 ", len %#" PRIx64 "\n", offset, len);
+
+    DEBUG_ASSERT(IS_PAGE_ALIGNED(offset) && IS_PAGE_ALIGNED(len));
+    DEBUG_ASSERT(list_length(pages) == len / PAGE_SIZE);
+
+    if (options_ & kContiguous) {
+        return ZX_ERR_NOT_SUPPORTED;
+    }
+
+    list_node free_list;
+    list_initialize(&free_list);
+
+    zx_status_t status = ZX_OK;
+    {
+        Guard<fbl::Mutex> guard{&lock_};
+
+        // the caller keeps the pages if the range can't take them
+        if (!InRange(offset, len, size_)) {
+            return ZX_ERR_OUT_OF_RANGE;
+        }
+        if (AnyPagesPinnedLocked(offset, len)) {
+            return ZX_ERR_BAD_STATE;
+        }
+
+        const uint64_t end = offset + len;
+
+        // unmap all of the pages in this range on all the mapping regions
+        RangeChangeUpdateLocked(offset, len);
+
+        // the pages being replaced go back to the pmm
+        FreeCompressedRangeLocked(offset, end);
+        page_list_.ForEveryPageInRange(
+            [&free_list](vm_page*& p, uint64_t off) {
+                list_add_tail(&free_list, &p->queue_node);
+                p = nullptr;
+                return ZX_ERR_NEXT;
+            },
+            offset, end);
+
+        for (uint64_t o = offset; o < end; o += PAGE_SIZE) {
+            vm_page_t* p = list_remove_head_type(pages, vm_page, queue_node);
+            DEBUG_ASSERT(p && p->state == VM_PAGE_STATE_OBJECT);
+            DEBUG_ASSERT(p->object.pin_count == 0);
+            p->object.age = 0;
+
+            status = page_list_.AddPage(p, o);
+            if (status != ZX_OK) {
+                list_add_head(pages, &p->queue_node);
+                break;
+            }
+        }
+        page_list_.RemoveEmptyNodes();
+    }
+
+    // return the replaced pages, and any we couldn't use, to the pmm outside
+    // of our lock
+    pmm_free(&free_list);
+    pmm_free(pages);
+
+    return status;
+}
+
 zx_status_t VmObjectPaged::Pin(uint64_t offset, uint64_t len) {
     canary_.Assert();
 
@@ -671,8 +888,14 @@ zx_status_t VmObjectPaged::PinLocked(uint64_t offset, uint64_t len) {
     const uint64_t start_page_offset = ROUNDDOWN(offset, PAGE_SIZE);
     const uint64_t end_page_offset = ROUNDUP(offset + len, PAGE_SIZE);
 
+    // pinned pages have to be resident
+    zx_status_t status = DecompressRangeLocked(start_page_offset, end_page_offset);
+    if (status != ZX_OK) {
+        return status;
+    }
+
     uint64_t expected_next_off = start_page_offset;
-    zx_status_t status = page_list_.ForEveryPageInRange(
+    status = page_list_.ForEveryPageInRange(
         [&expected_next_off](const auto p, uint64_t off) {
             if (off != expected_next_off) {
                 return ZX_ERR_NOT_FOUND;
@@ -795,6 +1018,8 @@ zx_status_t VmObjectPaged::ResizeLocked(uint64_t s) {
         // unmap all of the pages in this range on all the mapping regions
         RangeChangeUpdateLocked(start, len);
 
+        FreeCompressedRangeLocked(start, end);
+
         // iterate through the pages, freeing them
         // TODO: use page_list iterator, move pages to list, free at once
         while (start < end) {
@@ -944,8 +1169,14 @@ zx_status_t VmObjectPaged::Lookup(uint64_t offset, uint64_t len, uint pf_flags,
     const uint64_t start_page_offset = ROUNDDOWN(offset, PAGE_SIZE);
     const uint64_t end_page_offset = ROUNDUP(offset + len, PAGE_SIZE);
 
+    // restore compressed pages up front rather than while walking the page list
+    zx_status_t status = DecompressRangeLocked(start_page_offset, end_page_offset);
+    if (status != ZX_OK) {
+        return status;
+    }
+
     uint64_t expected_next_off = start_page_offset;
-    zx_status_t status = page_list_.ForEveryPageInRange(
+    status = page_list_.ForEveryPageInRange(
         [&expected_next_off, this, pf_flags, lookup_fn, context,
          start_page_offset](const auto p, uint64_t off) {
 
@@ -1046,6 +1277,274 @@ zx_status_t VmObjectPaged::LookupUser(uint64_t offset, uint64_t len, user_inout_
     return Lookup(offset, len, 0, copy_to_user, &buffer);
 }
 
+uint32_t VmObjectPaged::ScanForZeroPages(bool reclaim) {
+    canary_.Assert();
+
+    list_node free_list;
+    list_initialize(&free_list);
+
+    uint32_t count = 0;
+    {
+        Guard<fbl::Mutex> guard{&lock_};
+
+        // A clone's pages shadow its parent's, so dropping one would expose
+        // the parent's contents rather than zeroes. Contiguous and uncached
+        // objects must keep their physical pages, and objects without a koid
+        // or with kernel mappings may be touched from contexts that can't
+        // take a fault.
+        if (parent_ || is_contiguous() || cache_policy_ != ARCH_MMU_FLAG_CACHED || user_id_ == 0) {
+            return 0;
+        }
+        for (const auto& m : mapping_list_) {
+            if (!m.aspace()->is_user()) {
+                return 0;
+            }
+        }
+
+        page_list_.ForEveryPage(
+            [this, reclaim, &count, &free_list](vm_page*& p, uint64_t off)
+                TA_NO_THREAD_SAFETY_ANALYSIS {
+                // pinned pages may be the target of DMA
+                if (p->state != VM_PAGE_STATE_OBJECT || p->object.pin_count > 0) {
+                    return ZX_ERR_NEXT;
+                }
+                if (!IsZeroPage(p)) {
+                    return ZX_ERR_NEXT;
+                }
+                if (!reclaim) {
+                    count++;
+                    return ZX_ERR_NEXT;
+                }
+
+                // unmap the page before taking it away so that nobody can write to it
+                // through an existing mapping, then make sure it is still zero
+                RangeChangeUpdateLocked(off, PAGE_SIZE);
+                if (!IsZeroPage(p)) {
+                    return ZX_ERR_NEXT;
+                }
+
+                list_add_tail(&free_list, &p->queue_node);
+                p = nullptr;
+                count++;
+                return ZX_ERR_NEXT;
+            });
+
+        if (reclaim && count > 0) {
+            page_list_.RemoveEmptyNodes();
+        }
+    }
+
+    // return the pages to the pmm outside of our lock
+    __UNUSED auto freed = pmm_free(&free_list);
+    DEBUG_ASSERT(!reclaim || freed == count);
+
+    return count;
+}
+
+bool VmObjectPaged::CanHarvestLocked() const {
+    DEBUG_ASSERT(lock_.lock().IsHeld());
+
+    // Objects without a koid or with kernel mappings may be touched from
+    // contexts that can't take a fault, so their accessed state is left alone.
+    if (user_id_ == 0) {
+        return false;
+    }
+    for (const auto& m : mapping_list_) {
+        if (!m.aspace()->is_user()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VmObjectPaged::CanCompressLocked() const {
+    DEBUG_ASSERT(lock_.lock().IsHeld());
+
+    // Contiguous and uncached objects must keep their physical pages. Pages
+    // of an object with clones may be accessed through the clones' mappings,
+    // which don't reset the ages of our pages until they are harvested.
+    if (is_contiguous() || cache_policy_ != ARCH_MMU_FLAG_CACHED || children_list_len_ > 0) {
+        return false;
+    }
+    return CanHarvestLocked();
+}
+
+void VmObjectPaged::HarvestAccessed() {
+    canary_.Assert();
+
+    Guard<fbl::Mutex> guard{&lock_};
+
+    if (!CanHarvestLocked()) {
+        return;
+    }
+
+    page_list_.ForEveryPage([](const auto p, uint64_t off) {
+        if (p->object.age < UINT8_MAX) {
+            p->object.age++;
+        }
+        return ZX_ERR_NEXT;
+    });
+
+    // A mapping may also map pages of our parent, whose lock we share.
+    auto accessed = [](vaddr_t va, paddr_t pa, void* context) {
+        vm_page_t* p = paddr_to_vm_page(pa);
+        if (p && p->state == VM_PAGE_STATE_OBJECT) {
+            p->object.age = 0;
+        }
+    };
+    HarvestMappingsAccessedLocked(accessed, nullptr);
+}
+
+size_t VmObjectPaged::CountPagesByAgeInRange(uint64_t offset, uint64_t len,
+                                             uint64_t* counts, size_t num_counts) const {
+    canary_.Assert();
+    Guard<fbl::Mutex> guard{&lock_};
+    uint64_t new_len;
+    if (!TrimRange(offset, len, size_, &new_len)) {
+        return 0;
+    }
+    const uint64_t start_page_offset = ROUNDDOWN(offset, PAGE_SIZE);
+    const uint64_t end_page_offset = ROUNDUP(offset + new_len, PAGE_SIZE);
+
+    size_t count = 0;
+    page_list_.ForEveryPageInRange(
+        [&count, counts, num_counts](const auto p, uint64_t off) {
+            count++;
+            // a page of age n was last accessed within the last n + 1 harvests
+            for (size_t i = 0; i < num_counts; i++) {
+                if (p->object.age < (1u << i)) {
+                    counts[i]++;
+                }
+            }
+            return ZX_ERR_NEXT;
+        },
+        start_page_offset, end_page_offset);
+    return count;
+}
+
+uint32_t VmObjectPaged::CompressColdPages(uint8_t min_age, uint32_t max_pages) {
+    canary_.Assert();
+
+    list_node free_list;
+    list_initialize(&free_list);
+
+    uint32_t count = 0;
+    {
+        Guard<fbl::Mutex> guard{&lock_};
+
+        if (max_pages == 0 || !CanCompressLocked()) {
+            return 0;
+        }
+
+        page_list_.ForEveryPage(
+            [this, min_age, max_pages, &count, &free_list](vm_page*& p, uint64_t off)
+                TA_NO_THREAD_SAFETY_ANALYSIS {
+                if (count == max_pages || VmCompressedPage::PoolFull()) {
+                    return ZX_ERR_STOP;
+                }
+                // pinned pages may be the target of DMA
+                if (p->state != VM_PAGE_STATE_OBJECT || p->object.pin_count > 0 ||
+                    p->object.age < min_age) {
+                    return ZX_ERR_NEXT;
+                }
+
+                // unmap the page first so that it can't change while it is compressed
+                RangeChangeUpdateLocked(off, PAGE_SIZE);
+
+                auto compressed = VmCompressedPage::Compress(off, p->paddr());
+                if (!compressed) {
+                    return ZX_ERR_NEXT;
+                }
+                compressed_pages_.insert(fbl::move(compressed));
+
+                list_add_tail(&free_list, &p->queue_node);
+                p = nullptr;
+                count++;
+                return ZX_ERR_NEXT;
+            });
+
+        if (count > 0) {
+            page_list_.RemoveEmptyNodes();
+        }
+    }
+
+    // return the pages to the pmm outside of our lock
+    __UNUSED auto freed = pmm_free(&free_list);
+    DEBUG_ASSERT(freed == count);
+
+    LTRACEF("vmo %p compressed %u pages\n", this, count);
+    return count;
+}
+
+zx_status_t VmObjectPaged::DecompressPageLocked(uint64_t offset, list_node* free_list,
+                                                vm_page_t** page_out, paddr_t* pa_out) {
+    DEBUG_ASSERT(lock_.lock().IsHeld());
+
+    auto compressed = compressed_pages_.find(offset);
+    if (!compressed.IsValid()) {
+        return ZX_ERR_NOT_FOUND;
+    }
+
+    vm_page_t* p = nullptr;
+    paddr_t pa;
+    if (free_list) {
+        p = list_remove_head_type(free_list, vm_page, queue_node);
+        if (p) {
+            pa = p->paddr();
+        }
+    }
+    if (!p) {
+        p = pmm_alloc_page(pmm_alloc_flags_, &pa);
+    }
+    if (!p) {
+        return ZX_ERR_NO_MEMORY;
+    }
+
+    InitializeVmPage(p);
+
+    compressed->Decompress(pa);
+    compressed_pages_.erase(compressed);
+
+    zx_status_t status = AddPageLocked(p, offset);
+    DEBUG_ASSERT(status == ZX_OK);
+
+    LTRACEF("decompressed page %p, pa %#" PRIxPTR " at offset %#" PRIx64 "\n", p, pa, offset);
+
+    if (page_out)
+        *page_out = p;
+    if (pa_out)
+        *pa_out = pa;
+
+    return ZX_OK;
+}
+
+zx_status_t VmObjectPaged::DecompressRangeLocked(uint64_t start, uint64_t end) {
+    DEBUG_ASSERT(lock_.lock().IsHeld());
+
+    auto iter = compressed_pages_.lower_bound(start);
+    while (iter.IsValid() && iter->GetKey() < end) {
+        const uint64_t offset = iter->GetKey();
+        ++iter;
+
+        zx_status_t status = DecompressPageLocked(offset, nullptr, nullptr, nullptr);
+        if (status != ZX_OK) {
+            return status;
+        }
+    }
+    return ZX_OK;
+}
+
+void VmObjectPaged::FreeCompressedRangeLocked(uint64_t start, uint64_t end) {
+    DEBUG_ASSERT(lock_.lock().IsHeld());
+
+    auto iter = compressed_pages_.lower_bound(start);
+    while (iter.IsValid() && iter->GetKey() < end) {
+        auto to_erase = iter;
+        ++iter;
+        compressed_pages_.erase(to_erase);
+    }
+}
+
 zx_status_t VmObjectPaged::InvalidateCache(const uint64_t offset, const uint64_t len) {
     return CacheOp(offset, len, CacheOpType::Invalidate);
 }
@@ -8,6 +8,7 @@
 #include <err.h>
 #include <fbl/alloc_checker.h>
 #include <fbl/array.h>
+#include <fbl/unique_ptr.h>
 #include <lib/unittest/unittest.h>
 #include <vm/physmap.h>
 #include <vm/vm.h>
@@ -954,6 +955,247 @@ static bool vmo_lookup_test() {
     END_TEST;
 }
 
+// Creates a vm object, commits memory, and checks that only the pages that
+// are entirely zero get reclaimed by the zero page scan.
+static bool vmo_zero_scan_test() {
+    BEGIN_TEST;
+    static const size_t alloc_size = PAGE_SIZE * 4;
+    fbl::RefPtr<VmObject> vmo;
+    zx_status_t status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &vmo);
+    ASSERT_EQ(status, ZX_OK, "vmobject creation\n");
+    ASSERT_TRUE(vmo, "vmobject creation\n");
+
+    // objects without a koid are never scanned
+    uint64_t committed;
+    status = vmo->CommitRange(0, alloc_size, &committed);
+    ASSERT_EQ(ZX_OK, status, "committing vm object\n");
+    EXPECT_EQ(0u, vmo->ScanForZeroPages(true), "scanning kernel-only object\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, vmo->AllocatedPages(), "scanning kernel-only object\n");
+
+    vmo->set_user_id(42);
+
+    const uint8_t byte = 0xa5;
+    status = vmo->Write(&byte, PAGE_SIZE + 17, sizeof(byte));
+    EXPECT_EQ(ZX_OK, status, "writing to object\n");
+
+    // counting leaves the pages alone
+    EXPECT_EQ(3u, vmo->ScanForZeroPages(false), "counting zero pages\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, vmo->AllocatedPages(), "counting zero pages\n");
+
+    EXPECT_EQ(3u, vmo->ScanForZeroPages(true), "reclaiming zero pages\n");
+    EXPECT_EQ(1u, vmo->AllocatedPages(), "reclaiming zero pages\n");
+    EXPECT_EQ(0u, vmo->ScanForZeroPages(true), "reclaiming zero pages again\n");
+
+    // the remaining page kept its contents and the reclaimed ones read as zero
+    uint8_t buf[2];
+    status = vmo->Read(buf, PAGE_SIZE + 17, sizeof(buf));
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+    EXPECT_EQ(byte, buf[0], "reading from object\n");
+    EXPECT_EQ(0u, buf[1], "reading from object\n");
+    status = vmo->Read(buf, 3 * PAGE_SIZE, sizeof(buf));
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+    EXPECT_EQ(0u, buf[0], "reading from object\n");
+    EXPECT_EQ(1u, vmo->AllocatedPages(), "reading reclaimed pages\n");
+
+    // clones shadow their parent, so their zero pages have to stay
+    fbl::RefPtr<VmObject> clone;
+    status = vmo->CloneCOW(false, 0, alloc_size, false, &clone);
+    ASSERT_EQ(ZX_OK, status, "cloning vm object\n");
+    clone->set_user_id(43);
+    status = clone->CommitRange(0, alloc_size, &committed);
+    ASSERT_EQ(ZX_OK, status, "committing clone\n");
+    EXPECT_EQ(0u, clone->ScanForZeroPages(true), "scanning clone\n");
+    END_TEST;
+}
+
+static bool vmo_compression_test() {
+    BEGIN_TEST;
+    static const size_t alloc_size = PAGE_SIZE * 4;
+    fbl::RefPtr<VmObject> vmo;
+    zx_status_t status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &vmo);
+    ASSERT_EQ(status, ZX_OK, "vmobject creation\n");
+    ASSERT_TRUE(vmo, "vmobject creation\n");
+    vmo->set_user_id(42);
+
+    // fill every page with a compressible pattern
+    fbl::AllocChecker ac;
+    fbl::unique_ptr<uint8_t[]> data(new (&ac) uint8_t[alloc_size]);
+    ASSERT_TRUE(ac.check(), "allocating buffer\n");
+    for (size_t i = 0; i < alloc_size; i++) {
+        data[i] = static_cast<uint8_t>((i / 64) % 7);
+    }
+    status = vmo->Write(data.get(), 0, alloc_size);
+    ASSERT_EQ(ZX_OK, status, "writing to object\n");
+
+    // freshly written pages are too young
+    EXPECT_EQ(0u, vmo->CompressColdPages(2, UINT32_MAX), "compressing young pages\n");
+
+    // age the pages, then touch the first one again
+    vmo->HarvestAccessed();
+    vmo->HarvestAccessed();
+    uint8_t byte;
+    status = vmo->Read(&byte, 0, sizeof(byte));
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+
+    EXPECT_EQ(1u, vmo->CompressColdPages(2, 1), "compressing one cold page\n");
+    EXPECT_EQ(2u, vmo->CompressColdPages(2, UINT32_MAX), "compressing cold pages\n");
+    EXPECT_EQ(1u, vmo->AllocatedPages(), "compressing cold pages\n");
+
+    // reading brings the pages back intact
+    fbl::unique_ptr<uint8_t[]> buf(new (&ac) uint8_t[alloc_size]);
+    ASSERT_TRUE(ac.check(), "allocating buffer\n");
+    status = vmo->Read(buf.get(), 0, alloc_size);
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+    EXPECT_EQ(0, memcmp(data.get(), buf.get(), alloc_size), "comparing contents\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, vmo->AllocatedPages(), "reading compressed pages\n");
+
+    // decommitting drops compressed pages
+    EXPECT_EQ(alloc_size / PAGE_SIZE, vmo->CompressColdPages(0, UINT32_MAX),
+              "compressing all pages\n");
+    uint64_t decommitted;
+    status = vmo->DecommitRange(0, PAGE_SIZE, &decommitted);
+    EXPECT_EQ(ZX_OK, status, "decommitting\n");
+    status = vmo->Read(&byte, 0, sizeof(byte));
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+    EXPECT_EQ(0u, byte, "reading decommitted page\n");
+    status = vmo->Read(&byte, PAGE_SIZE + 64, sizeof(byte));
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+    EXPECT_EQ(data[PAGE_SIZE + 64], byte, "reading compressed page\n");
+
+    // pinned pages are resident and never compressed
+    status = vmo->Pin(2 * PAGE_SIZE, PAGE_SIZE);
+    EXPECT_EQ(ZX_OK, status, "pinning compressed page\n");
+    EXPECT_EQ(1u, vmo->CompressColdPages(0, UINT32_MAX), "compressing with a pinned page\n");
+    vmo->Unpin(2 * PAGE_SIZE, PAGE_SIZE);
+
+    // objects with kernel-only koids are left alone
+    fbl::RefPtr<VmObject> kernel_vmo;
+    status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &kernel_vmo);
+    ASSERT_EQ(ZX_OK, status, "vmobject creation\n");
+    status = kernel_vmo->CommitRange(0, alloc_size, nullptr);
+    ASSERT_EQ(ZX_OK, status, "committing vm object\n");
+    EXPECT_EQ(0u, kernel_vmo->CompressColdPages(0, UINT32_MAX), "compressing kernel object\n");
+    END_TEST;
+}
+
+static bool vmo_working_set_test() {
+    BEGIN_TEST;
+    static const size_t alloc_size = PAGE_SIZE * 4;
+    fbl::RefPtr<VmObject> vmo;
+    zx_status_t status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &vmo);
+    ASSERT_EQ(status, ZX_OK, "vmobject creation\n");
+    ASSERT_TRUE(vmo, "vmobject creation\n");
+    vmo->set_user_id(42);
+    status = vmo->CommitRange(0, alloc_size, nullptr);
+    ASSERT_EQ(ZX_OK, status, "committing vm object\n");
+
+    // freshly committed pages count as accessed
+    uint64_t counts[3] = {};
+    EXPECT_EQ(alloc_size / PAGE_SIZE, vmo->CountPagesByAgeInRange(0, alloc_size, counts, 3),
+              "counting committed pages\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, counts[0], "counting fresh pages\n");
+
+    // age the pages, then touch the first one again
+    vmo->HarvestAccessed();
+    vmo->HarvestAccessed();
+    uint8_t byte;
+    status = vmo->Read(&byte, 0, sizeof(byte));
+    EXPECT_EQ(ZX_OK, status, "reading from object\n");
+
+    memset(counts, 0, sizeof(counts));
+    EXPECT_EQ(alloc_size / PAGE_SIZE, vmo->CountPagesByAgeInRange(0, alloc_size, counts, 3),
+              "counting committed pages\n");
+    EXPECT_EQ(1u, counts[0], "counting pages accessed in the last harvest\n");
+    EXPECT_EQ(1u, counts[1], "counting pages accessed in the last 2 harvests\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, counts[2], "counting pages accessed in the last 4 harvests\n");
+
+    // only pages in the range are counted
+    memset(counts, 0, sizeof(counts));
+    EXPECT_EQ(1u, vmo->CountPagesByAgeInRange(PAGE_SIZE, PAGE_SIZE, counts, 3),
+              "counting a range\n");
+    EXPECT_EQ(0u, counts[0], "counting a range\n");
+
+    // objects with kernel-only koids aren't harvested, so always count as accessed
+    fbl::RefPtr<VmObject> kernel_vmo;
+    status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &kernel_vmo);
+    ASSERT_EQ(ZX_OK, status, "vmobject creation\n");
+    status = kernel_vmo->CommitRange(0, alloc_size, nullptr);
+    ASSERT_EQ(ZX_OK, status, "committing vm object\n");
+    kernel_vmo->HarvestAccessed();
+    memset(counts, 0, sizeof(counts));
+    kernel_vmo->CountPagesByAgeInRange(0, alloc_size, counts, 1);
+    EXPECT_EQ(alloc_size / PAGE_SIZE, counts[0], "counting kernel object\n");
+    END_TEST;
+}
+
+static bool vmo_zero_and_transfer_test() {
+    BEGIN_TEST;
+    static const size_t alloc_size = PAGE_SIZE * 4;
+    fbl::RefPtr<VmObject> src;
+    zx_status_t status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &src);
+    ASSERT_EQ(status, ZX_OK, "vmobject creation\n");
+    fbl::RefPtr<VmObject> dst;
+    status = VmObjectPaged::Create(PMM_ALLOC_FLAG_ANY, 0u, alloc_size, &dst);
+    ASSERT_EQ(status, ZX_OK, "vmobject creation\n");
+
+    fbl::AllocChecker ac;
+    fbl::unique_ptr<uint8_t[]> data(new (&ac) uint8_t[alloc_size]);
+    ASSERT_TRUE(ac.check(), "allocating buffer\n");
+    memset(data.get(), 0xaa, alloc_size);
+    status = src->Write(data.get(), 0, alloc_size);
+    ASSERT_EQ(ZX_OK, status, "writing to object\n");
+
+    // zeroing whole pages decommits them, partial pages are zeroed in place
+    status = src->ZeroRange(PAGE_SIZE / 2, PAGE_SIZE * 2);
+    EXPECT_EQ(ZX_OK, status, "zeroing range\n");
+    EXPECT_EQ(3u, src->AllocatedPages(), "zeroing range\n");
+    uint8_t byte;
+    EXPECT_EQ(ZX_OK, src->Read(&byte, PAGE_SIZE / 2 - 1, 1), "reading\n");
+    EXPECT_EQ(0xaa, byte, "before the zeroed range\n");
+    EXPECT_EQ(ZX_OK, src->Read(&byte, PAGE_SIZE / 2, 1), "reading\n");
+    EXPECT_EQ(0, byte, "start of the zeroed range\n");
+    EXPECT_EQ(ZX_OK, src->Read(&byte, PAGE_SIZE * 2 + PAGE_SIZE / 2, 1), "reading\n");
+    EXPECT_EQ(0xaa, byte, "after the zeroed range\n");
+
+    // taking pages commits the holes and leaves the range empty
+    list_node pages;
+    list_initialize(&pages);
+    status = src->TakePages(0, alloc_size, &pages);
+    EXPECT_EQ(ZX_OK, status, "taking pages\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, list_length(&pages), "taking pages\n");
+    EXPECT_EQ(0u, src->AllocatedPages(), "taking pages\n");
+
+    status = dst->SupplyPages(0, alloc_size, &pages);
+    EXPECT_EQ(ZX_OK, status, "supplying pages\n");
+    EXPECT_TRUE(list_is_empty(&pages), "supplying pages\n");
+    EXPECT_EQ(alloc_size / PAGE_SIZE, dst->AllocatedPages(), "supplying pages\n");
+    EXPECT_EQ(ZX_OK, dst->Read(&byte, PAGE_SIZE * 3, 1), "reading\n");
+    EXPECT_EQ(0xaa, byte, "reading transferred page\n");
+    EXPECT_EQ(ZX_OK, dst->Read(&byte, PAGE_SIZE, 1), "reading\n");
+    EXPECT_EQ(0, byte, "reading transferred hole\n");
+
+    // pinned pages stay put
+    status = dst->Pin(0, PAGE_SIZE);
+    EXPECT_EQ(ZX_OK, status, "pinning\n");
+    status = dst->TakePages(0, PAGE_SIZE, &pages);
+    EXPECT_EQ(ZX_ERR_BAD_STATE, status, "taking pinned pages\n");
+
+    // a range that can't take the pages leaves them with the caller
+    status = src->TakePages(0, PAGE_SIZE, &pages);
+    EXPECT_EQ(ZX_OK, status, "taking pages\n");
+    status = dst->SupplyPages(0, PAGE_SIZE, &pages);
+    EXPECT_EQ(ZX_ERR_BAD_STATE, status, "supplying pinned pages\n");
+    EXPECT_EQ(1u, list_length(&pages), "supplying pinned pages\n");
+    status = dst->SupplyPages(alloc_size, PAGE_SIZE, &pages);
+    EXPECT_EQ(ZX_ERR_OUT_OF_RANGE, status, "supplying past the end\n");
+    EXPECT_EQ(1u, list_length(&pages), "supplying past the end\n");
+    status = src->SupplyPages(0, PAGE_SIZE, &pages);
+    EXPECT_EQ(ZX_OK, status, "supplying pages back\n");
+    EXPECT_TRUE(list_is_empty(&pages), "supplying pages back\n");
+    dst->Unpin(0, PAGE_SIZE);
+    END_TEST;
+}
+
 // TODO(ZX-1431): The ARM code's error codes are always ZX_ERR_INTERNAL, so
 // special case that.
 #if ARCH_ARM64
@@ -1065,6 +1307,10 @@ VM_UNITTEST(vmo_double_remap_test)
 VM_UNITTEST(vmo_read_write_smoke_test)
 VM_UNITTEST(vmo_cache_test)
 VM_UNITTEST(vmo_lookup_test)
+VM_UNITTEST(vmo_zero_scan_test)
+VM_UNITTEST(vmo_compression_test)
+VM_UNITTEST(vmo_working_set_test)
+VM_UNITTEST(vmo_zero_and_transfer_test)
 VM_UNITTEST(arch_noncontiguous_map)
 // Uncomment for debugging
 // VM_UNITTEST(dump_all_aspaces)  // Run last
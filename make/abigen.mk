@@ -19,6 +19,7 @@ AG_KERNEL_TRACE := $(AG_ZIRCON)/syscall-ktrace-info.inc
 AG_KERNEL_CATEGORY := $(AG_ZIRCON)/syscall-category.inc
 AG_KERNEL_WRAPPERS := $(AG_ZIRCON)/syscall-kernel-wrappers.inc
 AG_KERNEL_BRANCHES := $(AG_ZIRCON)/syscall-kernel-branches.S
+AG_KERNEL_BATCH := $(AG_ZIRCON)/syscall-kernel-batch.inc
 
 AG_ULIB_VDSO_HEADER := $(AG_ZIRCON)/syscall-vdso-definitions.h
 AG_ULIB_VDSO_WRAPPERS := $(AG_ZIRCON)/syscall-vdso-wrappers.inc
@@ -29,10 +30,12 @@ AG_ULIB_X86 := $(AG_ZIRCON)/syscalls-x86-64.S
 AG_SYSCALLS := $(AG_ZIRCON)/syscalls
 AG_PUBLIC_HEADER := $(AG_SYSCALLS)/definitions.h
 AG_PUBLIC_RUST := $(AG_SYSCALLS)/definitions.rs
+AG_PUBLIC_BATCH := $(AG_SYSCALLS)/batch-numbers.h
 
 AG_SYSROOT_ZIRCON := $(BUILDSYSROOT)/include/zircon
 AG_SYSROOT_HEADER := $(AG_SYSROOT_ZIRCON)/syscalls/definitions.h
 AG_SYSROOT_RUST := $(AG_SYSROOT_ZIRCON)/syscalls/definitions.rs
+AG_SYSROOT_BATCH := $(AG_SYSROOT_ZIRCON)/syscalls/batch-numbers.h
 
 # STAMPY ultimately generates most of the files and paths here.
 $(STAMPY): $(ABIGEN) $(SYSCALLS_SRC)
@@ -44,6 +47,7 @@ $(STAMPY): $(ABIGEN) $(SYSCALLS_SRC)
 		-kernel-header $(AG_KERNEL_HEADER) \
 		-kernel-wrappers $(AG_KERNEL_WRAPPERS) \
 		-kernel-branch $(AG_KERNEL_BRANCHES) \
+		-kernel-batch $(AG_KERNEL_BATCH) \
 		-arm-asm $(AG_ULIB_ARM) \
 		-x86-asm $(AG_ULIB_X86) \
 		-vdso-header $(AG_ULIB_VDSO_HEADER) \
@@ -51,25 +55,29 @@ $(STAMPY): $(ABIGEN) $(SYSCALLS_SRC)
 		-numbers $(AG_ULIB_SYSCALL_NUMBER) \
 		-user-header $(AG_PUBLIC_HEADER) \
 		-rust $(AG_PUBLIC_RUST) \
+		-batch-numbers $(AG_PUBLIC_BATCH) \
 		$(SYSCALLS_SRC)
 	$(NOECHO) touch $(STAMPY)
 
-run-abigen $(AG_PUBLIC_HEADER) $(AG_PUBLIC_RUST) $(AG_SYSROOT_HEADER) $(AG_SYSROOT_RUST): $(STAMPY)
+run-abigen $(AG_PUBLIC_HEADER) $(AG_PUBLIC_RUST) $(AG_PUBLIC_BATCH) \
+	$(AG_SYSROOT_HEADER) $(AG_SYSROOT_RUST) $(AG_SYSROOT_BATCH): $(STAMPY)
 
 GENERATED += $(AG_KERNEL_HEADER) $(AG_KERNEL_TRACE) \
 	$(AG_KERNEL_CATEGORY) $(AG_ULIB_X86) $(AG_ULIB_ARM) \
-	$(AG_KERNEL_WRAPPERS) $(AG_KERNEL_BRANCHES) \
+	$(AG_KERNEL_WRAPPERS) $(AG_KERNEL_BRANCHES) $(AG_KERNEL_BATCH) \
 	$(AG_ULIB_SYSCALL_NUMBERS) \
 	$(AG_ULIB_VDSO_HEADER) $(AG_ULIB_VDSO_WRAPPERS) \
 	$(AG_PUBLIC_HEADER) $(AG_SYSROOT_HEADER) \
 	$(AG_PUBLIC_RUST) $(AG_SYSROOT_RUST) \
+	$(AG_PUBLIC_BATCH) $(AG_SYSROOT_BATCH) \
 	$(STAMPY)
 
 $(call copy-dst-src,$(AG_SYSROOT_HEADER),$(AG_PUBLIC_HEADER))
 $(call copy-dst-src,$(AG_SYSROOT_RUST),$(AG_PUBLIC_RUST))
+$(call copy-dst-src,$(AG_SYSROOT_BATCH),$(AG_PUBLIC_BATCH))
 
 # needed to create c.pkg (see: module-userlib.mk)
 ABIGEN_BUILDDIR := $(GENERATED_INCLUDES)
-ABIGEN_PUBLIC_HEADERS := $(AG_PUBLIC_HEADER) $(AG_PUBLIC_RUST)
+ABIGEN_PUBLIC_HEADERS := $(AG_PUBLIC_HEADER) $(AG_PUBLIC_RUST) $(AG_PUBLIC_BATCH)
 
-SYSROOT_DEPS += $(AG_SYSROOT_HEADER) $(AG_SYSROOT_RUST)
+SYSROOT_DEPS += $(AG_SYSROOT_HEADER) $(AG_SYSROOT_RUST) $(AG_SYSROOT_BATCH)
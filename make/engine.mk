@@ -26,7 +26,8 @@ ENABLE_BUILD_SYSROOT := $(call TOBOOL,$(ENABLE_BUILD_SYSROOT))
 ENABLE_INSTALL_SAMPLES ?= false
 ENABLE_DDK_DEPRECATIONS ?= false
 ENABLE_NEW_BOOTDATA := true
-ENABLE_LOCK_DEP ?= false
+ENABLE_LOCK_DEP_PROFILING ?= false
+ENABLE_LOCK_DEP ?= $(ENABLE_LOCK_DEP_PROFILING)
 ENABLE_LOCK_DEP_TESTS ?= $(ENABLE_LOCK_DEP)
 DISABLE_UTEST ?= false
 ENABLE_ULIB_ONLY ?= false
@@ -398,6 +399,12 @@ KERNEL_DEFINES += WITH_LOCK_DEP=1
 KERNEL_DEFINES += LOCK_DEP_ENABLE_VALIDATION=1
 endif
 
+# Kernel lock contention profiling. This builds on the per-lock class state
+# kept by lock dependency tracking, which it enables by default.
+ifeq ($(call TOBOOL,$(ENABLE_LOCK_DEP_PROFILING)),true)
+KERNEL_DEFINES += LOCK_DEP_ENABLE_PROFILING=1
+endif
+
 # Kernel lock dependency tracking tests. By default this is enabled when
 # tracking is enabled, but can also be eanbled independently to assess whether
 # the tests build and *fail correctly* when lockdep is disabled.
@@ -46,6 +46,9 @@ static KernelWrapperGenerator kernel_wrappers(
     "wrapper_", // wrapper prefix
     "ZX_SYS_"); // syscall numbers constant prefix
 
+static KernelBatchGenerator kernel_batch(
+    "sys_"); // function prefix
+
 static bool skip_nothing(const Syscall&) {
     return false;
 }
@@ -93,6 +96,7 @@ static VDsoAsmGenerator vdso_asm_generator(
     wrappers);
 
 static SyscallNumbersGenerator syscall_num_generator("#define ZX_SYS_");
+static BatchNumbersGenerator batch_num_generator("#define ZX_BATCH_");
 
 static RustBindingGenerator rust_binding_generator;
 static TraceInfoGenerator trace_generator;
@@ -115,6 +119,9 @@ const map<string, Generator&> type_to_generator = {
     // The kernel C++ wrappers.
     {"kernel-wrappers", kernel_wrappers},
 
+    // The kernel's zx_syscall_batch() dispatch cases.
+    {"kernel-batch", kernel_batch},
+
     //  The assembly file for x86-64.
     {"x86-asm", vdso_asm_generator},
 
@@ -124,6 +131,10 @@ const map<string, Generator&> type_to_generator = {
     // A C header defining ZX_SYS_* syscall number macros.
     {"numbers", syscall_num_generator},
 
+    // A public C header defining the ZX_BATCH_* numbers used with
+    // zx_syscall_batch().
+    {"batch-numbers", batch_num_generator},
+
     // The trace subsystem data, to be interpreted as an array of structs.
     {"trace", trace_generator},
 
@@ -146,9 +157,11 @@ const map<string, string> type_to_default_suffix = {
     {"kernel-header", ".kernel.h"},
     {"kernel-branch", ".kernel-branch.S"},
     {"kernel-wrappers", ".kernel-wrappers.inc"},
+    {"kernel-batch", ".kernel-batch.inc"},
     {"x86-asm", ".x86-64.S"},
     {"arm-asm", ".arm64.S"},
     {"numbers", ".syscall-numbers.h"},
+    {"batch-numbers", ".batch-numbers.h"},
     {"trace", ".trace.inc"},
     {"rust", ".rs"},
     {"vdso-wrappers", ".vdso-wrappers.inc"},
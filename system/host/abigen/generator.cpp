@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstdio>
 #include <ctime>
 #include <fstream>
 
@@ -83,6 +84,33 @@ bool SyscallNumbersGenerator::footer(ofstream& os) {
     return os.good();
 }
 
+bool BatchNumbersGenerator::header(ofstream& os) {
+    if (!Generator::header(os))
+        return false;
+
+    os << "#pragma once\n\n";
+    return os.good();
+}
+
+bool BatchNumbersGenerator::syscall(ofstream& os, const Syscall& sc) {
+    if (!sc.is_batchable())
+        return true;
+
+    // Two names hashing alike would make one of them unreachable; renaming
+    // one of the calls is the way out.
+    auto inserted = names_.emplace(sc.batch_id(), sc.name);
+    if (!inserted.second) {
+        fprintf(stderr, "error: batch id of %s collides with %s\n",
+                sc.name.c_str(), inserted.first->second.c_str());
+        return false;
+    }
+
+    char id[16];
+    snprintf(id, sizeof(id), "0x%08xu", sc.batch_id());
+    os << define_prefix_ << sc.name << " " << id << "\n";
+    return os.good();
+}
+
 bool TraceInfoGenerator::syscall(ofstream& os, const Syscall& sc) {
     if (sc.is_vdso())
         return true;
@@ -6,6 +6,7 @@
 
 #include <ctime>
 #include <fstream>
+#include <map>
 #include <string>
 
 #include "types.h"
@@ -105,6 +106,32 @@ private:
     const std::string define_prefix_;
 };
 
+/* Generates the kernel's zx_syscall_batch() dispatch cases. */
+class KernelBatchGenerator : public Generator {
+public:
+    KernelBatchGenerator(const std::string& syscall_prefix)
+        : syscall_prefix_(syscall_prefix) {}
+
+    bool syscall(std::ofstream& os, const Syscall& sc) override;
+
+private:
+    const std::string syscall_prefix_;
+};
+
+// Generate the public numbers that name calls in zx_syscall_batch().
+class BatchNumbersGenerator : public Generator {
+public:
+    BatchNumbersGenerator(const std::string& define_prefix)
+        : define_prefix_(define_prefix) {}
+
+    bool header(std::ofstream& os) override;
+    bool syscall(std::ofstream& os, const Syscall& sc) override;
+
+private:
+    const std::string define_prefix_;
+    std::map<uint32_t, std::string> names_;
+};
+
 /* Generates the Rust bindings. */
 class RustBindingGenerator : public Generator {
 public:
@@ -5,7 +5,9 @@
 #import "generator.h"
 
 #import <algorithm>
+#import <functional>
 #import <iterator>
+#import <utility>
 
 using std::ofstream;
 using std::string;
@@ -35,19 +37,15 @@ bool KernelWrapperGenerator::header(ofstream& os) {
     return os.good();
 }
 
-bool KernelWrapperGenerator::syscall(ofstream& os, const Syscall& sc) {
-    if (sc.is_vdso())
-        return true;
-
-    auto syscall_name = syscall_prefix_ + sc.name;
-    write_syscall_signature_line(os, sc, wrapper_prefix_);
-    os << in << "return do_syscall("
-       << define_prefix_ << sc.name << ", "
-       << "pc, "
-       << "&VDso::ValidSyscallPC::" << sc.name << ", "
-       << "[&](ProcessDispatcher* current_process) -> uint64_t {\n";
-
+// Writes the call to the sys_* implementation of |sc| and the copyout of any
+// handles it returns, ending in a return of the call's result.  |arg_value|
+// gives the expression for each user-supplied argument before it is wrapped
+// in a user_ptr.
+static void write_kernel_call(ofstream& os, const Syscall& sc, const string& syscall_name,
+                              const string& indent,
+                              const std::function<string(const TypeSpec&, size_t)>& arg_value) {
     string args;
+    size_t index = 0;
     for (const TypeSpec& arg : sc.arg_spec) {
         if (!args.empty())
             args += ", ";
@@ -55,14 +53,15 @@ bool KernelWrapperGenerator::syscall(ofstream& os, const Syscall& sc) {
             args += "make_user_";
             args += arg.arr_spec->kind_lowercase_str();
             args += "_ptr(";
-            args += arg.name;
+            args += arg_value(arg, index);
             args += ")";
         } else {
-            args += arg.name;
+            args += arg_value(arg, index);
         }
+        ++index;
     }
 
-    vector<string> out_handles;
+    vector<std::pair<string, string>> out_handles;
 
     sc.for_each_return([&](const TypeSpec& arg) {
         if (!args.empty())
@@ -71,41 +70,58 @@ bool KernelWrapperGenerator::syscall(ofstream& os, const Syscall& sc) {
             assert(arg.arr_spec->kind == ArraySpec::OUT);
             assert(arg.arr_spec->count == 1);
             if (arg.type == "zx_handle_t") {
-                out_handles.push_back(arg.name);
-                os << inin
+                out_handles.emplace_back(arg.name, arg_value(arg, index));
+                os << indent
                    << "user_out_handle out_handle_" << arg.name << ";\n";
                 args += "&out_handle_";
                 args += arg.name;
             } else {
                 args += "make_user_out_ptr(";
-                args += arg.name;
+                args += arg_value(arg, index);
                 args += ")";
             }
         } else {
-            args += arg.name;
+            args += arg_value(arg, index);
         }
+        ++index;
     });
 
-    os << inin
+    os << indent
        << (sc.is_noreturn() ? "/*noreturn*/ " : "auto result = ")
        << syscall_name << "(" << args << ");\n";
 
     if (sc.is_noreturn()) {
-        os << inin << "/* NOTREACHED */\n";
-        os << inin << "return ZX_ERR_BAD_STATE;\n";
+        os << indent << "/* NOTREACHED */\n";
+        os << indent << "return ZX_ERR_BAD_STATE;\n";
     } else {
         for (const auto& arg : out_handles) {
-            os << inin << "if (out_handle_" << arg
+            os << indent << "if (out_handle_" << arg.first
                << ".begin_copyout(current_process, make_user_out_ptr("
-               << arg << ")))\n"
-               << inin << in << "return ZX_ERR_INVALID_ARGS;\n";
+               << arg.second << ")))\n"
+               << indent << in << "return ZX_ERR_INVALID_ARGS;\n";
         }
         for (const auto& arg : out_handles) {
-            os << inin << "out_handle_" << arg
+            os << indent << "out_handle_" << arg.first
                << ".finish_copyout(current_process);\n";
         }
-        os << inin << "return result;\n";
+        os << indent << "return result;\n";
     }
+}
+
+bool KernelWrapperGenerator::syscall(ofstream& os, const Syscall& sc) {
+    if (sc.is_vdso())
+        return true;
+
+    auto syscall_name = syscall_prefix_ + sc.name;
+    write_syscall_signature_line(os, sc, wrapper_prefix_);
+    os << in << "return do_syscall("
+       << define_prefix_ << sc.name << ", "
+       << "pc, "
+       << "&VDso::ValidSyscallPC::" << sc.name << ", "
+       << "[&](ProcessDispatcher* current_process) -> uint64_t {\n";
+
+    write_kernel_call(os, sc, syscall_name, inin,
+                      [](const TypeSpec& arg, size_t) { return arg.name; });
 
     os << in << "});\n"
        << "}\n";
@@ -116,3 +132,19 @@ bool KernelWrapperGenerator::footer(ofstream& os) {
     os << "}\n";
     return os.good();
 }
+
+// Each batchable syscall becomes a case in the switch in
+// kernel/syscalls/batch.cpp, which provides |current_process| and the
+// entry's |args| array.
+bool KernelBatchGenerator::syscall(ofstream& os, const Syscall& sc) {
+    if (!sc.is_batchable())
+        return true;
+
+    os << "case 0x" << std::hex << sc.batch_id() << std::dec << "u: { // " << sc.name << "\n";
+    write_kernel_call(os, sc, syscall_prefix_ + sc.name, in,
+                      [](const TypeSpec& arg, size_t index) {
+                          return arg.as_cpp_cast("args[" + std::to_string(index) + "]");
+                      });
+    os << "}\n";
+    return os.good();
+}
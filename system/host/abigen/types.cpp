@@ -167,6 +167,27 @@ bool Syscall::is_internal() const {
     return has_attribute("internal", attributes);
 }
 
+// Whether the call can be made through zx_syscall_batch().  Blocking calls
+// are left out because the vDSO retries them when they are interrupted,
+// which a batch entry can't do.
+bool Syscall::is_batchable() const {
+    return !is_vdso() && !is_noreturn() && !is_blocking() && !is_internal() &&
+           !has_attribute("nobatch", attributes) &&
+           !ret_spec.empty() && ret_spec[0].type == "zx_status_t";
+}
+
+// The number that names the call in zx_syscall_batch().  It is a 32-bit
+// FNV-1a hash of the name rather than the syscall index, so it stays the
+// same when syscalls are added or reordered and doesn't reveal the index.
+uint32_t Syscall::batch_id() const {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 size_t Syscall::num_kernel_args() const {
     return is_noreturn() ? arg_spec.size() : arg_spec.size() + ret_spec.size() - 1;
 }
@@ -70,6 +70,8 @@ struct Syscall {
     bool is_noreturn() const;
     bool is_blocking() const;
     bool is_internal() const;
+    bool is_batchable() const;
+    uint32_t batch_id() const;
     size_t num_kernel_args() const;
     void for_each_kernel_arg(const std::function<void(const TypeSpec&)>& cb) const;
     void for_each_return(const std::function<void(const TypeSpec&)>& cb) const;
@@ -84,6 +84,9 @@
     (ZX_RIGHTS_BASIC | ZX_RIGHTS_IO | ZX_RIGHTS_PROPERTY |\
      ZX_RIGHT_EXECUTE | ZX_RIGHT_MAP | ZX_RIGHT_SIGNAL)
 
+#define ZX_DEFAULT_WAITSET_RIGHTS \
+    ((ZX_RIGHTS_BASIC & (~ZX_RIGHT_WAIT)) | ZX_RIGHTS_IO)
+
 #define ZX_DEFAULT_IOMMU_RIGHTS \
     (ZX_RIGHTS_BASIC & (~ZX_RIGHT_WAIT))
 
@@ -33,6 +33,9 @@ typedef enum {
     ZX_INFO_HANDLE_COUNT               = 19, // zx_info_handle_count_t[1]
     ZX_INFO_BTI                        = 20, // zx_info_bti_t[1]
     ZX_INFO_PROCESS_HANDLE_STATS       = 21, // zx_info_process_handle_stats_t[1]
+    ZX_INFO_VMO_WORKING_SET            = 22, // zx_info_working_set_t[1]
+    ZX_INFO_PROCESS_WORKING_SET        = 23, // zx_info_working_set_t[1]
+    ZX_INFO_LOCK_CLASS_STATS           = 24, // zx_info_lock_class_stats_t[n]
     ZX_INFO_LAST
 } zx_object_info_topic_t;
 
@@ -106,6 +109,10 @@ typedef struct zx_info_thread {
 typedef struct zx_info_thread_stats {
     // Total accumulated running time of the thread.
     zx_duration_t total_runtime;
+
+    // Part of |total_runtime| charged against the thread's CPU reservation.
+    // Zero if the thread has never had a reservation.
+    zx_duration_t reserved_runtime;
 } zx_info_thread_stats_t;
 
 // Statistics about resources (e.g., memory) used by a task. Can be relatively
@@ -275,6 +282,26 @@ typedef struct zx_info_vmo {
     zx_rights_t handle_rights;
 } zx_info_vmo_t;
 
+// The number of time windows reported in |zx_info_working_set_t|.
+#define ZX_INFO_WORKING_SET_WINDOWS 8
+
+// Describes how much of the committed memory of a VMO, or of the VMOs mapped
+// into a process, has been recently accessed.
+typedef struct zx_info_working_set {
+    // The interval at which the kernel samples page accesses, or zero if
+    // it doesn't sample them periodically.
+    zx_duration_t harvest_period;
+
+    // The amount of memory committed to the VMO, or to the mapped ranges of
+    // the process's VMOs.
+    uint64_t committed_bytes;
+
+    // The portion of |committed_bytes| accessed within the last
+    // 2^i * |harvest_period|, for each window i. Memory whose accesses the
+    // kernel can't sample is always counted as accessed.
+    uint64_t accessed_bytes[ZX_INFO_WORKING_SET_WINDOWS];
+} zx_info_working_set_t;
+
 // kernel statistics per cpu
 // TODO(cpu), expose the deprecated stats via a new syscall.
 typedef struct zx_info_cpu_stats {
@@ -341,6 +368,15 @@ typedef struct zx_info_kmem_stats {
 
     // Non-free memory that isn't accounted for in any other field.
     uint64_t other_bytes;
+
+    // The amount of memory the kernel has reclaimed since boot by
+    // decommitting VMO pages that contained only zeroes.
+    uint64_t zero_reclaimed_bytes;
+
+    // The amount of VMO data currently decommitted and held in compressed
+    // form, and the amount of memory holding it.
+    uint64_t compressed_bytes;
+    uint64_t compressed_storage_bytes;
 } zx_info_kmem_stats_t;
 
 typedef struct zx_info_resource {
@@ -359,6 +395,32 @@ typedef struct zx_info_resource {
 
 #define ZX_INFO_CPU_STATS_FLAG_ONLINE       (1u<<0)
 
+#define ZX_INFO_LOCK_CLASS_NAME_LEN 128
+
+// Contention statistics for a class of kernel locks, gathered when the kernel
+// is built with lock profiling enabled.
+typedef struct zx_info_lock_class_stats {
+    // A small integer identifying the lock class, matching the identifiers
+    // used in kernel trace records. It is stable across boots of the same
+    // kernel build, but not across builds.
+    uint64_t id;
+
+    // The number of times a lock of this class was acquired.
+    uint64_t acquisitions;
+
+    // The number of those acquisitions that had to wait for another holder.
+    uint64_t contended;
+
+    // The total time spent waiting by contended acquisitions.
+    zx_duration_t total_wait_time;
+
+    // The longest time a lock of this class was held.
+    zx_duration_t max_hold_time;
+
+    // The name of the lock class, truncated if too long.
+    char name[ZX_INFO_LOCK_CLASS_NAME_LEN];
+} zx_info_lock_class_stats_t;
+
 // Object properties.
 
 // Argument is a char[ZX_MAX_NAME_LEN].
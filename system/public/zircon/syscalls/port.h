@@ -12,6 +12,14 @@ __BEGIN_CDECLS
 
 // clang-format off
 
+// zx_port_create() options
+// ZX_PORT_QUOTA(n) limits the port to 2^n pending packets, for 1 <= n <= 20,
+// instead of the system default.  The quota can only lower the default.
+#define ZX_PORT_QUOTA_SHIFT         (8u)
+#define ZX_PORT_QUOTA_MASK          ((uint32_t)0xFFu << ZX_PORT_QUOTA_SHIFT)
+#define ZX_PORT_QUOTA(n)            ((uint32_t)((n) & 0xFFu) << ZX_PORT_QUOTA_SHIFT)
+#define ZX_PORT_QUOTA_MAX           (20u)
+
 // zx_object_wait_async() options
 #define ZX_WAIT_ASYNC_ONCE          ((uint32_t)0u)
 #define ZX_WAIT_ASYNC_REPEATING     ((uint32_t)1u)
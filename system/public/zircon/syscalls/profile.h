@@ -12,6 +12,7 @@ __BEGIN_CDECLS
 // clang-format off
 
 #define ZX_PROFILE_INFO_SCHEDULER   1
+#define ZX_PROFILE_INFO_BANDWIDTH   2
 
 typedef struct zx_profile_scheduler {
     int32_t priority;
@@ -26,10 +27,28 @@ typedef struct zx_profile_scheduler {
 #define ZX_PRIORITY_HIGH                24
 #define ZX_PRIORITY_HIGHEST             31
 
+// Threads of the same priority take turns running for a time slice that is
+// proportional to their weight.  Optionally, a thread may also reserve
+// |capacity_us| microseconds of running time in every |period_us|, during
+// which it runs ahead of unreserved threads of lower priority.  Both are zero
+// for no reservation.  The fields are 32 bits wide so that this struct fits
+// the union in zx_profile_info_t without changing its size or alignment.
+typedef struct zx_profile_bandwidth {
+    uint32_t weight;                // ZX_SCHED_WEIGHT_MIN to ZX_SCHED_WEIGHT_MAX
+    uint32_t capacity_us;
+    uint32_t period_us;
+    uint32_t reserved;
+} zx_profile_bandwidth_t;
+
+#define ZX_SCHED_WEIGHT_MIN             1
+#define ZX_SCHED_WEIGHT_DEFAULT         16
+#define ZX_SCHED_WEIGHT_MAX             64
+
 typedef struct zx_profile_info {
     uint32_t type;                  // one of ZX_PROFILE_INFO_
     union {
         zx_profile_scheduler_t scheduler;
+        zx_profile_bandwidth_t bandwidth;
     };
 } zx_profile_info_t;
 
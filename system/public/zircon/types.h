@@ -183,6 +183,33 @@ typedef struct zx_channel_call_args {
     uint32_t rd_num_handles;
 } zx_channel_call_args_t;
 
+// Buffers for one message read by zx_channel_read_many().
+typedef struct zx_channel_read_slot {
+    void* bytes;
+    zx_handle_t* handles;
+    uint32_t num_bytes;
+    uint32_t num_handles;
+    uint32_t actual_bytes;
+    uint32_t actual_handles;
+} zx_channel_read_slot_t;
+
+// One buffer of the vector passed to zx_socket_writev(), zx_socket_readv(),
+// zx_fifo_writev() and zx_fifo_readv().
+typedef struct zx_iovec {
+    void* buffer;
+    size_t capacity;
+} zx_iovec_t;
+
+// One call in the array passed to zx_syscall_batch().  |num| is one of the
+// ZX_BATCH_* numbers from <zircon/syscalls/batch-numbers.h>, and |args| holds
+// the call's arguments in order, with any out parameters last.  The kernel
+// stores the call's result in |status|.
+typedef struct zx_syscall_call {
+    uint32_t num;
+    zx_status_t status;
+    uint64_t args[8];
+} zx_syscall_call_t;
+
 // Maximum number of wait items allowed for zx_object_wait_many()
 // TODO(ZX-1349) Re-lower this.
 #define ZX_WAIT_MANY_MAX_ITEMS ((size_t)16)
@@ -194,6 +221,13 @@ typedef struct zx_wait_item {
     zx_signals_t pending;
 } zx_wait_item_t;
 
+// Structure for zx_waitset_wait():
+typedef struct zx_waitset_result {
+    uint64_t cookie;
+    zx_status_t status;
+    zx_signals_t observed;
+} zx_waitset_result_t;
+
 typedef uint32_t zx_rights_t;
 #define ZX_RIGHT_NONE             ((zx_rights_t)0u)
 #define ZX_RIGHT_DUPLICATE        ((zx_rights_t)1u << 0)
@@ -245,6 +279,7 @@ typedef uint32_t zx_rights_t;
 #define ZX_VMO_OP_CACHE_INVALIDATE       ((uint32_t)7u)
 #define ZX_VMO_OP_CACHE_CLEAN            ((uint32_t)8u)
 #define ZX_VMO_OP_CACHE_CLEAN_INVALIDATE ((uint32_t)9u)
+#define ZX_VMO_OP_ZERO                   ((uint32_t)10u)
 
 // VM Object clone flags
 #define ZX_VMO_CLONE_COPY_ON_WRITE        ((uint32_t)1u << 0)
@@ -305,6 +340,8 @@ typedef uint64_t zx_off_t;
 
 // Channel options and limits.
 #define ZX_CHANNEL_READ_MAY_DISCARD         ((uint32_t)1u)
+#define ZX_CHANNEL_WRITE_TRANSFER_PAGES     ((uint32_t)1u)
+#define ZX_CHANNEL_CALL_INHERIT_PRIORITY    ((uint32_t)1u)
 
 #define ZX_CHANNEL_MAX_MSG_BYTES            ((uint32_t)65536u)
 #define ZX_CHANNEL_MAX_MSG_HANDLES          ((uint32_t)64u)
@@ -325,6 +362,14 @@ typedef uint64_t zx_off_t;
 // These can be passed to zx_socket_read() and zx_socket_write().
 #define ZX_SOCKET_CONTROL                   ((uint32_t)1u << 2)
 
+// Maximum number of buffers that can be passed to the vectored socket and
+// fifo calls.
+#define ZX_IOVEC_MAX                        ((size_t)16u)
+
+// Options and limits for zx_syscall_batch().
+#define ZX_SYSCALL_BATCH_STOP_ON_ERROR      ((uint32_t)1u << 0)
+#define ZX_SYSCALL_BATCH_MAX                ((size_t)64u)
+
 // Flags which can be used to to control cache policy for APIs which map memory.
 #define ZX_CACHE_POLICY_CACHED              ((uint32_t)0u)
 #define ZX_CACHE_POLICY_UNCACHED            ((uint32_t)1u)
@@ -374,7 +419,8 @@ typedef uint32_t zx_obj_type_t;
 #define ZX_OBJ_TYPE_PROFILE         ((zx_obj_type_t)25u)
 #define ZX_OBJ_TYPE_PMT             ((zx_obj_type_t)26u)
 #define ZX_OBJ_TYPE_SUSPEND_TOKEN   ((zx_obj_type_t)27u)
-#define ZX_OBJ_TYPE_LAST            ((zx_obj_type_t)28u)
+#define ZX_OBJ_TYPE_WAITSET         ((zx_obj_type_t)28u)
+#define ZX_OBJ_TYPE_LAST            ((zx_obj_type_t)29u)
 
 typedef struct zx_handle_info {
     zx_handle_t handle;
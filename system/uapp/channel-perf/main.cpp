@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <threads.h>
 
 #include <fbl/algorithm.h>
 #include <fbl/unique_ptr.h>
@@ -114,6 +115,110 @@ void do_test(uint32_t duration_sec, const TestArgs& test_args) {
            test_args.size, test_args.handles, test_args.queue, its_per_second);
 }
 
+struct EchoArgs {
+    zx_handle_t channel;
+    const TestArgs* test_args;
+};
+
+// Sends every message received on |channel| straight back until the other end is closed.
+int echo_thread(void* arg) {
+    const EchoArgs* echo_args = static_cast<EchoArgs*>(arg);
+    const TestArgs& test_args = *echo_args->test_args;
+
+    fbl::unique_ptr<uint8_t[]> data(new uint8_t[test_args.size + 1]);
+    fbl::unique_ptr<zx_handle_t[]> handles(new zx_handle_t[test_args.handles + 1]);
+    for (;;) {
+        zx_signals_t pending;
+        zx_status_t status = zx_object_wait_one(echo_args->channel,
+                                                ZX_CHANNEL_READABLE | ZX_CHANNEL_PEER_CLOSED,
+                                                ZX_TIME_INFINITE, &pending);
+        assert(status == ZX_OK);
+        if (!(pending & ZX_CHANNEL_READABLE))
+            return 0;
+
+        uint32_t r_size = test_args.size;
+        uint32_t r_handles = test_args.handles;
+        status = zx_channel_read(echo_args->channel, 0u, data.get(), handles.get(), r_size,
+                                 r_handles, &r_size, &r_handles);
+        assert(status == ZX_OK);
+        status = zx_channel_write(echo_args->channel, 0u, data.get(), r_size,
+                                  handles.get(), r_handles);
+        assert(status == ZX_OK);
+    }
+}
+
+// Like do_test(), but bounces each message off a second thread, so every iteration wakes
+// up the other thread twice.  This measures how well the scheduler places the two threads.
+void do_ping_pong_test(uint32_t duration_sec, const TestArgs& test_args) {
+    __UNUSED zx_status_t status;
+
+    zx_duration_t duration_ns = ZX_SEC(duration_sec);
+
+    zx_handle_t mp[2] = {ZX_HANDLE_INVALID, ZX_HANDLE_INVALID};
+    status = zx_channel_create(0u, &mp[0], &mp[1]);
+    assert(status == ZX_OK);
+
+    zx_handle_t event;
+    assert(zx_event_create(0u, &event) == ZX_OK);
+
+    fbl::unique_ptr<uint8_t[]> data(new uint8_t[test_args.size + 1]);
+    for (uint32_t i = 0; i < test_args.size; i++)
+        data[i] = static_cast<uint8_t>(i);
+    fbl::unique_ptr<zx_handle_t[]> handles(new zx_handle_t[test_args.handles + 1]);
+    duplicate_handles(test_args.handles, event, handles.get());
+
+    EchoArgs echo_args = {mp[1], &test_args};
+    thrd_t echo;
+    assert(thrd_create(&echo, echo_thread, &echo_args) == thrd_success);
+
+    static constexpr uint32_t big_it_size = 1000;
+    uint64_t big_its = 0;
+    zx_time_t start_ns = zx_clock_get_monotonic();
+    zx_time_t end_ns;
+    for (;;) {
+        big_its++;
+        for (uint32_t i = 0; i < big_it_size; i++) {
+            status = zx_channel_write(mp[0], 0, data.get(), test_args.size,
+                                      handles.get(), test_args.handles);
+            assert(status == ZX_OK);
+
+            status = zx_object_wait_one(mp[0], ZX_CHANNEL_READABLE, ZX_TIME_INFINITE, nullptr);
+            assert(status == ZX_OK);
+
+            uint32_t r_size = test_args.size;
+            uint32_t r_handles = test_args.handles;
+            status = zx_channel_read(mp[0], 0u, data.get(), handles.get(), r_size,
+                                     r_handles, &r_size, &r_handles);
+            assert(status == ZX_OK);
+            assert(r_size == test_args.size);
+            assert(r_handles == test_args.handles);
+        }
+
+        end_ns = zx_clock_get_monotonic();
+        if (zx_time_sub_time(end_ns, start_ns) >= duration_ns)
+            break;
+    }
+
+    status = zx_handle_close(mp[0]);
+    assert(status == ZX_OK);
+    assert(thrd_join(echo, nullptr) == thrd_success);
+
+    for (uint32_t i = 0; i < test_args.handles; i++) {
+        status = zx_handle_close(handles[i]);
+        assert(status == ZX_OK);
+    }
+    status = zx_handle_close(event);
+    assert(status == ZX_OK);
+    status = zx_handle_close(mp[1]);
+    assert(status == ZX_OK);
+
+    double real_duration = static_cast<double>(zx_time_sub_time(end_ns, start_ns)) / 1000000000.0;
+    double its_per_second = static_cast<double>(big_its) * big_it_size / real_duration;
+    printf("ping-pong %" PRIu32 " bytes, %" PRIu32 " handles: "
+               "%.0f round trips/second (%.0f ns each)\n",
+           test_args.size, test_args.handles, its_per_second, 1000000000.0 / its_per_second);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -124,6 +229,7 @@ int main(int argc, char** argv) {
         "  -h    show help (this)\n"
         "  -o    run single test (default)\n"
         "  -s    run suite (ignores -S/-H/-Q)\n"
+        "  -p    bounce messages off a second thread (ignores -Q)\n"
         "  -n N  set test repetition count to N (default: 1)\n"
         "  -d N  set test duration to N seconds (default: 5)\n"
         "  -S N  set message size to N bytes (default: 10)\n"
@@ -131,6 +237,7 @@ int main(int argc, char** argv) {
         "  -Q N  set message pre-queue count to N messages (default: 0)\n";
 
     bool run_suite = false;  // -o/-s
+    bool ping_pong = false;  // -p
     uint32_t duration = 5;   // -d
     uint32_t repeats = 1;    // -n
     // Ignored when running a suite:
@@ -141,7 +248,7 @@ int main(int argc, char** argv) {
     };
 
     int opt;
-    while ((opt = getopt(argc, argv, "+hosn:d:S:H:Q:")) != -1) {
+    while ((opt = getopt(argc, argv, "+hospn:d:S:H:Q:")) != -1) {
         // Our option values are always unsigned numbers.
         uint32_t value = 0;
         if (optarg) {
@@ -163,6 +270,9 @@ int main(int argc, char** argv) {
             case 's':
                 run_suite = true;
                 break;
+            case 'p':
+                ping_pong = true;
+                break;
             case 'n':
                 assert(optarg);
                 repeats = value;
@@ -217,8 +327,16 @@ int main(int argc, char** argv) {
                 {100, 0, 1},
                 {1000, 0, 1},
             };
-            for (size_t i = 0; i < fbl::count_of(suite); i++)
-                do_test(duration, suite[i]);
+            for (size_t i = 0; i < fbl::count_of(suite); i++) {
+                if (ping_pong && suite[i].queue != 0)
+                    continue;
+                if (ping_pong)
+                    do_ping_pong_test(duration, suite[i]);
+                else
+                    do_test(duration, suite[i]);
+            }
+        } else if (ping_pong) {
+            do_ping_pong_test(duration, test_args);
         } else {
             do_test(duration, test_args);
         }
@@ -156,11 +156,62 @@ static zx_status_t memstats(zx_handle_t root_resource) {
     return ZX_OK;
 }
 
+static int compare_lock_wait(const void* a, const void* b) {
+    const zx_info_lock_class_stats_t* sa = a;
+    const zx_info_lock_class_stats_t* sb = b;
+    if (sa->total_wait_time != sb->total_wait_time)
+        return sa->total_wait_time < sb->total_wait_time ? 1 : -1;
+    return 0;
+}
+
+static zx_status_t lockstats(zx_handle_t root_resource) {
+    size_t actual, avail;
+    zx_status_t err = zx_object_get_info(
+        root_resource, ZX_INFO_LOCK_CLASS_STATS, NULL, 0, &actual, &avail);
+    if (err != ZX_OK) {
+        fprintf(stderr, "ZX_INFO_LOCK_CLASS_STATS returns %d (%s)\n",
+                err, zx_status_get_string(err));
+        return err;
+    }
+
+    zx_info_lock_class_stats_t* stats = calloc(avail, sizeof(*stats));
+    if (stats == NULL && avail != 0) {
+        return ZX_ERR_NO_MEMORY;
+    }
+    err = zx_object_get_info(root_resource, ZX_INFO_LOCK_CLASS_STATS,
+                             stats, avail * sizeof(*stats), &actual, &avail);
+    if (err != ZX_OK) {
+        fprintf(stderr, "ZX_INFO_LOCK_CLASS_STATS returns %d (%s)\n",
+                err, zx_status_get_string(err));
+        free(stats);
+        return err;
+    }
+
+    // Show the locks that cost the most waiting first.
+    qsort(stats, actual, sizeof(*stats), compare_lock_wait);
+
+    printf("%12s %12s %12s %12s  %s\n",
+           "acquired", "contended", "wait us", "max hold us", "lock class");
+    for (size_t i = 0; i < actual; i++) {
+        if (stats[i].acquisitions == 0)
+            continue;
+        printf("%12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "  %s\n",
+               stats[i].acquisitions, stats[i].contended,
+               stats[i].total_wait_time / ZX_USEC(1),
+               stats[i].max_hold_time / ZX_USEC(1), stats[i].name);
+    }
+
+    free(stats);
+    return ZX_OK;
+}
+
 static void print_help(FILE* f) {
     fprintf(f, "Usage: kstats [options]\n");
     fprintf(f, "Options:\n");
     fprintf(f, " -c              Print system CPU stats\n");
     fprintf(f, " -m              Print system memory stats\n");
+    fprintf(f, " -l              Print kernel lock contention stats (needs a\n");
+    fprintf(f, "                 kernel built with ENABLE_LOCK_DEP_PROFILING)\n");
     fprintf(f, " -d <delay>      Delay in seconds (default 1 second)\n");
     fprintf(f, " -n <times>      Run this many times and then exit\n");
     fprintf(f, " -t              Print timestamp for each report\n");
@@ -188,12 +239,13 @@ static void print_help(FILE* f) {
 int main(int argc, char** argv) {
     bool cpu_stats = false;
     bool mem_stats = false;
+    bool lock_stats = false;
     zx_duration_t delay = ZX_SEC(1);
     int num_loops = -1;
     bool timestamp = false;
 
     int c;
-    while ((c = getopt(argc, argv, "cd:n:hmt")) > 0) {
+    while ((c = getopt(argc, argv, "cd:n:hlmt")) > 0) {
         switch (c) {
             case 'c':
                 cpu_stats = true;
@@ -217,6 +269,9 @@ int main(int argc, char** argv) {
             case 'h':
                 print_help(stdout);
                 return 0;
+            case 'l':
+                lock_stats = true;
+                break;
             case 'm':
                 mem_stats = true;
                 break;
@@ -230,7 +285,7 @@ int main(int argc, char** argv) {
         }
     }
 
-    if (!cpu_stats && !mem_stats) {
+    if (!cpu_stats && !mem_stats && !lock_stats) {
         fprintf(stderr, "No statistics selected\n");
         print_help(stderr);
         return 1;
@@ -267,6 +322,9 @@ int main(int argc, char** argv) {
         if (mem_stats) {
             ret |= memstats(root_resource);
         }
+        if (lock_stats) {
+            ret |= lockstats(root_resource);
+        }
 
         if (ret != ZX_OK)
             break;
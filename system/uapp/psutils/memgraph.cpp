@@ -73,6 +73,8 @@ const char* obj_type_get_name(zx_obj_type_t type) {
         return "bti";
     case ZX_OBJ_TYPE_PROFILE:
         return "profile";
+    case ZX_OBJ_TYPE_WAITSET:
+        return "waitset";
     default:
         return "unknown";
     }
@@ -26,6 +26,9 @@
 // The port wait key associated with the dispatcher's control messages.
 #define KEY_CONTROL (0u)
 
+// The maximum number of packets read from the port by a single syscall.
+#define BATCH_SIZE (16u)
+
 static zx_time_t async_loop_now(async_dispatcher_t* dispatcher);
 static zx_status_t async_loop_begin_wait(async_dispatcher_t* dispatcher, async_wait_t* wait);
 static zx_status_t async_loop_cancel_wait(async_dispatcher_t* dispatcher, async_wait_t* wait);
@@ -85,9 +88,16 @@ typedef struct async_loop {
     list_node_t due_list; // due tasks, earliest deadline first
     list_node_t thread_list; // earliest created thread first
     list_node_t exception_list; // most recently added first
+    bool reading_batch; // true while a thread is reading a batch from the port
+    size_t batch_next; // index of the next batched packet to dispatch
+    size_t batch_count; // number of packets in the batch
+    zx_port_packet_t batch[BATCH_SIZE]; // packets read but not yet dispatched
 } async_loop_t;
 
 static zx_status_t async_loop_run_once(async_loop_t* loop, zx_time_t deadline);
+static zx_status_t async_loop_read_packet(async_loop_t* loop, zx_time_t deadline,
+                                          zx_port_packet_t* out_packet);
+static bool async_loop_discard_batched_locked(async_loop_t* loop, uint64_t key);
 static zx_status_t async_loop_dispatch_wait(async_loop_t* loop, async_wait_t* wait,
                                             zx_status_t status, const zx_packet_signal_t* signal);
 static zx_status_t async_loop_dispatch_tasks(async_loop_t* loop);
@@ -219,6 +229,8 @@ void async_loop_shutdown(async_loop_t* loop) {
         async_exception_t* exception = node_to_exception(node);
         async_loop_dispatch_exception(loop, exception, ZX_ERR_CANCELED, NULL);
     }
+    loop->batch_next = 0u;
+    loop->batch_count = 0u;
 
     if (loop->config.make_default_for_current_thread) {
         ZX_DEBUG_ASSERT(async_get_default_dispatcher() == &loop->dispatcher);
@@ -254,7 +266,7 @@ static zx_status_t async_loop_run_once(async_loop_t* loop, zx_time_t deadline) {
         return ZX_ERR_CANCELED;
 
     zx_port_packet_t packet;
-    zx_status_t status = zx_port_wait(loop->port, deadline, &packet);
+    zx_status_t status = async_loop_read_packet(loop, deadline, &packet);
     if (status != ZX_OK)
         return status;
 
@@ -303,6 +315,62 @@ static zx_status_t async_loop_run_once(async_loop_t* loop, zx_time_t deadline) {
     return ZX_ERR_INTERNAL;
 }
 
+static zx_status_t async_loop_read_packet(async_loop_t* loop, zx_time_t deadline,
+                                          zx_port_packet_t* out_packet) {
+    // Dispatch packets left over from an earlier batch first.
+    mtx_lock(&loop->lock);
+    if (loop->batch_next < loop->batch_count) {
+        *out_packet = loop->batch[loop->batch_next++];
+        mtx_unlock(&loop->lock);
+        return ZX_OK;
+    }
+
+    // Only read ahead while a single thread is servicing the loop, otherwise
+    // the other threads could sit idle in |port_wait| while packets wait in
+    // the batch.  At most one thread reads a batch at a time, so the batch
+    // is still empty when the reader stores what it read.
+    bool read_batch = !loop->reading_batch &&
+                      atomic_load_explicit(&loop->active_threads, memory_order_acquire) <= 1u;
+    if (read_batch)
+        loop->reading_batch = true;
+    mtx_unlock(&loop->lock);
+
+    if (!read_batch)
+        return zx_port_wait(loop->port, deadline, out_packet);
+
+    zx_port_packet_t packets[BATCH_SIZE];
+    size_t count = 0u;
+    zx_status_t status = zx_port_wait_many(loop->port, deadline, packets, BATCH_SIZE, &count);
+
+    mtx_lock(&loop->lock);
+    loop->reading_batch = false;
+    if (status == ZX_OK) {
+        ZX_DEBUG_ASSERT(count > 0u && count <= BATCH_SIZE);
+        ZX_DEBUG_ASSERT(loop->batch_next == loop->batch_count);
+        *out_packet = packets[0];
+        for (size_t i = 1u; i < count; i++)
+            loop->batch[i - 1u] = packets[i];
+        loop->batch_next = 0u;
+        loop->batch_count = count - 1u;
+    }
+    mtx_unlock(&loop->lock);
+    return status;
+}
+
+static bool async_loop_discard_batched_locked(async_loop_t* loop, uint64_t key) {
+    // Turn the packet into a wake-up packet so it is skipped when dispatched.
+    bool found = false;
+    for (size_t i = loop->batch_next; i < loop->batch_count; i++) {
+        zx_port_packet_t* packet = &loop->batch[i];
+        if (packet->key == key) {
+            packet->key = KEY_CONTROL;
+            packet->type = ZX_PKT_TYPE_USER;
+            found = true;
+        }
+    }
+    return found;
+}
+
 async_dispatcher_t* async_loop_get_dispatcher(async_loop_t* loop) {
     // Note: The loop's implementation inherits from async_t so we can upcast to it.
     return (async_dispatcher_t*)loop;
@@ -520,9 +588,12 @@ static zx_status_t async_loop_cancel_wait(async_dispatcher_t* async, async_wait_
 
     // Next, cancel the wait.  This may be racing with another thread that
     // has read the wait's packet but not yet dispatched it.  So if we fail
-    // to cancel then we assume we lost the race.
+    // to cancel then we assume we lost the race, unless the packet is still
+    // sitting in the batch in which case it can be discarded.
     zx_status_t status = zx_port_cancel(loop->port, wait->object,
                                         (uintptr_t)wait);
+    if (status == ZX_ERR_NOT_FOUND && async_loop_discard_batched_locked(loop, (uintptr_t)wait))
+        status = ZX_OK;
     if (status == ZX_OK) {
         list_delete(node);
     } else {
@@ -675,6 +746,7 @@ static zx_status_t async_loop_unbind_exception_port(async_dispatcher_t* async,
                                                      ZX_HANDLE_INVALID, key, 0);
 
     if (status == ZX_OK) {
+        async_loop_discard_batched_locked(loop, key);
         list_delete(node);
     }
 
@@ -137,7 +137,10 @@ static zx_status_t finish_load_segment(
     const uint32_t flags = ZX_VM_FLAG_SPECIFIC |
         ((ph->p_flags & PF_R) ? ZX_VM_FLAG_PERM_READ : 0) |
         ((ph->p_flags & PF_W) ? ZX_VM_FLAG_PERM_WRITE : 0) |
-        ((ph->p_flags & PF_X) ? ZX_VM_FLAG_PERM_EXECUTE : 0);
+        ((ph->p_flags & PF_X) ? ZX_VM_FLAG_PERM_EXECUTE : 0) |
+        // Read-only segments are usually shared by many processes and already
+        // resident, so map them in up front rather than faulting on each page.
+        ((ph->p_flags & PF_W) ? 0 : ZX_VM_FLAG_MAP_RANGE);
 
     uintptr_t start;
     if (ph->p_filesz == ph->p_memsz)
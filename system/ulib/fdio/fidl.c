@@ -63,6 +63,26 @@ static zx_status_t handle_rpc_close(zxfidl_cb_t cb, void* cookie) {
     return ERR_DISPATCHER_DONE;
 }
 
+zx_status_t zxfidl_handle_msg(zx_handle_t h, fidl_msg_t* msg, zxfidl_cb_t cb, void* cookie) {
+    if (msg->num_bytes < sizeof(fidl_message_header_t)) {
+        zx_handle_close_many(msg->handles, msg->num_handles);
+        return ZX_ERR_IO;
+    }
+
+    fidl_message_header_t* hdr = msg->bytes;
+    zxfidl_connection_t cnxn = {
+        .txn = {
+            .reply = txn_reply,
+        },
+        .channel = h,
+        .txid = hdr->txid,
+    };
+
+    // Callback is responsible for decoding the message, and closing
+    // any associated handles.
+    return cb(msg, &cnxn.txn, cookie);
+}
+
 static zx_status_t handle_rpc(zx_handle_t h, zxfidl_cb_t cb, void* cookie) {
     uint8_t bytes[ZXFIDL_MAX_MSG_BYTES];
     zx_handle_t handles[ZXFIDL_MAX_MSG_HANDLES];
@@ -80,23 +100,7 @@ static zx_status_t handle_rpc(zx_handle_t h, zxfidl_cb_t cb, void* cookie) {
         return r;
     }
 
-    if (msg.num_bytes < sizeof(fidl_message_header_t)) {
-        zx_handle_close_many(msg.handles, msg.num_handles);
-        return ZX_ERR_IO;
-    }
-
-    fidl_message_header_t* hdr = msg.bytes;
-    zxfidl_connection_t cnxn = {
-        .txn = {
-            .reply = txn_reply,
-        },
-        .channel = h,
-        .txid = hdr->txid,
-    };
-
-    // Callback is responsible for decoding the message, and closing
-    // any associated handles.
-    return cb(&msg, &cnxn.txn, cookie);
+    return zxfidl_handle_msg(h, &msg, cb, cookie);
 }
 
 zx_status_t zxfidl_handler(zx_handle_t h, zxfidl_cb_t cb, void* cookie) {
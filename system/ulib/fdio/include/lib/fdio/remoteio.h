@@ -101,6 +101,10 @@ inline zxfidl_connection_t zxfidl_txn_copy(fidl_txn_t* txn) {
 // A fdio_dispatcher_handler suitable for use with a fdio_dispatcher.
 zx_status_t zxfidl_handler(zx_handle_t h, zxfidl_cb_t cb, void* cookie);
 
+// Dispatches |msg|, already read from |h|, to |cb| as zxfidl_handler() does.
+// For servers that read several messages at once with zx_channel_read_many().
+zx_status_t zxfidl_handle_msg(zx_handle_t h, fidl_msg_t* msg, zxfidl_cb_t cb, void* cookie);
+
 // OPEN and CLONE ops do not return a reply
 // Instead they receive a channel handle that they write their status
 // and (if successful) type, extra data, and handles to.
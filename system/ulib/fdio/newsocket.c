@@ -2,12 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <assert.h>
 #include <poll.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include <zircon/processargs.h>
 #include <zircon/syscalls.h>
@@ -19,6 +21,12 @@
 
 #include "private-socket.h"
 
+// struct iovec and zx_iovec_t share a layout, so iovec arrays can be passed
+// straight to zx_socket_writev() and zx_socket_readv().
+static_assert(sizeof(struct iovec) == sizeof(zx_iovec_t), "");
+static_assert(offsetof(struct iovec, iov_base) == offsetof(zx_iovec_t, buffer), "");
+static_assert(offsetof(struct iovec, iov_len) == offsetof(zx_iovec_t, capacity), "");
+
 static bool is_rio_message_valid(zxsio_msg_t* msg) {
     if ((msg->datalen > ZXSIO_PAYLOAD_SZ) ||
         (msg->hcount > 0)) {
@@ -110,6 +118,46 @@ static ssize_t zxsio_read_stream(fdio_t* io, void* data, size_t len) {
     }
 }
 
+// Reads into as many of the first ZX_IOVEC_MAX buffers of |iov| as there is
+// data for.
+static ssize_t zxsio_readv_stream(fdio_t* io, const struct iovec* iov, int iovcnt) {
+    zxsio_t* sio = (zxsio_t*)io;
+    int nonblock = sio->io.ioflag & IOFLAG_NONBLOCK;
+    if (iovcnt < 0) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    size_t num_vector = (size_t)iovcnt < ZX_IOVEC_MAX ? (size_t)iovcnt : ZX_IOVEC_MAX;
+
+    for (;;) {
+        ssize_t r;
+        size_t bytes_read;
+        if ((r = zx_socket_readv(sio->s, 0, (const zx_iovec_t*)iov, num_vector,
+                                 &bytes_read)) == ZX_OK) {
+            return (ssize_t)bytes_read;
+        }
+        if (r == ZX_ERR_PEER_CLOSED || r == ZX_ERR_BAD_STATE) {
+            return 0;
+        } else if (r == ZX_ERR_SHOULD_WAIT && !nonblock) {
+            zx_signals_t pending;
+            r = zx_object_wait_one(sio->s,
+                                   ZX_SOCKET_READABLE | ZX_SOCKET_PEER_CLOSED | ZX_SOCKET_READ_DISABLED,
+                                   ZX_TIME_INFINITE, &pending);
+            if (r < 0) {
+                return r;
+            }
+            if (pending & ZX_SOCKET_READABLE) {
+                continue;
+            }
+            if (pending & (ZX_SOCKET_PEER_CLOSED | ZX_SOCKET_READ_DISABLED)) {
+                return 0;
+            }
+            // impossible
+            return ZX_ERR_INTERNAL;
+        }
+        return r;
+    }
+}
+
 static ssize_t zxsio_recvfrom(fdio_t* io, void* data, size_t len, int flags,
                               struct sockaddr* restrict addr,
                               socklen_t* restrict addrlen) {
@@ -134,14 +182,21 @@ static ssize_t zxsio_recvfrom(fdio_t* io, void* data, size_t len, int flags,
     return r;
 }
 
-static ssize_t zxsio_write_stream(fdio_t* io, const void* data, size_t len) {
+// Writes as much of the first ZX_IOVEC_MAX buffers of |iov| as fits.
+static ssize_t zxsio_writev_stream(fdio_t* io, const struct iovec* iov, int iovcnt) {
     zxsio_t* sio = (zxsio_t*)io;
     int nonblock = sio->io.ioflag & IOFLAG_NONBLOCK;
+    if (iovcnt < 0) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    size_t num_vector = (size_t)iovcnt < ZX_IOVEC_MAX ? (size_t)iovcnt : ZX_IOVEC_MAX;
 
     // TODO: let the generic write() to do this loop
     for (;;) {
         ssize_t r;
-        if ((r = zx_socket_write(sio->s, 0, data, len, &len)) == ZX_OK) {
+        size_t len;
+        if ((r = zx_socket_writev(sio->s, 0, (const zx_iovec_t*)iov, num_vector,
+                                  &len)) == ZX_OK) {
             return (ssize_t) len;
         }
         if (r == ZX_ERR_SHOULD_WAIT && !nonblock) {
@@ -165,6 +220,13 @@ static ssize_t zxsio_write_stream(fdio_t* io, const void* data, size_t len) {
     }
 }
 
+static ssize_t zxsio_write_stream(fdio_t* io, const void* data, size_t len) {
+    struct iovec iov;
+    iov.iov_base = (void*)data;
+    iov.iov_len = len;
+    return zxsio_writev_stream(io, &iov, 1);
+}
+
 static ssize_t zxsio_sendto(fdio_t* io, const void* data, size_t len, int flags, const struct sockaddr* addr, socklen_t addrlen) {
     struct iovec iov;
     iov.iov_base = (void*)data;
@@ -193,19 +255,7 @@ static ssize_t zxsio_recvmsg_stream(fdio_t* io, struct msghdr* msg, int flags) {
     }
     // we ignore msg_name and msg_namelen members.
     // (this is a consistent behavior with other OS implementations for TCP protocol)
-    ssize_t total = 0;
-    for (int i = 0; i < msg->msg_iovlen; i++) {
-        struct iovec *iov = &msg->msg_iov[i];
-        ssize_t n = zxsio_read_stream(io, iov->iov_base, iov->iov_len);
-        if (n < 0) {
-            return n;
-        }
-        total += n;
-        if ((size_t)n != iov->iov_len) {
-            break;
-        }
-    }
-    return total;
+    return zxsio_readv_stream(io, msg->msg_iov, msg->msg_iovlen);
 }
 
 static ssize_t zxsio_sendmsg_stream(fdio_t* io, const struct msghdr* msg, int flags) {
@@ -222,22 +272,7 @@ static ssize_t zxsio_sendmsg_stream(fdio_t* io, const struct msghdr* msg, int fl
     } else {
         return ZX_ERR_BAD_STATE;
     }
-    ssize_t total = 0;
-    for (int i = 0; i < msg->msg_iovlen; i++) {
-        struct iovec *iov = &msg->msg_iov[i];
-        if (iov->iov_len <= 0) {
-            return ZX_ERR_INVALID_ARGS;
-        }
-        ssize_t n = zxsio_write_stream(io, iov->iov_base, iov->iov_len);
-        if (n < 0) {
-            return n;
-        }
-        total += n;
-        if ((size_t)n != iov->iov_len) {
-            break;
-        }
-    }
-    return total;
+    return zxsio_writev_stream(io, msg->msg_iov, msg->msg_iovlen);
 }
 
 static zx_status_t zxsio_clone_stream(fdio_t* io, zx_handle_t* handles, uint32_t* types) {
@@ -827,6 +862,10 @@ void fdio_socket_set_stream_ops(fdio_t* io) {
     sio->io.ops = &fdio_socket_stream_ops;
 }
 
+bool fdio_socket_is_stream(fdio_t* io) {
+    return io->ops == &fdio_socket_stream_ops;
+}
+
 void fdio_socket_set_dgram_ops(fdio_t* io) {
     zxsio_t* sio = (zxsio_t*)io;
     sio->io.ops = &fdio_socket_dgram_ops;
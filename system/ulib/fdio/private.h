@@ -155,6 +155,10 @@ fdio_t* fdio_waitable_create(zx_handle_t h, zx_signals_t signals_in,
 void fdio_socket_set_stream_ops(fdio_t* io);
 void fdio_socket_set_dgram_ops(fdio_t* io);
 
+// Whether |io| is a stream socket, whose recvmsg and sendmsg ops take a whole
+// iovec array in one call without modifying it.
+bool fdio_socket_is_stream(fdio_t* io);
+
 zx_status_t fdio_socket_posix_ioctl(fdio_t* io, int req, va_list va);
 zx_status_t fdio_socket_shutdown(fdio_t* io, int how);
 zx_status_t fdio_socketpair_shutdown(fdio_t* io, int how);
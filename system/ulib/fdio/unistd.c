@@ -844,6 +844,26 @@ int fdio_status_to_errno(zx_status_t status) {
 // centric posix-y io operations.
 
 ssize_t readv(int fd, const struct iovec* iov, int num) {
+    if (num < 0) {
+        return ERRNO(EINVAL);
+    }
+    fdio_t* io = fd_to_io(fd);
+    if (io == NULL) {
+        return ERRNO(EBADF);
+    }
+    if ((io->ioflag & IOFLAG_SOCKET) && fdio_socket_is_stream(io)) {
+        // Stream sockets take the whole vector in one call rather than one
+        // per buffer.  They leave it untouched, so the cast is safe.
+        struct msghdr msg = {
+            .msg_iov = (struct iovec*)iov,
+            .msg_iovlen = num,
+        };
+        ssize_t r = io->ops->recvmsg(io, &msg, 0);
+        fdio_release(io);
+        return r < 0 ? STATUS(r) : r;
+    }
+    fdio_release(io);
+
     ssize_t count = 0;
     ssize_t r;
     while (num > 0) {
@@ -864,6 +884,26 @@ ssize_t readv(int fd, const struct iovec* iov, int num) {
 }
 
 ssize_t writev(int fd, const struct iovec* iov, int num) {
+    if (num < 0) {
+        return ERRNO(EINVAL);
+    }
+    fdio_t* io = fd_to_io(fd);
+    if (io == NULL) {
+        return ERRNO(EBADF);
+    }
+    if ((io->ioflag & IOFLAG_SOCKET) && fdio_socket_is_stream(io)) {
+        // Stream sockets take the whole vector in one call rather than one
+        // per buffer.  They leave it untouched, so the cast is safe.
+        struct msghdr msg = {
+            .msg_iov = (struct iovec*)iov,
+            .msg_iovlen = num,
+        };
+        ssize_t r = io->ops->sendmsg(io, &msg, 0);
+        fdio_release(io);
+        return r < 0 ? STATUS(r) : r;
+    }
+    fdio_release(io);
+
     ssize_t count = 0;
     ssize_t r;
     while (num > 0) {
@@ -6,6 +6,7 @@
 #include <lib/fidl/bind.h>
 #include <stdlib.h>
 #include <string.h>
+#include <zircon/compiler.h>
 #include <zircon/syscalls.h>
 
 typedef struct fidl_binding {
@@ -21,6 +22,31 @@ typedef struct fidl_connection {
     zx_txid_t txid;
 } fidl_connection_t;
 
+// Messages queued behind the first one are read in the same call if they fit
+// in these smaller buffers.  A larger message ends the batch and is read into
+// the full-sized buffer by the next call.
+#define BATCH_SLOTS 8
+#define BATCH_SLOT_BYTES 512
+#define BATCH_SLOT_HANDLES 4
+
+static void init_slot(zx_channel_read_slot_t* slot, void* bytes, zx_handle_t* handles,
+                      uint32_t num_bytes, uint32_t num_handles) {
+    slot->bytes = bytes;
+    slot->handles = handles;
+    slot->num_bytes = num_bytes;
+    slot->num_handles = num_handles;
+    slot->actual_bytes = 0u;
+    slot->actual_handles = 0u;
+}
+
+// Closes the handles of the messages in slots [begin, end), which won't be
+// dispatched.
+static void close_slot_handles(const zx_channel_read_slot_t* slots, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        zx_handle_close_many(slots[i].handles, slots[i].actual_handles);
+    }
+}
+
 static zx_status_t fidl_reply(fidl_txn_t* txn, const fidl_msg_t* msg) {
     fidl_connection_t* conn = (fidl_connection_t*)txn;
     if (conn->txid == 0u)
@@ -45,30 +71,47 @@ static void fidl_message_handler(async_dispatcher_t* dispatcher,
     if (signal->observed & ZX_CHANNEL_READABLE) {
         char bytes[ZX_CHANNEL_MAX_MSG_BYTES];
         zx_handle_t handles[ZX_CHANNEL_MAX_MSG_HANDLES];
-        for (uint64_t i = 0; i < signal->count; i++) {
-            fidl_msg_t msg = {
-                .bytes = bytes,
-                .handles = handles,
-                .num_bytes = 0u,
-                .num_handles = 0u,
-            };
-            status = zx_channel_read(wait->object, 0, bytes, handles,
-                                     ZX_CHANNEL_MAX_MSG_BYTES,
-                                     ZX_CHANNEL_MAX_MSG_HANDLES,
-                                     &msg.num_bytes, &msg.num_handles);
+        char batch_bytes[BATCH_SLOTS - 1][BATCH_SLOT_BYTES] __ALIGNED(8);
+        zx_handle_t batch_handles[BATCH_SLOTS - 1][BATCH_SLOT_HANDLES];
+        uint64_t remaining = signal->count;
+        while (remaining > 0) {
+            zx_channel_read_slot_t slots[BATCH_SLOTS];
+            size_t num_slots = remaining < BATCH_SLOTS ? remaining : BATCH_SLOTS;
+            init_slot(&slots[0], bytes, handles, sizeof(bytes), countof(handles));
+            for (size_t i = 1; i < num_slots; i++) {
+                init_slot(&slots[i], batch_bytes[i - 1], batch_handles[i - 1],
+                          BATCH_SLOT_BYTES, BATCH_SLOT_HANDLES);
+            }
+            size_t actual = 0u;
+            status = zx_channel_read_many(wait->object, 0, slots, num_slots, &actual);
             if (status == ZX_ERR_SHOULD_WAIT)
                 break;
-            if (status != ZX_OK || msg.num_bytes < sizeof(fidl_message_header_t))
-                goto shutdown;
-            fidl_message_header_t* hdr = (fidl_message_header_t*)msg.bytes;
-            fidl_connection_t conn = {
-                .txn.reply = fidl_reply,
-                .channel = wait->object,
-                .txid = hdr->txid,
-            };
-            status = binding->dispatch(binding->ctx, &conn.txn, &msg, binding->ops);
             if (status != ZX_OK)
                 goto shutdown;
+            remaining -= actual;
+            for (size_t i = 0; i < actual; i++) {
+                fidl_msg_t msg = {
+                    .bytes = slots[i].bytes,
+                    .handles = slots[i].handles,
+                    .num_bytes = slots[i].actual_bytes,
+                    .num_handles = slots[i].actual_handles,
+                };
+                if (msg.num_bytes < sizeof(fidl_message_header_t)) {
+                    close_slot_handles(slots, i, actual);
+                    goto shutdown;
+                }
+                fidl_message_header_t* hdr = (fidl_message_header_t*)msg.bytes;
+                fidl_connection_t conn = {
+                    .txn.reply = fidl_reply,
+                    .channel = wait->object,
+                    .txid = hdr->txid,
+                };
+                status = binding->dispatch(binding->ctx, &conn.txn, &msg, binding->ops);
+                if (status != ZX_OK) {
+                    close_slot_handles(slots, i + 1, actual);
+                    goto shutdown;
+                }
+            }
         }
         status = async_begin_wait(dispatcher, wait);
         if (status != ZX_OK)
@@ -11,12 +11,14 @@
 #include <string.h>
 #include <sys/stat.h>
 
+#include <fbl/alloc_checker.h>
 #include <fs/trace.h>
 #include <fs/vnode.h>
 #include <fuchsia/io/c/fidl.h>
 #include <lib/fdio/debug.h>
 #include <lib/fdio/io.h>
 #include <lib/fdio/remoteio.h>
+#include <lib/async/cpp/task.h>
 #include <lib/fdio/vfs.h>
 #include <lib/zx/handle.h>
 #include <zircon/assert.h>
@@ -289,25 +291,122 @@ void Connection::HandleSignals(async_dispatcher_t* dispatcher, async::WaitBase*
             // opened while filesystems are torn down.
             status = ZX_ERR_PEER_CLOSED;
         } else if (signal->observed & ZX_CHANNEL_READABLE) {
-            // Handle the message.
-            status = CallHandler();
-            switch (status) {
-            case ERR_DISPATCHER_ASYNC:
-                return;
-            case ZX_OK:
-                status = wait_.Begin(dispatcher);
-                if (status == ZX_OK) {
-                    return;
-                }
-                break;
-            }
+            // Handle the messages.
+            FinishMessages(ReadMessages());
+            return;
+        }
+    }
+
+    bool call_close = (status != ERR_DISPATCHER_DONE);
+    Terminate(call_close);
+}
+
+struct Connection::MessageBatch {
+    // The first message is read into a full-sized buffer on the stack.  Small
+    // messages queued behind it are read into these buffers as well.
+    static constexpr size_t kSlots = 4;
+    static constexpr uint32_t kSlotBytes = 256;
+
+    ~MessageBatch() { Discard(); }
+
+    // Closes the handles of the messages which haven't been handled.
+    void Discard() {
+        for (; next < count; ++next) {
+            zx_handle_close_many(slots[next].handles, slots[next].actual_handles);
+        }
+    }
+
+    zx_channel_read_slot_t slots[kSlots];
+    size_t next = 0;
+    size_t count = 0;
+    uint8_t bytes[kSlots - 1][kSlotBytes] __ALIGNED(8);
+    zx_handle_t handles[kSlots - 1][ZXFIDL_MAX_MSG_HANDLES];
+};
+
+zx_status_t Connection::ReadMessages() {
+    if (!batch_) {
+        fbl::AllocChecker ac;
+        batch_.reset(new (&ac) MessageBatch);
+        if (!ac.check()) {
+            return ZX_ERR_NO_MEMORY;
+        }
+    }
+    ZX_DEBUG_ASSERT(batch_->next == batch_->count);
+
+    uint8_t bytes[ZXFIDL_MAX_MSG_BYTES] __ALIGNED(8);
+    zx_handle_t handles[ZXFIDL_MAX_MSG_HANDLES];
+    batch_->slots[0].bytes = bytes;
+    batch_->slots[0].handles = handles;
+    batch_->slots[0].num_bytes = sizeof(bytes);
+    batch_->slots[0].num_handles = ZXFIDL_MAX_MSG_HANDLES;
+    for (size_t i = 1; i < MessageBatch::kSlots; ++i) {
+        batch_->slots[i].bytes = batch_->bytes[i - 1];
+        batch_->slots[i].handles = batch_->handles[i - 1];
+        batch_->slots[i].num_bytes = sizeof(batch_->bytes[i - 1]);
+        batch_->slots[i].num_handles = ZXFIDL_MAX_MSG_HANDLES;
+    }
+
+    size_t actual = 0;
+    zx_status_t status = zx_channel_read_many(channel_.get(), 0, batch_->slots,
+                                              MessageBatch::kSlots, &actual);
+    if (status != ZX_OK) {
+        return status;
+    }
+    batch_->next = 0;
+    batch_->count = actual;
+    return HandleBatchedMessages();
+}
+
+zx_status_t Connection::HandleBatchedMessages() {
+    while (batch_->next < batch_->count) {
+        const zx_channel_read_slot_t& slot = batch_->slots[batch_->next++];
+        fidl_msg_t msg = {slot.bytes, slot.handles, slot.actual_bytes, slot.actual_handles};
+        zx_status_t status = zxfidl_handle_msg(channel_.get(), &msg,
+                                               &Connection::HandleMessageThunk, this);
+        if (status == ERR_DISPATCHER_ASYNC) {
+            // The handler may have torn down the connection, so the rest of
+            // the batch is left for |Resume()|, if the connection survives.
+            return status;
+        }
+        if (status != ZX_OK) {
+            batch_->Discard();
+            return status;
         }
     }
+    return ZX_OK;
+}
+
+void Connection::FinishMessages(zx_status_t status) {
+    switch (status) {
+    case ERR_DISPATCHER_ASYNC:
+        return;
+    case ZX_OK:
+        status = wait_.Begin(vfs_->dispatcher());
+        if (status == ZX_OK) {
+            return;
+        }
+        break;
+    }
 
     bool call_close = (status != ERR_DISPATCHER_DONE);
     Terminate(call_close);
 }
 
+void Connection::Resume() {
+    if (!batch_ || batch_->next == batch_->count) {
+        ZX_ASSERT_MSG(wait_.Begin(vfs_->dispatcher()) == ZX_OK,
+                      "Dispatch loop unexpectedly ended");
+        return;
+    }
+
+    // Asynchronous handlers may complete on any thread, so the messages left
+    // in the batch are handled back on the dispatcher.
+    ZX_ASSERT_MSG(async::PostTask(vfs_->dispatcher(), [this] {
+                      FinishMessages(HandleBatchedMessages());
+                  }) == ZX_OK,
+                  "Dispatch loop unexpectedly ended");
+}
+
 void Connection::Terminate(bool call_close) {
     if (call_close) {
         // Give the dispatcher a chance to clean up.
@@ -411,8 +510,7 @@ zx_status_t Connection::NodeSync(fidl_txn_t* txn) {
         fuchsia_io_NodeSync_reply(&ctxn.txn, status);
 
         // Try to reset the wait object
-        ZX_ASSERT_MSG(wait_.Begin(vfs_->dispatcher()) == ZX_OK,
-                      "Dispatch loop unexpectedly ended");
+        Resume();
     });
 
     vnode_->Sync(fbl::move(closure));
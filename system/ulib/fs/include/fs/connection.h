@@ -106,8 +106,26 @@ public:
                               const char* dst_data, size_t dst_size, fidl_txn_t* txn);
 
 private:
+    // Messages read from the channel in one call, see |ReadMessages()|.
+    struct MessageBatch;
+
     void HandleSignals(async_dispatcher_t* dispatcher, async::WaitBase* wait, zx_status_t status,
                        const zx_packet_signal_t* signal);
+
+    // Reads the messages queued on the channel, as many as fit in a batch,
+    // and handles them in order.
+    zx_status_t ReadMessages();
+
+    // Handles the messages left in |batch_|, stopping early if one of them
+    // isn't handled synchronously.
+    zx_status_t HandleBatchedMessages();
+
+    // Waits for more messages if the handling of the last one completed,
+    // or terminates the connection given the |status| of handling messages.
+    void FinishMessages(zx_status_t status);
+
+    // Resumes handling messages once an asynchronous handler completes.
+    void Resume();
     // Closes the connection and unregisters it from the VFS object.
     void Terminate(bool call_close);
 
@@ -136,6 +154,10 @@ private:
     // The object field is |ZX_HANDLE_INVALID| when not actively waiting.
     async::WaitMethod<Connection, &Connection::HandleSignals> wait_;
 
+    // Buffers for reading messages, allocated on first use.  Messages read
+    // behind one whose handler went asynchronous wait here until |Resume()|.
+    fbl::unique_ptr<MessageBatch> batch_;
+
     // Open flags such as |ZX_FS_RIGHT_READABLE|, and other bits.
     uint32_t flags_;
 
@@ -0,0 +1,97 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <fbl/atomic.h>
+#include <fbl/macros.h>
+#include <lib/fzl/vmo-mapper.h>
+#include <lib/zx/socket.h>
+#include <lib/zx/time.h>
+#include <lib/zx/vmo.h>
+#include <zircon/types.h>
+
+namespace fzl {
+
+// SharedRing is a byte stream from one process to another through a VMO that
+// both of them map.  The writer copies data into the ring and the reader copies
+// it out, so the data never passes through the kernel.  Each end also holds one
+// end of a socket, which only carries wake-ups, and only while the other end is
+// blocked in Wait().
+//
+// The first page of the VMO holds the ring's read and write positions and the
+// rest holds the data.  Neither end trusts the positions written by the other.
+//
+// This class is not thread safe; each end must be used by one thread at a time.
+class SharedRing {
+public:
+    enum class Role {
+        kWriter,
+        kReader,
+    };
+
+    // Creates the VMO and sockets for a ring holding |size| bytes, which must be
+    // a power of two multiple of PAGE_SIZE.  Each end passes the VMO (or a
+    // duplicate of it) and its socket to Init().
+    static zx_status_t Create(size_t size, zx::vmo* vmo, zx::socket* writer, zx::socket* reader);
+
+    SharedRing() = default;
+    ~SharedRing() = default;
+    DISALLOW_COPY_ASSIGN_AND_MOVE(SharedRing);
+
+    // Maps |vmo| and sets this up as the |role| end of the ring.
+    zx_status_t Init(const zx::vmo& vmo, zx::socket socket, Role role);
+
+    // Copies up to |len| bytes into the ring and returns the number copied in
+    // |actual|.  Returns ZX_ERR_SHOULD_WAIT if the ring is full.  Writer only.
+    zx_status_t Write(const void* data, size_t len, size_t* actual);
+
+    // Copies up to |len| bytes out of the ring and returns the number copied in
+    // |actual|.  Returns ZX_ERR_SHOULD_WAIT if the ring is empty.  Reader only.
+    zx_status_t Read(void* data, size_t len, size_t* actual);
+
+    // Blocks until Write() or Read(), depending on the role, can make progress.
+    // Returns ZX_ERR_TIMED_OUT if |deadline| passes first, and
+    // ZX_ERR_PEER_CLOSED once the other end has closed its socket and there's
+    // nothing left to do; a reader can still drain data written before then.
+    zx_status_t Wait(zx::time deadline);
+
+    // Returns the number of bytes the ring holds when full.
+    size_t size() const { return size_; }
+
+private:
+    struct Control {
+        // Total bytes ever written and read.  Only the writer stores to head
+        // and only the reader to tail.
+        fbl::atomic<uint64_t> head;
+        fbl::atomic<uint64_t> tail;
+        // Set by an end about to block in Wait(), and cleared by the other end
+        // when it signals the socket.
+        fbl::atomic<uint32_t> writer_waiting;
+        fbl::atomic<uint32_t> reader_waiting;
+    };
+
+    // Wake-ups sent to the peer's socket: kDataSignal tells the reader there's
+    // data, kSpaceSignal tells the writer there's room.
+    static constexpr zx_signals_t kDataSignal = ZX_USER_SIGNAL_0;
+    static constexpr zx_signals_t kSpaceSignal = ZX_USER_SIGNAL_1;
+
+    Control* control() const { return static_cast<Control*>(mapping_.start()); }
+
+    // Returns the number of bytes in the ring, or ZX_ERR_IO_DATA_INTEGRITY if
+    // the peer has corrupted the positions.
+    zx_status_t Used(uint64_t head, uint64_t tail, size_t* used) const;
+
+    // Returns true if Write() or Read(), depending on the role, would make
+    // progress.
+    bool Ready() const;
+
+    VmoMapper mapping_;
+    zx::socket socket_;
+    Role role_ = Role::kWriter;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace fzl
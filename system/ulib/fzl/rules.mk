@@ -11,6 +11,7 @@ MODULE_TYPE := userlib
 MODULE_SRCS += \
     $(LOCAL_DIR)/mapped-vmo.cpp \
     $(LOCAL_DIR)/pinned-vmo.cpp \
+    $(LOCAL_DIR)/shared-ring.cpp \
     $(LOCAL_DIR)/time.cpp \
     $(LOCAL_DIR)/vmar-manager.cpp \
     $(LOCAL_DIR)/vmo-mapper.cpp \
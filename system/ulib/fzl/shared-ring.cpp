@@ -0,0 +1,165 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <lib/fzl/shared-ring.h>
+
+#include <fbl/algorithm.h>
+#include <limits.h>
+#include <string.h>
+#include <zircon/assert.h>
+
+namespace fzl {
+
+namespace {
+
+bool IsValidSize(uint64_t size) {
+    return size != 0 && (size & (size - 1)) == 0 && (size % PAGE_SIZE) == 0;
+}
+
+} // namespace
+
+zx_status_t SharedRing::Create(size_t size, zx::vmo* vmo, zx::socket* writer,
+                               zx::socket* reader) {
+    if (!IsValidSize(size)) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+    zx_status_t status = zx::vmo::create(PAGE_SIZE + size, 0, vmo);
+    if (status != ZX_OK) {
+        return status;
+    }
+    return zx::socket::create(0, writer, reader);
+}
+
+zx_status_t SharedRing::Init(const zx::vmo& vmo, zx::socket socket, Role role) {
+    uint64_t vmo_size;
+    zx_status_t status = vmo.get_size(&vmo_size);
+    if (status != ZX_OK) {
+        return status;
+    }
+    if (vmo_size <= PAGE_SIZE || !IsValidSize(vmo_size - PAGE_SIZE)) {
+        return ZX_ERR_INVALID_ARGS;
+    }
+
+    status = mapping_.Map(vmo, 0, vmo_size, ZX_VM_FLAG_PERM_READ | ZX_VM_FLAG_PERM_WRITE);
+    if (status != ZX_OK) {
+        return status;
+    }
+
+    socket_ = fbl::move(socket);
+    role_ = role;
+    data_ = static_cast<uint8_t*>(mapping_.start()) + PAGE_SIZE;
+    size_ = vmo_size - PAGE_SIZE;
+    return ZX_OK;
+}
+
+zx_status_t SharedRing::Used(uint64_t head, uint64_t tail, size_t* used) const {
+    uint64_t count = head - tail;
+    if (count > size_) {
+        return ZX_ERR_IO_DATA_INTEGRITY;
+    }
+    *used = count;
+    return ZX_OK;
+}
+
+bool SharedRing::Ready() const {
+    size_t used;
+    if (Used(control()->head.load(), control()->tail.load(), &used) != ZX_OK) {
+        // Let Write() or Read() report the corruption.
+        return true;
+    }
+    return role_ == Role::kWriter ? used < size_ : used > 0;
+}
+
+zx_status_t SharedRing::Write(const void* data, size_t len, size_t* actual) {
+    ZX_DEBUG_ASSERT(role_ == Role::kWriter);
+    Control* control = this->control();
+
+    const uint64_t head = control->head.load(fbl::memory_order_relaxed);
+    size_t used;
+    zx_status_t status = Used(head, control->tail.load(fbl::memory_order_acquire), &used);
+    if (status != ZX_OK) {
+        return status;
+    }
+    if (used == size_) {
+        return ZX_ERR_SHOULD_WAIT;
+    }
+
+    const size_t count = fbl::min(len, size_ - used);
+    const size_t offset = head & (size_ - 1);
+    const size_t first = fbl::min(count, size_ - offset);
+    memcpy(data_ + offset, data, first);
+    memcpy(data_, static_cast<const uint8_t*>(data) + first, count - first);
+
+    // Publishing the new head and then checking the flag pairs with Wait()
+    // setting the flag and then checking the head, so that one side or the
+    // other always notices.
+    control->head.store(head + count);
+    if (control->reader_waiting.exchange(0) != 0) {
+        socket_.signal_peer(0, kDataSignal);
+    }
+
+    *actual = count;
+    return ZX_OK;
+}
+
+zx_status_t SharedRing::Read(void* data, size_t len, size_t* actual) {
+    ZX_DEBUG_ASSERT(role_ == Role::kReader);
+    Control* control = this->control();
+
+    const uint64_t tail = control->tail.load(fbl::memory_order_relaxed);
+    size_t used;
+    zx_status_t status = Used(control->head.load(fbl::memory_order_acquire), tail, &used);
+    if (status != ZX_OK) {
+        return status;
+    }
+    if (used == 0) {
+        return ZX_ERR_SHOULD_WAIT;
+    }
+
+    const size_t count = fbl::min(len, used);
+    const size_t offset = tail & (size_ - 1);
+    const size_t first = fbl::min(count, size_ - offset);
+    memcpy(data, data_ + offset, first);
+    memcpy(static_cast<uint8_t*>(data) + first, data_, count - first);
+
+    control->tail.store(tail + count);
+    if (control->writer_waiting.exchange(0) != 0) {
+        socket_.signal_peer(0, kSpaceSignal);
+    }
+
+    *actual = count;
+    return ZX_OK;
+}
+
+zx_status_t SharedRing::Wait(zx::time deadline) {
+    const bool writer = role_ == Role::kWriter;
+    const zx_signals_t signal = writer ? kSpaceSignal : kDataSignal;
+    fbl::atomic<uint32_t>* waiting =
+        writer ? &control()->writer_waiting : &control()->reader_waiting;
+
+    for (;;) {
+        // Clear any stale wake-up, then say we're about to block before
+        // checking the ring one last time.
+        socket_.signal(signal, 0);
+        waiting->store(1);
+        if (Ready()) {
+            waiting->store(0);
+            return ZX_OK;
+        }
+
+        zx_signals_t pending;
+        zx_status_t status = socket_.wait_one(signal | ZX_SOCKET_PEER_CLOSED, deadline,
+                                              &pending);
+        if (status != ZX_OK) {
+            waiting->store(0);
+            return status;
+        }
+        if (!(pending & signal)) {
+            waiting->store(0);
+            return Ready() ? ZX_OK : ZX_ERR_PEER_CLOSED;
+        }
+    }
+}
+
+} // namespace fzl
@@ -12,6 +12,7 @@
 #include <zircon/processargs.h>
 #include <zircon/stack.h>
 #include <zircon/syscalls.h>
+#include <zircon/syscalls/batch-numbers.h>
 #include <ldmsg/ldmsg.h>
 #include <lib/fdio/io.h>
 #include <assert.h>
@@ -932,25 +933,35 @@ static zx_status_t send_loader_message(launchpad_t* lp,
         switch (i) {
         case HND_SPECIAL_COUNT:;
             // Duplicate the handles for the loader so we can send them in the
-            // loader message and still have them later.
-            zx_handle_t proc;
-            status = zx_handle_duplicate(lp_proc(lp), ZX_RIGHT_SAME_RIGHTS, &proc);
-            if (status != ZX_OK) {
-                free(msg);
-                return status;
-            }
-            zx_handle_t vmar;
-            status = zx_handle_duplicate(lp_vmar(lp), ZX_RIGHT_SAME_RIGHTS, &vmar);
-            if (status != ZX_OK) {
-                zx_handle_close(proc);
-                free(msg);
-                return status;
+            // loader message and still have them later.  The three
+            // duplications are made with one trip into the kernel.
+            zx_handle_t proc = ZX_HANDLE_INVALID;
+            zx_handle_t vmar = ZX_HANDLE_INVALID;
+            zx_handle_t thread = ZX_HANDLE_INVALID;
+            zx_syscall_call_t calls[HND_LOADER_COUNT] = {
+                {.num = ZX_BATCH_handle_duplicate,
+                 .args = {lp_proc(lp), ZX_RIGHT_SAME_RIGHTS, (uintptr_t)&proc}},
+                {.num = ZX_BATCH_handle_duplicate,
+                 .args = {lp_vmar(lp), ZX_RIGHT_SAME_RIGHTS, (uintptr_t)&vmar}},
+                {.num = ZX_BATCH_handle_duplicate,
+                 .args = {first_thread, ZX_RIGHT_SAME_RIGHTS, (uintptr_t)&thread}},
+            };
+            // A batch can stop short if this thread is suspended, so
+            // resubmit whatever is left.
+            size_t done = 0;
+            while (status == ZX_OK && done < HND_LOADER_COUNT) {
+                size_t completed = 0;
+                status = zx_syscall_batch(ZX_SYSCALL_BATCH_STOP_ON_ERROR,
+                                          &calls[done], HND_LOADER_COUNT - done,
+                                          &completed);
+                for (size_t j = 0; status == ZX_OK && j < completed; ++j)
+                    status = calls[done + j].status;
+                done += completed;
             }
-            zx_handle_t thread;
-            status = zx_handle_duplicate(first_thread, ZX_RIGHT_SAME_RIGHTS, &thread);
             if (status != ZX_OK) {
                 zx_handle_close(proc);
                 zx_handle_close(vmar);
+                zx_handle_close(thread);
                 free(msg);
                 return status;
             }
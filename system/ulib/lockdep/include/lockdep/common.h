@@ -31,6 +31,20 @@ namespace lockdep {
 #define LOCK_DEP_ENABLE_VALIDATION 0
 #endif
 
+// Configures whether per-lock class contention profiling is enabled. Profiling
+// builds on the per-lock class state maintained for validation and has no
+// effect unless validation is also enabled. Defaults to disabled.
+#ifndef LOCK_DEP_ENABLE_PROFILING
+#define LOCK_DEP_ENABLE_PROFILING 0
+#endif
+
+// Configures the wait time, in the units returned by the system-defined
+// SystemGetLockProfilingTime(), above which the profiler counts an acquisition
+// as contended.
+#ifndef LOCK_DEP_PROFILING_CONTENDED_THRESHOLD
+#define LOCK_DEP_PROFILING_CONTENDED_THRESHOLD 500
+#endif
+
 // Id type used to identify each lock class.
 using LockClassId = uintptr_t;
 
@@ -82,6 +96,20 @@ using IfLockValidationEnabled = typename fbl::conditional<kLockValidationEnabled
                                                           EnabledType,
                                                           DisabledType>::type;
 
+// Whether or not lock contention profiling is globally enabled.
+constexpr bool kLockProfilingEnabled =
+    kLockValidationEnabled && static_cast<bool>(LOCK_DEP_ENABLE_PROFILING);
+
+// Wait time above which an acquisition is counted as contended.
+constexpr uint64_t kLockProfilingContendedThreshold = LOCK_DEP_PROFILING_CONTENDED_THRESHOLD;
+
+// Utility template alias to simplify selecting different types based whether
+// lock profiling is enabled or disabled.
+template <typename EnabledType, typename DisabledType>
+using IfLockProfilingEnabled = typename fbl::conditional<kLockProfilingEnabled,
+                                                         EnabledType,
+                                                         DisabledType>::type;
+
 // Result type that represents whether a lock attempt was successful, or if not
 // which check failed.
 enum class LockResult : uint8_t {
@@ -98,6 +98,7 @@ public:
     template <typename... Args>
     void Release(Args&&... args) __TA_RELEASE() {
         if (lock_ != nullptr) {
+            validator_.ProfileRelease();
             LockPolicy<LockType, Option>::Release(lock_, &state_,
                                                   fbl::forward<Args>(args)...);
             validator_.ValidateRelease();
@@ -158,6 +159,7 @@ public:
         __TA_NO_THREAD_SAFETY_ANALYSIS {
         ZX_DEBUG_ASSERT(lock_ != nullptr);
 
+        validator_.ProfileRelease();
         LockPolicy<LockType, Option>::Release(
             lock_, &state_, fbl::forward<ReleaseArgs>(release_args)...);
         validator_.ValidateRelease();
@@ -179,9 +181,12 @@ private:
     // body.
     void ValidateAndAcquire() __TA_NO_THREAD_SAFETY_ANALYSIS {
         validator_.ValidateAcquire();
+        validator_.ProfileAcquireBegin();
         if (!LockPolicy<LockType, Option>::Acquire(lock_, &state_)) {
             lock_ = nullptr;
             validator_.ValidateRelease();
+        } else {
+            validator_.ProfileAcquireEnd();
         }
     }
 
@@ -207,6 +212,42 @@ private:
         void ValidateRelease() {
             ThreadLockState::Get()->Release(&lock_entry);
         }
+        void ProfileAcquireBegin() { profiler.AcquireBegin(); }
+        void ProfileAcquireEnd() { profiler.AcquireEnd(lock_entry.id()); }
+        void ProfileRelease() { profiler.Release(lock_entry.id()); }
+
+        // Profiler type used when lock profiling is enabled. Records how long
+        // the acquisition waited and how long the lock was held in the state
+        // of the lock class.
+        struct LockProfiler {
+            void AcquireBegin() {
+                timestamp = SystemGetLockProfilingTime();
+            }
+            void AcquireEnd(LockClassId id) {
+                const uint64_t now = SystemGetLockProfilingTime();
+                const uint64_t wait_time = now - timestamp;
+                const bool contended = wait_time > kLockProfilingContendedThreshold;
+                LockClassState::Get(id)->RecordAcquire(wait_time, contended);
+                if (contended)
+                    SystemLockContended(LockClassState::Get(id), wait_time);
+                timestamp = now;
+            }
+            void Release(LockClassId id) {
+                LockClassState::Get(id)->RecordRelease(
+                    SystemGetLockProfilingTime() - timestamp);
+            }
+
+            uint64_t timestamp{0};
+        };
+
+        // Profiler type used when lock profiling is disabled.
+        struct DummyProfiler {
+            void AcquireBegin() {}
+            void AcquireEnd(LockClassId) {}
+            void Release(LockClassId) {}
+        };
+
+        IfLockProfilingEnabled<LockProfiler, DummyProfiler> profiler;
 
         AcquiredLockEntry lock_entry;
     };
@@ -216,6 +257,9 @@ private:
         DummyValidator(LockClassId, uintptr_t = 0) {}
         void ValidateAcquire() {}
         void ValidateRelease() {}
+        void ProfileAcquireBegin() {}
+        void ProfileAcquireEnd() {}
+        void ProfileRelease() {}
     };
 
     // Alias of the configured validator.
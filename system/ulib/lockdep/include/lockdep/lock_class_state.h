@@ -124,6 +124,11 @@ public:
     // Returns the name of this lock class.
     const char* name() const { return name_; }
 
+    // Returns a small integer identifying this lock class in profiling output.
+    // Unlike id() it does not reveal an address, and since ids are handed out
+    // in registration order it is the same from boot to boot of one build.
+    uint32_t profile_id() const { return profile_id_; }
+
     // Return the flags of this lock class.
     LockFlags flags() const { return flags_; }
 
@@ -142,6 +147,53 @@ public:
     uint64_t index() const { return loop_node_.index; }
     uint64_t least() const { return loop_node_.least; }
 
+    // Contention statistics gathered for this lock class when lock profiling
+    // is enabled. Times are in the units of SystemGetLockProfilingTime().
+    struct Profile {
+        uint64_t acquisitions;
+        uint64_t contended;
+        uint64_t total_wait_time;
+        uint64_t max_hold_time;
+    };
+
+    // Records an acquisition of a lock of this class that waited for the given
+    // time, and whether the acquisition was contended.
+    void RecordAcquire(uint64_t wait_time, bool contended) {
+        profile_.acquisitions.fetch_add(1, fbl::memory_order_relaxed);
+        if (contended) {
+            profile_.contended.fetch_add(1, fbl::memory_order_relaxed);
+            profile_.total_wait_time.fetch_add(wait_time, fbl::memory_order_relaxed);
+        }
+    }
+
+    // Records a release of a lock of this class that was held for the given
+    // time.
+    void RecordRelease(uint64_t hold_time) {
+        uint64_t max = profile_.max_hold_time.load(fbl::memory_order_relaxed);
+        while (hold_time > max &&
+               !profile_.max_hold_time.compare_exchange_weak(&max, hold_time,
+                                                             fbl::memory_order_relaxed,
+                                                             fbl::memory_order_relaxed)) {
+        }
+    }
+
+    // Returns a snapshot of the contention statistics for this lock class. The
+    // fields are read individually and may not be mutually consistent.
+    Profile profile() const {
+        return {profile_.acquisitions.load(fbl::memory_order_relaxed),
+                profile_.contended.load(fbl::memory_order_relaxed),
+                profile_.total_wait_time.load(fbl::memory_order_relaxed),
+                profile_.max_hold_time.load(fbl::memory_order_relaxed)};
+    }
+
+    // Clears the contention statistics for this lock class.
+    void ResetProfile() {
+        profile_.acquisitions.store(0, fbl::memory_order_relaxed);
+        profile_.contended.store(0, fbl::memory_order_relaxed);
+        profile_.total_wait_time.store(0, fbl::memory_order_relaxed);
+        profile_.max_hold_time.store(0, fbl::memory_order_relaxed);
+    }
+
     // Resets the dependency set and disjoint set of this object. This is
     // primarily used to initialize the state between successive tests.
     void Reset() {
@@ -166,6 +218,18 @@ private:
     // list of lock classes.
     LockClassState* next_{InitNext(this)};
 
+    // Position of this instance in the state list, counting from the first
+    // instance registered. Must be declared after next_.
+    const uint32_t profile_id_{next_ != nullptr ? next_->profile_id_ + 1 : 0};
+
+    // Contention statistics, only updated when lock profiling is enabled.
+    struct {
+        fbl::atomic<uint64_t> acquisitions{0};
+        fbl::atomic<uint64_t> contended{0};
+        fbl::atomic<uint64_t> total_wait_time{0};
+        fbl::atomic<uint64_t> max_hold_time{0};
+    } profile_;
+
     // Returns a pointer to the head pointer of the state linked list.
     static LockClassState** Head() {
         static LockClassState* head{nullptr};
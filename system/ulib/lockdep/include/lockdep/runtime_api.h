@@ -54,4 +54,15 @@ extern void SystemInitThreadLockState(ThreadLockState* state);
 // given time interval.
 extern void SystemTriggerLoopDetection();
 
+// System-defined hook that returns a monotonic timestamp used to measure lock
+// wait and hold times. Only called when lock profiling is enabled. The units
+// are up to the system, but must match LOCK_DEP_PROFILING_CONTENDED_THRESHOLD.
+extern uint64_t SystemGetLockProfilingTime();
+
+// System-defined hook to report a contended acquisition of a lock of the given
+// class, along with how long the acquiring thread waited. Only called when
+// lock profiling is enabled. This may be called with arbitrary locks held, so
+// the implementation must not block or acquire any tracked locks.
+extern void SystemLockContended(LockClassState* lock_class, uint64_t wait_time);
+
 } // namespace lockdep
@@ -18,6 +18,7 @@ KTRACE_DEF(0x023,NAME,SYSCALL_NAME,META) // num, 0, name[]
 KTRACE_DEF(0x024,NAME,IRQ_NAME,META) // num, 0, name[]
 KTRACE_DEF(0x025,NAME,PROBE_NAME,META) // num, 0, name[]
 KTRACE_DEF(0x026,NAME,VCPU_META,META) // meta, 0, name[]
+KTRACE_DEF(0x027,NAME,LOCK_CLASS_NAME,META) // class, 0, name[]
 
 KTRACE_DEF(0x030,16B,IRQ_ENTER,IRQ) // (irqn << 8) | cpu
 KTRACE_DEF(0x031,16B,IRQ_EXIT,IRQ) // (irqn << 8) | cpu
@@ -57,6 +58,7 @@ KTRACE_DEF(0x151,32B,WAIT_ONE_DONE,IPC) // id, status, pending
 KTRACE_DEF(0x160,32B,KWAIT_BLOCK,SCHEDULER) // queue_hi, queue_hi
 KTRACE_DEF(0x161,32B,KWAIT_WAKE,SCHEDULER) // queue_hi, queue_hi, is_mutex
 KTRACE_DEF(0x162,32B,KWAIT_UNBLOCK,SCHEDULER) // queue_hi, queue_hi, blocked_status
+KTRACE_DEF(0x163,32B,LOCK_CONTENDED,SCHEDULER) // class, wait_ns, cpu
 
 KTRACE_DEF(0x170,32B,VCPU_ENTER,TASKS)
 KTRACE_DEF(0x171,32B,VCPU_EXIT,TASKS) // meta
@@ -0,0 +1,96 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <zircon/syscalls.h>
+
+#include "private.h"
+
+namespace {
+
+// This must match u64_mul_u64_fp32_64() in kernel/lib/fixed_point so that
+// the vDSO and the kernel agree on the time exactly.
+uint64_t mul_u64_fp32_64(uint64_t a, uint32_t l0, uint32_t l32, uint32_t l64) {
+    uint32_t a_r32 = static_cast<uint32_t>(a >> 32);
+    uint32_t a_0 = static_cast<uint32_t>(a);
+    uint64_t res_0;
+    uint64_t res_l32;
+    uint64_t tmp;
+
+    res_0 = (static_cast<uint64_t>(a_r32) * l0) << 32;
+    res_0 += static_cast<uint64_t>(a_0) * l0;
+    res_0 += static_cast<uint64_t>(a_r32) * l32;
+    tmp = static_cast<uint64_t>(a_0) * l32;
+    res_0 += tmp >> 32;
+    res_l32 = static_cast<uint32_t>(tmp);
+    tmp = static_cast<uint64_t>(a_r32) * l64;
+    res_0 += tmp >> 32;
+    res_l32 += static_cast<uint32_t>(tmp);
+    tmp = static_cast<uint64_t>(a_0) * l64; // Improve rounding accuracy.
+    res_l32 += tmp >> 32;
+    res_0 += res_l32 >> 32;
+    return res_0 + (static_cast<uint32_t>(res_l32) >> 31); // Round to nearest integer.
+}
+
+// Computes the monotonic or UTC time from the clock parameters the kernel
+// publishes.  Returns false if the kernel has to be asked instead.
+bool clock_get_in_vdso(zx_clock_t clock_id, zx_time_t* time) {
+    const vdso_clock& clock = DATA_CLOCK;
+    for (;;) {
+        uint64_t seq = __atomic_load_n(&clock.seq, __ATOMIC_ACQUIRE);
+        uint32_t ticks_valid = __atomic_load_n(&clock.ticks_valid, __ATOMIC_RELAXED);
+        uint32_t l0 = __atomic_load_n(&clock.ns_per_tick_l0, __ATOMIC_RELAXED);
+        uint32_t l32 = __atomic_load_n(&clock.ns_per_tick_l32, __ATOMIC_RELAXED);
+        uint32_t l64 = __atomic_load_n(&clock.ns_per_tick_l64, __ATOMIC_RELAXED);
+        int64_t utc_offset = __atomic_load_n(&clock.utc_offset, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (unlikely((seq & 1) != 0 ||
+                     seq != __atomic_load_n(&clock.seq, __ATOMIC_RELAXED))) {
+            // The kernel is updating the clock.
+            continue;
+        }
+
+        if (unlikely(!ticks_valid))
+            return false;
+
+        zx_time_t now = mul_u64_fp32_64(VDSO_zx_ticks_get(), l0, l32, l64);
+        *time = clock_id == ZX_CLOCK_UTC ? now + utc_offset : now;
+        return true;
+    }
+}
+
+} // namespace
+
+zx_time_t _zx_clock_get_monotonic(void) {
+    zx_time_t time;
+    if (likely(clock_get_in_vdso(ZX_CLOCK_MONOTONIC, &time)))
+        return time;
+    return SYSCALL_zx_clock_get_via_kernel(ZX_CLOCK_MONOTONIC);
+}
+
+VDSO_INTERFACE_FUNCTION(zx_clock_get_monotonic);
+
+zx_time_t _zx_clock_get(zx_clock_t clock_id) {
+    zx_time_t time;
+    if ((clock_id == ZX_CLOCK_MONOTONIC || clock_id == ZX_CLOCK_UTC) &&
+        likely(clock_get_in_vdso(clock_id, &time))) {
+        return time;
+    }
+    return SYSCALL_zx_clock_get_via_kernel(clock_id);
+}
+
+VDSO_INTERFACE_FUNCTION(zx_clock_get);
+
+zx_status_t _zx_clock_get_new(zx_clock_t clock_id, zx_time_t* out) {
+    switch (clock_id) {
+    case ZX_CLOCK_MONOTONIC:
+    case ZX_CLOCK_UTC:
+    case ZX_CLOCK_THREAD:
+        *out = VDSO_zx_clock_get(clock_id);
+        return ZX_OK;
+    default:
+        return ZX_ERR_INVALID_ARGS;
+    }
+}
+
+VDSO_INTERFACE_FUNCTION(zx_clock_get_new);
@@ -108,6 +108,23 @@ protected:
     }
 };
 
+class CancelingWait : public TestWait {
+public:
+    CancelingWait(zx_handle_t object, zx_signals_t trigger, TestWait* other)
+        : TestWait(object, trigger), other_(other) {}
+
+    zx_status_t cancel_result = ZX_ERR_INTERNAL;
+
+protected:
+    TestWait* other_;
+
+    void Handle(async_dispatcher_t* dispatcher, zx_status_t status,
+                const zx_packet_signal_t* signal) override {
+        TestWait::Handle(dispatcher, status, signal);
+        cancel_result = other_->Cancel(dispatcher);
+    }
+};
+
 class TestTask : public async_task_t {
 public:
     TestTask()
@@ -606,6 +623,43 @@ bool wait_shutdown_test() {
     END_TEST;
 }
 
+bool wait_cancel_batched_test() {
+    BEGIN_TEST;
+
+    async::Loop loop(&kAsyncLoopConfigNoAttachToThread);
+    zx::event event1, event2;
+    EXPECT_EQ(ZX_OK, zx::event::create(0u, &event1), "create event 1");
+    EXPECT_EQ(ZX_OK, zx::event::create(0u, &event2), "create event 2");
+
+    TestWait wait2(event2.get(), ZX_USER_SIGNAL_0);
+    CancelingWait wait1(event1.get(), ZX_USER_SIGNAL_0, &wait2);
+    EXPECT_EQ(ZX_OK, wait1.Begin(loop.dispatcher()), "begin 1");
+    EXPECT_EQ(ZX_OK, wait2.Begin(loop.dispatcher()), "begin 2");
+
+    // Both packets are queued before the loop runs, so a single thread reads
+    // them in one batch, and |wait2|'s packet is still in the batch when
+    // |wait1| cancels it.
+    EXPECT_EQ(ZX_OK, event1.signal(0u, ZX_USER_SIGNAL_0), "signal 1");
+    EXPECT_EQ(ZX_OK, event2.signal(0u, ZX_USER_SIGNAL_0), "signal 2");
+    EXPECT_EQ(ZX_OK, loop.Run(zx::time::infinite(), true), "run once");
+    EXPECT_EQ(1u, wait1.run_count, "run count 1");
+    EXPECT_EQ(ZX_OK, wait1.cancel_result, "cancel result 1");
+    EXPECT_EQ(0u, wait2.run_count, "run count 2");
+
+    // The canceled packet is skipped rather than dispatched.
+    EXPECT_EQ(ZX_OK, loop.RunUntilIdle(), "run loop");
+    EXPECT_EQ(1u, wait1.run_count, "run count 1");
+    EXPECT_EQ(0u, wait2.run_count, "run count 2");
+    EXPECT_EQ(ZX_ERR_NOT_FOUND, wait2.Cancel(loop.dispatcher()), "cancel again");
+
+    // Nor is it canceled again on shutdown.
+    loop.Shutdown();
+    EXPECT_EQ(1u, wait1.run_count, "run count 1");
+    EXPECT_EQ(0u, wait2.run_count, "run count 2");
+
+    END_TEST;
+}
+
 bool task_test() {
     BEGIN_TEST;
 
@@ -854,6 +908,67 @@ bool exception_test() {
     END_TEST;
 }
 
+class UnbindingReceiver : public TestReceiver {
+public:
+    UnbindingReceiver(TestException* exception, zx_handle_t crashing_thread)
+        : exception_(exception), crashing_thread_(crashing_thread) {}
+
+    zx_status_t unbind_result = ZX_ERR_INTERNAL;
+
+protected:
+    TestException* exception_;
+    zx_handle_t crashing_thread_;
+
+    void Handle(async_dispatcher_t* dispatcher, zx_status_t status,
+                const zx_packet_user_t* data) override {
+        TestReceiver::Handle(dispatcher, status, data);
+        // Make sure the thread is gone before we unbind the exception port,
+        // otherwise the global crash-handler will see the exception.
+        zx_task_kill(crashing_thread_);
+        zx_object_wait_one(crashing_thread_, ZX_THREAD_TERMINATED, ZX_TIME_INFINITE, nullptr);
+        unbind_result = exception_->Unbind(dispatcher);
+    }
+};
+
+bool exception_unbind_batched_test() {
+    BEGIN_TEST;
+
+    async::Loop loop(&kAsyncLoopConfigNoAttachToThread);
+
+    zx_handle_t self = zx_process_self();
+    TestException exception(self, 0);
+    EXPECT_EQ(ZX_OK, exception.Bind(loop.dispatcher()));
+
+    zx_handle_t crashing_thread;
+    EXPECT_EQ(ZX_OK, create_crashing_thread(&crashing_thread));
+    UnbindingReceiver receiver(&exception, crashing_thread);
+    EXPECT_EQ(ZX_OK, receiver.QueuePacket(loop.dispatcher(), nullptr));
+
+    // Wait until thread has crashed, which queues the exception behind the
+    // receiver's packet.
+    uint32_t state;
+    do {
+        zx_nanosleep(zx_deadline_after(ZX_MSEC(1)));
+        state = get_thread_state(crashing_thread);
+    } while (state != ZX_THREAD_STATE_BLOCKED_EXCEPTION);
+
+    // A single thread reads both packets in one batch, so the exception is
+    // still in the batch when the receiver unbinds the port.
+    EXPECT_EQ(ZX_OK, loop.Run(zx::time::infinite(), true));
+    EXPECT_EQ(1u, receiver.run_count);
+    EXPECT_EQ(ZX_OK, receiver.unbind_result);
+    EXPECT_EQ(0u, exception.run_count);
+
+    EXPECT_EQ(ZX_OK, loop.RunUntilIdle());
+    EXPECT_EQ(0u, exception.run_count);
+    zx_handle_close(crashing_thread);
+
+    loop.Shutdown();
+    EXPECT_EQ(0u, exception.run_count);
+
+    END_TEST;
+}
+
 bool exception_shutdown_test() {
     BEGIN_TEST;
 
@@ -1235,11 +1350,13 @@ RUN_TEST(time_test)
 RUN_TEST(wait_test)
 RUN_TEST(wait_unwaitable_handle_test)
 RUN_TEST(wait_shutdown_test)
+RUN_TEST(wait_cancel_batched_test)
 RUN_TEST(task_test)
 RUN_TEST(task_shutdown_test)
 RUN_TEST(receiver_test)
 RUN_TEST(receiver_shutdown_test)
 RUN_TEST(exception_test)
+RUN_TEST(exception_unbind_batched_test)
 RUN_TEST(exception_shutdown_test)
 RUN_TEST(threads_have_default_dispatcher)
 for (int i = 0; i < 3; i++) {
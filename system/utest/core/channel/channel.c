@@ -3,7 +3,9 @@
 // found in the LICENSE file.
 
 #include <assert.h>
+#include <limits.h>
 #include <zircon/compiler.h>
+#include <zircon/process.h>
 #include <zircon/rights.h>
 #include <zircon/syscalls.h>
 #include <zircon/syscalls/object.h>
@@ -11,6 +13,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <threads.h>
 #include <unistd.h>
 
@@ -1025,6 +1028,321 @@ static bool channel_write_different_sizes(void) {
     END_TEST;
 }
 
+// Write large messages from pages of a mapped VMO with
+// ZX_CHANNEL_WRITE_TRANSFER_PAGES, checking that the reader sees the bytes as
+// written and that the writer's pages are only given up when they can be.
+static bool channel_write_transfer_pages(void) {
+    BEGIN_TEST;
+    zx_handle_t channel[2];
+    ASSERT_EQ(zx_channel_create(0, &channel[0], &channel[1]), ZX_OK, "");
+
+    const size_t size = ZX_CHANNEL_MAX_MSG_BYTES + PAGE_SIZE;
+    zx_handle_t vmo;
+    ASSERT_EQ(zx_vmo_create(size, 0, &vmo), ZX_OK, "");
+    uintptr_t addr;
+    ASSERT_EQ(zx_vmar_map(zx_vmar_root_self(), 0, vmo, 0, size,
+                          ZX_VM_FLAG_PERM_READ | ZX_VM_FLAG_PERM_WRITE, &addr),
+              ZX_OK, "");
+    char* src = (char*)addr;
+
+    char* data_recv = malloc(ZX_CHANNEL_MAX_MSG_BYTES);
+    ASSERT_NE(NULL, data_recv, "");
+    char* expected = malloc(ZX_CHANNEL_MAX_MSG_BYTES);
+    ASSERT_NE(NULL, expected, "");
+
+    // page aligned but not a whole number of pages: moved
+    // unaligned: copied
+    // too small to be worth moving: copied
+    // the largest message, ending before the last page of the mapping: moved
+    const struct {
+        size_t offset;
+        uint32_t num_bytes;
+        bool moved;
+    } cases[] = {
+        {0, 5 * PAGE_SIZE + 100, true},
+        {16, 5 * PAGE_SIZE, false},
+        {0, 2 * PAGE_SIZE, false},
+        {0, ZX_CHANNEL_MAX_MSG_BYTES, true},
+    };
+
+    for (size_t i = 0; i < countof(cases); ++i) {
+        for (size_t j = 0; j < size; ++j) {
+            src[j] = (char)(j * 7 + i + 1);
+        }
+        const uint32_t num_bytes = cases[i].num_bytes;
+        memcpy(expected, src + cases[i].offset, num_bytes);
+
+        ASSERT_EQ(zx_channel_write(channel[0], ZX_CHANNEL_WRITE_TRANSFER_PAGES,
+                                   src + cases[i].offset, num_bytes, NULL, 0),
+                  ZX_OK, "");
+        uint32_t actual_bytes = 0;
+        ASSERT_EQ(zx_channel_read(channel[1], 0u, data_recv, NULL, ZX_CHANNEL_MAX_MSG_BYTES,
+                                  0, &actual_bytes, NULL),
+                  ZX_OK, "");
+        ASSERT_EQ(actual_bytes, num_bytes, "");
+        ASSERT_EQ(memcmp(expected, data_recv, num_bytes), 0, "");
+
+        // A moved range reads as zero up to the end of its last page, and the
+        // rest of the mapping is left alone.
+        const size_t moved_end =
+            cases[i].moved ? (num_bytes + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1) : 0;
+        for (size_t j = 0; j < size; ++j) {
+            const char want = j < moved_end ? 0 : (char)(j * 7 + i + 1);
+            ASSERT_EQ(src[j], want, "");
+        }
+    }
+
+    // Unknown options are still rejected.
+    EXPECT_EQ(zx_channel_write(channel[0], 2u, src, PAGE_SIZE, NULL, 0),
+              ZX_ERR_INVALID_ARGS, "");
+
+    free(expected);
+    free(data_recv);
+    EXPECT_EQ(zx_vmar_unmap(zx_vmar_root_self(), addr, size), ZX_OK, "");
+    EXPECT_EQ(zx_handle_close(vmo), ZX_OK, "");
+    EXPECT_EQ(zx_handle_close(channel[0]), ZX_OK, "");
+    EXPECT_EQ(zx_handle_close(channel[1]), ZX_OK, "");
+    END_TEST;
+}
+
+// Read several messages at once with zx_channel_read_many().
+static bool channel_read_many(void) {
+    BEGIN_TEST;
+    zx_handle_t channel[2];
+    ASSERT_EQ(zx_channel_create(0, &channel[0], &channel[1]), ZX_OK, "");
+
+    zx_channel_read_slot_t slots[4];
+    size_t actual = 0;
+    EXPECT_EQ(zx_channel_read_many(channel[1], 0u, slots, countof(slots), &actual),
+              ZX_ERR_SHOULD_WAIT, "");
+    EXPECT_EQ(zx_channel_read_many(channel[1], 0u, slots, 0u, &actual),
+              ZX_ERR_INVALID_ARGS, "");
+    EXPECT_EQ(zx_channel_read_many(channel[1], 1u, slots, countof(slots), &actual),
+              ZX_ERR_INVALID_ARGS, "");
+
+    // Three small messages, the second carrying a handle, then one that is
+    // too large for the slots.
+    zx_handle_t event;
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(zx_channel_write(channel[0], 0u, &i, sizeof(i), &event, i == 1 ? 1 : 0),
+                  ZX_OK, "");
+    }
+    char large[64] = {0};
+    ASSERT_EQ(zx_channel_write(channel[0], 0u, large, sizeof(large), NULL, 0), ZX_OK, "");
+
+    uint32_t bytes[4][4];
+    zx_handle_t handles[4][1];
+    for (size_t i = 0; i < countof(slots); ++i) {
+        slots[i].bytes = bytes[i];
+        slots[i].handles = handles[i];
+        slots[i].num_bytes = sizeof(bytes[i]);
+        slots[i].num_handles = countof(handles[i]);
+        slots[i].actual_bytes = 0u;
+        slots[i].actual_handles = 0u;
+    }
+
+    ASSERT_EQ(zx_channel_read_many(channel[1], 0u, slots, countof(slots), &actual), ZX_OK, "");
+    ASSERT_EQ(actual, 3u, "");
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(slots[i].actual_bytes, sizeof(uint32_t), "");
+        EXPECT_EQ(slots[i].actual_handles, i == 1 ? 1u : 0u, "");
+        EXPECT_EQ(bytes[i][0], i, "");
+    }
+    EXPECT_EQ(zx_object_signal(handles[1][0], 0u, ZX_USER_SIGNAL_0), ZX_OK, "");
+    EXPECT_EQ(zx_handle_close(handles[1][0]), ZX_OK, "");
+
+    // The large message stays queued until it fits.
+    ASSERT_EQ(zx_channel_read_many(channel[1], 0u, slots, countof(slots), &actual),
+              ZX_ERR_BUFFER_TOO_SMALL, "");
+    EXPECT_EQ(slots[0].actual_bytes, sizeof(large), "");
+    EXPECT_EQ(slots[0].actual_handles, 0u, "");
+    slots[0].bytes = large;
+    slots[0].num_bytes = sizeof(large);
+    ASSERT_EQ(zx_channel_read_many(channel[1], 0u, slots, countof(slots), &actual), ZX_OK, "");
+    EXPECT_EQ(actual, 1u, "");
+    EXPECT_EQ(slots[0].actual_bytes, sizeof(large), "");
+
+    EXPECT_EQ(zx_handle_close(channel[0]), ZX_OK, "");
+    EXPECT_EQ(zx_channel_read_many(channel[1], 0u, slots, countof(slots), &actual),
+              ZX_ERR_PEER_CLOSED, "");
+    EXPECT_EQ(zx_handle_close(channel[1]), ZX_OK, "");
+    END_TEST;
+}
+
+// A later slot whose buffer faults ends zx_channel_read_many() early, and
+// the message meant for it stays queued.
+static bool channel_read_many_fault(void) {
+    BEGIN_TEST;
+    zx_handle_t channel[2];
+    ASSERT_EQ(zx_channel_create(0, &channel[0], &channel[1]), ZX_OK, "");
+
+    for (uint32_t i = 0; i < 2; ++i) {
+        ASSERT_EQ(zx_channel_write(channel[0], 0u, &i, sizeof(i), NULL, 0), ZX_OK, "");
+    }
+
+    uint32_t bytes[2] = {UINT32_MAX, UINT32_MAX};
+    zx_channel_read_slot_t slots[2] = {
+        {.bytes = &bytes[0], .handles = NULL, .num_bytes = sizeof(bytes[0]), .num_handles = 0u},
+        {.bytes = (void*)1, .handles = NULL, .num_bytes = sizeof(bytes[1]), .num_handles = 0u},
+    };
+    size_t actual = 0;
+    ASSERT_EQ(zx_channel_read_many(channel[1], 0u, slots, countof(slots), &actual), ZX_OK, "");
+    EXPECT_EQ(actual, 1u, "");
+    EXPECT_EQ(bytes[0], 0u, "");
+
+    uint32_t actual_bytes = 0;
+    ASSERT_EQ(zx_channel_read(channel[1], 0u, &bytes[1], NULL, sizeof(bytes[1]), 0u,
+                              &actual_bytes, NULL), ZX_OK, "");
+    EXPECT_EQ(actual_bytes, sizeof(uint32_t), "");
+    EXPECT_EQ(bytes[1], 1u, "");
+
+    EXPECT_EQ(zx_handle_close(channel[0]), ZX_OK, "");
+    EXPECT_EQ(zx_handle_close(channel[1]), ZX_OK, "");
+    END_TEST;
+}
+
+// Serves one call on |srv|.  If |next| is valid, the call is forwarded
+// there with zx_channel_call() before replying, as a server calling
+// another server does.
+typedef struct {
+    zx_handle_t srv;
+    zx_handle_t next;
+    zx_status_t status;
+} inherit_server_args_t;
+
+static int inherit_server(void* ptr) {
+    inherit_server_args_t* args = ptr;
+
+    args->status = zx_object_wait_one(args->srv, ZX_CHANNEL_READABLE, ZX_TIME_INFINITE, NULL);
+    if (args->status != ZX_OK)
+        return 0;
+
+    uint32_t msg[2];
+    uint32_t actual_bytes;
+    args->status = zx_channel_read(args->srv, 0u, msg, NULL, sizeof(msg), 0u,
+                                   &actual_bytes, NULL);
+    if (args->status != ZX_OK)
+        return 0;
+
+    if (args->next != ZX_HANDLE_INVALID) {
+        const zx_txid_t txid = msg[0];
+        zx_channel_call_args_t call = {
+            .wr_bytes = msg,
+            .wr_handles = NULL,
+            .rd_bytes = msg,
+            .rd_handles = NULL,
+            .wr_num_bytes = sizeof(msg),
+            .wr_num_handles = 0,
+            .rd_num_bytes = sizeof(msg),
+            .rd_num_handles = 0,
+        };
+        uint32_t actual_handles;
+        args->status = zx_channel_call(args->next, ZX_CHANNEL_CALL_INHERIT_PRIORITY,
+                                       ZX_TIME_INFINITE, &call, &actual_bytes, &actual_handles);
+        if (args->status != ZX_OK)
+            return 0;
+        msg[0] = txid;
+    }
+
+    msg[1] += 1u;
+    args->status = zx_channel_write(args->srv, 0u, msg, sizeof(msg), NULL, 0u);
+    return 0;
+}
+
+// A call made with ZX_CHANNEL_CALL_INHERIT_PRIORITY is served normally,
+// including when the server passes the priority on with a call of its own.
+static bool channel_call_inherit_priority(void) {
+    BEGIN_TEST;
+
+    zx_handle_t cli, srv, next_cli, next_srv;
+    ASSERT_EQ(zx_channel_create(0, &cli, &srv), ZX_OK, "");
+    ASSERT_EQ(zx_channel_create(0, &next_cli, &next_srv), ZX_OK, "");
+
+    inherit_server_args_t server_args[2] = {
+        {.srv = srv, .next = next_cli, .status = ZX_ERR_INTERNAL},
+        {.srv = next_srv, .next = ZX_HANDLE_INVALID, .status = ZX_ERR_INTERNAL},
+    };
+    thrd_t threads[2];
+    for (size_t i = 0; i < countof(threads); ++i) {
+        ASSERT_EQ(thrd_create(&threads[i], inherit_server, &server_args[i]), thrd_success, "");
+    }
+
+    uint32_t msg[2] = {0u, 40u};
+    zx_channel_call_args_t args = {
+        .wr_bytes = msg,
+        .wr_handles = NULL,
+        .rd_bytes = msg,
+        .rd_handles = NULL,
+        .wr_num_bytes = sizeof(msg),
+        .wr_num_handles = 0,
+        .rd_num_bytes = sizeof(msg),
+        .rd_num_handles = 0,
+    };
+    uint32_t act_bytes = 0xffffffff;
+    uint32_t act_handles = 0xffffffff;
+    ASSERT_EQ(zx_channel_call(cli, ZX_CHANNEL_CALL_INHERIT_PRIORITY, ZX_TIME_INFINITE, &args,
+                              &act_bytes, &act_handles), ZX_OK, "");
+    EXPECT_EQ(act_bytes, sizeof(msg), "");
+    EXPECT_EQ(act_handles, 0u, "");
+    EXPECT_EQ(msg[1], 42u, "");
+
+    for (size_t i = 0; i < countof(threads); ++i) {
+        EXPECT_EQ(thrd_join(threads[i], NULL), thrd_success, "");
+        EXPECT_EQ(server_args[i].status, ZX_OK, "");
+    }
+
+    zx_handle_t handles[4] = {cli, srv, next_cli, next_srv};
+    EXPECT_EQ(zx_handle_close_many(handles, countof(handles)), ZX_OK, "");
+
+    END_TEST;
+}
+
+// A server can reply to an inheriting call after the caller has given up,
+// and the reply is then queued like any other message.
+static bool channel_call_inherit_priority_timeout(void) {
+    BEGIN_TEST;
+
+    zx_handle_t cli, srv;
+    ASSERT_EQ(zx_channel_create(0, &cli, &srv), ZX_OK, "");
+
+    uint32_t msg[2] = {0u, 1u};
+    zx_channel_call_args_t args = {
+        .wr_bytes = msg,
+        .wr_handles = NULL,
+        .rd_bytes = msg,
+        .rd_handles = NULL,
+        .wr_num_bytes = sizeof(msg),
+        .wr_num_handles = 0,
+        .rd_num_bytes = sizeof(msg),
+        .rd_num_handles = 0,
+    };
+    uint32_t act_bytes, act_handles;
+    ASSERT_EQ(zx_channel_call(cli, ZX_CHANNEL_CALL_INHERIT_PRIORITY,
+                              zx_deadline_after(ZX_MSEC(1)), &args, &act_bytes, &act_handles),
+              ZX_ERR_TIMED_OUT, "");
+
+    uint32_t request[2];
+    ASSERT_EQ(zx_channel_read(srv, 0u, request, NULL, sizeof(request), 0u, &act_bytes, NULL),
+              ZX_OK, "");
+    EXPECT_EQ(request[1], 1u, "");
+    ASSERT_EQ(zx_channel_write(srv, 0u, request, sizeof(request), NULL, 0u), ZX_OK, "");
+
+    uint32_t reply[2];
+    ASSERT_EQ(zx_channel_read(cli, 0u, reply, NULL, sizeof(reply), 0u, &act_bytes, NULL),
+              ZX_OK, "");
+    EXPECT_EQ(reply[0], request[0], "");
+
+    // Options other than ZX_CHANNEL_CALL_INHERIT_PRIORITY are still refused.
+    EXPECT_EQ(zx_channel_call(cli, ZX_CHANNEL_CALL_INHERIT_PRIORITY << 1, 0, &args,
+                              &act_bytes, &act_handles), ZX_ERR_INVALID_ARGS, "");
+
+    EXPECT_EQ(zx_handle_close(cli), ZX_OK, "");
+    EXPECT_EQ(zx_handle_close(srv), ZX_OK, "");
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(channel_tests)
 RUN_TEST(channel_test)
 RUN_TEST(channel_read_error_test)
@@ -1042,6 +1360,11 @@ RUN_TEST(channel_nest)
 RUN_TEST(channel_disallow_write_to_self)
 RUN_TEST(channel_read_etc)
 RUN_TEST(channel_write_different_sizes)
+RUN_TEST(channel_write_transfer_pages)
+RUN_TEST(channel_read_many)
+RUN_TEST(channel_read_many_fault)
+RUN_TEST(channel_call_inherit_priority)
+RUN_TEST(channel_call_inherit_priority_timeout)
 END_TEST_CASE(channel_tests)
 
 #ifndef BUILD_COMBINED_TESTS
@@ -32,8 +32,43 @@ static bool clock_monotonic_test(void) {
     END_TEST;
 }
 
+// The vDSO computes the time without entering the kernel, so check that
+// it agrees with the kernel's notion of when a deadline has passed.
+static bool clock_agrees_with_kernel_test(void) {
+    BEGIN_TEST;
+
+    for (int idx = 0; idx < 100; ++idx) {
+        zx_time_t deadline = zx_time_add_duration(zx_clock_get_monotonic(), 1000u * idx);
+        ASSERT_EQ(zx_nanosleep(deadline), ZX_OK, "");
+        ASSERT_GE(zx_clock_get_monotonic(), deadline, "woke up before the deadline");
+        ASSERT_GE(zx_clock_get(ZX_CLOCK_MONOTONIC), deadline, "woke up before the deadline");
+    }
+
+    END_TEST;
+}
+
+static bool clock_get_new_test(void) {
+    BEGIN_TEST;
+
+    zx_time_t before = zx_clock_get_monotonic();
+    zx_time_t time = 0;
+    ASSERT_EQ(zx_clock_get_new(ZX_CLOCK_MONOTONIC, &time), ZX_OK, "");
+    EXPECT_GE(time, before, "");
+
+    EXPECT_EQ(zx_clock_get_new(ZX_CLOCK_UTC, &time), ZX_OK, "");
+    EXPECT_EQ(zx_clock_get_new(ZX_CLOCK_THREAD, &time), ZX_OK, "");
+    EXPECT_GT(time, 0, "");
+
+    EXPECT_EQ(zx_clock_get_new(1234u, &time), ZX_ERR_INVALID_ARGS, "");
+    EXPECT_EQ(zx_clock_get(1234u), 0, "");
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(clock_tests)
 RUN_TEST(clock_monotonic_test)
+RUN_TEST(clock_agrees_with_kernel_test)
+RUN_TEST(clock_get_new_test)
 END_TEST_CASE(clock_tests)
 
 #ifndef BUILD_COMBINED_TESTS
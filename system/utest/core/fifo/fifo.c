@@ -161,10 +161,55 @@ static bool options_test(void) {
     END_TEST;
 }
 
+static bool vectored_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t a, b;
+    ASSERT_EQ(zx_fifo_create(8, sizeof(uint32_t), 0, &a, &b), ZX_OK, "");
+
+    // An element may be split across buffers.
+    uint8_t w0[6] = { 1, 0, 0, 0, 2, 0 };
+    uint8_t w1[6] = { 0, 0, 3, 0, 0, 0 };
+    zx_iovec_t wvec[] = {
+        { w0, sizeof(w0) },
+        { w1, sizeof(w1) },
+    };
+    size_t actual;
+    EXPECT_EQ(zx_fifo_writev(a, sizeof(uint32_t), wvec, countof(wvec), &actual), ZX_OK, "");
+    EXPECT_EQ(actual, 3u, "");
+
+    // The buffers must hold a whole number of elements.
+    wvec[1].capacity = 5;
+    EXPECT_EQ(zx_fifo_writev(a, sizeof(uint32_t), wvec, countof(wvec), &actual),
+              ZX_ERR_INVALID_ARGS, "");
+    EXPECT_EQ(zx_fifo_writev(a, sizeof(uint32_t), wvec, 0, &actual), ZX_ERR_OUT_OF_RANGE, "");
+    EXPECT_EQ(zx_fifo_writev(a, sizeof(uint64_t), wvec, 1, &actual), ZX_ERR_OUT_OF_RANGE, "");
+
+    uint32_t r0[1] = {};
+    uint32_t r1[4] = {};
+    zx_iovec_t rvec[] = {
+        { r0, sizeof(r0) },
+        { r1, sizeof(r1) },
+    };
+    EXPECT_EQ(zx_fifo_readv(b, sizeof(uint32_t), rvec, countof(rvec), &actual), ZX_OK, "");
+    EXPECT_EQ(actual, 3u, "");
+    EXPECT_EQ(r0[0], 1u, "");
+    EXPECT_EQ(r1[0], 2u, "");
+    EXPECT_EQ(r1[1], 3u, "");
+
+    EXPECT_EQ(zx_fifo_readv(b, sizeof(uint32_t), rvec, countof(rvec), &actual),
+              ZX_ERR_SHOULD_WAIT, "");
+
+    zx_handle_close(a);
+    zx_handle_close(b);
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(fifo_tests)
 RUN_TEST(basic_test)
 RUN_TEST(peer_closed_test)
 RUN_TEST(options_test)
+RUN_TEST(vectored_test)
 END_TEST_CASE(fifo_tests)
 
 #ifndef BUILD_COMBINED_TESTS
@@ -12,6 +12,8 @@
 #include <time.h>
 #include <unistd.h>
 #include <unittest/unittest.h>
+#include <zircon/process.h>
+#include <zircon/rights.h>
 #include <zircon/syscalls.h>
 #include <zircon/threads.h>
 #include <zircon/time.h>
@@ -455,6 +457,78 @@ static bool test_futex_misaligned() {
     END_TEST;
 }
 
+// Test that futex_wait_owned() checks its owner argument.
+static bool test_futex_wait_owned_bad_owner() {
+    BEGIN_TEST;
+    int32_t futex_value = 123;
+
+    // A thread can't wait on a futex that it owns itself.
+    EXPECT_EQ(zx_futex_wait_owned(&futex_value, futex_value, zx_thread_self(), 0),
+              ZX_ERR_INVALID_ARGS);
+    EXPECT_EQ(zx_futex_wait_owned(&futex_value, futex_value, ZX_HANDLE_INVALID, 0),
+              ZX_ERR_BAD_HANDLE);
+
+    // Lending priority to a thread needs the right to manage it, which other
+    // objects' handles never have.
+    zx_handle_t thread;
+    const zx_rights_t rights = ZX_DEFAULT_THREAD_RIGHTS & ~ZX_RIGHT_MANAGE_THREAD;
+    ASSERT_EQ(zx_handle_duplicate(zx_thread_self(), rights, &thread), ZX_OK);
+    EXPECT_EQ(zx_futex_wait_owned(&futex_value, futex_value, thread, 0), ZX_ERR_ACCESS_DENIED);
+    EXPECT_EQ(zx_handle_close(thread), ZX_OK);
+
+    zx_handle_t event;
+    ASSERT_EQ(zx_event_create(0, &event), ZX_OK);
+    EXPECT_EQ(zx_futex_wait_owned(&futex_value, futex_value, event, 0), ZX_ERR_ACCESS_DENIED);
+    EXPECT_EQ(zx_handle_close(event), ZX_OK);
+
+    END_TEST;
+}
+
+struct OwnedWaitArgs {
+    volatile int32_t* futex_addr;
+    zx_handle_t owner;
+    volatile zx_status_t status;
+    volatile bool done;
+};
+
+static int owned_wait_thread(void* arg) {
+    auto* args = static_cast<OwnedWaitArgs*>(arg);
+    args->status = zx_futex_wait_owned(const_cast<int32_t*>(args->futex_addr), 1,
+                                       args->owner, ZX_TIME_INFINITE);
+    args->done = true;
+    return 0;
+}
+
+// Test that a thread waiting with futex_wait_owned() is woken normally, and
+// that the owner can wait on and wake other futexes while it is boosted.
+static bool test_futex_wait_owned_wakeup() {
+    BEGIN_TEST;
+    volatile int32_t futex_value = 1;
+    OwnedWaitArgs args = {&futex_value, zx_thread_self(), ZX_ERR_INTERNAL, false};
+
+    thrd_t thread;
+    ASSERT_EQ(thrd_create_with_name(&thread, owned_wait_thread, &args, "owned_wait_thread"),
+              thrd_success);
+
+    // Give the thread time to block, then check that the owner still runs
+    // futex operations normally.
+    int32_t other_value = 0;
+    EXPECT_EQ(zx_futex_wait(&other_value, 0, zx_deadline_after(ZX_MSEC(100))), ZX_ERR_TIMED_OUT);
+    EXPECT_FALSE(args.done);
+
+    // Keep the value unchanged so that a wake that comes before the thread
+    // blocks is retried rather than lost.
+    while (!args.done) {
+        EXPECT_EQ(zx_futex_wake(const_cast<int32_t*>(&futex_value), 1), ZX_OK);
+        zx_nanosleep(zx_deadline_after(ZX_MSEC(10)));
+    }
+
+    EXPECT_EQ(thrd_join(thread, NULL), thrd_success);
+    EXPECT_EQ(args.status, ZX_OK);
+
+    END_TEST;
+}
+
 static void log(const char* str) {
     zx_time_t now = zx_clock_get_monotonic();
     unittest_printf("[%08" PRIu64 ".%08" PRIu64 "]: %s",
@@ -547,6 +621,8 @@ RUN_TEST(test_futex_requeue_unqueued_on_timeout);
 RUN_TEST(test_futex_thread_killed);
 RUN_TEST(test_futex_thread_suspended);
 RUN_TEST(test_futex_misaligned);
+RUN_TEST(test_futex_wait_owned_bad_owner);
+RUN_TEST(test_futex_wait_owned_wakeup);
 RUN_TEST(test_event_signaling);
 END_TEST_CASE(futex_tests)
 
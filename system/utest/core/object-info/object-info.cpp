@@ -71,6 +71,47 @@ bool task_stats_smoke() {
     END_TEST;
 }
 
+// Returns a VMO with a few committed pages.
+zx_handle_t get_test_vmo() {
+    static zx_handle_t test_vmo = ZX_HANDLE_INVALID;
+
+    if (test_vmo == ZX_HANDLE_INVALID) {
+        zx_status_t s = zx_vmo_create(4 * PAGE_SIZE, 0, &test_vmo);
+        if (s != ZX_OK) {
+            EXPECT_EQ(s, ZX_OK, "zx_vmo_create"); // Poison the test.
+            return ZX_HANDLE_INVALID;
+        }
+        s = zx_vmo_op_range(test_vmo, ZX_VMO_OP_COMMIT, 0, 4 * PAGE_SIZE, nullptr, 0);
+        if (s != ZX_OK) {
+            EXPECT_EQ(s, ZX_OK, "zx_vmo_op_range"); // Poison the test.
+            return ZX_HANDLE_INVALID;
+        }
+    }
+    return test_vmo;
+}
+
+bool working_set_smoke() {
+    BEGIN_TEST;
+    zx_info_working_set_t info;
+    ASSERT_EQ(zx_object_get_info(get_test_vmo(), ZX_INFO_VMO_WORKING_SET,
+                                 &info, sizeof(info), nullptr, nullptr),
+              ZX_OK);
+    EXPECT_EQ(info.committed_bytes, 4u * PAGE_SIZE);
+    for (size_t i = 1; i < ZX_INFO_WORKING_SET_WINDOWS; i++) {
+        EXPECT_GE(info.accessed_bytes[i], info.accessed_bytes[i - 1]);
+    }
+    EXPECT_LE(info.accessed_bytes[ZX_INFO_WORKING_SET_WINDOWS - 1], info.committed_bytes);
+
+    ASSERT_EQ(zx_object_get_info(zx_process_self(), ZX_INFO_PROCESS_WORKING_SET,
+                                 &info, sizeof(info), nullptr, nullptr),
+              ZX_OK);
+    EXPECT_GT(info.committed_bytes, 0u);
+    // We just touched our stack, so something must be in the working set.
+    EXPECT_GT(info.accessed_bytes[0], 0u);
+    EXPECT_LE(info.accessed_bytes[ZX_INFO_WORKING_SET_WINDOWS - 1], info.committed_bytes);
+    END_TEST;
+}
+
 // Structs to keep track of VMARs/mappings in the test child process.
 typedef struct test_mapping {
     uintptr_t base;
@@ -958,6 +999,14 @@ RUN_SINGLE_ENTRY_TESTS(ZX_INFO_TASK_STATS, zx_info_task_stats_t, zx_process_self
 RUN_TEST((wrong_handle_type_fails<ZX_INFO_TASK_STATS, zx_info_task_stats_t, get_test_job>));
 RUN_TEST((wrong_handle_type_fails<ZX_INFO_TASK_STATS, zx_info_task_stats_t, zx_thread_self>));
 
+RUN_TEST(working_set_smoke);
+RUN_SINGLE_ENTRY_TESTS(ZX_INFO_VMO_WORKING_SET, zx_info_working_set_t, get_test_vmo);
+RUN_TEST((wrong_handle_type_fails<ZX_INFO_VMO_WORKING_SET, zx_info_working_set_t,
+                                  zx_process_self>));
+RUN_SINGLE_ENTRY_TESTS(ZX_INFO_PROCESS_WORKING_SET, zx_info_working_set_t, zx_process_self);
+RUN_TEST((wrong_handle_type_fails<ZX_INFO_PROCESS_WORKING_SET, zx_info_working_set_t,
+                                  get_test_job>));
+
 RUN_TEST(process_maps_smoke);
 RUN_MULTI_ENTRY_TESTS(ZX_INFO_PROCESS_MAPS, zx_info_maps_t, get_test_process);
 RUN_TEST((self_fails<ZX_INFO_PROCESS_MAPS, zx_info_maps_t>))
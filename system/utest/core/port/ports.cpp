@@ -82,7 +82,7 @@ static bool queue_too_many(void) {
     zx_status_t status;
 
     zx_handle_t port;
-    status = zx_port_create(0, &port);
+    status = zx_port_create(ZX_PORT_QUOTA(11), &port);
     EXPECT_EQ(status, ZX_OK, "could not create port");
 
     const zx_port_packet_t in = {
@@ -100,7 +100,109 @@ static bool queue_too_many(void) {
     }
 
     EXPECT_EQ(status, ZX_ERR_SHOULD_WAIT);
-    EXPECT_EQ(count, 2049u);
+    EXPECT_EQ(count, 2048u);
+
+    // Dequeuing a packet makes room for another.
+    zx_port_packet_t out = {};
+    status = zx_port_wait(port, 0, &out);
+    EXPECT_EQ(status, ZX_OK);
+    status = zx_port_queue(port, &in);
+    EXPECT_EQ(status, ZX_OK);
+    status = zx_port_queue(port, &in);
+    EXPECT_EQ(status, ZX_ERR_SHOULD_WAIT);
+
+    status = zx_handle_close(port);
+    EXPECT_EQ(status, ZX_OK);
+
+    END_TEST;
+}
+
+static bool create_quota_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t port;
+    EXPECT_EQ(zx_port_create(ZX_PORT_QUOTA(ZX_PORT_QUOTA_MAX + 1u), &port),
+              ZX_ERR_INVALID_ARGS);
+    EXPECT_EQ(zx_port_create(ZX_PORT_QUOTA(1) | (1u << 4), &port), ZX_ERR_INVALID_ARGS);
+
+    ASSERT_EQ(zx_port_create(ZX_PORT_QUOTA(1), &port), ZX_OK);
+    const zx_port_packet_t in = {3ull, ZX_PKT_TYPE_USER, 0, { {} }};
+    EXPECT_EQ(zx_port_queue(port, &in), ZX_OK);
+    EXPECT_EQ(zx_port_queue(port, &in), ZX_OK);
+    EXPECT_EQ(zx_port_queue(port, &in), ZX_ERR_SHOULD_WAIT);
+    EXPECT_EQ(zx_handle_close(port), ZX_OK);
+
+    // A quota can't raise the per-port limit past the system default.
+    ASSERT_EQ(zx_port_create(ZX_PORT_QUOTA(ZX_PORT_QUOTA_MAX), &port), ZX_OK);
+    const size_t quota = size_t(1) << ZX_PORT_QUOTA_MAX;
+    size_t queued = 0u;
+    while (queued < quota && zx_port_queue(port, &in) == ZX_OK) {
+        ++queued;
+    }
+    EXPECT_LT(queued, quota);
+    EXPECT_EQ(zx_handle_close(port), ZX_OK);
+
+    // The default quota is larger than the old fixed limit of 2049 packets.
+    ASSERT_EQ(zx_port_create(0, &port), ZX_OK);
+    for (size_t count = 0; count < 4096u; ++count) {
+        ASSERT_EQ(zx_port_queue(port, &in), ZX_OK);
+    }
+    EXPECT_EQ(zx_handle_close(port), ZX_OK);
+
+    END_TEST;
+}
+
+static bool wait_many_test(void) {
+    BEGIN_TEST;
+    zx_status_t status;
+
+    zx_handle_t port;
+    status = zx_port_create(0, &port);
+    EXPECT_EQ(status, ZX_OK, "could not create port");
+
+    zx_port_packet_t out[40] = {};
+    size_t actual = 0u;
+
+    status = zx_port_wait_many(port, 0, out, 0u, &actual);
+    EXPECT_EQ(status, ZX_ERR_INVALID_ARGS);
+
+    status = zx_port_wait_many(port, zx_deadline_after(ZX_USEC(1)), out, 1u, &actual);
+    EXPECT_EQ(status, ZX_ERR_TIMED_OUT);
+
+    // Queue more than the kernel stages at a time to check that packets come
+    // back whole and in order.
+    for (uint64_t key = 0u; key < 35u; ++key) {
+        zx_port_packet_t in = {key, ZX_PKT_TYPE_USER, 0, { {} }};
+        in.user.u64[0] = key * 3u;
+        status = zx_port_queue(port, &in);
+        EXPECT_EQ(status, ZX_OK);
+    }
+
+    status = zx_port_wait_many(port, ZX_TIME_INFINITE, out, 5u, &actual);
+    EXPECT_EQ(status, ZX_OK);
+    EXPECT_EQ(actual, 5u);
+
+    status = zx_port_wait_many(port, ZX_TIME_INFINITE, out + 5, fbl::count_of(out) - 5u,
+                               &actual);
+    EXPECT_EQ(status, ZX_OK);
+    EXPECT_EQ(actual, 30u);
+
+    for (uint64_t key = 0u; key < 35u; ++key) {
+        EXPECT_EQ(out[key].key, key);
+        EXPECT_EQ(out[key].type, ZX_PKT_TYPE_USER);
+        EXPECT_EQ(out[key].user.u64[0], key * 3u);
+    }
+
+    // |actual| is optional.
+    zx_port_packet_t in = {7ull, ZX_PKT_TYPE_USER, 0, { {} }};
+    status = zx_port_queue(port, &in);
+    EXPECT_EQ(status, ZX_OK);
+    status = zx_port_wait_many(port, 0, out, 2u, nullptr);
+    EXPECT_EQ(status, ZX_OK);
+    EXPECT_EQ(out[0].key, 7u);
+
+    status = zx_port_wait_many(port, 0, out, 2u, &actual);
+    EXPECT_EQ(status, ZX_ERR_TIMED_OUT);
 
     status = zx_handle_close(port);
     EXPECT_EQ(status, ZX_OK);
@@ -677,10 +779,76 @@ static bool cancel_stress() {
     END_TEST;
 }
 
+static constexpr uint32_t kQuotaStressThreads = 8u;
+static constexpr uint32_t kQuotaStressLog2 = 13u;
+static constexpr uint32_t kQuotaStressRounds = 4u;
+
+// Fills a port to its quota and drains it, a few times over.
+static int quota_filler_thread(void* arg) {
+    zx_handle_t port;
+    if (zx_port_create(ZX_PORT_QUOTA(kQuotaStressLog2), &port) != ZX_OK)
+        return 1;
+
+    int result = 0;
+    for (uint32_t round = 0; round < kQuotaStressRounds && result == 0; ++round) {
+        uint64_t queued = 0;
+        zx_status_t st;
+        while (true) {
+            const zx_port_packet_t in = {queued, ZX_PKT_TYPE_USER, 0, { {} }};
+            st = zx_port_queue(port, &in);
+            if (st != ZX_OK)
+                break;
+            ++queued;
+        }
+        if (st != ZX_ERR_SHOULD_WAIT || queued != (1u << kQuotaStressLog2)) {
+            result = 2;
+            break;
+        }
+
+        uint64_t received = 0;
+        zx_port_packet_t out[32];
+        while (received < queued) {
+            size_t actual;
+            if (zx_port_wait_many(port, 0, out, fbl::count_of(out), &actual) != ZX_OK) {
+                result = 3;
+                break;
+            }
+            for (size_t ix = 0; ix != actual; ++ix) {
+                if (out[ix].key != received + ix)
+                    result = 4;
+            }
+            received += actual;
+        }
+    }
+
+    zx_handle_close(port);
+    return result;
+}
+
+// Keeps more packets pending across the system than the old fixed arena held.
+static bool quota_stress() {
+    BEGIN_TEST;
+
+    thrd_t threads[kQuotaStressThreads];
+    for (size_t ix = 0; ix != fbl::count_of(threads); ++ix) {
+        ASSERT_EQ(thrd_create(&threads[ix], quota_filler_thread, nullptr), thrd_success);
+    }
+
+    for (size_t ix = 0; ix != fbl::count_of(threads); ++ix) {
+        int res;
+        EXPECT_EQ(thrd_join(threads[ix], &res), thrd_success);
+        EXPECT_EQ(res, 0);
+    }
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(port_tests)
 RUN_TEST(basic_test)
 RUN_TEST(queue_and_close_test)
 RUN_TEST(queue_too_many)
+RUN_TEST(create_quota_test)
+RUN_TEST(wait_many_test)
 RUN_TEST(async_wait_channel_test)
 RUN_TEST(async_wait_event_test_single)
 RUN_TEST(async_wait_event_test_repeat)
@@ -700,6 +868,7 @@ RUN_TEST(cancel_event_key_repeat_after)
 RUN_TEST(threads_event_once)
 RUN_TEST(threads_event_repeat)
 RUN_TEST_LARGE(cancel_stress)
+RUN_TEST_LARGE(quota_stress)
 END_TEST_CASE(port_tests)
 
 #ifndef BUILD_COMBINED_TESTS
@@ -61,7 +61,86 @@ static bool change_priority_via_profile(void) {
     END_TEST;
 }
 
+static bool make_bandwidth_profile_fails(void) {
+    BEGIN_TEST;
+
+    zx_handle_t rrh = get_root_resource();
+    if (rrh == ZX_HANDLE_INVALID) {
+        unittest_printf("no root resource. skipping test\n");
+    } else {
+        zx_handle_t profile;
+        zx_profile_info_t profile_info = { 0 };
+        profile_info.type = ZX_PROFILE_INFO_BANDWIDTH;
+
+        profile_info.bandwidth.weight = ZX_SCHED_WEIGHT_MIN - 1;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &profile), ZX_ERR_INVALID_ARGS, "");
+        profile_info.bandwidth.weight = ZX_SCHED_WEIGHT_MAX + 1;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &profile), ZX_ERR_INVALID_ARGS, "");
+
+        profile_info.bandwidth.weight = ZX_SCHED_WEIGHT_DEFAULT;
+        profile_info.bandwidth.capacity_us = 2000u;
+        profile_info.bandwidth.period_us = 1000u;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &profile), ZX_ERR_INVALID_ARGS, "");
+
+        profile_info.bandwidth.capacity_us = 0u;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &profile), ZX_ERR_INVALID_ARGS, "");
+
+        profile_info.bandwidth.capacity_us = 1u;
+        profile_info.bandwidth.period_us = 1u;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &profile), ZX_ERR_INVALID_ARGS, "");
+    }
+
+    END_TEST;
+}
+
+static bool reserve_bandwidth_via_profile(void) {
+    BEGIN_TEST;
+
+    zx_handle_t rrh = get_root_resource();
+    if (rrh == ZX_HANDLE_INVALID) {
+        unittest_printf("no root resource. skipping test\n");
+    } else {
+        zx_profile_info_t profile_info = { 0 };
+        profile_info.type = ZX_PROFILE_INFO_BANDWIDTH;
+        profile_info.bandwidth.weight = ZX_SCHED_WEIGHT_MAX;
+        profile_info.bandwidth.capacity_us = 1000u;
+        profile_info.bandwidth.period_us = 10000u;
+
+        zx_handle_t reserved;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &reserved), ZX_OK, "");
+
+        zx_handle_t unreserved;
+        profile_info.bandwidth.weight = ZX_SCHED_WEIGHT_DEFAULT;
+        profile_info.bandwidth.capacity_us = 0u;
+        profile_info.bandwidth.period_us = 0u;
+        ASSERT_EQ(zx_profile_create(rrh, &profile_info, &unreserved), ZX_OK, "");
+
+        ASSERT_EQ(zx_object_set_profile(zx_thread_self(), reserved, 0), ZX_OK, "");
+
+        // Run long enough to be charged for some reserved time.
+        zx_time_t deadline = zx_deadline_after(ZX_MSEC(20));
+        while (zx_clock_get(ZX_CLOCK_MONOTONIC) < deadline) {
+            zx_nanosleep(zx_deadline_after(ZX_USEC(100)));
+        }
+
+        zx_info_thread_stats_t stats;
+        ASSERT_EQ(zx_object_get_info(zx_thread_self(), ZX_INFO_THREAD_STATS,
+                                     &stats, sizeof(stats), NULL, NULL), ZX_OK, "");
+        EXPECT_GT(stats.reserved_runtime, 0, "");
+        EXPECT_LE(stats.reserved_runtime, stats.total_runtime, "");
+
+        ASSERT_EQ(zx_object_set_profile(zx_thread_self(), unreserved, 0), ZX_OK, "");
+
+        ASSERT_EQ(zx_handle_close(reserved), ZX_OK, "");
+        ASSERT_EQ(zx_handle_close(unreserved), ZX_OK, "");
+    }
+
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(profile_tests)
 RUN_TEST(make_profile_fails)
 RUN_TEST(change_priority_via_profile)
+RUN_TEST(make_bandwidth_profile_fails)
+RUN_TEST(reserve_bandwidth_via_profile)
 END_TEST_CASE(profile_tests)
@@ -886,6 +886,114 @@ bool socket_share_consumes_on_failure(void) {
     END_TEST;
 }
 
+static bool socket_vectored(void) {
+    BEGIN_TEST;
+
+    size_t count;
+    zx_status_t status;
+    zx_handle_t h0, h1;
+
+    status = zx_socket_create(0, &h0, &h1);
+    ASSERT_EQ(status, ZX_OK, "");
+
+    char header[] = "head:";
+    char empty[1];
+    char body[] = "body";
+    zx_iovec_t wvec[] = {
+        { header, 5u },
+        { empty, 0u },
+        { body, 4u },
+    };
+    status = zx_socket_writev(h0, 0u, wvec, countof(wvec), &count);
+    EXPECT_EQ(status, ZX_OK, "");
+    EXPECT_EQ(count, 9u, "");
+
+    char r0[3] = {0};
+    char r1[16] = {0};
+    zx_iovec_t rvec[] = {
+        { r0, sizeof(r0) },
+        { r1, sizeof(r1) },
+    };
+    status = zx_socket_readv(h1, 0u, rvec, countof(rvec), &count);
+    EXPECT_EQ(status, ZX_OK, "");
+    EXPECT_EQ(count, 9u, "");
+    EXPECT_EQ(memcmp(r0, "hea", 3), 0, "");
+    EXPECT_EQ(memcmp(r1, "d:body", 6), 0, "");
+
+    status = zx_socket_readv(h1, 0u, rvec, countof(rvec), &count);
+    EXPECT_EQ(status, ZX_ERR_SHOULD_WAIT, "");
+
+    zx_iovec_t too_many[ZX_IOVEC_MAX + 1] = {};
+    status = zx_socket_writev(h0, 0u, too_many, countof(too_many), &count);
+    EXPECT_EQ(status, ZX_ERR_OUT_OF_RANGE, "");
+
+    zx_iovec_t bad[] = {
+        { (void*)1u, 4u },
+    };
+    status = zx_socket_writev(h0, 0u, bad, countof(bad), &count);
+    EXPECT_EQ(status, ZX_ERR_INVALID_ARGS, "");
+
+    status = zx_socket_writev(h0, ZX_SOCKET_CONTROL, wvec, countof(wvec), &count);
+    EXPECT_EQ(status, ZX_ERR_INVALID_ARGS, "");
+
+    zx_handle_close(h0);
+    zx_handle_close(h1);
+    END_TEST;
+}
+
+static bool socket_vectored_datagram(void) {
+    BEGIN_TEST;
+
+    size_t count;
+    zx_status_t status;
+    zx_handle_t h0, h1;
+
+    status = zx_socket_create(ZX_SOCKET_DATAGRAM, &h0, &h1);
+    ASSERT_EQ(status, ZX_OK, "");
+
+    // The buffers of one call form one datagram.
+    char a[] = "pkt";
+    char b[] = "1";
+    zx_iovec_t wvec[] = {
+        { a, 3u },
+        { b, 2u },
+    };
+    status = zx_socket_writev(h0, 0u, wvec, countof(wvec), &count);
+    EXPECT_EQ(status, ZX_OK, "");
+    EXPECT_EQ(count, 5u, "");
+    status = zx_socket_write(h0, 0u, "pkt2", 5u, &count);
+    EXPECT_EQ(status, ZX_OK, "");
+
+    zx_iovec_t empty[] = {
+        { a, 0u },
+    };
+    status = zx_socket_writev(h0, 0u, empty, countof(empty), &count);
+    EXPECT_EQ(status, ZX_ERR_INVALID_ARGS, "");
+
+    // Reads stop at the end of a datagram, however much room is left.
+    char r0[2] = {0};
+    char r1[16] = {0};
+    zx_iovec_t rvec[] = {
+        { r0, sizeof(r0) },
+        { r1, sizeof(r1) },
+    };
+    status = zx_socket_readv(h1, 0u, rvec, countof(rvec), &count);
+    EXPECT_EQ(status, ZX_OK, "");
+    EXPECT_EQ(count, 5u, "");
+    EXPECT_EQ(memcmp(r0, "pk", 2), 0, "");
+    EXPECT_EQ(memcmp(r1, "t1", 3), 0, "");
+
+    status = zx_socket_readv(h1, 0u, rvec, countof(rvec), &count);
+    EXPECT_EQ(status, ZX_OK, "");
+    EXPECT_EQ(count, 5u, "");
+    EXPECT_EQ(memcmp(r0, "pk", 2), 0, "");
+    EXPECT_EQ(memcmp(r1, "t2", 3), 0, "");
+
+    zx_handle_close(h0);
+    zx_handle_close(h1);
+    END_TEST;
+}
+
 BEGIN_TEST_CASE(socket_tests)
 RUN_TEST(socket_basic)
 RUN_TEST(socket_signals)
@@ -904,6 +1012,8 @@ RUN_TEST(socket_control_plane_shutdown)
 RUN_TEST(socket_accept)
 RUN_TEST(socket_share_invalid_handle)
 RUN_TEST(socket_share_consumes_on_failure)
+RUN_TEST(socket_vectored)
+RUN_TEST(socket_vectored_datagram)
 END_TEST_CASE(socket_tests)
 
 #ifndef BUILD_COMBINED_TESTS
@@ -0,0 +1,137 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <unittest/unittest.h>
+
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/batch-numbers.h>
+#include <zircon/syscalls/object.h>
+
+static bool syscall_batch_args_test(void) {
+    BEGIN_TEST;
+
+    zx_syscall_call_t calls[2] = {
+        {.num = ZX_BATCH_syscall_test_0},
+        {.num = ZX_BATCH_syscall_test_8, .args = {1, 2, 3, 4, 5, 6, 7, 8}},
+    };
+    size_t completed = 0u;
+    ASSERT_EQ(zx_syscall_batch(0u, calls, 2u, &completed), ZX_OK, "");
+    EXPECT_EQ(completed, 2u, "");
+    EXPECT_EQ(calls[0].status, 0, "");
+    EXPECT_EQ(calls[1].status, 36, "");
+
+    END_TEST;
+}
+
+static bool syscall_batch_out_handle_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t event;
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+
+    zx_handle_t dups[2] = {ZX_HANDLE_INVALID, ZX_HANDLE_INVALID};
+    zx_syscall_call_t calls[2];
+    for (size_t i = 0u; i < 2u; ++i) {
+        calls[i] = (zx_syscall_call_t){
+            .num = ZX_BATCH_handle_duplicate,
+            .args = {event, ZX_RIGHT_SAME_RIGHTS, (uintptr_t)&dups[i]},
+        };
+    }
+    ASSERT_EQ(zx_syscall_batch(0u, calls, 2u, NULL), ZX_OK, "");
+
+    zx_info_handle_basic_t info[3];
+    zx_handle_t handles[3] = {event, dups[0], dups[1]};
+    for (size_t i = 0u; i < 3u; ++i) {
+        if (i > 0u) {
+            EXPECT_EQ(calls[i - 1].status, ZX_OK, "");
+        }
+        ASSERT_EQ(zx_object_get_info(handles[i], ZX_INFO_HANDLE_BASIC, &info[i],
+                                     sizeof(info[i]), NULL, NULL), ZX_OK, "");
+    }
+    EXPECT_EQ(info[1].koid, info[0].koid, "");
+    EXPECT_EQ(info[2].koid, info[0].koid, "");
+
+    ASSERT_EQ(zx_handle_close_many(handles, 3u), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool syscall_batch_unknown_test(void) {
+    BEGIN_TEST;
+
+    // Numbers that don't name a batchable call fail individually.  Small
+    // numbers like the kernel's syscall indices name nothing.
+    zx_syscall_call_t calls[4] = {
+        {.num = UINT32_MAX},
+        {.num = ZX_BATCH_syscall_test_0},
+        {.num = UINT32_MAX - 1u},
+        {.num = 3u},
+    };
+    size_t completed = 0u;
+    ASSERT_EQ(zx_syscall_batch(0u, calls, 4u, &completed), ZX_OK, "");
+    EXPECT_EQ(completed, 4u, "");
+    EXPECT_EQ(calls[0].status, ZX_ERR_NOT_SUPPORTED, "");
+    EXPECT_EQ(calls[1].status, 0, "");
+    EXPECT_EQ(calls[2].status, ZX_ERR_NOT_SUPPORTED, "");
+    EXPECT_EQ(calls[3].status, ZX_ERR_NOT_SUPPORTED, "");
+
+    END_TEST;
+}
+
+static bool syscall_batch_stop_on_error_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t event;
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(event), ZX_OK, "");
+
+    const zx_status_t untouched = 12345;
+    zx_syscall_call_t calls[3] = {
+        {.num = ZX_BATCH_syscall_test_0, .status = untouched},
+        {.num = ZX_BATCH_handle_close, .status = untouched, .args = {event}},
+        {.num = ZX_BATCH_syscall_test_0, .status = untouched},
+    };
+    size_t completed = 0u;
+    ASSERT_EQ(zx_syscall_batch(ZX_SYSCALL_BATCH_STOP_ON_ERROR, calls, 3u, &completed),
+              ZX_OK, "");
+    EXPECT_EQ(completed, 2u, "");
+    EXPECT_EQ(calls[0].status, 0, "");
+    EXPECT_EQ(calls[1].status, ZX_ERR_BAD_HANDLE, "");
+    EXPECT_EQ(calls[2].status, untouched, "");
+
+    END_TEST;
+}
+
+static bool syscall_batch_invalid_test(void) {
+    BEGIN_TEST;
+
+    zx_syscall_call_t call = {.num = ZX_BATCH_syscall_test_0};
+    EXPECT_EQ(zx_syscall_batch(~ZX_SYSCALL_BATCH_STOP_ON_ERROR, &call, 1u, NULL),
+              ZX_ERR_INVALID_ARGS, "");
+    EXPECT_EQ(zx_syscall_batch(0u, NULL, 1u, NULL), ZX_ERR_INVALID_ARGS, "");
+    EXPECT_EQ(zx_syscall_batch(0u, &call, ZX_SYSCALL_BATCH_MAX + 1u, NULL),
+              ZX_ERR_OUT_OF_RANGE, "");
+
+    size_t completed = 1u;
+    EXPECT_EQ(zx_syscall_batch(0u, NULL, 0u, &completed), ZX_OK, "");
+    EXPECT_EQ(completed, 0u, "");
+
+    END_TEST;
+}
+
+BEGIN_TEST_CASE(syscall_batch_tests)
+RUN_TEST(syscall_batch_args_test)
+RUN_TEST(syscall_batch_out_handle_test)
+RUN_TEST(syscall_batch_unknown_test)
+RUN_TEST(syscall_batch_stop_on_error_test)
+RUN_TEST(syscall_batch_invalid_test)
+END_TEST_CASE(syscall_batch_tests)
+
+#ifndef BUILD_COMBINED_TESTS
+int main(int argc, char** argv) {
+    return unittest_run_all_tests(argc, argv) ? 0 : -1;
+}
+#endif
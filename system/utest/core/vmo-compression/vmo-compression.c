@@ -0,0 +1,173 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unittest/unittest.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/object.h>
+
+extern zx_handle_t get_root_resource(void);
+
+#define MB (1024u * 1024u)
+
+// The memory is filled in VMOs of this size.
+#define CHUNK_SIZE (16u * MB)
+#define CHUNK_PAGES (CHUNK_SIZE / PAGE_SIZE)
+
+// userboot passes the kernel command line to core-tests as its environment,
+// so these read the same options the kernel did, with the same defaults.
+static bool cmdline_bool(const char* name, bool default_value) {
+    const char* value = getenv(name);
+    if (value == NULL) {
+        return default_value;
+    }
+    return strcmp(value, "0") != 0 && strcmp(value, "false") != 0 &&
+           strcmp(value, "off") != 0;
+}
+
+static uint64_t cmdline_uint64(const char* name, uint64_t default_value) {
+    const char* value = getenv(name);
+    if (value == NULL || *value == '\0') {
+        return default_value;
+    }
+    return strtoull(value, NULL, 0);
+}
+
+static zx_status_t get_kmem_stats(zx_info_kmem_stats_t* stats) {
+    return zx_object_get_info(get_root_resource(), ZX_INFO_KMEM_STATS,
+                              stats, sizeof(*stats), NULL, NULL);
+}
+
+// Every page compresses well, and starts with its index so that pages that
+// come back at the wrong offset are caught.
+static void fill_page(uint8_t* page, uint64_t index) {
+    for (size_t i = 0; i < PAGE_SIZE; i++) {
+        page[i] = (uint8_t)((index + i / 64) % 7);
+    }
+    memcpy(page, &index, sizeof(index));
+}
+
+static uint64_t committed_bytes(const zx_handle_t* vmos, size_t num_vmos) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < num_vmos; i++) {
+        zx_info_working_set_t info;
+        if (zx_object_get_info(vmos[i], ZX_INFO_VMO_WORKING_SET, &info, sizeof(info),
+                               NULL, NULL) == ZX_OK) {
+            total += info.committed_bytes;
+        }
+    }
+    return total;
+}
+
+// Fills memory until free memory drops below the compressor's watermark,
+// waits for the compressor to engage on its own, then checks that every page
+// reads back intact.
+static bool compress_under_pressure_test(void) {
+    BEGIN_TEST;
+
+    if (!cmdline_bool("kernel.vm.compression.enable", false)) {
+        unittest_printf("page compression is not enabled. skipping test\n");
+        END_TEST;
+    }
+
+    const uint64_t watermark = cmdline_uint64("kernel.vm.compression.watermark-mb", 100) * MB;
+    const uint64_t redline = cmdline_uint64("kernel.oom.redline-mb", 50) * MB;
+    const zx_duration_t period =
+        ZX_SEC(cmdline_uint64("kernel.vm.compression.period-sec", 10));
+    const zx_duration_t harvest_period =
+        ZX_SEC(cmdline_uint64("kernel.vm.harvester.period-sec", 10));
+    if (watermark <= redline || harvest_period == 0) {
+        unittest_printf("compressor can't engage before the OOM redline. skipping test\n");
+        END_TEST;
+    }
+
+    zx_info_kmem_stats_t stats;
+    ASSERT_EQ(get_kmem_stats(&stats), ZX_OK, "");
+    const uint64_t initial_compressed = stats.compressed_bytes;
+
+    // Aim halfway between the watermark and the redline, so the compressor
+    // has work to do but the OOM thread stays out of the way.
+    const uint64_t target_free = redline + (watermark - redline) / 2;
+    if (stats.free_bytes <= target_free + CHUNK_SIZE) {
+        unittest_printf("not enough free memory to fill. skipping test\n");
+        END_TEST;
+    }
+    const size_t num_vmos = (stats.free_bytes - target_free) / CHUNK_SIZE;
+
+    zx_handle_t* vmos = calloc(num_vmos, sizeof(zx_handle_t));
+    ASSERT_NONNULL(vmos, "");
+    uint8_t* page = malloc(PAGE_SIZE);
+    ASSERT_NONNULL(page, "");
+
+    size_t filled = 0;
+    for (; filled < num_vmos; filled++) {
+        if (zx_vmo_create(CHUNK_SIZE, 0, &vmos[filled]) != ZX_OK) {
+            break;
+        }
+        for (uint64_t i = 0; i < CHUNK_PAGES; i++) {
+            fill_page(page, filled * CHUNK_PAGES + i);
+            EXPECT_EQ(zx_vmo_write(vmos[filled], page, i * PAGE_SIZE, PAGE_SIZE), ZX_OK, "");
+        }
+    }
+    EXPECT_EQ(filled, num_vmos, "creating vmos");
+    const uint64_t filled_bytes = (uint64_t)filled * CHUNK_SIZE;
+    EXPECT_EQ(committed_bytes(vmos, filled), filled_bytes, "");
+
+    // The pages must go unaccessed for a harvest before the compressor will
+    // take them, and the compressor then has to come around.
+    const zx_time_t deadline = zx_deadline_after(2 * (harvest_period + period));
+    for (;;) {
+        ASSERT_EQ(get_kmem_stats(&stats), ZX_OK, "");
+        if (stats.compressed_bytes > initial_compressed &&
+            committed_bytes(vmos, filled) < filled_bytes) {
+            break;
+        }
+        if (zx_clock_get_monotonic() > deadline) {
+            break;
+        }
+        zx_nanosleep(zx_deadline_after(ZX_MSEC(100)));
+    }
+    EXPECT_GT(stats.compressed_bytes, initial_compressed, "compressor didn't engage");
+    EXPECT_LT(committed_bytes(vmos, filled), filled_bytes, "no filled page was compressed");
+
+    // Reading decompresses the pages, which must come back as written.
+    uint8_t* expected = malloc(PAGE_SIZE);
+    ASSERT_NONNULL(expected, "");
+    size_t mismatches = 0;
+    for (size_t v = 0; v < filled; v++) {
+        for (uint64_t i = 0; i < CHUNK_PAGES; i++) {
+            fill_page(expected, v * CHUNK_PAGES + i);
+            EXPECT_EQ(zx_vmo_read(vmos[v], page, i * PAGE_SIZE, PAGE_SIZE), ZX_OK, "");
+            if (memcmp(page, expected, PAGE_SIZE) != 0) {
+                mismatches++;
+            }
+        }
+    }
+    EXPECT_EQ(mismatches, 0u, "pages changed across compression");
+    EXPECT_EQ(committed_bytes(vmos, filled), filled_bytes, "");
+
+    for (size_t v = 0; v < filled; v++) {
+        zx_handle_close(vmos[v]);
+    }
+    free(expected);
+    free(page);
+    free(vmos);
+
+    END_TEST;
+}
+
+BEGIN_TEST_CASE(vmo_compression_tests)
+RUN_TEST_LARGE(compress_under_pressure_test)
+END_TEST_CASE(vmo_compression_tests)
+
+#ifndef BUILD_COMBINED_TESTS
+int main(int argc, char** argv) {
+    return unittest_run_all_tests(argc, argv) ? 0 : -1;
+}
+#endif
@@ -0,0 +1,221 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <unittest/unittest.h>
+
+#include <zircon/syscalls.h>
+
+static bool waitset_add_wait_remove_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws, event;
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+    ASSERT_EQ(zx_waitset_add(ws, 7u, event, ZX_USER_SIGNAL_0), ZX_OK, "");
+
+    zx_waitset_result_t result;
+    size_t actual = 1u;
+    EXPECT_EQ(zx_waitset_wait(ws, 0u, &result, 1u, &actual), ZX_ERR_TIMED_OUT, "");
+
+    ASSERT_EQ(zx_object_signal(event, 0u, ZX_USER_SIGNAL_0 | ZX_USER_SIGNAL_1), ZX_OK, "");
+    ASSERT_EQ(zx_waitset_wait(ws, ZX_TIME_INFINITE, &result, 1u, &actual), ZX_OK, "");
+    EXPECT_EQ(actual, 1u, "");
+    EXPECT_EQ(result.cookie, 7u, "");
+    EXPECT_EQ(result.status, ZX_OK, "");
+    EXPECT_EQ(result.observed & (ZX_USER_SIGNAL_0 | ZX_USER_SIGNAL_1),
+              ZX_USER_SIGNAL_0 | ZX_USER_SIGNAL_1, "");
+
+    ASSERT_EQ(zx_waitset_remove(ws, 7u), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_wait(ws, 0u, &result, 1u, NULL), ZX_ERR_TIMED_OUT, "");
+    EXPECT_EQ(zx_waitset_remove(ws, 7u), ZX_ERR_NOT_FOUND, "");
+
+    // The cookie can be used again once it has been removed.
+    EXPECT_EQ(zx_waitset_add(ws, 7u, event, ZX_USER_SIGNAL_1), ZX_OK, "");
+
+    ASSERT_EQ(zx_handle_close(event), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(ws), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool waitset_duplicate_cookie_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws, event;
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+
+    ASSERT_EQ(zx_waitset_add(ws, 1u, event, ZX_USER_SIGNAL_0), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_add(ws, 1u, event, ZX_USER_SIGNAL_1), ZX_ERR_ALREADY_EXISTS, "");
+
+    // The same handle can be added again under another cookie.
+    EXPECT_EQ(zx_waitset_add(ws, 2u, event, ZX_USER_SIGNAL_1), ZX_OK, "");
+
+    ASSERT_EQ(zx_handle_close(event), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(ws), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool waitset_level_triggered_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws;
+    zx_handle_t events[3];
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    for (uint64_t i = 0u; i < 3u; ++i) {
+        ASSERT_EQ(zx_event_create(0u, &events[i]), ZX_OK, "");
+        ASSERT_EQ(zx_waitset_add(ws, i, events[i], ZX_USER_SIGNAL_0), ZX_OK, "");
+    }
+
+    ASSERT_EQ(zx_object_signal(events[0], 0u, ZX_USER_SIGNAL_0), ZX_OK, "");
+    ASSERT_EQ(zx_object_signal(events[2], 0u, ZX_USER_SIGNAL_0), ZX_OK, "");
+
+    // Ready members are reported until their signals are deasserted.
+    zx_waitset_result_t results[3];
+    size_t actual = 0u;
+    for (int pass = 0; pass < 2; ++pass) {
+        ASSERT_EQ(zx_waitset_wait(ws, 0u, results, 3u, &actual), ZX_OK, "");
+        ASSERT_EQ(actual, 2u, "");
+        uint64_t seen = 0u;
+        for (size_t i = 0u; i < actual; ++i) {
+            seen |= 1u << results[i].cookie;
+        }
+        EXPECT_EQ(seen, (1u << 0) | (1u << 2), "");
+    }
+
+    ASSERT_EQ(zx_object_signal(events[0], ZX_USER_SIGNAL_0, 0u), ZX_OK, "");
+    ASSERT_EQ(zx_waitset_wait(ws, 0u, results, 3u, &actual), ZX_OK, "");
+    ASSERT_EQ(actual, 1u, "");
+    EXPECT_EQ(results[0].cookie, 2u, "");
+
+    ASSERT_EQ(zx_object_signal(events[2], ZX_USER_SIGNAL_0, 0u), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_wait(ws, 0u, results, 3u, &actual), ZX_ERR_TIMED_OUT, "");
+
+    ASSERT_EQ(zx_handle_close_many(events, 3u), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(ws), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool waitset_small_buffer_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws;
+    zx_handle_t events[3];
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    for (uint64_t i = 0u; i < 3u; ++i) {
+        ASSERT_EQ(zx_event_create(0u, &events[i]), ZX_OK, "");
+        ASSERT_EQ(zx_object_signal(events[i], 0u, ZX_USER_SIGNAL_0), ZX_OK, "");
+        ASSERT_EQ(zx_waitset_add(ws, i, events[i], ZX_USER_SIGNAL_0), ZX_OK, "");
+    }
+
+    // Waiting for one member at a time sees each ready member in turn.
+    uint64_t seen = 0u;
+    for (int i = 0; i < 3; ++i) {
+        zx_waitset_result_t result;
+        ASSERT_EQ(zx_waitset_wait(ws, 0u, &result, 1u, NULL), ZX_OK, "");
+        seen |= 1u << result.cookie;
+    }
+    EXPECT_EQ(seen, 7u, "");
+
+    ASSERT_EQ(zx_handle_close_many(events, 3u), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(ws), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool waitset_handle_closed_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws, event;
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+    ASSERT_EQ(zx_waitset_add(ws, 3u, event, ZX_USER_SIGNAL_0), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(event), ZX_OK, "");
+
+    zx_waitset_result_t result;
+    size_t actual = 0u;
+    ASSERT_EQ(zx_waitset_wait(ws, 0u, &result, 1u, &actual), ZX_OK, "");
+    EXPECT_EQ(actual, 1u, "");
+    EXPECT_EQ(result.cookie, 3u, "");
+    EXPECT_EQ(result.status, ZX_ERR_CANCELED, "");
+    EXPECT_EQ(result.observed, ZX_SIGNAL_HANDLE_CLOSED, "");
+
+    ASSERT_EQ(zx_waitset_remove(ws, 3u), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_wait(ws, 0u, &result, 1u, NULL), ZX_ERR_TIMED_OUT, "");
+
+    ASSERT_EQ(zx_handle_close(ws), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool waitset_close_with_members_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws, event;
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+    ASSERT_EQ(zx_waitset_add(ws, 1u, event, ZX_USER_SIGNAL_0), ZX_OK, "");
+    ASSERT_EQ(zx_waitset_add(ws, 2u, event, ZX_USER_SIGNAL_1), ZX_OK, "");
+
+    // Closing the wait set first leaves the event working.
+    ASSERT_EQ(zx_handle_close(ws), ZX_OK, "");
+    ASSERT_EQ(zx_object_signal(event, 0u, ZX_USER_SIGNAL_0), ZX_OK, "");
+    ASSERT_EQ(zx_handle_close(event), ZX_OK, "");
+
+    END_TEST;
+}
+
+static bool waitset_bad_args_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t ws, event;
+    EXPECT_EQ(zx_waitset_create(1u, &ws), ZX_ERR_INVALID_ARGS, "");
+    ASSERT_EQ(zx_waitset_create(0u, &ws), ZX_OK, "");
+    ASSERT_EQ(zx_event_create(0u, &event), ZX_OK, "");
+
+    zx_waitset_result_t result;
+    EXPECT_EQ(zx_waitset_wait(ws, 0u, &result, 0u, NULL), ZX_ERR_INVALID_ARGS, "");
+    EXPECT_EQ(zx_waitset_wait(event, 0u, &result, 1u, NULL), ZX_ERR_WRONG_TYPE, "");
+    EXPECT_EQ(zx_waitset_add(ws, 0u, ZX_HANDLE_INVALID, ZX_USER_SIGNAL_0),
+              ZX_ERR_BAD_HANDLE, "");
+
+    // A wait set can't be waited on, so it can't be a member either.
+    zx_handle_t other;
+    ASSERT_EQ(zx_waitset_create(0u, &other), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_add(ws, 0u, other, ZX_USER_SIGNAL_0), ZX_ERR_ACCESS_DENIED, "");
+
+    zx_handle_t no_wait;
+    ASSERT_EQ(zx_handle_duplicate(event, ZX_RIGHT_TRANSFER, &no_wait), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_add(ws, 0u, no_wait, ZX_USER_SIGNAL_0), ZX_ERR_ACCESS_DENIED, "");
+
+    zx_handle_t read_only;
+    ASSERT_EQ(zx_handle_duplicate(ws, ZX_RIGHT_READ, &read_only), ZX_OK, "");
+    EXPECT_EQ(zx_waitset_add(read_only, 0u, event, ZX_USER_SIGNAL_0),
+              ZX_ERR_ACCESS_DENIED, "");
+
+    zx_handle_t handles[5] = {ws, event, other, no_wait, read_only};
+    ASSERT_EQ(zx_handle_close_many(handles, 5u), ZX_OK, "");
+
+    END_TEST;
+}
+
+BEGIN_TEST_CASE(waitset_tests)
+RUN_TEST(waitset_add_wait_remove_test)
+RUN_TEST(waitset_duplicate_cookie_test)
+RUN_TEST(waitset_level_triggered_test)
+RUN_TEST(waitset_small_buffer_test)
+RUN_TEST(waitset_handle_closed_test)
+RUN_TEST(waitset_close_with_members_test)
+RUN_TEST(waitset_bad_args_test)
+END_TEST_CASE(waitset_tests)
+
+#ifndef BUILD_COMBINED_TESTS
+int main(int argc, char** argv) {
+    return unittest_run_all_tests(argc, argv) ? 0 : -1;
+}
+#endif
@@ -9,6 +9,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <threads.h>
 #include <unistd.h>
 
@@ -53,6 +54,43 @@ bool socketpair_test(void) {
     END_TEST;
 }
 
+// readv() and writev() accept empty buffers and reject negative counts.
+bool socketpair_vector_test(void) {
+    BEGIN_TEST;
+
+    int fds[2];
+    int status = socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+    ASSERT_EQ(status, 0, "socketpair(AF_UNIX, SOCK_STREAM, 0, fds) failed");
+
+    char head[2] = "ab";
+    char tail[3] = "cde";
+    const struct iovec out[3] = {
+        {.iov_base = head, .iov_len = sizeof(head)},
+        {.iov_base = NULL, .iov_len = 0},
+        {.iov_base = tail, .iov_len = sizeof(tail)},
+    };
+    EXPECT_EQ(writev(fds[0], out, 3), 5, "writev failed");
+
+    char recvbuf[5];
+    struct iovec in[2] = {
+        {.iov_base = NULL, .iov_len = 0},
+        {.iov_base = recvbuf, .iov_len = sizeof(recvbuf)},
+    };
+    EXPECT_EQ(readv(fds[1], in, 2), 5, "readv failed");
+    EXPECT_EQ(memcmp(recvbuf, "abcde", 5), 0, "data did not make it after writev+readv");
+    EXPECT_EQ(in[1].iov_len, sizeof(recvbuf), "readv modified the vector");
+
+    EXPECT_EQ(writev(fds[0], out, -1), -1, "writev with a negative count succeeded");
+    EXPECT_EQ(errno, EINVAL, "");
+    EXPECT_EQ(readv(fds[1], in, -1), -1, "readv with a negative count succeeded");
+    EXPECT_EQ(errno, EINVAL, "");
+
+    EXPECT_EQ(close(fds[0]), 0, "close(fds[0]) failed");
+    EXPECT_EQ(close(fds[1]), 0, "close(fds[1]) failed");
+
+    END_TEST;
+}
+
 static_assert(EAGAIN == EWOULDBLOCK, "Assuming EAGAIN and EWOULDBLOCK have same value");
 
 bool socketpair_shutdown_setup(int fds[2]) {
@@ -399,6 +437,7 @@ bool socketpair_shutdown_peer_rd_during_send_test(void) {
 
 BEGIN_TEST_CASE(fdio_socketpair_test)
 RUN_TEST(socketpair_test);
+RUN_TEST(socketpair_vector_test);
 RUN_TEST(socketpair_shutdown_rd_test);
 RUN_TEST(socketpair_shutdown_wr_test);
 RUN_TEST(socketpair_shutdown_rdwr_test);
@@ -0,0 +1,212 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <limits.h>
+#include <string.h>
+#include <threads.h>
+
+#include <fbl/algorithm.h>
+#include <fbl/unique_ptr.h>
+#include <lib/fzl/shared-ring.h>
+#include <lib/fzl/vmo-mapper.h>
+#include <lib/zx/time.h>
+#include <unittest/unittest.h>
+
+namespace {
+
+using fzl::SharedRing;
+
+constexpr size_t kRingSize = PAGE_SIZE;
+
+// Sets up both ends of a kRingSize ring in this process.
+bool CreateRing(SharedRing* writer, SharedRing* reader, zx::vmo* vmo_out = nullptr) {
+    BEGIN_HELPER;
+
+    zx::vmo vmo;
+    zx::socket writer_socket, reader_socket;
+    ASSERT_EQ(SharedRing::Create(kRingSize, &vmo, &writer_socket, &reader_socket), ZX_OK);
+    ASSERT_EQ(writer->Init(vmo, fbl::move(writer_socket), SharedRing::Role::kWriter), ZX_OK);
+    ASSERT_EQ(reader->Init(vmo, fbl::move(reader_socket), SharedRing::Role::kReader), ZX_OK);
+    ASSERT_EQ(writer->size(), kRingSize);
+    if (vmo_out != nullptr) {
+        *vmo_out = fbl::move(vmo);
+    }
+
+    END_HELPER;
+}
+
+bool shared_ring_create_test() {
+    BEGIN_TEST;
+
+    zx::vmo vmo;
+    zx::socket writer, reader;
+    EXPECT_EQ(SharedRing::Create(0, &vmo, &writer, &reader), ZX_ERR_INVALID_ARGS);
+    EXPECT_EQ(SharedRing::Create(PAGE_SIZE + 1, &vmo, &writer, &reader), ZX_ERR_INVALID_ARGS);
+    EXPECT_EQ(SharedRing::Create(3 * PAGE_SIZE, &vmo, &writer, &reader), ZX_ERR_INVALID_ARGS);
+
+    // The VMO has to have room for the control page and a valid ring.
+    SharedRing ring;
+    ASSERT_EQ(zx::vmo::create(PAGE_SIZE, 0, &vmo), ZX_OK);
+    ASSERT_EQ(zx::socket::create(0, &writer, &reader), ZX_OK);
+    EXPECT_EQ(ring.Init(vmo, fbl::move(writer), SharedRing::Role::kWriter), ZX_ERR_INVALID_ARGS);
+
+    END_TEST;
+}
+
+bool shared_ring_write_read_test() {
+    BEGIN_TEST;
+
+    SharedRing writer, reader;
+    ASSERT_TRUE(CreateRing(&writer, &reader));
+
+    char buffer[kRingSize + 1];
+    size_t actual;
+    EXPECT_EQ(reader.Read(buffer, sizeof(buffer), &actual), ZX_ERR_SHOULD_WAIT);
+
+    // Move the positions close to the end so the next write wraps around.
+    char fill[kRingSize - 3];
+    memset(fill, 'x', sizeof(fill));
+    ASSERT_EQ(writer.Write(fill, sizeof(fill), &actual), ZX_OK);
+    ASSERT_EQ(actual, sizeof(fill));
+    ASSERT_EQ(reader.Read(buffer, sizeof(buffer), &actual), ZX_OK);
+    ASSERT_EQ(actual, sizeof(fill));
+
+    ASSERT_EQ(writer.Write("hello world", 12, &actual), ZX_OK);
+    ASSERT_EQ(actual, 12u);
+    ASSERT_EQ(reader.Read(buffer, 5, &actual), ZX_OK);
+    ASSERT_EQ(actual, 5u);
+    EXPECT_EQ(memcmp(buffer, "hello", 5), 0);
+    ASSERT_EQ(reader.Read(buffer, sizeof(buffer), &actual), ZX_OK);
+    ASSERT_EQ(actual, 7u);
+    EXPECT_EQ(memcmp(buffer, " world", 7), 0);
+
+    // Writes are short once the ring fills up.
+    char big[kRingSize + 1] = {};
+    ASSERT_EQ(writer.Write(big, sizeof(big), &actual), ZX_OK);
+    EXPECT_EQ(actual, kRingSize);
+    EXPECT_EQ(writer.Write(big, 1, &actual), ZX_ERR_SHOULD_WAIT);
+    EXPECT_EQ(writer.Wait(zx::time(0)), ZX_ERR_TIMED_OUT);
+
+    END_TEST;
+}
+
+struct WriterArgs {
+    SharedRing* ring;
+    size_t total;
+};
+
+int WriterThread(void* arg) {
+    auto args = static_cast<WriterArgs*>(arg);
+    uint8_t chunk[256];
+    size_t written = 0;
+    while (written < args->total) {
+        for (size_t i = 0; i < sizeof(chunk); ++i) {
+            chunk[i] = static_cast<uint8_t>(written + i);
+        }
+        size_t actual;
+        zx_status_t status = args->ring->Write(
+            chunk, fbl::min(sizeof(chunk), args->total - written), &actual);
+        if (status == ZX_ERR_SHOULD_WAIT) {
+            status = args->ring->Wait(zx::time::infinite());
+            if (status != ZX_OK) {
+                return status;
+            }
+            continue;
+        }
+        if (status != ZX_OK) {
+            return status;
+        }
+        written += actual;
+    }
+    return ZX_OK;
+}
+
+bool shared_ring_wait_test() {
+    BEGIN_TEST;
+
+    SharedRing writer, reader;
+    ASSERT_TRUE(CreateRing(&writer, &reader));
+
+    // Push several rings' worth through so that both ends block on each
+    // other.
+    WriterArgs args = {&writer, 8 * kRingSize + 17};
+    thrd_t thread;
+    ASSERT_EQ(thrd_create(&thread, WriterThread, &args), thrd_success);
+
+    size_t received = 0;
+    bool matched = true;
+    while (received < args.total) {
+        uint8_t buffer[100];
+        size_t actual;
+        zx_status_t status = reader.Read(buffer, sizeof(buffer), &actual);
+        if (status == ZX_ERR_SHOULD_WAIT) {
+            ASSERT_EQ(reader.Wait(zx::time::infinite()), ZX_OK);
+            continue;
+        }
+        ASSERT_EQ(status, ZX_OK);
+        for (size_t i = 0; i < actual; ++i) {
+            matched &= buffer[i] == static_cast<uint8_t>(received + i);
+        }
+        received += actual;
+    }
+    EXPECT_TRUE(matched);
+
+    int result;
+    ASSERT_EQ(thrd_join(thread, &result), thrd_success);
+    EXPECT_EQ(result, ZX_OK);
+
+    END_TEST;
+}
+
+bool shared_ring_peer_closed_test() {
+    BEGIN_TEST;
+
+    fbl::unique_ptr<SharedRing> writer(new SharedRing);
+    SharedRing reader;
+    ASSERT_TRUE(CreateRing(writer.get(), &reader));
+
+    size_t actual;
+    ASSERT_EQ(writer->Write("abc", 3, &actual), ZX_OK);
+    writer.reset();
+
+    // Data written before the writer went away can still be read.
+    char buffer[4];
+    EXPECT_EQ(reader.Wait(zx::time::infinite()), ZX_OK);
+    EXPECT_EQ(reader.Read(buffer, sizeof(buffer), &actual), ZX_OK);
+    EXPECT_EQ(actual, 3u);
+    EXPECT_EQ(reader.Wait(zx::time::infinite()), ZX_ERR_PEER_CLOSED);
+
+    END_TEST;
+}
+
+bool shared_ring_corrupt_test() {
+    BEGIN_TEST;
+
+    SharedRing writer, reader;
+    zx::vmo vmo;
+    ASSERT_TRUE(CreateRing(&writer, &reader, &vmo));
+
+    // A peer claiming to have written more than the ring holds is caught.
+    fzl::VmoMapper mapping;
+    ASSERT_EQ(mapping.Map(vmo, 0, PAGE_SIZE, ZX_VM_FLAG_PERM_READ | ZX_VM_FLAG_PERM_WRITE),
+              ZX_OK);
+    static_cast<uint64_t*>(mapping.start())[0] = kRingSize + 1;
+
+    char buffer[16];
+    size_t actual;
+    EXPECT_EQ(reader.Read(buffer, sizeof(buffer), &actual), ZX_ERR_IO_DATA_INTEGRITY);
+    EXPECT_EQ(writer.Write(buffer, sizeof(buffer), &actual), ZX_ERR_IO_DATA_INTEGRITY);
+
+    END_TEST;
+}
+
+} // namespace
+
+BEGIN_TEST_CASE(shared_ring_tests)
+RUN_NAMED_TEST("shared_ring_create", shared_ring_create_test)
+RUN_NAMED_TEST("shared_ring_write_read", shared_ring_write_read_test)
+RUN_NAMED_TEST("shared_ring_wait", shared_ring_wait_test)
+RUN_NAMED_TEST("shared_ring_peer_closed", shared_ring_peer_closed_test)
+RUN_NAMED_TEST("shared_ring_corrupt", shared_ring_corrupt_test)
+END_TEST_CASE(shared_ring_tests)
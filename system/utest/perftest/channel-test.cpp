@@ -0,0 +1,121 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <fbl/string_printf.h>
+#include <fbl/unique_ptr.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/process.h>
+#include <zircon/syscalls.h>
+
+namespace {
+
+// Measure the throughput of filling in a message of |size| bytes, writing it
+// to a channel and reading it back.  The message is written from a page
+// aligned buffer, with the given zx_channel_write() |options|.
+bool ChannelWriteReadTest(perftest::RepeatState* state, uint32_t size, uint32_t options) {
+    state->SetBytesProcessedPerRun(size);
+    state->DeclareStep("fill");
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx_handle_t channel[2];
+    ZX_ASSERT(zx_channel_create(0, &channel[0], &channel[1]) == ZX_OK);
+
+    zx_handle_t vmo;
+    ZX_ASSERT(zx_vmo_create(size, 0, &vmo) == ZX_OK);
+    uintptr_t addr;
+    ZX_ASSERT(zx_vmar_map(zx_vmar_root_self(), 0, vmo, 0, size,
+                          ZX_VM_FLAG_PERM_READ | ZX_VM_FLAG_PERM_WRITE, &addr) == ZX_OK);
+    char* src = reinterpret_cast<char*>(addr);
+    fbl::unique_ptr<char[]> dest(new char[size]);
+
+    while (state->KeepRunning()) {
+        memset(src, 0xa5, size);
+        state->NextStep();
+
+        ZX_ASSERT(zx_channel_write(channel[0], options, src, size, nullptr, 0) == ZX_OK);
+        state->NextStep();
+
+        uint32_t actual_bytes;
+        ZX_ASSERT(zx_channel_read(channel[1], 0, dest.get(), nullptr, size, 0,
+                                  &actual_bytes, nullptr) == ZX_OK);
+        ZX_ASSERT(actual_bytes == size);
+    }
+
+    ZX_ASSERT(zx_vmar_unmap(zx_vmar_root_self(), addr, size) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(vmo) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(channel[0]) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(channel[1]) == ZX_OK);
+    return true;
+}
+
+constexpr uint32_t kQueuedMessages = 64;
+constexpr uint32_t kSmallMessageSize = 64;
+
+// Measure the cost of draining |kQueuedMessages| small messages from a
+// channel using zx_channel_read_many() with the given batch size.  A batch
+// size of 1 uses zx_channel_read() instead, for comparison.
+bool ChannelReadManyTest(perftest::RepeatState* state, uint32_t batch_size) {
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx_handle_t channel[2];
+    ZX_ASSERT(zx_channel_create(0, &channel[0], &channel[1]) == ZX_OK);
+
+    char bytes[kQueuedMessages][kSmallMessageSize] = {};
+    zx_channel_read_slot_t slots[kQueuedMessages];
+    for (uint32_t i = 0; i < kQueuedMessages; ++i) {
+        slots[i] = {bytes[i], nullptr, kSmallMessageSize, 0, 0, 0};
+    }
+
+    while (state->KeepRunning()) {
+        for (uint32_t i = 0; i < kQueuedMessages; ++i) {
+            ZX_ASSERT(zx_channel_write(channel[0], 0, bytes[0], kSmallMessageSize,
+                                       nullptr, 0) == ZX_OK);
+        }
+        state->NextStep();
+
+        uint32_t received = 0;
+        while (received < kQueuedMessages) {
+            if (batch_size == 1) {
+                ZX_ASSERT(zx_channel_read(channel[1], 0, bytes[0], nullptr, kSmallMessageSize,
+                                          0, nullptr, nullptr) == ZX_OK);
+                ++received;
+            } else {
+                size_t actual;
+                ZX_ASSERT(zx_channel_read_many(channel[1], 0, slots, batch_size,
+                                               &actual) == ZX_OK);
+                received += static_cast<uint32_t>(actual);
+            }
+        }
+    }
+
+    ZX_ASSERT(zx_handle_close(channel[0]) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(channel[1]) == ZX_OK);
+    return true;
+}
+
+void RegisterTests() {
+    static const uint32_t kSizesKb[] = {16, 32, 64};
+    for (uint32_t size_kb : kSizesKb) {
+        auto name = fbl::StringPrintf("Channel/WriteRead/%uKB", size_kb);
+        perftest::RegisterTest(name.c_str(), ChannelWriteReadTest, size_kb * 1024, 0u);
+
+        name = fbl::StringPrintf("Channel/WriteRead/%uKB/TransferPages", size_kb);
+        perftest::RegisterTest(name.c_str(), ChannelWriteReadTest, size_kb * 1024,
+                               ZX_CHANNEL_WRITE_TRANSFER_PAGES);
+    }
+
+    static const uint32_t kBatchSizes[] = {1, 4, 16, 64};
+    for (uint32_t batch_size : kBatchSizes) {
+        auto name = fbl::StringPrintf("Channel/Read64Messages/Batch%u", batch_size);
+        perftest::RegisterTest(name.c_str(), ChannelReadManyTest, batch_size);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
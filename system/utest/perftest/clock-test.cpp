@@ -8,9 +8,10 @@
 namespace {
 
 // Performance test for zx_clock_get_monotonic().  This is worth
-// testing because it is a very commonly called syscall.  The kernel's
-// implementation of the syscall is non-trivial and can be rather slow on
-// some machines/VMs.
+// testing because it is a very commonly called syscall.  The vDSO
+// computes it without entering the kernel where the hardware allows,
+// and otherwise falls back to the kernel's implementation, which is
+// non-trivial and can be rather slow on some machines/VMs.
 bool ClockGetMonotonicTest() {
     zx_clock_get_monotonic();
     return true;
@@ -21,6 +22,12 @@ bool ClockGetUtcTest() {
     return true;
 }
 
+bool ClockGetNewMonotonicTest() {
+    zx_time_t time;
+    zx_clock_get_new(ZX_CLOCK_MONOTONIC, &time);
+    return true;
+}
+
 bool ClockGetThreadTest() {
     zx_clock_get(ZX_CLOCK_THREAD);
     return true;
@@ -34,6 +41,7 @@ bool TicksGetTest() {
 void RegisterTests() {
     perftest::RegisterSimpleTest<ClockGetMonotonicTest>("ClockGetMonotonic");
     perftest::RegisterSimpleTest<ClockGetUtcTest>("ClockGetUtc");
+    perftest::RegisterSimpleTest<ClockGetNewMonotonicTest>("ClockGetNewMonotonic");
     perftest::RegisterSimpleTest<ClockGetThreadTest>("ClockGetThread");
     perftest::RegisterSimpleTest<TicksGetTest>("TicksGet");
 }
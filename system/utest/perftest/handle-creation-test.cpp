@@ -13,6 +13,8 @@
 #include <lib/zx/vmar.h>
 #include <perftest/perftest.h>
 
+#include "thread-scaling.h"
+
 namespace {
 
 // These tests measure the times taken to create and close various types of
@@ -126,6 +128,26 @@ bool VmoCreateTest(perftest::RepeatState* state) {
     return true;
 }
 
+// Measures creating and closing an event while |thread_count| - 1 other
+// threads do the same, to show whether handle creation scales across CPUs
+// or serializes in the kernel.
+bool EventCreateContendedTest(perftest::RepeatState* state, uint32_t thread_count) {
+    state->DeclareStep("create");
+    state->DeclareStep("close");
+
+    thread_scaling::BackgroundThreads background(thread_count, [](uint32_t) {
+        zx::event handle;
+        ZX_ASSERT(zx::event::create(0, &handle) == ZX_OK);
+    });
+
+    while (state->KeepRunning()) {
+        zx::event handle;
+        ZX_ASSERT(zx::event::create(0, &handle) == ZX_OK);
+        state->NextStep();
+    }
+    return true;
+}
+
 void RegisterTests() {
     perftest::RegisterTest("HandleCreate_Channel", ChannelCreateTest);
     perftest::RegisterTest("HandleCreate_Event", EventCreateTest);
@@ -135,6 +157,7 @@ void RegisterTests() {
     perftest::RegisterTest("HandleCreate_Process", ProcessCreateTest);
     perftest::RegisterTest("HandleCreate_Thread", ThreadCreateTest);
     perftest::RegisterTest("HandleCreate_Vmo", VmoCreateTest);
+    thread_scaling::RegisterTests("HandleCreate_Event", EventCreateContendedTest);
 }
 PERFTEST_CTOR(RegisterTests);
 
@@ -5,6 +5,9 @@
 #include <threads.h>
 
 #include <perftest/perftest.h>
+#include <zircon/syscalls.h>
+
+#include "thread-scaling.h"
 
 namespace {
 
@@ -24,8 +27,37 @@ bool MutexLockUnlockTest(perftest::RepeatState* state) {
     return true;
 }
 
+// Each thread's futex sits in its own cache line, so that the threads only
+// share state inside the kernel.
+struct alignas(64) PaddedFutex {
+    zx_futex_t value = 0;
+};
+
+// The futex operations that a contended mutex makes, minus the blocking:
+// a wait that finds the value changed, and a wake with no waiters.
+void FutexWaitWake(zx_futex_t* futex) {
+    ZX_ASSERT(zx_futex_wait(futex, 1, ZX_TIME_INFINITE) == ZX_ERR_BAD_STATE);
+    ZX_ASSERT(zx_futex_wake(futex, 1) == ZX_OK);
+}
+
+// Measures futex wait and wake calls on a private futex while
+// |thread_count| - 1 other threads do the same on their own futexes, to
+// show whether the kernel's futex table serializes unrelated futexes.
+bool FutexManyTest(perftest::RepeatState* state, uint32_t thread_count) {
+    PaddedFutex futexes[thread_scaling::kMaxThreads];
+    thread_scaling::BackgroundThreads background(thread_count, [&futexes](uint32_t index) {
+        FutexWaitWake(&futexes[index].value);
+    });
+
+    while (state->KeepRunning()) {
+        FutexWaitWake(&futexes[0].value);
+    }
+    return true;
+}
+
 void RegisterTests() {
     perftest::RegisterTest("MutexLockUnlock", MutexLockUnlockTest);
+    thread_scaling::RegisterTests("Futex_Many", FutexManyTest);
 }
 PERFTEST_CTOR(RegisterTests);
 
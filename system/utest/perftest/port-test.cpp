@@ -0,0 +1,63 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/port.h>
+
+namespace {
+
+constexpr uint32_t kPacketCount = 64;
+
+void QueuePackets(zx_handle_t port) {
+    const zx_port_packet_t packet = {1, ZX_PKT_TYPE_USER, 0, {{}}};
+    for (uint32_t i = 0; i < kPacketCount; ++i) {
+        ZX_ASSERT(zx_port_queue(port, &packet) == ZX_OK);
+    }
+}
+
+// Measure the cost of draining |kPacketCount| packets from a port using
+// zx_port_wait_many() with the given batch size.  A batch size of 1 uses
+// zx_port_wait() instead, for comparison.
+bool PortWaitTest(perftest::RepeatState* state, uint32_t batch_size) {
+    state->DeclareStep("queue");
+    state->DeclareStep("dequeue");
+
+    zx_handle_t port;
+    ZX_ASSERT(zx_port_create(0, &port) == ZX_OK);
+
+    zx_port_packet_t packets[kPacketCount];
+    while (state->KeepRunning()) {
+        QueuePackets(port);
+        state->NextStep();
+
+        uint32_t received = 0;
+        while (received < kPacketCount) {
+            if (batch_size == 1) {
+                ZX_ASSERT(zx_port_wait(port, 0, &packets[0]) == ZX_OK);
+                ++received;
+            } else {
+                size_t actual;
+                ZX_ASSERT(zx_port_wait_many(port, 0, packets, batch_size, &actual) == ZX_OK);
+                received += static_cast<uint32_t>(actual);
+            }
+        }
+    }
+
+    ZX_ASSERT(zx_handle_close(port) == ZX_OK);
+    return true;
+}
+
+void RegisterTests() {
+    static const uint32_t kBatchSizes[] = {1, 4, 16, 64};
+    for (uint32_t batch_size : kBatchSizes) {
+        auto name = fbl::StringPrintf("Port/Wait64Packets/Batch%u", batch_size);
+        perftest::RegisterTest(name.c_str(), PortWaitTest, batch_size);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
@@ -5,6 +5,7 @@
 #include <dlfcn.h>
 #include <limits.h>
 #include <launchpad/launchpad.h>
+#include <lib/fdio/spawn.h>
 #include <perftest/perftest.h>
 #include <zircon/assert.h>
 #include <zircon/process.h>
@@ -15,6 +16,10 @@ namespace {
 constexpr char pname[] = "benchmark-process";
 constexpr char tname[] = "benchmark-thread";
 
+// A dynamically linked program that exits as soon as it starts when given
+// no arguments.
+constexpr char kSpawnChild[] = "/boot/bin/spawn-child";
+
 // Computes the stack pointer. Modeled after zircon/stack.h.
 uintptr_t compute_stack_pointer(uintptr_t stack_base, size_t stack_size) {
     uintptr_t sp = stack_base + stack_size;
@@ -197,8 +202,93 @@ bool StartTest(perftest::RepeatState* state) {
     return true;
 }
 
+// This benchmark measures spawning a dynamically linked process, which maps
+// ld.so, libc and the vDSO, and waiting for it to exit.
+bool SpawnTest(perftest::RepeatState* state) {
+    state->DeclareStep("spawn");
+    state->DeclareStep("wait");
+    state->DeclareStep("close");
+
+    const char* const argv[] = {kSpawnChild, nullptr};
+    while (state->KeepRunning()) {
+        zx_handle_t process;
+        ZX_ASSERT(fdio_spawn(ZX_HANDLE_INVALID, FDIO_SPAWN_CLONE_ALL, kSpawnChild, argv,
+                             &process) == ZX_OK);
+        state->NextStep();
+        ZX_ASSERT(zx_object_wait_one(process, ZX_TASK_TERMINATED, ZX_TIME_INFINITE, NULL) ==
+                  ZX_OK);
+        state->NextStep();
+        ZX_ASSERT(zx_handle_close(process) == ZX_OK);
+    }
+    return true;
+}
+
+// This benchmark measures the same thing as SpawnTest, but loads the
+// process in this one using launchpad rather than asking the process
+// launcher service to do it.
+bool LaunchpadTest(perftest::RepeatState* state) {
+    state->DeclareStep("launch");
+    state->DeclareStep("wait");
+    state->DeclareStep("close");
+
+    const char* const argv[] = {kSpawnChild};
+    while (state->KeepRunning()) {
+        launchpad_t* lp;
+        launchpad_create(ZX_HANDLE_INVALID, kSpawnChild, &lp);
+        launchpad_load_from_file(lp, kSpawnChild);
+        launchpad_set_args(lp, 1, argv);
+        launchpad_clone(lp, LP_CLONE_ALL);
+        zx_handle_t process;
+        ZX_ASSERT(launchpad_go(lp, &process, NULL) == ZX_OK);
+        state->NextStep();
+        ZX_ASSERT(zx_object_wait_one(process, ZX_TASK_TERMINATED, ZX_TIME_INFINITE, NULL) ==
+                  ZX_OK);
+        state->NextStep();
+        ZX_ASSERT(zx_handle_close(process) == ZX_OK);
+    }
+    return true;
+}
+
+// This benchmark measures mapping a clone of resident, read-only code the way
+// the ELF loaders do and then touching each of its pages, either by taking a
+// fault on each page or by mapping them in up front with
+// ZX_VM_FLAG_MAP_RANGE.
+bool MapSharedCodeTest(perftest::RepeatState* state, uint32_t map_flags) {
+    state->DeclareStep("map");
+    state->DeclareStep("touch");
+    state->DeclareStep("unmap");
+
+    constexpr size_t kSize = 64 * PAGE_SIZE;
+    zx_handle_t vmo;
+    ZX_ASSERT(zx_vmo_create(kSize, 0, &vmo) == ZX_OK);
+    ZX_ASSERT(zx_vmo_op_range(vmo, ZX_VMO_OP_COMMIT, 0, kSize, nullptr, 0) == ZX_OK);
+    zx_handle_t clone;
+    ZX_ASSERT(zx_vmo_clone(vmo, ZX_VMO_CLONE_COPY_ON_WRITE, 0, kSize, &clone) == ZX_OK);
+
+    while (state->KeepRunning()) {
+        uintptr_t addr;
+        ZX_ASSERT(zx_vmar_map(zx_vmar_root_self(), 0, clone, 0, kSize,
+                              ZX_VM_FLAG_PERM_READ | map_flags, &addr) == ZX_OK);
+        state->NextStep();
+        for (size_t offset = 0; offset < kSize; offset += PAGE_SIZE) {
+            (void)*reinterpret_cast<volatile uint8_t*>(addr + offset);
+        }
+        state->NextStep();
+        ZX_ASSERT(zx_vmar_unmap(zx_vmar_root_self(), addr, kSize) == ZX_OK);
+    }
+
+    ZX_ASSERT(zx_handle_close(clone) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(vmo) == ZX_OK);
+    return true;
+}
+
 void RegisterTests() {
     perftest::RegisterTest("Process/Start", StartTest);
+    perftest::RegisterTest("Process/Spawn", SpawnTest);
+    perftest::RegisterTest("Process/Launchpad", LaunchpadTest);
+    perftest::RegisterTest("Process/MapSharedCode/Faulting", MapSharedCodeTest, 0u);
+    perftest::RegisterTest("Process/MapSharedCode/MapRange", MapSharedCodeTest,
+                           ZX_VM_FLAG_MAP_RANGE);
 }
 PERFTEST_CTOR(RegisterTests);
 
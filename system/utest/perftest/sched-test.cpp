@@ -0,0 +1,123 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <threads.h>
+
+#include <fbl/atomic.h>
+#include <fbl/string_printf.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+
+namespace {
+
+constexpr uint32_t kMaxThreads = 16;
+
+// The CPU-bound work of one slice.  This counts loop iterations rather than
+// time so that a thread that waits in a run queue takes longer to finish.
+constexpr uint32_t kSliceIterations = 20000;
+
+void Spin(uint32_t slices) {
+    volatile uint32_t sink = 0;
+    for (uint32_t i = 0; i < slices * kSliceIterations; i++) {
+        sink = sink + i;
+    }
+}
+
+enum class Load {
+    // Every worker gets one slice.
+    kEven,
+    // Worker i gets 1 + i % 4 slices, so CPUs run out of work at different
+    // times while others still have threads queued.
+    kUneven,
+};
+
+struct LoadgenState {
+    // Bumped by the controller to start a run.
+    zx_futex_t generation = 0;
+    // Counts down as workers finish their run.
+    fbl::atomic<int32_t> remaining;
+    zx_futex_t done = 0;
+    fbl::atomic<bool> stop;
+};
+
+struct WorkerArgs {
+    LoadgenState* state;
+    uint32_t slices;
+};
+
+int Worker(void* arg) {
+    auto* args = static_cast<WorkerArgs*>(arg);
+    LoadgenState* state = args->state;
+    int32_t seen = 0;
+    for (;;) {
+        while (state->generation == seen) {
+            zx_status_t status = zx_futex_wait(&state->generation, seen, ZX_TIME_INFINITE);
+            ZX_ASSERT(status == ZX_OK || status == ZX_ERR_BAD_STATE);
+        }
+        seen = state->generation;
+        if (state->stop.load()) {
+            return 0;
+        }
+
+        Spin(args->slices);
+
+        if (state->remaining.fetch_sub(1) == 1) {
+            state->done = 1;
+            ZX_ASSERT(zx_futex_wake(&state->done, 1) == ZX_OK);
+        }
+    }
+}
+
+// A fork/join loop in the style of loadgen: each run hands every worker its
+// slices of CPU-bound work and waits for all of them to finish.  A run takes
+// as long as the most loaded CPU, so the run times, and their tail in
+// particular, show how well the scheduler spreads |thread_count| runnable
+// threads over the CPUs.
+bool LoadgenTest(perftest::RepeatState* state, uint32_t thread_count, Load load) {
+    ZX_ASSERT(thread_count >= 1 && thread_count <= kMaxThreads);
+
+    LoadgenState loadgen;
+    loadgen.remaining.store(0);
+    loadgen.stop.store(false);
+    WorkerArgs args[kMaxThreads];
+    thrd_t threads[kMaxThreads];
+    for (uint32_t i = 0; i < thread_count; i++) {
+        args[i] = {&loadgen, load == Load::kEven ? 1 : 1 + i % 4};
+        ZX_ASSERT(thrd_create(&threads[i], Worker, &args[i]) == thrd_success);
+    }
+
+    while (state->KeepRunning()) {
+        loadgen.done = 0;
+        loadgen.remaining.store(static_cast<int32_t>(thread_count));
+        __atomic_fetch_add(&loadgen.generation, 1, __ATOMIC_SEQ_CST);
+        ZX_ASSERT(zx_futex_wake(&loadgen.generation, UINT32_MAX) == ZX_OK);
+
+        while (loadgen.done == 0) {
+            zx_status_t status = zx_futex_wait(&loadgen.done, 0, ZX_TIME_INFINITE);
+            ZX_ASSERT(status == ZX_OK || status == ZX_ERR_BAD_STATE);
+        }
+    }
+
+    loadgen.stop.store(true);
+    __atomic_fetch_add(&loadgen.generation, 1, __ATOMIC_SEQ_CST);
+    ZX_ASSERT(zx_futex_wake(&loadgen.generation, UINT32_MAX) == ZX_OK);
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ZX_ASSERT(thrd_join(threads[i], nullptr) == thrd_success);
+    }
+    return true;
+}
+
+void RegisterTests() {
+    for (uint32_t thread_count = 1; thread_count <= kMaxThreads; thread_count *= 2) {
+        auto name = fbl::StringPrintf("Sched/Loadgen/Even/%uThreads", thread_count);
+        perftest::RegisterTest(name.c_str(), LoadgenTest, thread_count, Load::kEven);
+
+        name = fbl::StringPrintf("Sched/Loadgen/Uneven/%uThreads", thread_count);
+        perftest::RegisterTest(name.c_str(), LoadgenTest, thread_count, Load::kUneven);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
@@ -0,0 +1,210 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <fbl/algorithm.h>
+#include <fbl/string_printf.h>
+#include <fbl/unique_ptr.h>
+#include <lib/fzl/shared-ring.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+
+namespace {
+
+// Measure the throughput of writing |size| bytes to a stream socket and
+// reading them back.
+bool SocketWriteReadTest(perftest::RepeatState* state, uint32_t size) {
+    state->SetBytesProcessedPerRun(size);
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx_handle_t socket[2];
+    ZX_ASSERT(zx_socket_create(0, &socket[0], &socket[1]) == ZX_OK);
+
+    fbl::unique_ptr<char[]> src(new char[size]);
+    fbl::unique_ptr<char[]> dest(new char[size]);
+    memset(src.get(), 0xa5, size);
+
+    while (state->KeepRunning()) {
+        size_t actual;
+        ZX_ASSERT(zx_socket_write(socket[0], 0, src.get(), size, &actual) == ZX_OK);
+        ZX_ASSERT(actual == size);
+        state->NextStep();
+
+        ZX_ASSERT(zx_socket_read(socket[1], 0, dest.get(), size, &actual) == ZX_OK);
+        ZX_ASSERT(actual == size);
+    }
+
+    ZX_ASSERT(zx_handle_close(socket[0]) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(socket[1]) == ZX_OK);
+    return true;
+}
+
+constexpr uint32_t kHeaderSize = 16;
+
+enum class HeaderMode {
+    // Assemble the header and payload in one buffer and write it.
+    kCopy,
+    // Write the header and the payload with separate calls.
+    kTwoWrites,
+    // Write both with one zx_socket_writev().
+    kWritev,
+};
+
+// Measure the cost of sending a |kHeaderSize| byte header followed by a
+// |size| byte payload over a stream socket, the way a framed protocol would.
+bool SocketHeaderPayloadTest(perftest::RepeatState* state, uint32_t size, HeaderMode mode) {
+    state->SetBytesProcessedPerRun(kHeaderSize + size);
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx_handle_t socket[2];
+    ZX_ASSERT(zx_socket_create(0, &socket[0], &socket[1]) == ZX_OK);
+
+    char header[kHeaderSize] = {};
+    fbl::unique_ptr<char[]> payload(new char[size]);
+    fbl::unique_ptr<char[]> frame(new char[kHeaderSize + size]);
+    fbl::unique_ptr<char[]> dest(new char[kHeaderSize + size]);
+    memset(payload.get(), 0xa5, size);
+
+    while (state->KeepRunning()) {
+        size_t actual;
+        switch (mode) {
+        case HeaderMode::kCopy:
+            memcpy(frame.get(), header, kHeaderSize);
+            memcpy(frame.get() + kHeaderSize, payload.get(), size);
+            ZX_ASSERT(zx_socket_write(socket[0], 0, frame.get(), kHeaderSize + size,
+                                      &actual) == ZX_OK);
+            ZX_ASSERT(actual == kHeaderSize + size);
+            break;
+        case HeaderMode::kTwoWrites:
+            ZX_ASSERT(zx_socket_write(socket[0], 0, header, kHeaderSize, &actual) == ZX_OK);
+            ZX_ASSERT(zx_socket_write(socket[0], 0, payload.get(), size, &actual) == ZX_OK);
+            ZX_ASSERT(actual == size);
+            break;
+        case HeaderMode::kWritev: {
+            zx_iovec_t vector[] = {
+                {header, kHeaderSize},
+                {payload.get(), size},
+            };
+            ZX_ASSERT(zx_socket_writev(socket[0], 0, vector, countof(vector),
+                                       &actual) == ZX_OK);
+            ZX_ASSERT(actual == kHeaderSize + size);
+            break;
+        }
+        }
+        state->NextStep();
+
+        ZX_ASSERT(zx_socket_read(socket[1], 0, dest.get(), kHeaderSize + size,
+                                 &actual) == ZX_OK);
+        ZX_ASSERT(actual == kHeaderSize + size);
+    }
+
+    ZX_ASSERT(zx_handle_close(socket[0]) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(socket[1]) == ZX_OK);
+    return true;
+}
+
+enum class StreamMode {
+    // A socket with the default buffer limit.
+    kDefault,
+    // A socket whose receive buffer has been raised to hold the whole
+    // transfer.
+    kLargeBuffer,
+    // A fzl::SharedRing big enough for the whole transfer.
+    kSharedRing,
+};
+
+// Measure moving |size| bytes through a stream from a single thread, writing
+// as much as fits and then draining it until everything has gone through.
+bool StreamTest(perftest::RepeatState* state, uint32_t size, StreamMode mode) {
+    state->SetBytesProcessedPerRun(size);
+
+    fbl::unique_ptr<char[]> src(new char[size]);
+    fbl::unique_ptr<char[]> dest(new char[size]);
+    memset(src.get(), 0xa5, size);
+
+    zx_handle_t socket[2];
+    ZX_ASSERT(zx_socket_create(0, &socket[0], &socket[1]) == ZX_OK);
+    if (mode == StreamMode::kLargeBuffer) {
+        size_t max;
+        ZX_ASSERT(zx_object_get_property(socket[1], ZX_PROP_SOCKET_RX_BUF_MAX,
+                                         &max, sizeof(max)) == ZX_OK);
+        max = fbl::max<size_t>(max, size);
+        ZX_ASSERT(zx_object_set_property(socket[1], ZX_PROP_SOCKET_RX_BUF_MAX,
+                                         &max, sizeof(max)) == ZX_OK);
+    }
+
+    fzl::SharedRing writer, reader;
+    if (mode == StreamMode::kSharedRing) {
+        zx::vmo vmo;
+        zx::socket writer_socket, reader_socket;
+        ZX_ASSERT(fzl::SharedRing::Create(size, &vmo, &writer_socket,
+                                          &reader_socket) == ZX_OK);
+        ZX_ASSERT(writer.Init(vmo, fbl::move(writer_socket),
+                              fzl::SharedRing::Role::kWriter) == ZX_OK);
+        ZX_ASSERT(reader.Init(vmo, fbl::move(reader_socket),
+                              fzl::SharedRing::Role::kReader) == ZX_OK);
+    }
+
+    while (state->KeepRunning()) {
+        size_t written = 0;
+        size_t read = 0;
+        while (read < size) {
+            size_t actual;
+            zx_status_t status;
+            if (written < size) {
+                status = mode == StreamMode::kSharedRing
+                    ? writer.Write(src.get() + written, size - written, &actual)
+                    : zx_socket_write(socket[0], 0, src.get() + written, size - written,
+                                      &actual);
+                ZX_ASSERT(status == ZX_OK || status == ZX_ERR_SHOULD_WAIT);
+                if (status == ZX_OK) {
+                    written += actual;
+                }
+            }
+            status = mode == StreamMode::kSharedRing
+                ? reader.Read(dest.get() + read, size - read, &actual)
+                : zx_socket_read(socket[1], 0, dest.get() + read, size - read, &actual);
+            ZX_ASSERT(status == ZX_OK);
+            read += actual;
+        }
+    }
+
+    ZX_ASSERT(zx_handle_close(socket[0]) == ZX_OK);
+    ZX_ASSERT(zx_handle_close(socket[1]) == ZX_OK);
+    return true;
+}
+
+void RegisterTests() {
+    static const uint32_t kSizes[] = {64, 1024, 32768};
+    for (uint32_t size : kSizes) {
+        auto name = fbl::StringPrintf("Socket/WriteRead/%ubytes", size);
+        perftest::RegisterTest(name.c_str(), SocketWriteReadTest, size);
+
+        name = fbl::StringPrintf("Socket/HeaderPayload/%ubytes/Copy", size);
+        perftest::RegisterTest(name.c_str(), SocketHeaderPayloadTest, size, HeaderMode::kCopy);
+        name = fbl::StringPrintf("Socket/HeaderPayload/%ubytes/TwoWrites", size);
+        perftest::RegisterTest(name.c_str(), SocketHeaderPayloadTest, size,
+                               HeaderMode::kTwoWrites);
+        name = fbl::StringPrintf("Socket/HeaderPayload/%ubytes/Writev", size);
+        perftest::RegisterTest(name.c_str(), SocketHeaderPayloadTest, size,
+                               HeaderMode::kWritev);
+    }
+
+    static const uint32_t kStreamSizes[] = {65536, 1048576};
+    for (uint32_t size : kStreamSizes) {
+        auto name = fbl::StringPrintf("Socket/Stream/%ubytes/Default", size);
+        perftest::RegisterTest(name.c_str(), StreamTest, size, StreamMode::kDefault);
+        name = fbl::StringPrintf("Socket/Stream/%ubytes/LargeBuffer", size);
+        perftest::RegisterTest(name.c_str(), StreamTest, size, StreamMode::kLargeBuffer);
+        name = fbl::StringPrintf("Socket/Stream/%ubytes/SharedRing", size);
+        perftest::RegisterTest(name.c_str(), StreamTest, size, StreamMode::kSharedRing);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
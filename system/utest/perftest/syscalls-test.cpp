@@ -2,9 +2,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <fbl/string_printf.h>
 #include <perftest/perftest.h>
 #include <zircon/assert.h>
 #include <zircon/syscalls.h>
+#include <zircon/syscalls/batch-numbers.h>
 
 namespace {
 
@@ -18,9 +20,40 @@ bool SyscallManyArgsTest() {
     return true;
 }
 
+// Makes |count| null syscalls, either one at a time or with a single
+// zx_syscall_batch() call, to compare the per-call cost of the two.
+bool SyscallNullManyTest(perftest::RepeatState* state, uint32_t count, bool batch) {
+    zx_syscall_call_t calls[ZX_SYSCALL_BATCH_MAX] = {};
+    for (auto& call : calls) {
+        call.num = ZX_BATCH_syscall_test_0;
+    }
+
+    while (state->KeepRunning()) {
+        if (batch) {
+            size_t completed;
+            ZX_ASSERT(zx_syscall_batch(0, calls, count, &completed) == ZX_OK);
+            ZX_ASSERT(completed == count);
+        } else {
+            for (uint32_t i = 0; i < count; ++i) {
+                ZX_ASSERT(zx_syscall_test_0() == 0);
+            }
+        }
+    }
+    return true;
+}
+
 void RegisterTests() {
     perftest::RegisterSimpleTest<SyscallNullTest>("Syscall/Null");
     perftest::RegisterSimpleTest<SyscallManyArgsTest>("Syscall/ManyArgs");
+
+    static const uint32_t kCounts[] = {1, 8, 64};
+    for (uint32_t count : kCounts) {
+        auto name = fbl::StringPrintf("Syscall/NullLoop/%ucalls", count);
+        perftest::RegisterTest(name.c_str(), SyscallNullManyTest, count, false);
+
+        name = fbl::StringPrintf("Syscall/NullBatch/%ucalls", count);
+        perftest::RegisterTest(name.c_str(), SyscallNullManyTest, count, true);
+    }
 }
 PERFTEST_CTOR(RegisterTests);
 
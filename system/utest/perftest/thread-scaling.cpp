@@ -0,0 +1,51 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "thread-scaling.h"
+
+#include <fbl/string_printf.h>
+#include <zircon/assert.h>
+
+namespace thread_scaling {
+
+void RegisterTests(const char* name, ScalingTestFunc* test_func) {
+    for (uint32_t thread_count = 1; thread_count <= kMaxThreads; thread_count *= 2) {
+        auto test_name = fbl::StringPrintf("%s/%uThreads", name, thread_count);
+        perftest::RegisterTest(test_name.c_str(), test_func, thread_count);
+    }
+}
+
+BackgroundThreads::BackgroundThreads(uint32_t thread_count,
+                                     fbl::Function<void(uint32_t index)> body)
+    : body_(fbl::move(body)), stop_(false), thread_count_(thread_count) {
+    ZX_ASSERT(thread_count >= 1 && thread_count <= kMaxThreads);
+    for (uint32_t i = 1; i < thread_count_; i++) {
+        args_[i] = {this, i};
+        ZX_ASSERT(thrd_create(&threads_[i], ThreadFunc, &args_[i]) == thrd_success);
+    }
+}
+
+BackgroundThreads::~BackgroundThreads() {
+    Stop();
+}
+
+void BackgroundThreads::Stop() {
+    if (joined_)
+        return;
+    stop_.store(true);
+    for (uint32_t i = 1; i < thread_count_; i++) {
+        ZX_ASSERT(thrd_join(threads_[i], nullptr) == thrd_success);
+    }
+    joined_ = true;
+}
+
+int BackgroundThreads::ThreadFunc(void* arg) {
+    auto* args = static_cast<ThreadArgs*>(arg);
+    while (!args->self->stop_.load()) {
+        args->self->body_(args->index);
+    }
+    return 0;
+}
+
+}  // namespace thread_scaling
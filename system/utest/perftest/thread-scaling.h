@@ -0,0 +1,56 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <threads.h>
+
+#include <fbl/atomic.h>
+#include <fbl/function.h>
+#include <fbl/macros.h>
+#include <perftest/perftest.h>
+
+// Helpers for tests that measure how an operation scales with the number of
+// threads doing it at once.  The test thread runs the measured loop while
+// |thread_count| - 1 background threads repeat the same kind of work.
+namespace thread_scaling {
+
+constexpr uint32_t kMaxThreads = 8;
+
+typedef bool ScalingTestFunc(perftest::RepeatState* state, uint32_t thread_count);
+
+// Registers |test_func| as "<name>/<N>Threads" for N = 1, 2, 4, ... up to
+// kMaxThreads.
+void RegisterTests(const char* name, ScalingTestFunc* test_func);
+
+// Runs |body| in a loop on |thread_count| - 1 threads until Stop() is called
+// or the object is destroyed.  Each thread passes its own index, from 1 up,
+// so that index 0 is left for the test thread.
+class BackgroundThreads {
+public:
+    BackgroundThreads(uint32_t thread_count, fbl::Function<void(uint32_t index)> body);
+    ~BackgroundThreads();
+
+    // Stops and joins the threads.
+    void Stop();
+
+    DISALLOW_COPY_ASSIGN_AND_MOVE(BackgroundThreads);
+
+private:
+    struct ThreadArgs {
+        BackgroundThreads* self;
+        uint32_t index;
+    };
+
+    static int ThreadFunc(void* arg);
+
+    const fbl::Function<void(uint32_t)> body_;
+    fbl::atomic<bool> stop_;
+    uint32_t thread_count_;
+    bool joined_ = false;
+    ThreadArgs args_[kMaxThreads];
+    thrd_t threads_[kMaxThreads];
+};
+
+}  // namespace thread_scaling
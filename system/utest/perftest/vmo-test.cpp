@@ -0,0 +1,49 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <fbl/string_printf.h>
+#include <fbl/unique_ptr.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+
+namespace {
+
+// Measure the time taken to write |size| bytes to a VMO and read them back.
+// The VMO's pages are committed up front, so this mostly measures the
+// kernel's copies to and from user memory.
+bool VmoWriteReadTest(perftest::RepeatState* state, uint32_t size) {
+    state->SetBytesProcessedPerRun(size);
+    state->DeclareStep("write");
+    state->DeclareStep("read");
+
+    zx_handle_t vmo;
+    ZX_ASSERT(zx_vmo_create(size, 0, &vmo) == ZX_OK);
+    ZX_ASSERT(zx_vmo_op_range(vmo, ZX_VMO_OP_COMMIT, 0, size, nullptr, 0) == ZX_OK);
+
+    fbl::unique_ptr<char[]> buffer(new char[size]);
+    memset(buffer.get(), 0xa5, size);
+
+    while (state->KeepRunning()) {
+        ZX_ASSERT(zx_vmo_write(vmo, buffer.get(), 0, size) == ZX_OK);
+        state->NextStep();
+        ZX_ASSERT(zx_vmo_read(vmo, buffer.get(), 0, size) == ZX_OK);
+    }
+
+    ZX_ASSERT(zx_handle_close(vmo) == ZX_OK);
+    return true;
+}
+
+void RegisterTests() {
+    static const uint32_t kSizes[] = {8, 32, 64, 256, 1024, 4096, 32768, 262144};
+    for (uint32_t size : kSizes) {
+        auto name = fbl::StringPrintf("Vmo/WriteRead/%ubytes", size);
+        perftest::RegisterTest(name.c_str(), VmoWriteReadTest, size);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
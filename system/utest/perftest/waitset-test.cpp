@@ -0,0 +1,123 @@
+// Copyright 2018 The Fuchsia Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fbl/string_printf.h>
+#include <fbl/vector.h>
+#include <perftest/perftest.h>
+#include <zircon/assert.h>
+#include <zircon/syscalls.h>
+#include <zircon/syscalls/port.h>
+
+namespace {
+
+enum class Waiter { kWaitMany, kPort, kWaitSet };
+
+// Measure the cost of finding the one ready handle out of |count| idle ones,
+// as a server with many mostly-quiet clients does.  Each iteration signals
+// the next event, waits for it with |waiter| and clears it again.
+//
+// zx_object_wait_many() registers a waiter on every handle on each call.
+// A port only wakes for the ready handle, but its one-shot wait has to be
+// re-armed after every wake-up.  A wait set registers each handle once.
+bool WaitTest(perftest::RepeatState* state, uint32_t count, Waiter waiter) {
+    fbl::Vector<zx_handle_t> events;
+    fbl::Vector<zx_wait_item_t> items;
+    for (uint32_t i = 0; i < count; ++i) {
+        zx_handle_t event;
+        ZX_ASSERT(zx_event_create(0, &event) == ZX_OK);
+        events.push_back(event);
+        items.push_back({event, ZX_USER_SIGNAL_0, 0});
+    }
+
+    zx_handle_t port = ZX_HANDLE_INVALID;
+    zx_handle_t wait_set = ZX_HANDLE_INVALID;
+    switch (waiter) {
+    case Waiter::kWaitMany:
+        ZX_ASSERT(count <= ZX_WAIT_MANY_MAX_ITEMS);
+        break;
+    case Waiter::kPort:
+        ZX_ASSERT(zx_port_create(0, &port) == ZX_OK);
+        for (uint32_t i = 0; i < count; ++i) {
+            ZX_ASSERT(zx_object_wait_async(events[i], port, i, ZX_USER_SIGNAL_0,
+                                           ZX_WAIT_ASYNC_ONCE) == ZX_OK);
+        }
+        break;
+    case Waiter::kWaitSet:
+        ZX_ASSERT(zx_waitset_create(0, &wait_set) == ZX_OK);
+        for (uint32_t i = 0; i < count; ++i) {
+            ZX_ASSERT(zx_waitset_add(wait_set, i, events[i], ZX_USER_SIGNAL_0) == ZX_OK);
+        }
+        break;
+    }
+
+    uint32_t next = 0;
+    while (state->KeepRunning()) {
+        const uint32_t index = next;
+        next = (next + 1) % count;
+        ZX_ASSERT(zx_object_signal(events[index], 0, ZX_USER_SIGNAL_0) == ZX_OK);
+
+        uint64_t ready;
+        switch (waiter) {
+        case Waiter::kWaitMany: {
+            ZX_ASSERT(zx_object_wait_many(items.get(), count, ZX_TIME_INFINITE) == ZX_OK);
+            ready = count;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (items[i].pending & ZX_USER_SIGNAL_0) {
+                    ready = i;
+                    break;
+                }
+            }
+            break;
+        }
+        case Waiter::kPort: {
+            zx_port_packet_t packet;
+            ZX_ASSERT(zx_port_wait(port, ZX_TIME_INFINITE, &packet) == ZX_OK);
+            ready = packet.key;
+            break;
+        }
+        case Waiter::kWaitSet: {
+            zx_waitset_result_t result;
+            ZX_ASSERT(zx_waitset_wait(wait_set, ZX_TIME_INFINITE, &result, 1, nullptr) == ZX_OK);
+            ready = result.cookie;
+            break;
+        }
+        }
+        ZX_ASSERT(ready == index);
+
+        ZX_ASSERT(zx_object_signal(events[index], ZX_USER_SIGNAL_0, 0) == ZX_OK);
+        if (waiter == Waiter::kPort) {
+            ZX_ASSERT(zx_object_wait_async(events[index], port, index, ZX_USER_SIGNAL_0,
+                                           ZX_WAIT_ASYNC_ONCE) == ZX_OK);
+        }
+    }
+
+    if (port != ZX_HANDLE_INVALID) {
+        ZX_ASSERT(zx_handle_close(port) == ZX_OK);
+    }
+    if (wait_set != ZX_HANDLE_INVALID) {
+        ZX_ASSERT(zx_handle_close(wait_set) == ZX_OK);
+    }
+    ZX_ASSERT(zx_handle_close_many(events.get(), events.size()) == ZX_OK);
+    return true;
+}
+
+void RegisterTests() {
+    static const uint32_t kCounts[] = {8, 64, 512};
+    for (uint32_t count : kCounts) {
+        // zx_object_wait_many() can't take more than ZX_WAIT_MANY_MAX_ITEMS.
+        if (count <= ZX_WAIT_MANY_MAX_ITEMS) {
+            auto name = fbl::StringPrintf("WaitSet/WaitManyBaseline/%uhandles", count);
+            perftest::RegisterTest(name.c_str(), WaitTest, count, Waiter::kWaitMany);
+        }
+
+        auto name = fbl::StringPrintf("WaitSet/PortBaseline/%uhandles", count);
+        perftest::RegisterTest(name.c_str(), WaitTest, count, Waiter::kPort);
+
+        name = fbl::StringPrintf("WaitSet/Wait/%uhandles", count);
+        perftest::RegisterTest(name.c_str(), WaitTest, count, Waiter::kWaitSet);
+    }
+}
+PERFTEST_CTOR(RegisterTests);
+
+}  // namespace
@@ -274,6 +274,77 @@ static bool socket_buffer_test(void) {
     END_TEST;
 }
 
+static bool socket_buffer_max_test(void) {
+    BEGIN_TEST;
+
+    zx_handle_t sockets[2];
+    ASSERT_EQ(zx_socket_create(0, &sockets[0], &sockets[1]), ZX_OK, "");
+
+    size_t value = 0u;
+    ASSERT_EQ(zx_object_set_property(sockets[0], ZX_PROP_SOCKET_RX_BUF_MAX, &value, sizeof(value)),
+              ZX_ERR_OUT_OF_RANGE, "");
+    value = SIZE_MAX;
+    ASSERT_EQ(zx_object_set_property(sockets[0], ZX_PROP_SOCKET_RX_BUF_MAX, &value, sizeof(value)),
+              ZX_ERR_OUT_OF_RANGE, "");
+    uint32_t small = 4096u;
+    ASSERT_EQ(zx_object_set_property(sockets[0], ZX_PROP_SOCKET_RX_BUF_MAX, &small, sizeof(small)),
+              ZX_ERR_BUFFER_TOO_SMALL, "");
+
+    // Setting one side's receive limit shows up as the other side's transmit
+    // limit, which the writer itself can't set.
+    size_t max = 1u << 20;
+    ASSERT_EQ(zx_object_set_property(sockets[0], ZX_PROP_SOCKET_RX_BUF_MAX, &max, sizeof(max)),
+              ZX_OK, "");
+    ASSERT_EQ(zx_object_get_property(sockets[1], ZX_PROP_SOCKET_TX_BUF_MAX, &value, sizeof(value)),
+              ZX_OK, "");
+    EXPECT_EQ(value, max, "");
+    ASSERT_EQ(zx_object_set_property(sockets[1], ZX_PROP_SOCKET_TX_BUF_MAX, &max, sizeof(max)),
+              ZX_ERR_ACCESS_DENIED, "");
+
+    // A lower limit shortens writes.
+    max = 8192u;
+    ASSERT_EQ(zx_object_set_property(sockets[0], ZX_PROP_SOCKET_RX_BUF_MAX, &max, sizeof(max)),
+              ZX_OK, "");
+    ASSERT_EQ(zx_object_get_property(sockets[1], ZX_PROP_SOCKET_TX_BUF_MAX, &value, sizeof(value)),
+              ZX_OK, "");
+    EXPECT_EQ(value, max, "");
+
+    static uint8_t buf[3 * 8192u];
+    size_t actual;
+    ASSERT_EQ(zx_socket_write(sockets[1], 0, buf, sizeof(buf), &actual), ZX_OK, "");
+    EXPECT_LE(actual, max, "");
+    zx_signals_t pending;
+    ASSERT_EQ(zx_object_wait_one(sockets[1], ZX_SOCKET_WRITABLE, 0u, &pending),
+              ZX_ERR_TIMED_OUT, "");
+
+    // Raising the limit again makes the writer writable.
+    max = 4u * 8192u;
+    ASSERT_EQ(zx_object_set_property(sockets[0], ZX_PROP_SOCKET_RX_BUF_MAX, &max, sizeof(max)),
+              ZX_OK, "");
+    ASSERT_EQ(zx_object_wait_one(sockets[1], ZX_SOCKET_WRITABLE, 0u, &pending), ZX_OK, "");
+
+    // Socket handles keep their default rights, so the limit is set with
+    // ZX_RIGHT_READ and not ZX_RIGHT_SET_PROPERTY.
+    zx_info_handle_basic_t info;
+    ASSERT_EQ(zx_object_get_info(sockets[0], ZX_INFO_HANDLE_BASIC, &info, sizeof(info),
+                                 NULL, NULL),
+              ZX_OK, "");
+    EXPECT_EQ(info.rights & ZX_RIGHT_SET_PROPERTY, 0u, "");
+    zx_handle_t cant_read;
+    ASSERT_EQ(zx_handle_duplicate(sockets[0], info.rights & ~ZX_RIGHT_READ, &cant_read),
+              ZX_OK, "");
+    EXPECT_EQ(zx_object_set_property(cant_read, ZX_PROP_SOCKET_RX_BUF_MAX, &max, sizeof(max)),
+              ZX_ERR_ACCESS_DENIED, "");
+    EXPECT_EQ(zx_object_get_property(cant_read, ZX_PROP_SOCKET_RX_BUF_MAX, &value, sizeof(value)),
+              ZX_OK, "");
+    zx_handle_close(cant_read);
+
+    zx_handle_close(sockets[0]);
+    zx_handle_close(sockets[1]);
+
+    END_TEST;
+}
+
 static bool channel_depth_test(void) {
     BEGIN_TEST;
 
@@ -417,6 +488,7 @@ RUN_TEST(job_name_test);
 RUN_TEST(vmo_name_test);
 RUN_TEST(channel_name_test);
 RUN_TEST(socket_buffer_test);
+RUN_TEST(socket_buffer_max_test);
 RUN_TEST(channel_depth_test);
 #if defined(__x86_64__)
 RUN_TEST(fs_invalid_test)
@@ -1098,6 +1098,133 @@ bool vmo_clone_decommit_test() {
     END_TEST;
 }
 
+bool vmo_zero_test() {
+    BEGIN_TEST;
+
+    zx_handle_t vmo;
+    zx_handle_t clone_vmo;
+    uintptr_t ptr;
+    uintptr_t clone_ptr;
+    volatile uint8_t *p;
+    volatile uint8_t *cp;
+
+    const size_t size = PAGE_SIZE * 4;
+    EXPECT_EQ(ZX_OK, zx_vmo_create(size, 0, &vmo), "vm_object_create");
+    EXPECT_EQ(ZX_OK,
+            zx_vmar_map(zx_vmar_root_self(), 0, vmo, 0, size, ZX_VM_FLAG_PERM_READ|ZX_VM_FLAG_PERM_WRITE, &ptr),
+            "map");
+    p = (volatile uint8_t *)ptr;
+    memset((void*)ptr, 0xaa, size);
+
+    // zero a range that covers whole pages and parts of pages
+    EXPECT_EQ(ZX_OK, zx_vmo_op_range(vmo, ZX_VMO_OP_ZERO, PAGE_SIZE / 2, PAGE_SIZE * 2, NULL, 0));
+    EXPECT_EQ(0xaa, p[PAGE_SIZE / 2 - 1], "before the range");
+    EXPECT_EQ(0, p[PAGE_SIZE / 2], "start of the range");
+    EXPECT_EQ(0, p[PAGE_SIZE], "whole page in the range");
+    EXPECT_EQ(0, p[PAGE_SIZE * 2 + PAGE_SIZE / 2 - 1], "end of the range");
+    EXPECT_EQ(0xaa, p[PAGE_SIZE * 2 + PAGE_SIZE / 2], "after the range");
+
+    // zeroing a whole page of a clone hides the parent's contents
+    EXPECT_EQ(ZX_OK, zx_vmo_clone(vmo, ZX_VMO_CLONE_COPY_ON_WRITE, 0, size, &clone_vmo), "vm_clone");
+    EXPECT_EQ(ZX_OK,
+            zx_vmar_map(zx_vmar_root_self(), 0, clone_vmo, 0, size, ZX_VM_FLAG_PERM_READ|ZX_VM_FLAG_PERM_WRITE, &clone_ptr),
+            "map");
+    cp = (volatile uint8_t *)clone_ptr;
+    EXPECT_EQ(0xaa, cp[PAGE_SIZE * 3], "read back from clone");
+    EXPECT_EQ(ZX_OK, zx_vmo_op_range(clone_vmo, ZX_VMO_OP_ZERO, PAGE_SIZE * 3, PAGE_SIZE, NULL, 0));
+    EXPECT_EQ(0, cp[PAGE_SIZE * 3], "read back from clone");
+    EXPECT_EQ(0xaa, p[PAGE_SIZE * 3], "read back from original");
+
+    // the zero op needs the write right
+    zx_handle_t ro_vmo;
+    EXPECT_EQ(ZX_OK, zx_handle_duplicate(vmo, ZX_RIGHT_READ, &ro_vmo));
+    EXPECT_EQ(ZX_ERR_ACCESS_DENIED, zx_vmo_op_range(ro_vmo, ZX_VMO_OP_ZERO, 0, PAGE_SIZE, NULL, 0));
+    EXPECT_EQ(ZX_ERR_OUT_OF_RANGE, zx_vmo_op_range(vmo, ZX_VMO_OP_ZERO, size + PAGE_SIZE, PAGE_SIZE, NULL, 0));
+
+    EXPECT_EQ(ZX_OK, zx_handle_close(ro_vmo), "handle_close");
+    EXPECT_EQ(ZX_OK, zx_handle_close(vmo), "handle_close");
+    EXPECT_EQ(ZX_OK, zx_handle_close(clone_vmo), "handle_close");
+    EXPECT_EQ(ZX_OK, zx_vmar_unmap(zx_vmar_root_self(), ptr, size), "unmap");
+    EXPECT_EQ(ZX_OK, zx_vmar_unmap(zx_vmar_root_self(), clone_ptr, size), "unmap");
+
+    END_TEST;
+}
+
+bool vmo_transfer_pages_test() {
+    BEGIN_TEST;
+
+    zx_handle_t src;
+    zx_handle_t dst;
+    uintptr_t src_ptr;
+    uintptr_t dst_ptr;
+
+    const size_t size = PAGE_SIZE * 4;
+    EXPECT_EQ(ZX_OK, zx_vmo_create(size, 0, &src), "vm_object_create");
+    EXPECT_EQ(ZX_OK, zx_vmo_create(size, 0, &dst), "vm_object_create");
+    EXPECT_EQ(ZX_OK,
+            zx_vmar_map(zx_vmar_root_self(), 0, src, 0, size, ZX_VM_FLAG_PERM_READ|ZX_VM_FLAG_PERM_WRITE, &src_ptr),
+            "map");
+    EXPECT_EQ(ZX_OK,
+            zx_vmar_map(zx_vmar_root_self(), 0, dst, 0, size, ZX_VM_FLAG_PERM_READ|ZX_VM_FLAG_PERM_WRITE, &dst_ptr),
+            "map");
+    volatile uint32_t *sp = (volatile uint32_t *)src_ptr;
+    volatile uint32_t *dp = (volatile uint32_t *)dst_ptr;
+
+    // fill the first two source pages, leaving the third uncommitted
+    for (size_t i = 0; i < PAGE_SIZE * 2 / sizeof(uint32_t); i++) {
+        sp[i] = static_cast<uint32_t>(i);
+    }
+    dp[PAGE_SIZE * 3 / sizeof(uint32_t)] = 42;
+
+    // move three pages to the end of the destination
+    EXPECT_EQ(ZX_OK, zx_vmo_transfer_pages(dst, PAGE_SIZE, src, 0, PAGE_SIZE * 3));
+    for (size_t i = 0; i < PAGE_SIZE * 2 / sizeof(uint32_t); i++) {
+        if (dp[PAGE_SIZE / sizeof(uint32_t) + i] != i) {
+            EXPECT_EQ(i, dp[PAGE_SIZE / sizeof(uint32_t) + i], "transferred contents");
+            break;
+        }
+    }
+    EXPECT_EQ(0u, dp[PAGE_SIZE * 3 / sizeof(uint32_t)], "transferred uncommitted page");
+
+    // the source range is left decommitted
+    zx_info_working_set_t info;
+    EXPECT_EQ(ZX_OK, zx_object_get_info(src, ZX_INFO_VMO_WORKING_SET, &info, sizeof(info),
+                                        nullptr, nullptr));
+    EXPECT_EQ(0u, info.committed_bytes, "source after transfer");
+    EXPECT_EQ(0u, sp[1], "source after transfer");
+
+    // the ranges are checked, and must be page aligned
+    EXPECT_EQ(ZX_ERR_INVALID_ARGS, zx_vmo_transfer_pages(dst, 0, src, 1, PAGE_SIZE));
+    EXPECT_EQ(ZX_ERR_OUT_OF_RANGE, zx_vmo_transfer_pages(dst, 0, src, size, PAGE_SIZE));
+    EXPECT_EQ(ZX_ERR_OUT_OF_RANGE, zx_vmo_transfer_pages(dst, size, src, 0, PAGE_SIZE));
+
+    // overlapping ranges of one VMO are refused, leaving the source intact
+    sp[0] = 7;
+    EXPECT_EQ(ZX_ERR_INVALID_ARGS, zx_vmo_transfer_pages(src, PAGE_SIZE, src, 0, PAGE_SIZE * 2));
+    EXPECT_EQ(7u, sp[0], "source after refused transfer");
+    EXPECT_EQ(ZX_OK, zx_vmo_transfer_pages(src, PAGE_SIZE, src, 0, PAGE_SIZE));
+    EXPECT_EQ(7u, sp[PAGE_SIZE / sizeof(uint32_t)], "transferred within one VMO");
+
+    // a source with clones can't give up its pages
+    zx_handle_t clone_vmo;
+    EXPECT_EQ(ZX_OK, zx_vmo_clone(src, ZX_VMO_CLONE_COPY_ON_WRITE, 0, size, &clone_vmo), "vm_clone");
+    EXPECT_EQ(ZX_ERR_BAD_STATE, zx_vmo_transfer_pages(dst, 0, src, 0, PAGE_SIZE));
+    EXPECT_EQ(ZX_OK, zx_handle_close(clone_vmo), "handle_close");
+
+    // the source needs the read and write rights
+    zx_handle_t ro_src;
+    EXPECT_EQ(ZX_OK, zx_handle_duplicate(src, ZX_RIGHT_READ, &ro_src));
+    EXPECT_EQ(ZX_ERR_ACCESS_DENIED, zx_vmo_transfer_pages(dst, 0, ro_src, 0, PAGE_SIZE));
+    EXPECT_EQ(ZX_OK, zx_handle_close(ro_src), "handle_close");
+
+    EXPECT_EQ(ZX_OK, zx_handle_close(src), "handle_close");
+    EXPECT_EQ(ZX_OK, zx_handle_close(dst), "handle_close");
+    EXPECT_EQ(ZX_OK, zx_vmar_unmap(zx_vmar_root_self(), src_ptr, size), "unmap");
+    EXPECT_EQ(ZX_OK, zx_vmar_unmap(zx_vmar_root_self(), dst_ptr, size), "unmap");
+
+    END_TEST;
+}
+
 // verify the affect of commit on a clone
 bool vmo_clone_commit_test() {
     BEGIN_TEST;
@@ -1740,6 +1867,8 @@ RUN_TEST(vmo_clone_test_3);
 RUN_TEST(vmo_clone_test_4);
 RUN_TEST(vmo_clone_decommit_test);
 RUN_TEST(vmo_clone_commit_test);
+RUN_TEST(vmo_zero_test);
+RUN_TEST(vmo_transfer_pages_test);
 RUN_TEST(vmo_clone_rights_test);
 RUN_TEST(vmo_resize_hazard);
 RUN_TEST(vmo_clone_resize_clone_hazard);
@@ -1036,6 +1036,11 @@ __NO_SAFESTACK NO_ASAN static zx_status_t map_library(zx_handle_t vmo,
         } else if (ph->p_memsz > ph->p_filesz) {
             // Read-only .bss is not a thing.
             goto noexec;
+        } else {
+            // Read-only segments are usually shared with other processes
+            // and already resident, so map them in up front rather than
+            // faulting on each page.
+            zx_flags |= ZX_VM_FLAG_MAP_RANGE;
         }
 
         status = _zx_vmar_map(dso->vmar, mapaddr - vmar_base, map_vmo,